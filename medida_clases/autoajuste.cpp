@@ -0,0 +1,296 @@
+#include "autoajuste.h"
+#include "coleccion_virtual.h"
+#include "mapas_bits.h"
+#include "persona.h"
+#include "texto.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+static const size_t REPETICIONES = 7;
+static const double TOLERANCIA = 0.05;            // Diferencias menores se consideran ruido
+static const size_t FILAS_MUESTRA_MINIMAS = 65536;
+static const size_t FILAS_MUESTRA_MAXIMAS = 262144;
+static const size_t FILAS_SONDEO_GENERACION = 16384;
+static const int PASADAS_MAPA_BITS = 4;           // Un resumen solo dura ~1 ms: se repite para medir sobre el ruido
+static const uint64_t SEMILLA_MUESTRA = 97;
+static const int VERSION_ARCHIVO = 2; // 2: clave calibrado
+
+// Evita que el compilador descarte los resultados de los sondeos
+static volatile double sumidero = 0.0;
+
+std::vector<size_t> cachesActuales() {
+    std::vector<size_t> bytes;
+    for (const auto& c : cachesDelNucleo(0)) bytes.push_back(c.bytes);
+    return bytes;
+}
+
+static size_t potenciaDeDosHasta(size_t valor) {
+    size_t p = 1;
+    while (p * 2 <= valor) p *= 2;
+    return p;
+}
+
+/**
+ * Mide cada candidato REPETICIONES veces, intercalando los candidatos en
+ * cada ronda para repartir la deriva, y devuelve la mediana de cada uno.
+ */
+template <typename Ejecutar>
+static std::vector<double> medirCandidatos(size_t candidatos, Ejecutar ejecutar, const ControlOperacion& control,
+                                           size_t& rondas, size_t totalRondas) {
+    std::vector<std::vector<double>> tiempos(candidatos);
+    for (size_t r = 0; r < REPETICIONES; ++r) {
+        control.avanzar(rondas++, totalRondas);
+        for (size_t k = 0; k < candidatos; ++k) {
+            size_t c = (k + r) % candidatos;
+            auto inicio = std::chrono::steady_clock::now();
+            ejecutar(c);
+            std::chrono::duration<double, std::milli> duracion = std::chrono::steady_clock::now() - inicio;
+            tiempos[c].push_back(duracion.count());
+        }
+    }
+    std::vector<double> medianas;
+    for (auto& t : tiempos) {
+        std::nth_element(t.begin(), t.begin() + t.size() / 2, t.end());
+        medianas.push_back(t[t.size() / 2]);
+    }
+    return medianas;
+}
+
+/**
+ * Primer candidato (en orden de preferencia) dentro de la tolerancia del mejor puntaje.
+ */
+static size_t elegir(const std::vector<double>& puntajes) {
+    double mejor = *std::min_element(puntajes.begin(), puntajes.end());
+    for (size_t i = 0; i < puntajes.size(); ++i) {
+        if (puntajes[i] <= mejor * (1.0 + TOLERANCIA)) return i;
+    }
+    return 0;
+}
+
+/**
+ * Recorrido por fragmentos como los de generador.cpp: patrimonio del grupo
+ * A y edad máxima, con un punto de control por fragmento.
+ */
+static double recorrerPorFragmentos(const std::vector<Persona>& personas, const ControlOperacion& control) {
+    double suma = 0.0;
+    int edadMaxima = 0;
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            if (personas[i].getGrupoDeclaracion() == "A") suma += personas[i].getPatrimonio();
+            edadMaxima = std::max(edadMaxima, personas[i].getEdad());
+        }
+    }
+    control.avanzar(personas.size(), personas.size());
+    return suma + edadMaxima;
+}
+
+ReporteAjuste calibrarParametros(const ControlOperacion& control) {
+    ReporteAjuste reporte;
+    ParametrosAjuste& elegidos = reporte.parametros;
+    elegidos.caches = cachesActuales();
+    elegidos.calibrado = true;
+
+    // Tamaños de caché con respaldo típico si sysfs no los expone
+    std::vector<NivelCache> caches = cachesDelNucleo(0);
+    size_t bytesL1 = caches.size() > 0 ? caches[0].bytes : 32 * 1024;
+    size_t bytesL2 = caches.size() > 1 ? caches[1].bytes : 1024 * 1024;
+    size_t bytesUltimo = caches.empty() ? 8 * 1024 * 1024 : caches.back().bytes;
+
+    // Muestra mayor que L2 (hasta dos veces el último nivel, con tope) para
+    // que el prefetch tenga latencia que ocultar
+    reporte.filasMuestra = std::max(FILAS_MUESTRA_MINIMAS, std::min(FILAS_MUESTRA_MAXIMAS, 2 * bytesUltimo / sizeof(Persona)));
+    ColeccionVirtual sintetica(reporte.filasMuestra, SEMILLA_MUESTRA);
+    std::vector<Persona> muestra = sintetica.materializar();
+    IndicesMapaBits indices(muestra);
+
+    // Candidatos en orden de preferencia
+    std::vector<size_t> fragmentos = {1024, 4096, 16384, 65536, 262144};
+    fragmentos.push_back(potenciaDeDosHasta(std::max<size_t>(1024, bytesL2 / sizeof(Persona)))); // Fragmento que cabe en L2
+    std::sort(fragmentos.begin(), fragmentos.end());
+    fragmentos.erase(std::unique(fragmentos.begin(), fragmentos.end()), fragmentos.end());
+
+    std::vector<size_t> lotes; // El búfer de filas (4 bytes cada una) ocupa a lo sumo media L1
+    for (size_t l = 64; l <= std::max<size_t>(64, bytesL1 / 2 / sizeof(uint32_t)); l *= 4) lotes.push_back(l);
+    const std::vector<size_t> distancias = {0, 2, 4, 8, 16, 32};
+
+    size_t rondas = 0;
+    const size_t totalRondas = 3 * REPETICIONES;
+    ControlOperacion sondeo; // Punto de control como el del menú: token y progreso que calcula el porcentaje
+    sondeo.token = control.token;
+    int ultimoPorcentaje = -1;
+    sondeo.progreso = [&ultimoPorcentaje](size_t hechas, size_t total) {
+        ultimoPorcentaje = total ? static_cast<int>(hechas * 100 / total) : 100;
+    };
+
+    // 1. Fragmento: generación y recorrido, cada uno relativo a su mejor tiempo
+    std::vector<double> generacion = medirCandidatos(fragmentos.size(), [&](size_t c) {
+        sondeo.tamFragmento = fragmentos[c];
+        sumidero = sumidero + sintetica.materializar(FILAS_SONDEO_GENERACION, sondeo).back().getPatrimonio();
+    }, control, rondas, totalRondas);
+    std::vector<double> recorrido = medirCandidatos(fragmentos.size(), [&](size_t c) {
+        sondeo.tamFragmento = fragmentos[c];
+        sumidero = sumidero + recorrerPorFragmentos(muestra, sondeo);
+    }, control, rondas, totalRondas);
+    double mejorGeneracion = *std::min_element(generacion.begin(), generacion.end());
+    double mejorRecorrido = *std::min_element(recorrido.begin(), recorrido.end());
+    std::vector<double> puntajes;
+    for (size_t c = 0; c < fragmentos.size(); ++c) {
+        puntajes.push_back(generacion[c] / mejorGeneracion + recorrido[c] / mejorRecorrido);
+    }
+    size_t fragmentoElegido = elegir(puntajes);
+    elegidos.tamFragmento = fragmentos[fragmentoElegido];
+    for (size_t c = 0; c < fragmentos.size(); ++c) {
+        std::string valores = "fragmento=" + std::to_string(fragmentos[c]);
+        reporte.mediciones.push_back({"Generación", valores, generacion[c], c == fragmentoElegido});
+        reporte.mediciones.push_back({"Recorrido", valores, recorrido[c], c == fragmentoElegido});
+    }
+
+    // 2. Lote y prefetch: resumen de un filtro disperso (una ciudad) y uno denso (grupo A)
+    FiltroCategorico disperso, denso;
+    disperso.ciudades = {indices.ciudades().front()};
+    denso.grupos = {"A"};
+    const MapaBitsRoaring filasDispersas = indices.filtrar(disperso);
+    const MapaBitsRoaring filasDensas = indices.filtrar(denso);
+    std::vector<std::pair<size_t, size_t>> combinaciones; // Prefetch más corto primero
+    for (size_t d : distancias) {
+        for (size_t l : lotes) {
+            if (d < l) combinaciones.emplace_back(l, d);
+        }
+    }
+    std::vector<double> resumen = medirCandidatos(combinaciones.size(), [&](size_t c) {
+        for (int pasada = 0; pasada < PASADAS_MAPA_BITS; ++pasada) {
+            ResumenFiltro a = indices.resumir(muestra, filasDispersas, combinaciones[c].first, combinaciones[c].second);
+            ResumenFiltro b = indices.resumir(muestra, filasDensas, combinaciones[c].first, combinaciones[c].second);
+            sumidero = sumidero + a.sumaPatrimonio + b.sumaEdad;
+        }
+    }, control, rondas, totalRondas);
+    size_t combinacionElegida = elegir(resumen);
+    elegidos.filasPorLote = combinaciones[combinacionElegida].first;
+    elegidos.distanciaPrefetch = combinaciones[combinacionElegida].second;
+    for (size_t c = 0; c < combinaciones.size(); ++c) {
+        reporte.mediciones.push_back({"Mapa de bits", "lote=" + std::to_string(combinaciones[c].first) + " prefetch=" +
+                                      std::to_string(combinaciones[c].second), resumen[c], c == combinacionElegida});
+    }
+
+    control.avanzar(totalRondas, totalRondas);
+    return reporte;
+}
+
+// ============================================================================
+// ARCHIVO DE PARÁMETROS
+// ============================================================================
+
+void guardarParametros(const ParametrosAjuste& parametros, const std::string& ruta) {
+    std::ofstream archivo(ruta);
+    if (!archivo) throw std::runtime_error("No se pudo escribir " + ruta);
+    archivo << "# Parámetros calibrados para esta máquina; se regeneran con la opción 34\n";
+    archivo << "version=" << VERSION_ARCHIVO << "\n";
+    archivo << "calibrado=" << (parametros.calibrado ? 1 : 0) << "\n";
+    archivo << "caches=";
+    for (size_t i = 0; i < parametros.caches.size(); ++i) archivo << (i ? "," : "") << parametros.caches[i];
+    archivo << "\nfragmento=" << parametros.tamFragmento << "\n";
+    archivo << "lote=" << parametros.filasPorLote << "\n";
+    archivo << "prefetch=" << parametros.distanciaPrefetch << "\n";
+    if (!archivo) throw std::runtime_error("No se pudo escribir " + ruta);
+}
+
+static size_t leerEntero(const std::string& clave, const std::string& valor, size_t minimo, size_t maximo) {
+    size_t leido = 0;
+    size_t numero = 0;
+    try {
+        numero = std::stoul(valor, &leido);
+    } catch (const std::exception&) {
+        leido = 0;
+    }
+    if (leido == 0 || leido != valor.size() || numero < minimo || numero > maximo) {
+        throw std::runtime_error("Valor inválido para " + clave + ": " + valor);
+    }
+    return numero;
+}
+
+ParametrosAjuste cargarParametros(const std::string& ruta) {
+    std::ifstream archivo(ruta);
+    if (!archivo) throw std::runtime_error("No existe " + ruta);
+
+    ParametrosAjuste parametros;
+    bool version = false, calibrado = false, fragmento = false, lote = false, prefetch = false;
+    std::string linea;
+    while (std::getline(archivo, linea)) {
+        if (linea.empty() || linea[0] == '#') continue;
+        size_t igual = linea.find('=');
+        if (igual == std::string::npos) throw std::runtime_error("Línea inválida en " + ruta + ": " + linea);
+        std::string clave = linea.substr(0, igual), valor = linea.substr(igual + 1);
+        if (clave == "version") {
+            if (leerEntero(clave, valor, 0, 1000) != VERSION_ARCHIVO) throw std::runtime_error("Versión de " + ruta + " no soportada");
+            version = true;
+        } else if (clave == "calibrado") {
+            parametros.calibrado = leerEntero(clave, valor, 0, 1) == 1;
+            calibrado = true;
+        } else if (clave == "caches") {
+            std::istringstream partes(valor);
+            std::string parte;
+            while (std::getline(partes, parte, ',')) parametros.caches.push_back(leerEntero(clave, parte, 1, SIZE_MAX));
+        } else if (clave == "fragmento") {
+            parametros.tamFragmento = leerEntero(clave, valor, 1, size_t(1) << 24);
+            fragmento = true;
+        } else if (clave == "lote") {
+            parametros.filasPorLote = leerEntero(clave, valor, 1, size_t(1) << 20);
+            lote = true;
+        } else if (clave == "prefetch") {
+            parametros.distanciaPrefetch = leerEntero(clave, valor, 0, 1024);
+            prefetch = true;
+        }
+    }
+    if (!version || !calibrado || !fragmento || !lote || !prefetch) throw std::runtime_error("Faltan parámetros en " + ruta);
+    return parametros;
+}
+
+// ============================================================================
+// SALIDA
+// ============================================================================
+
+void mostrarParametros(const ParametrosAjuste& parametros, std::ostream& salida) {
+    salida << "Fragmento: " << parametros.tamFragmento << " filas, lote: " << parametros.filasPorLote
+           << " filas, prefetch: ";
+    if (parametros.distanciaPrefetch) salida << parametros.distanciaPrefetch << " filas adelante";
+    else salida << "no";
+    if (!parametros.calibrado) {
+        salida << " (valores por defecto, sin calibrar)\n";
+        return;
+    }
+    if (parametros.caches.empty()) {
+        salida << " (calibrado; el sistema no informa las cachés)\n";
+        return;
+    }
+    salida << " (calibrado con cachés de";
+    for (size_t i = 0; i < parametros.caches.size(); ++i) {
+        salida << (i ? ", " : " ") << "L" << i + 1 << " " << parametros.caches[i] / 1024 << " KB";
+    }
+    salida << ")\n";
+}
+
+void mostrarReporteAjuste(const ReporteAjuste& reporte, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+
+    salida << "\n=== CALIBRACIÓN (" << reporte.filasMuestra << " filas de muestra, mediana de " << REPETICIONES
+           << " repeticiones) ===\n";
+    salida << rellenar("Núcleo", 14) << rellenar("Valores", 26) << std::setw(12) << "ms" << "\n";
+    salida << std::fixed << std::setprecision(3);
+    for (const auto& m : reporte.mediciones) {
+        salida << rellenar(m.nucleo, 14) << rellenar(m.valores, 26) << std::setw(12) << m.ms
+               << (m.elegida ? "  <- elegido" : "") << "\n";
+    }
+    salida << "Se elige el valor más conservador a menos de " << static_cast<int>(TOLERANCIA * 100) << "% del mejor.\n";
+    mostrarParametros(reporte.parametros, salida);
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
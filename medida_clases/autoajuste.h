@@ -0,0 +1,83 @@
+#ifndef AUTOAJUSTE_H
+#define AUTOAJUSTE_H
+
+#include "banco_pruebas.h"
+#include "cancelacion.h"
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// AUTOAJUSTE DE FRAGMENTO, LOTE Y DISTANCIA DE PREFETCH
+// ============================================================================
+// Los núcleos por fragmentos o por lotes tienen parámetros cuyo mejor valor
+// depende de la máquina (tamaños de caché, latencia de memoria):
+//   - fragmento: filas entre puntos de control en generación, recorridos y
+//     guardado (ControlOperacion::tamFragmento),
+//   - lote: filas que se sacan de un mapa de bits antes de leer las personas,
+//   - prefetch: cuántas filas del lote se adelanta la carga de cada Persona.
+// La calibración lee las cachés de sysfs, elige candidatos alrededor de
+// ellas, mide sondeos cortos de los núcleos reales sobre una muestra mayor
+// que L2 y guarda lo elegido en un archivo de texto clave=valor. Al arrancar
+// se carga ese archivo; si falta o es de otra máquina se calibra de nuevo.
+// ============================================================================
+
+/**
+ * Parámetros en uso por los núcleos ajustables.
+ */
+struct ParametrosAjuste {
+    size_t tamFragmento = ControlOperacion::FRAGMENTO_POR_DEFECTO;
+    size_t filasPorLote = 1024;
+    size_t distanciaPrefetch = 0;    // 0 = sin prefetch
+    bool calibrado = false;          // false = valores por defecto
+    std::vector<size_t> caches;      // Bytes de cada nivel con que se calibró (vacío si sysfs no los expone)
+};
+
+/**
+ * Una medición de la calibración.
+ */
+struct MedicionAjuste {
+    std::string nucleo;   // "Generación", "Recorrido", "Mapa de bits"
+    std::string valores;  // Ej. "fragmento=16384" o "lote=1024 prefetch=8"
+    double ms = 0.0;      // Mediana
+    bool elegida = false;
+};
+
+struct ReporteAjuste {
+    ParametrosAjuste parametros;
+    size_t filasMuestra = 0;
+    std::vector<MedicionAjuste> mediciones;
+};
+
+/**
+ * Calibra los parámetros para la máquina actual.
+ *
+ * IMPLEMENTACIÓN: Muestra sintética de ColeccionVirtual (no toca rand());
+ *                 por cada candidato, mediana de repeticiones intercaladas.
+ *                 Entre candidatos a menos de la tolerancia del mejor se
+ *                 prefiere el más conservador (fragmento menor, sin prefetch)
+ * @throws OperacionCancelada si se cancela
+ */
+ReporteAjuste calibrarParametros(const ControlOperacion& control = ControlOperacion());
+
+/**
+ * Cachés de datos actuales del núcleo 0 (bytes por nivel), para comparar
+ * con las de un archivo guardado.
+ */
+std::vector<size_t> cachesActuales();
+
+/**
+ * @throws std::runtime_error si no se puede escribir
+ */
+void guardarParametros(const ParametrosAjuste& parametros, const std::string& ruta);
+
+/**
+ * @throws std::runtime_error si el archivo no existe o algún valor no es válido
+ */
+ParametrosAjuste cargarParametros(const std::string& ruta);
+
+void mostrarParametros(const ParametrosAjuste& parametros, std::ostream& salida = std::cout);
+void mostrarReporteAjuste(const ReporteAjuste& reporte, std::ostream& salida = std::cout);
+
+#endif // AUTOAJUSTE_H
@@ -0,0 +1,223 @@
+#include "banco_pruebas.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sched.h>  // sched_setaffinity, CPU_SET
+
+static const size_t VACIADO_POR_DEFECTO = 64 * 1024 * 1024; // Si no se puede leer el tamaño de la LLC
+
+/**
+ * Lee la primera línea de un archivo de /sys (vacío si no existe).
+ */
+static std::string leerSys(const std::string& ruta) {
+    std::ifstream archivo(ruta);
+    std::string linea;
+    std::getline(archivo, linea);
+    return linea;
+}
+
+/**
+ * Interpreta una lista de CPUs del kernel, p. ej. "2-3,6".
+ */
+static std::vector<int> listaCpus(const std::string& texto) {
+    std::vector<int> cpus;
+    std::stringstream partes(texto);
+    std::string parte;
+    while (std::getline(partes, parte, ',')) {
+        if (parte.empty()) continue;
+        size_t guion = parte.find('-');
+        int desde = std::atoi(parte.c_str());
+        int hasta = guion == std::string::npos ? desde : std::atoi(parte.c_str() + guion + 1);
+        for (int c = desde; c <= hasta; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+std::vector<NivelCache> cachesDelNucleo(int cpu) {
+    std::vector<NivelCache> caches;
+    for (int indice = 0; indice < 8; ++indice) {
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index" + std::to_string(indice);
+        std::string tamano = leerSys(base + "/size");
+        if (tamano.empty()) break;
+        NivelCache c;
+        c.nivel = std::atoi(leerSys(base + "/level").c_str());
+        c.tipo = leerSys(base + "/type");
+        if (c.tipo == "Instruction") continue;
+        c.bytes = std::strtoul(tamano.c_str(), nullptr, 10);
+        if (tamano.back() == 'K') c.bytes *= 1024;
+        if (tamano.back() == 'M') c.bytes *= 1024 * 1024;
+        caches.push_back(c);
+    }
+    std::sort(caches.begin(), caches.end(),
+              [](const NivelCache& a, const NivelCache& b) { return a.nivel < b.nivel; });
+    return caches;
+}
+
+BancoPruebas::BancoPruebas(const ConfiguracionBanco& configuracion) : config(configuracion) {
+    cpu_set_t permitidas;
+    CPU_ZERO(&permitidas);
+    sched_getaffinity(0, sizeof(permitidas), &permitidas);
+
+    // Preferencia: el núcleo pedido; si no, uno aislado; si no, el último permitido
+    // (el 0 suele atender más interrupciones)
+    std::vector<int> aisladas = listaCpus(leerSys("/sys/devices/system/cpu/isolated"));
+    nucleoElegido = -1;
+    if (config.nucleo >= 0 && config.nucleo < CPU_SETSIZE && CPU_ISSET(config.nucleo, &permitidas)) {
+        nucleoElegido = config.nucleo;
+    }
+    for (int cpu : aisladas) {
+        if (nucleoElegido < 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &permitidas)) nucleoElegido = cpu;
+    }
+    for (int cpu = CPU_SETSIZE - 1; nucleoElegido < 0 && cpu >= 0; --cpu) {
+        if (CPU_ISSET(cpu, &permitidas)) nucleoElegido = cpu;
+    }
+    nucleoAislado = std::find(aisladas.begin(), aisladas.end(), nucleoElegido) != aisladas.end();
+
+    std::vector<NivelCache> caches = cachesDelNucleo(std::max(nucleoElegido, 0));
+    bytesVaciado = caches.empty() ? VACIADO_POR_DEFECTO : 2 * caches.back().bytes;
+}
+
+std::vector<std::string> BancoPruebas::advertenciasEntorno() const {
+    std::vector<std::string> advertencias;
+    if (config.nucleo >= 0 && config.nucleo != nucleoElegido) {
+        advertencias.push_back("El núcleo " + std::to_string(config.nucleo) + " no está permitido; se usa el " +
+                               std::to_string(nucleoElegido));
+    }
+    if (!nucleoAislado) {
+        advertencias.push_back("El núcleo " + std::to_string(nucleoElegido) +
+                               " no está aislado (isolcpus); otros procesos pueden interferir");
+    }
+
+    std::string cpufreq = "/sys/devices/system/cpu/cpu" + std::to_string(nucleoElegido) + "/cpufreq/";
+    std::string gobernador = leerSys(cpufreq + "scaling_governor");
+    if (gobernador.empty()) {
+        advertencias.push_back("No se pudo leer el gobernador de frecuencia (¿máquina virtual?)");
+    } else if (gobernador != "performance") {
+        advertencias.push_back("Gobernador de frecuencia '" + gobernador + "'; use 'performance' para frecuencia estable");
+    }
+
+    if (leerSys("/sys/devices/system/cpu/intel_pstate/no_turbo") == "0" ||
+        leerSys("/sys/devices/system/cpu/cpufreq/boost") == "1") {
+        advertencias.push_back("Turbo activo: la frecuencia varía con la temperatura y la carga");
+    }
+    return advertencias;
+}
+
+void BancoPruebas::vaciarCaches() const {
+    // Escribir y leer un búfer mayor que la LLC expulsa los datos medidos
+    static std::vector<char> bufer;
+    bufer.resize(bytesVaciado);
+    volatile char suma = 0;
+    for (size_t i = 0; i < bufer.size(); i += 64) {
+        bufer[i] = static_cast<char>(i);
+        suma = suma + bufer[i];
+    }
+}
+
+/**
+ * Fija el hilo actual a un núcleo y restaura la afinidad original al salir.
+ */
+class AfinidadTemporal {
+public:
+    explicit AfinidadTemporal(int nucleo) {
+        fijado = sched_getaffinity(0, sizeof(original), &original) == 0;
+        cpu_set_t uno;
+        CPU_ZERO(&uno);
+        CPU_SET(nucleo, &uno);
+        fijado = fijado && sched_setaffinity(0, sizeof(uno), &uno) == 0;
+    }
+    ~AfinidadTemporal() {
+        if (fijado) sched_setaffinity(0, sizeof(original), &original);
+    }
+
+private:
+    cpu_set_t original;
+    bool fijado;
+};
+
+/**
+ * Descarta lo que imprime la variante y restaura la salida al terminar.
+ */
+class SalidaSilenciada {
+public:
+    SalidaSilenciada() : original(std::cout.rdbuf(nullptr)) {}
+    ~SalidaSilenciada() {
+        std::cout.rdbuf(original);
+        std::cout.clear(); // Escribir sin búfer activa badbit
+    }
+
+private:
+    std::streambuf* original;
+};
+
+static void calcularEstadisticas(ResultadoVariante& r) {
+    std::vector<double> ordenados = r.tiempos;
+    std::sort(ordenados.begin(), ordenados.end());
+    size_t n = ordenados.size();
+    r.minimo = ordenados.front();
+    r.mediana = n % 2 ? ordenados[n / 2] : (ordenados[n / 2 - 1] + ordenados[n / 2]) / 2;
+    double suma = 0.0;
+    for (double t : ordenados) suma += t;
+    r.media = suma / n;
+    double cuadrados = 0.0;
+    for (double t : ordenados) cuadrados += (t - r.media) * (t - r.media);
+    r.desviacion = n > 1 ? std::sqrt(cuadrados / (n - 1)) : 0.0;
+    r.coeficienteVariacion = r.media > 0 ? r.desviacion * 100.0 / r.media : 0.0;
+}
+
+std::vector<ResultadoVariante> BancoPruebas::ejecutar(const std::vector<VarianteBanco>& variantes) const {
+    if (variantes.empty() || config.repeticiones == 0) {
+        throw std::invalid_argument("Se necesita al menos una variante y una repetición");
+    }
+
+    std::vector<ResultadoVariante> resultados(variantes.size());
+    for (size_t v = 0; v < variantes.size(); ++v) resultados[v].nombre = variantes[v].nombre;
+
+    AfinidadTemporal afinidad(nucleoElegido);
+    SalidaSilenciada silencio;
+
+    // Ronda r: las variantes empiezan en la posición r (A B C, B C A, C A B, ...)
+    // así ninguna queda siempre primera o última frente a la deriva térmica
+    for (size_t ronda = 0; ronda < config.repeticiones; ++ronda) {
+        for (size_t k = 0; k < variantes.size(); ++k) {
+            size_t v = (ronda + k) % variantes.size();
+            if (config.cache == ModoCache::VACIAR) vaciarCaches();
+            if (config.cache == ModoCache::PRECALENTAR) variantes[v].ejecutar();
+
+            auto inicio = std::chrono::high_resolution_clock::now();
+            variantes[v].ejecutar();
+            auto fin = std::chrono::high_resolution_clock::now();
+            resultados[v].tiempos.push_back(std::chrono::duration<double, std::milli>(fin - inicio).count());
+        }
+    }
+
+    for (auto& r : resultados) calcularEstadisticas(r);
+    return resultados;
+}
+
+void BancoPruebas::mostrar(const std::vector<ResultadoVariante>& resultados, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+
+    salida << std::fixed << std::setprecision(3);
+    salida << "\n" << std::left << std::setw(32) << "Variante" << std::right << std::setw(12) << "Mediana ms"
+           << std::setw(12) << "Mínimo ms" << std::setw(12) << "Media ms" << std::setw(10) << "CV %" << "\n";
+    for (const auto& r : resultados) {
+        salida << std::left << std::setw(32) << r.nombre << std::right << std::setw(12) << r.mediana
+               << std::setw(12) << r.minimo << std::setw(12) << r.media << std::setw(10) << r.coeficienteVariacion;
+        if (r.coeficienteVariacion > 5.0) salida << "  (ruidoso)";
+        salida << "\n";
+    }
+    if (resultados.size() >= 2 && resultados[1].mediana > 0) {
+        salida << "Razón de medianas " << resultados[0].nombre << " / " << resultados[1].nombre << ": "
+               << resultados[0].mediana / resultados[1].mediana << "\n";
+    }
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
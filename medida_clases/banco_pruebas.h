@@ -0,0 +1,108 @@
+#ifndef BANCO_PRUEBAS_H
+#define BANCO_PRUEBAS_H
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// BANCO DE PRUEBAS CON CONTROL DE RUIDO
+// ============================================================================
+// Las mediciones del menú cambian mucho según el estado de las cachés, la
+// frecuencia de la CPU y lo que corra en paralelo. Este banco:
+//   - fija el hilo a un núcleo (preferiblemente aislado con isolcpus),
+//   - revisa el gobernador de frecuencia y el turbo y advierte si meten ruido,
+//   - vacía o precalienta las cachés antes de cada repetición,
+//   - intercala las variantes rotando el orden para cancelar la deriva,
+//   - y reporta mediana, mínimo y coeficiente de variación por variante.
+// ============================================================================
+
+/**
+ * Estado de las cachés antes de cada repetición medida.
+ */
+enum class ModoCache {
+    NINGUNO,     // Lo que haya quedado de la repetición anterior
+    VACIAR,      // Recorre un búfer mayor que la caché de último nivel
+    PRECALENTAR  // Ejecuta la variante una vez sin medir
+};
+
+/**
+ * Un nivel de caché del núcleo, leído de /sys/devices/system/cpu/cpuN/cache.
+ */
+struct NivelCache {
+    int nivel = 0;        // 1, 2, 3...
+    std::string tipo;     // "Data", "Instruction" o "Unified"
+    size_t bytes = 0;
+};
+
+/**
+ * Cachés de datos (y unificadas) de una CPU, ordenadas por nivel.
+ * Vacío si sysfs no expone la información.
+ */
+std::vector<NivelCache> cachesDelNucleo(int cpu);
+
+struct ConfiguracionBanco {
+    int nucleo = -1;            // -1 = elegir automáticamente
+    size_t repeticiones = 15;   // Repeticiones medidas por variante
+    ModoCache cache = ModoCache::VACIAR;
+};
+
+/**
+ * Variante a medir: nombre y función que ejecuta una repetición.
+ */
+struct VarianteBanco {
+    std::string nombre;
+    std::function<void()> ejecutar;
+};
+
+struct ResultadoVariante {
+    std::string nombre;
+    std::vector<double> tiempos; // ms, en orden de ejecución
+    double media = 0.0;
+    double mediana = 0.0;
+    double minimo = 0.0;
+    double desviacion = 0.0;
+    double coeficienteVariacion = 0.0; // desviación / media, en %
+};
+
+/**
+ * Ejecutor de comparaciones controladas.
+ *
+ * USO: Construir con la configuración, revisar advertenciasEntorno() y
+ *      llamar a ejecutar() con las variantes a comparar.
+ * SALIDA: Lo que las variantes impriman en std::cout se descarta.
+ */
+class BancoPruebas {
+public:
+    explicit BancoPruebas(const ConfiguracionBanco& configuracion);
+
+    /**
+     * Problemas del entorno que restan confiabilidad a las mediciones
+     * (gobernador distinto de "performance", turbo activo, núcleo no aislado).
+     */
+    std::vector<std::string> advertenciasEntorno() const;
+
+    /** Núcleo al que se fijará el hilo durante las mediciones. */
+    int nucleo() const { return nucleoElegido; }
+
+    /**
+     * Mide todas las variantes intercaladas.
+     *
+     * @throws std::invalid_argument si no hay variantes o repeticiones
+     */
+    std::vector<ResultadoVariante> ejecutar(const std::vector<VarianteBanco>& variantes) const;
+
+    static void mostrar(const std::vector<ResultadoVariante>& resultados, std::ostream& salida);
+
+private:
+    void vaciarCaches() const;
+
+    ConfiguracionBanco config;
+    int nucleoElegido;
+    bool nucleoAislado;
+    size_t bytesVaciado; // Dos veces la caché de último nivel
+};
+
+#endif // BANCO_PRUEBAS_H
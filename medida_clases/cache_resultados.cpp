@@ -0,0 +1,74 @@
+#include "cache_resultados.h"
+
+// Costo fijo aproximado por entrada (nodo de lista + nodo de tabla hash)
+static const size_t SOBRECOSTO_ENTRADA = 96;
+
+static size_t tamanoEntrada(const std::string& clave, const std::string& resultado) {
+    // La clave se guarda dos veces: en la lista y en la tabla hash
+    return 2 * clave.size() + resultado.size() + SOBRECOSTO_ENTRADA;
+}
+
+CacheResultados::CacheResultados(size_t capacidadBytes) : capacidad(capacidadBytes) {}
+
+/**
+ * Arma la clave separando los componentes con un carácter de control
+ * que no aparece en nombres de operaciones ni parámetros.
+ */
+std::string CacheResultados::clave(const std::string& operacion, const std::string& parametros, unsigned long version) {
+    return operacion + '\x1f' + parametros + '\x1f' + std::to_string(version);
+}
+
+/**
+ * Al ver una versión nueva, libera de inmediato todo lo anterior
+ * en lugar de esperar a que el LRU lo expulse.
+ */
+void CacheResultados::descartarVersionesAnteriores(unsigned long version) {
+    if (version != versionVigente) {
+        limpiar();
+        versionVigente = version;
+    }
+}
+
+bool CacheResultados::buscar(const std::string& operacion, const std::string& parametros,
+                             unsigned long version, std::string& resultado) {
+    descartarVersionesAnteriores(version);
+    auto it = mapa.find(clave(operacion, parametros, version));
+    if (it == mapa.end()) return false;
+
+    lru.splice(lru.begin(), lru, it->second); // Pasa a ser la más reciente
+    resultado = it->second->second;
+    return true;
+}
+
+void CacheResultados::guardar(const std::string& operacion, const std::string& parametros,
+                              unsigned long version, const std::string& resultado) {
+    descartarVersionesAnteriores(version);
+    std::string k = clave(operacion, parametros, version);
+    size_t tamano = tamanoEntrada(k, resultado);
+    if (tamano > capacidad) return;
+
+    auto existente = mapa.find(k);
+    if (existente != mapa.end()) {
+        usados -= tamanoEntrada(k, existente->second->second);
+        lru.erase(existente->second);
+        mapa.erase(existente);
+    }
+
+    // Expulsa desde el final (menos reciente) hasta que haya espacio
+    while (usados + tamano > capacidad && !lru.empty()) {
+        const Entrada& victima = lru.back();
+        usados -= tamanoEntrada(victima.first, victima.second);
+        mapa.erase(victima.first);
+        lru.pop_back();
+    }
+
+    lru.emplace_front(k, resultado);
+    mapa[k] = lru.begin();
+    usados += tamano;
+}
+
+void CacheResultados::limpiar() {
+    lru.clear();
+    mapa.clear();
+    usados = 0;
+}
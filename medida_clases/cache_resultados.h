@@ -0,0 +1,70 @@
+#ifndef CACHE_RESULTADOS_H
+#define CACHE_RESULTADOS_H
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// ============================================================================
+// CACHÉ DE RESULTADOS DE CONSULTAS
+// ============================================================================
+// Guarda el resultado ya formateado de una consulta, identificado por la
+// operación, sus parámetros y la versión del conjunto de datos. La versión
+// se incrementa con cada regeneración o modificación, así que un resultado
+// de una versión anterior nunca se vuelve a servir.
+// ============================================================================
+
+/**
+ * Caché LRU con memoria acotada.
+ *
+ * PROPÓSITO: Responder en microsegundos consultas repetidas sobre datos
+ *            que no cambiaron
+ * IMPLEMENTACIÓN: Lista doblemente enlazada (orden de uso) + tabla hash
+ *                 (acceso por clave); al superar la capacidad se expulsan
+ *                 las entradas menos usadas recientemente
+ * MEMORIA: Se contabilizan los bytes de claves y valores
+ */
+class CacheResultados {
+public:
+    static const size_t CAPACIDAD_POR_DEFECTO = 8 * 1024 * 1024; // 8 MB
+
+    explicit CacheResultados(size_t capacidadBytes = CAPACIDAD_POR_DEFECTO);
+
+    /**
+     * Busca un resultado.
+     *
+     * @param operacion Nombre de la operación
+     * @param parametros Parámetros de la operación (ciudad, grupo, ...)
+     * @param version Versión actual del conjunto de datos
+     * @param resultado Salida: resultado guardado, si existe
+     * @return true si hubo acierto
+     */
+    bool buscar(const std::string& operacion, const std::string& parametros,
+                unsigned long version, std::string& resultado);
+
+    /**
+     * Guarda un resultado; si no cabe ni solo en la caché, se ignora.
+     */
+    void guardar(const std::string& operacion, const std::string& parametros,
+                 unsigned long version, const std::string& resultado);
+
+    void limpiar();
+
+    size_t bytesUsados() const { return usados; }
+    size_t entradas() const { return mapa.size(); }
+
+private:
+    typedef std::pair<std::string, std::string> Entrada; // clave, resultado
+
+    static std::string clave(const std::string& operacion, const std::string& parametros, unsigned long version);
+    void descartarVersionesAnteriores(unsigned long version);
+
+    std::list<Entrada> lru; // Frente = usada más recientemente
+    std::unordered_map<std::string, std::list<Entrada>::iterator> mapa;
+    size_t capacidad;
+    size_t usados = 0;
+    unsigned long versionVigente = 0;
+};
+
+#endif // CACHE_RESULTADOS_H
@@ -0,0 +1,61 @@
+#include "cancelacion.h"
+#include <algorithm> // std::max
+#include <csignal>  // std::signal, SIGINT, std::sig_atomic_t
+#include <iostream>
+#include <memory>   // std::make_shared
+
+// Indica al manejador si hay una operación cancelable en curso
+static volatile std::sig_atomic_t operacionEnCurso = 0;
+
+TokenCancelacion& tokenInterrupcion() {
+    static TokenCancelacion token;
+    return token;
+}
+
+/**
+ * Manejador de SIGINT.
+ *
+ * NOTA: Solo toca variables atómicas, lo único seguro dentro de una señal.
+ * Sin operación en curso restaura la acción por defecto y la vuelve a lanzar.
+ */
+static void manejarInterrupcion(int senal) {
+    if (operacionEnCurso) {
+        tokenInterrupcion().cancelar();
+        return;
+    }
+    std::signal(senal, SIG_DFL);
+    std::raise(senal);
+}
+
+void instalarManejadorInterrupcion() {
+    std::signal(SIGINT, manejarInterrupcion);
+}
+
+OperacionCancelable::OperacionCancelable() {
+    tokenInterrupcion().reiniciar();
+    operacionEnCurso = 1;
+}
+
+OperacionCancelable::~OperacionCancelable() {
+    operacionEnCurso = 0;
+}
+
+ControlOperacion OperacionCancelable::control(const std::string& etiqueta, size_t tamFragmento) const {
+    ControlOperacion c;
+    c.token = &tokenInterrupcion();
+    c.progreso = barraProgreso(etiqueta);
+    c.tamFragmento = std::max<size_t>(1, tamFragmento); // 0 dejaría los recorridos por fragmentos sin avanzar
+    return c;
+}
+
+CallbackProgreso barraProgreso(const std::string& etiqueta) {
+    auto ultimo = std::make_shared<int>(-1); // Último porcentaje impreso
+    return [etiqueta, ultimo](size_t hechas, size_t total) {
+        int porcentaje = total ? static_cast<int>(hechas * 100 / total) : 100;
+        if (porcentaje == *ultimo) return;
+        *ultimo = porcentaje;
+        // Va a stderr para no mezclarse con la salida de la consulta
+        std::cerr << "\r" << etiqueta << ": " << porcentaje << "% (Ctrl-C para cancelar)" << std::flush;
+        if (hechas >= total) std::cerr << "\n";
+    };
+}
@@ -0,0 +1,116 @@
+#ifndef CANCELACION_H
+#define CANCELACION_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+// ============================================================================
+// CANCELACIÓN COOPERATIVA Y REPORTE DE PROGRESO
+// ============================================================================
+// Las operaciones largas recorren los datos por fragmentos. Entre fragmentos
+// consultan un token de cancelación y notifican el avance. Con fragmentos de
+// decenas de miles de filas la verificación se amortiza y su costo sobre los
+// bucles principales es despreciable.
+// ============================================================================
+
+/**
+ * Excepción lanzada cuando una operación detecta que fue cancelada.
+ *
+ * PROPÓSITO: Abandonar la operación sin modificar los datos existentes
+ */
+class OperacionCancelada : public std::runtime_error {
+public:
+    OperacionCancelada() : std::runtime_error("Operación cancelada por el usuario") {}
+};
+
+/**
+ * Token de cancelación compartido entre quien cancela y quien trabaja.
+ *
+ * IMPLEMENTACIÓN: Un booleano atómico; es seguro activarlo desde un
+ *                 manejador de señales o desde otro hilo
+ */
+class TokenCancelacion {
+public:
+    void cancelar() { solicitado.store(true, std::memory_order_relaxed); }
+    void reiniciar() { solicitado.store(false, std::memory_order_relaxed); }
+    bool cancelado() const { return solicitado.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> solicitado{false};
+};
+
+/**
+ * Función de progreso: recibe elementos procesados y total.
+ */
+using CallbackProgreso = std::function<void(size_t hechas, size_t total)>;
+
+/**
+ * Parámetros de control de una operación larga.
+ *
+ * USO: Se pasa a las funciones que la aceptan; el valor por defecto
+ *      (sin token ni callback) no agrega trabajo observable.
+ */
+struct ControlOperacion {
+    static const size_t FRAGMENTO_POR_DEFECTO = 65536;
+
+    const TokenCancelacion* token = nullptr; // nullptr = no cancelable
+    CallbackProgreso progreso;               // vacío = sin reporte
+    size_t tamFragmento = FRAGMENTO_POR_DEFECTO; // Elementos entre verificaciones
+
+    /**
+     * Punto de control entre fragmentos.
+     *
+     * @throws OperacionCancelada si el token fue activado
+     */
+    void avanzar(size_t hechas, size_t total) const {
+        if (token && token->cancelado()) throw OperacionCancelada();
+        if (progreso) progreso(hechas, total);
+    }
+};
+
+/**
+ * Token global activado por Ctrl-C (SIGINT) durante una operación.
+ */
+TokenCancelacion& tokenInterrupcion();
+
+/**
+ * Instala el manejador de SIGINT.
+ *
+ * COMPORTAMIENTO: Si hay una operación cancelable en curso, Ctrl-C activa
+ *                 tokenInterrupcion(); si no, termina el programa como siempre.
+ */
+void instalarManejadorInterrupcion();
+
+/**
+ * Marca el alcance de una operación que puede cancelarse con Ctrl-C.
+ *
+ * IMPLEMENTACIÓN: RAII; al crearse reinicia el token global y al destruirse
+ *                 vuelve al comportamiento normal de Ctrl-C
+ */
+class OperacionCancelable {
+public:
+    OperacionCancelable();
+    ~OperacionCancelable();
+    OperacionCancelable(const OperacionCancelable&) = delete;
+    OperacionCancelable& operator=(const OperacionCancelable&) = delete;
+
+    /**
+     * Control listo para usar: token global, barra de progreso y fragmento
+     * (al menos 1).
+     */
+    ControlOperacion control(const std::string& etiqueta,
+                             size_t tamFragmento = ControlOperacion::FRAGMENTO_POR_DEFECTO) const;
+};
+
+/**
+ * Crea un callback que imprime una barra de progreso en la misma línea.
+ *
+ * @param etiqueta Texto que antecede al porcentaje
+ * @return Callback que solo imprime cuando cambia el porcentaje entero
+ */
+CallbackProgreso barraProgreso(const std::string& etiqueta);
+
+#endif // CANCELACION_H
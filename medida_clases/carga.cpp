@@ -0,0 +1,304 @@
+#include "carga.h"
+#include "esquema_grupos.h"
+#include "generador.h"
+#include "texto.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <stdexcept>
+#include <thread>
+
+using Reloj = std::chrono::steady_clock;
+
+static const char* NOMBRES_CONSULTA[] = {"Por ID", "Máximo por ciudad", "Máximo por grupo"};
+
+// ============================================================================
+// DISTRIBUCIÓN ZIPF
+// ============================================================================
+
+// log1p(x)/x y expm1(x)/x, con su límite 1 cerca de x = 0
+static double log1pEntreX(double x) {
+    return std::fabs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x / 2.0;
+}
+
+static double expm1EntreX(double x) {
+    return std::fabs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x / 2.0;
+}
+
+DistribucionZipf::DistribucionZipf(uint64_t elementos, double exponente) : n(elementos), s(exponente) {
+    if (n == 0) throw std::invalid_argument("La distribución Zipf necesita al menos un elemento");
+    if (!(s > 0)) throw std::invalid_argument("El exponente Zipf debe ser positivo");
+    hIntegralX1 = hIntegral(1.5) - 1.0;
+    hIntegralN = hIntegral(static_cast<double>(n) + 0.5);
+    umbral = 2.0 - hIntegralInversa(hIntegral(2.5) - h(2.0));
+}
+
+double DistribucionZipf::h(double x) const {
+    return std::exp(-s * std::log(x));
+}
+
+double DistribucionZipf::hIntegral(double x) const {
+    const double logX = std::log(x);
+    return expm1EntreX((1.0 - s) * logX) * logX;
+}
+
+double DistribucionZipf::hIntegralInversa(double x) const {
+    double t = x * (1.0 - s);
+    if (t < -1.0) t = -1.0; // Solo por redondeo en el extremo
+    return std::exp(log1pEntreX(t) * x);
+}
+
+uint64_t DistribucionZipf::operator()(std::mt19937_64& generador) const {
+    std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+    for (;;) {
+        const double u = hIntegralN + uniforme(generador) * (hIntegralX1 - hIntegralN);
+        const double x = hIntegralInversa(u);
+        double k = std::floor(x + 0.5);
+        k = std::max(1.0, std::min(k, static_cast<double>(n)));
+        if (k - x <= umbral || u >= hIntegral(k + 0.5) - h(k)) return static_cast<uint64_t>(k);
+    }
+}
+
+// ============================================================================
+// CLIENTES
+// ============================================================================
+
+/**
+ * Latencias de un cliente, por tipo de consulta.
+ */
+struct MuestrasCliente {
+    std::vector<double> programada[3]; // ms desde la hora programada (también las no enviadas)
+    std::vector<double> servicio[3];   // ms desde el envío real
+    size_t errores[3] = {0, 0, 0};
+    size_t sinEnviar[3] = {0, 0, 0};   // Incluidas en programada con su espera hasta el corte
+    size_t consultasId = 0;
+    size_t idMasFrecuente = 0;
+};
+
+/**
+ * Rango Zipf -> fila: permutación afín (rango * a mod n, con a coprimo
+ * con n) para que las cédulas calientes queden repartidas por el vector y
+ * no todas en las primeras filas, que estarían siempre en caché.
+ */
+static uint64_t multiplicadorPermutacion(uint64_t n) {
+    auto mcd = [](uint64_t a, uint64_t b) {
+        while (b) { uint64_t r = a % b; a = b; b = r; }
+        return a;
+    };
+    uint64_t a = static_cast<uint64_t>(n * 0.6180339887) | 1;
+    while (mcd(a, n) != 1) a += 2;
+    return a % n == 0 ? 1 : a;
+}
+
+static double percentil(const std::vector<double>& ordenados, double q) {
+    if (ordenados.empty()) return 0.0;
+    size_t rango = static_cast<size_t>(std::ceil(q * ordenados.size()));
+    return ordenados[std::min(ordenados.size() - 1, rango == 0 ? 0 : rango - 1)];
+}
+
+static LatenciasCarga resumir(const std::string& consulta, std::vector<double> programada,
+                              std::vector<double> servicio, size_t errores, size_t sinEnviar) {
+    LatenciasCarga l;
+    l.consulta = consulta;
+    l.completadas = programada.size() - sinEnviar;
+    l.errores = errores;
+    std::sort(programada.begin(), programada.end());
+    std::sort(servicio.begin(), servicio.end());
+    l.p50 = percentil(programada, 0.50);
+    l.p99 = percentil(programada, 0.99);
+    l.p999 = percentil(programada, 0.999);
+    l.maximo = programada.empty() ? 0.0 : programada.back();
+    l.p50Servicio = percentil(servicio, 0.50);
+    l.p99Servicio = percentil(servicio, 0.99);
+    return l;
+}
+
+ReporteCarga ejecutarCarga(const std::vector<Persona>& personas, const ConfiguracionCarga& configuracion,
+                           const ControlOperacion& control) {
+    const ConfiguracionCarga& c = configuracion;
+    if (personas.empty()) throw std::invalid_argument("No hay personas sobre las que generar carga");
+    if (c.clientes == 0 || c.clientes > 1024) throw std::invalid_argument("El número de clientes debe estar entre 1 y 1024");
+    if (!(c.duracionSegundos > 0)) throw std::invalid_argument("La duración debe ser positiva");
+    if (c.tasaObjetivo < 0) throw std::invalid_argument("La tasa objetivo no puede ser negativa");
+    if (c.pesoPorId < 0 || c.pesoCiudad < 0 || c.pesoGrupo < 0 || c.pesoPorId + c.pesoCiudad + c.pesoGrupo <= 0) {
+        throw std::invalid_argument("La mezcla de consultas debe tener algún peso positivo");
+    }
+
+    // Claves: el orden de popularidad de ciudades y grupos sale de la semilla
+    std::mt19937_64 barajador(c.semilla);
+    std::vector<std::string> ciudades = catalogoCiudades();
+    std::vector<std::string> grupos = esquemaGruposActivo()->grupos();
+    std::shuffle(ciudades.begin(), ciudades.end(), barajador);
+    std::shuffle(grupos.begin(), grupos.end(), barajador);
+    const DistribucionZipf zipfIds(personas.size(), c.exponenteZipf);
+    const DistribucionZipf zipfCiudades(ciudades.size(), c.exponenteZipf);
+    const DistribucionZipf zipfGrupos(grupos.size(), c.exponenteZipf);
+    const uint64_t multiplicador = multiplicadorPermutacion(personas.size());
+
+    const double pesoTotal = c.pesoPorId + c.pesoCiudad + c.pesoGrupo;
+    const double limiteId = c.pesoPorId / pesoTotal;
+    const double limiteCiudad = (c.pesoPorId + c.pesoCiudad) / pesoTotal;
+
+    // Cada cliente envía a tasa / clientes, desfasado para no llegar todos a la vez
+    const bool lazoAbierto = c.tasaObjetivo > 0;
+    const double intervalo = lazoAbierto ? c.clientes / c.tasaObjetivo : 0.0;
+    const auto aDuracion = [](double segundos) {
+        return std::chrono::duration_cast<Reloj::duration>(std::chrono::duration<double>(segundos));
+    };
+    const auto inicio = Reloj::now() + std::chrono::milliseconds(10); // Todos los clientes arrancan juntos
+    const auto fin = inicio + aDuracion(c.duracionSegundos);
+
+    auto cliente = [&](unsigned numero, ControlOperacion propio) {
+        MuestrasCliente m;
+        std::mt19937_64 generador(c.semilla + 1 + numero);
+        std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+        volatile size_t sumidero = 0;
+        const double desfase = intervalo * numero / c.clientes;
+        auto ultimoProgreso = Reloj::time_point();
+
+        std::this_thread::sleep_until(inicio);
+        for (uint64_t k = 0;; ++k) {
+            const auto ahora = Reloj::now();
+            const auto programada = lazoAbierto ? inicio + aDuracion(desfase + k * intervalo) : ahora;
+            if (programada >= fin) break;
+            if (ahora >= fin) {
+                // Atrasado al cortar: lo programado que no salió también espera, al menos hasta
+                // ahora. Omitirlo haría ver mejor la cola justo cuando el sistema no da abasto
+                for (auto pendiente = programada; pendiente < fin; pendiente = inicio + aDuracion(desfase + ++k * intervalo)) {
+                    const double sorteo = uniforme(generador);
+                    const int tipo = sorteo < limiteId ? 0 : sorteo < limiteCiudad ? 1 : 2;
+                    m.programada[tipo].push_back(std::chrono::duration<double, std::milli>(ahora - pendiente).count());
+                    m.sinEnviar[tipo]++;
+                }
+                break;
+            }
+            if (propio.token && propio.token->cancelado()) throw OperacionCancelada();
+            if (propio.progreso && ahora - ultimoProgreso > std::chrono::milliseconds(200)) {
+                propio.avanzar(static_cast<size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(ahora - inicio).count()),
+                               static_cast<size_t>(c.duracionSegundos * 1000));
+                ultimoProgreso = ahora;
+            }
+            std::this_thread::sleep_until(programada);
+
+            // Tipo y clave se eligen antes de medir
+            const double sorteo = uniforme(generador);
+            const int tipo = sorteo < limiteId ? 0 : sorteo < limiteCiudad ? 1 : 2;
+            std::string clave;
+            bool longevo = false;
+            if (tipo == 0) {
+                uint64_t rango = zipfIds(generador);
+                m.consultasId++;
+                if (rango == 1) m.idMasFrecuente++;
+                clave = personas[(rango - 1) * multiplicador % personas.size()].getId();
+            } else if (tipo == 1) {
+                clave = ciudades[zipfCiudades(generador) - 1];
+                longevo = uniforme(generador) < 0.5;
+            } else {
+                clave = grupos[zipfGrupos(generador) - 1];
+            }
+
+            const auto envio = Reloj::now();
+            try {
+                if (tipo == 0) {
+                    sumidero = buscarPorID(personas, clave) != nullptr;
+                } else if (tipo == 1) {
+                    sumidero = longevo ? buscarMasLongevoPorReferenciaEnCiudad(personas, clave)->getEdad()
+                                       : buscarMasPatrimonioPorReferenciaEnCiudad(personas, clave)->getEdad();
+                } else {
+                    sumidero = buscarMasPatrimonioPorReferenciaEnGrupo(personas, clave)->getEdad();
+                }
+            } catch (const std::exception&) {
+                m.errores[tipo]++; // Ciudad sin personas en conjuntos pequeños
+            }
+            const auto respuesta = Reloj::now();
+            m.programada[tipo].push_back(std::chrono::duration<double, std::milli>(respuesta - programada).count());
+            m.servicio[tipo].push_back(std::chrono::duration<double, std::milli>(respuesta - envio).count());
+        }
+        (void)sumidero;
+        return m;
+    };
+
+    std::vector<std::future<MuestrasCliente>> clientes;
+    for (unsigned i = 0; i < c.clientes; ++i) {
+        ControlOperacion propio;
+        propio.token = control.token;
+        if (i == 0) propio.progreso = control.progreso; // Un solo cliente dibuja el progreso
+        clientes.push_back(std::async(std::launch::async, cliente, i, propio));
+    }
+    std::vector<MuestrasCliente> muestras;
+    std::exception_ptr error;
+    for (auto& f : clientes) {
+        try {
+            muestras.push_back(f.get());
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    if (control.progreso) control.progreso(static_cast<size_t>(c.duracionSegundos * 1000), static_cast<size_t>(c.duracionSegundos * 1000));
+
+    ReporteCarga reporte;
+    reporte.configuracion = c;
+    reporte.segundos = std::chrono::duration<double>(Reloj::now() - inicio).count();
+
+    std::vector<double> totalProgramada, totalServicio;
+    size_t totalErrores = 0, consultasId = 0, idMasFrecuente = 0, enviadas = 0;
+    for (int tipo = 0; tipo < 3; ++tipo) {
+        std::vector<double> programada, servicio;
+        size_t errores = 0, sinEnviar = 0;
+        for (const auto& m : muestras) {
+            programada.insert(programada.end(), m.programada[tipo].begin(), m.programada[tipo].end());
+            servicio.insert(servicio.end(), m.servicio[tipo].begin(), m.servicio[tipo].end());
+            errores += m.errores[tipo];
+            sinEnviar += m.sinEnviar[tipo];
+        }
+        totalProgramada.insert(totalProgramada.end(), programada.begin(), programada.end());
+        totalServicio.insert(totalServicio.end(), servicio.begin(), servicio.end());
+        totalErrores += errores;
+        reporte.sinEnviar += sinEnviar;
+        enviadas += programada.size() - sinEnviar;
+        if (!programada.empty()) {
+            reporte.porConsulta.push_back(resumir(NOMBRES_CONSULTA[tipo], std::move(programada), std::move(servicio), errores, sinEnviar));
+        }
+    }
+    for (const auto& m : muestras) {
+        consultasId += m.consultasId;
+        idMasFrecuente += m.idMasFrecuente;
+    }
+    reporte.porConsulta.push_back(resumir("Total", std::move(totalProgramada), std::move(totalServicio), totalErrores,
+                                          reporte.sinEnviar));
+    reporte.rendimiento = enviadas / reporte.segundos;
+    reporte.fraccionIdMasFrecuente = consultasId ? static_cast<double>(idMasFrecuente) / consultasId : 0.0;
+    return reporte;
+}
+
+void mostrarReporteCarga(const ReporteCarga& reporte, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+    const ConfiguracionCarga& c = reporte.configuracion;
+
+    salida << "\n=== PRUEBA DE CARGA (claves Zipf, s = " << c.exponenteZipf << ") ===\n";
+    salida << c.clientes << " clientes, tasa objetivo: ";
+    if (c.tasaObjetivo > 0) salida << c.tasaObjetivo << " consultas/s";
+    else salida << "sin límite (lazo cerrado, sin corrección de omisión coordinada)";
+    salida << std::fixed << std::setprecision(1) << "\nRendimiento: " << reporte.rendimiento << " consultas/s en "
+           << reporte.segundos << " s";
+    if (reporte.sinEnviar) salida << " (" << reporte.sinEnviar << " programadas sin enviar: el sistema no sostiene la tasa)";
+    if (c.pesoPorId > 0) salida << "\nConsultas por ID a la cédula más frecuente: " << reporte.fraccionIdMasFrecuente * 100.0 << "%";
+    salida << "\n\n";
+
+    salida << std::setprecision(3) << rellenar("Consulta", 20) << std::setw(10) << "Hechas"
+           << std::setw(8) << "Error" << std::setw(11) << "p50" << std::setw(11) << "p99" << std::setw(11) << "p99.9"
+           << std::setw(11) << "Peor" << std::setw(13) << "p50 serv." << std::setw(13) << "p99 serv." << "\n";
+    for (const auto& l : reporte.porConsulta) {
+        salida << rellenar(l.consulta, 20) << std::setw(10) << l.completadas << std::setw(8) << l.errores << std::setw(11) << l.p50
+               << std::setw(11) << l.p99 << std::setw(11) << l.p999 << std::setw(11) << l.maximo
+               << std::setw(13) << l.p50Servicio << std::setw(13) << l.p99Servicio << "\n";
+    }
+    salida << "Latencias en ms desde la hora programada (las no enviadas, hasta el corte); \"serv.\" = desde el envío real (sin corrección).\n";
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
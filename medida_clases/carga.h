@@ -0,0 +1,102 @@
+#ifndef CARGA_H
+#define CARGA_H
+
+#include "persona.h"
+#include "cancelacion.h"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// GENERADOR DE CARGA CON CLAVES ZIPF Y LATENCIA DE COLA
+// ============================================================================
+// Una consulta interactiva a la vez no dice cómo se comportan las búsquedas
+// bajo carga sostenida. Aquí N clientes concurrentes lanzan una mezcla de
+// búsquedas por ID, máximos por ciudad y máximos por grupo a una tasa
+// objetivo. Las claves siguen una ley de Zipf: unas pocas cédulas y
+// ciudades concentran la mayoría de las consultas, como en uso real.
+//
+// OMISIÓN COORDINADA: Si una consulta se atrasa, un cliente de lazo cerrado
+// también atrasa las siguientes y esas esperas no se miden. Cada consulta
+// tiene una hora programada (inicio + k / tasa por cliente) y su latencia se
+// mide desde esa hora, no desde que el cliente pudo enviarla. También se
+// reporta el tiempo de servicio (desde el envío real) para comparar.
+// ============================================================================
+
+/**
+ * Muestreo Zipf sobre los rangos 1..n con probabilidad proporcional a 1/k^s.
+ *
+ * IMPLEMENTACIÓN: Rechazo-inversión de Hörmann y Derflinger (1996): O(1) en
+ *                 memoria y tiempo esperado, así que sirve para n de
+ *                 millones de cédulas sin tabla de probabilidades
+ */
+class DistribucionZipf {
+public:
+    /**
+     * @throws std::invalid_argument si n = 0 o s <= 0
+     */
+    DistribucionZipf(uint64_t n, double s);
+
+    /** Rango entre 1 (el más frecuente) y n. */
+    uint64_t operator()(std::mt19937_64& generador) const;
+
+    uint64_t elementos() const { return n; }
+
+private:
+    double h(double x) const;
+    double hIntegral(double x) const;
+    double hIntegralInversa(double x) const;
+
+    uint64_t n;
+    double s;
+    double hIntegralX1, hIntegralN, umbral;
+};
+
+enum class TipoConsultaCarga { POR_ID, MAXIMO_CIUDAD, MAXIMO_GRUPO };
+
+struct ConfiguracionCarga {
+    unsigned clientes = 4;
+    double tasaObjetivo = 1000.0;   // Consultas por segundo en total (0 = lazo cerrado, sin límite)
+    double duracionSegundos = 5.0;
+    double exponenteZipf = 1.0;     // s; mayor = claves más concentradas
+    // Mezcla de consultas (se normaliza; no hace falta que sume 100)
+    double pesoPorId = 70.0;
+    double pesoCiudad = 20.0;       // Más longevo o más patrimonio, al 50%
+    double pesoGrupo = 10.0;        // Más patrimonio del grupo
+    uint64_t semilla = 42;          // Mismas claves en cada ejecución con la misma semilla
+};
+
+/**
+ * Percentiles de un tipo de consulta (o del total), en milisegundos.
+ */
+struct LatenciasCarga {
+    std::string consulta;
+    size_t completadas = 0;
+    size_t errores = 0;
+    double p50 = 0.0, p99 = 0.0, p999 = 0.0, maximo = 0.0; // Desde la hora programada, con las no enviadas
+    double p50Servicio = 0.0, p99Servicio = 0.0;           // Desde el envío real
+};
+
+struct ReporteCarga {
+    ConfiguracionCarga configuracion;
+    double segundos = 0.0;          // Duración real de la prueba
+    double rendimiento = 0.0;       // Consultas completadas por segundo
+    size_t sinEnviar = 0;           // Programadas dentro de la duración que no alcanzaron a salir (cuentan en los percentiles)
+    double fraccionIdMasFrecuente = 0.0; // De las consultas por ID, las que fueron a la cédula más frecuente
+    std::vector<LatenciasCarga> porConsulta; // Por ID, ciudad, grupo y total
+};
+
+/**
+ * Ejecuta la prueba de carga sobre personas (solo lectura, variantes por referencia).
+ *
+ * @throws std::invalid_argument si la configuración no es válida
+ * @throws OperacionCancelada si el control lo indica
+ */
+ReporteCarga ejecutarCarga(const std::vector<Persona>& personas, const ConfiguracionCarga& configuracion,
+                           const ControlOperacion& control = ControlOperacion());
+
+void mostrarReporteCarga(const ReporteCarga& reporte, std::ostream& salida = std::cout);
+
+#endif // CARGA_H
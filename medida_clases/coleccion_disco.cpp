@@ -0,0 +1,434 @@
+#include "coleccion_disco.h"
+#include "generador.h"  // generarColeccion, verificarGrupoPorReferencia
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <fcntl.h>      // open, posix_fadvise
+#include <sys/mman.h>   // mmap, madvise
+#include <sys/stat.h>   // stat, fstat
+#include <unistd.h>     // read, close, fsync, sysconf
+
+static const char MAGICO[8] = {'P', 'E', 'R', 'S', 'D', 'S', 'K', '2'};
+static const uint64_t TAM_CABECERA = sizeof(MAGICO) + 4 * sizeof(uint64_t);
+
+// Memoria de una persona decodificada: el objeto más un margen para textos
+// que no quepan en el búfer interno de std::string
+static const size_t BYTES_POR_PERSONA = sizeof(Persona) + 64;
+// Registro serializado típico (solo para dimensionar fragmentos al generar)
+static const size_t BYTES_POR_REGISTRO = 128;
+
+// Definición de la constante de clase: std::min la toma por referencia (C++14)
+const size_t ColeccionEnDisco::PRESUPUESTO_POR_DEFECTO;
+
+// ---------------------------------------------------------------------------
+// Serialización
+// ---------------------------------------------------------------------------
+
+template <typename T>
+static void escribirValor(std::string& salida, T valor) {
+    salida.append(reinterpret_cast<const char*>(&valor), sizeof(T));
+}
+
+static void escribirTexto(std::string& salida, const std::string& texto) {
+    if (texto.size() > 255) throw std::runtime_error("Texto demasiado largo para el formato en disco: " + texto);
+    salida.push_back(static_cast<char>(texto.size()));
+    salida.append(texto);
+}
+
+static void serializar(std::string& salida, const Persona& p) {
+    escribirTexto(salida, p.getNombre());
+    escribirTexto(salida, p.getApellido());
+    escribirTexto(salida, p.getId());
+    escribirTexto(salida, p.getCiudadNacimiento());
+    escribirTexto(salida, p.getFechaNacimiento());
+    escribirTexto(salida, p.getGrupoDeclaracion());
+    escribirValor<int32_t>(salida, p.getEdad());
+    escribirValor<double>(salida, p.getIngresosAnuales());
+    escribirValor<double>(salida, p.getPatrimonio());
+    escribirValor<double>(salida, p.getDeudas());
+    escribirValor<uint8_t>(salida, p.getDeclaranteRenta() ? 1 : 0);
+}
+
+/**
+ * Lector secuencial sobre un fragmento proyectado en memoria.
+ *
+ * NOTA: memcpy en lugar de conversiones de puntero; los registros no
+ * están alineados.
+ */
+class LectorRegistros {
+public:
+    LectorRegistros(const char* datos, uint64_t bytes) : actual(datos), fin(datos + bytes) {}
+
+    template <typename T>
+    T valor() {
+        comprobar(sizeof(T));
+        T v;
+        std::memcpy(&v, actual, sizeof(T));
+        actual += sizeof(T);
+        return v;
+    }
+
+    std::string texto() {
+        size_t largo = valor<uint8_t>();
+        comprobar(largo);
+        std::string t(actual, largo);
+        actual += largo;
+        return t;
+    }
+
+    Persona persona() {
+        std::string nombre = texto();
+        std::string apellido = texto();
+        std::string id = texto();
+        std::string ciudad = texto();
+        std::string fecha = texto();
+        std::string grupo = texto();
+        int edad = valor<int32_t>();
+        double ingresos = valor<double>();
+        double patrimonio = valor<double>();
+        double deudas = valor<double>();
+        bool declara = valor<uint8_t>() != 0;
+        return Persona(nombre, apellido, id, ciudad, fecha, grupo, edad, ingresos, patrimonio, deudas, declara);
+    }
+
+private:
+    void comprobar(size_t bytes) const {
+        if (static_cast<size_t>(fin - actual) < bytes) throw std::runtime_error("Archivo en disco dañado: registro truncado");
+    }
+
+    const char* actual;
+    const char* fin;
+};
+
+// ---------------------------------------------------------------------------
+// Generación
+// ---------------------------------------------------------------------------
+
+uint64_t huellaBytes(uint64_t huella, const char* datos, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        huella ^= static_cast<unsigned char>(datos[i]);
+        huella *= 1099511628211ULL; // Primo FNV de 64 bits
+    }
+    return huella;
+}
+
+/**
+ * Escribe el archivo fragmento a fragmento; la cabecera se completa al cerrar.
+ */
+class EscritorFragmentos {
+public:
+    explicit EscritorFragmentos(const std::string& ruta) : ruta(ruta), archivo(ruta, std::ios::binary | std::ios::trunc) {
+        if (!archivo) throw std::runtime_error("No se pudo crear el archivo: " + ruta);
+        std::string cabecera(TAM_CABECERA, '\0');
+        archivo.write(cabecera.data(), cabecera.size());
+    }
+
+    template <typename Iterador>
+    void agregar(Iterador desde, Iterador hasta) {
+        bufer.clear();
+        uint32_t filas = 0;
+        for (; desde != hasta; ++desde, ++filas) serializar(bufer, *desde);
+        archivo.write(bufer.data(), bufer.size());
+        huella = huellaBytes(huella, bufer.data(), bufer.size());
+        tabla.push_back({desplazamiento, bufer.size(), filas, 0});
+        desplazamiento += bufer.size();
+        total += filas;
+    }
+
+    void cerrar() {
+        archivo.write(reinterpret_cast<const char*>(tabla.data()), tabla.size() * sizeof(tabla[0]));
+
+        std::string cabecera;
+        cabecera.append(MAGICO, sizeof(MAGICO));
+        escribirValor<uint64_t>(cabecera, total);
+        escribirValor<uint64_t>(cabecera, tabla.size());
+        escribirValor<uint64_t>(cabecera, desplazamiento);
+        escribirValor<uint64_t>(cabecera, huella);
+        archivo.seekp(0);
+        archivo.write(cabecera.data(), cabecera.size());
+        archivo.close();
+        if (!archivo) throw std::runtime_error("Error escribiendo el archivo: " + ruta);
+    }
+
+private:
+    struct Entrada {
+        uint64_t desplazamiento;
+        uint64_t bytes;
+        uint32_t filas;
+        uint32_t reservado;
+    };
+
+    std::string ruta;
+    std::ofstream archivo;
+    std::vector<Entrada> tabla;
+    std::string bufer;
+    uint64_t desplazamiento = TAM_CABECERA;
+    uint64_t total = 0;
+    uint64_t huella = HUELLA_INICIAL;
+};
+
+// El fragmento decodificado y su serialización deben caber juntos en el presupuesto
+static uint64_t filasPorFragmento(size_t presupuestoBytes) {
+    uint64_t filas = std::max<uint64_t>(1, presupuestoBytes / (BYTES_POR_PERSONA + BYTES_POR_REGISTRO));
+    return std::min<uint64_t>(filas, UINT32_MAX);
+}
+
+void ColeccionEnDisco::generar(const std::string& ruta, uint64_t n, size_t presupuestoBytes,
+                               const ControlOperacion& control) {
+    const uint64_t porFragmento = filasPorFragmento(presupuestoBytes);
+    EscritorFragmentos escritor(ruta);
+    for (uint64_t hechas = 0; hechas < n; hechas += porFragmento) {
+        control.avanzar(hechas, n);
+        std::vector<Persona> fragmento = generarColeccion(std::min(porFragmento, n - hechas));
+        escritor.agregar(fragmento.begin(), fragmento.end());
+    } // Cada fragmento generado se libera antes de producir el siguiente
+    control.avanzar(n, n);
+    escritor.cerrar();
+}
+
+void ColeccionEnDisco::guardar(const std::string& ruta, const std::vector<Persona>& personas,
+                               size_t presupuestoBytes, const ControlOperacion& control) {
+    const uint64_t porFragmento = filasPorFragmento(presupuestoBytes);
+    EscritorFragmentos escritor(ruta);
+    for (size_t hechas = 0; hechas < personas.size(); hechas += porFragmento) {
+        control.avanzar(hechas, personas.size());
+        size_t hasta = static_cast<size_t>(std::min<uint64_t>(personas.size(), hechas + porFragmento));
+        escritor.agregar(personas.begin() + hechas, personas.begin() + hasta);
+    }
+    control.avanzar(personas.size(), personas.size());
+    escritor.cerrar();
+}
+
+// ---------------------------------------------------------------------------
+// Lectura
+// ---------------------------------------------------------------------------
+
+ColeccionEnDisco::ColeccionEnDisco(const std::string& ruta, size_t presupuestoBytes)
+    : rutaArchivo(ruta), presupuesto(presupuestoBytes) {
+    std::ifstream archivo(ruta, std::ios::binary);
+    if (!archivo) throw std::runtime_error("No se pudo abrir el archivo: " + ruta);
+
+    char magico[sizeof(MAGICO)];
+    uint64_t numFragmentos = 0, desplazamientoTabla = 0;
+    archivo.read(magico, sizeof(magico));
+    archivo.read(reinterpret_cast<char*>(&totalFilas), sizeof(totalFilas));
+    archivo.read(reinterpret_cast<char*>(&numFragmentos), sizeof(numFragmentos));
+    archivo.read(reinterpret_cast<char*>(&desplazamientoTabla), sizeof(desplazamientoTabla));
+    archivo.read(reinterpret_cast<char*>(&huellaDatos), sizeof(huellaDatos));
+    if (!archivo || std::memcmp(magico, MAGICO, sizeof(MAGICO)) != 0) {
+        throw std::runtime_error("El archivo no es una colección en disco válida: " + ruta);
+    }
+
+    // Todo desplazamiento de la cabecera se contrasta con el tamaño real antes
+    // de usarlo: un archivo truncado o dañado no debe pedir gigabytes de memoria
+    // ni proyectar páginas más allá del final (SIGBUS al leerlas)
+    struct stat info;
+    if (::stat(ruta.c_str(), &info) != 0) throw std::runtime_error("No se pudo consultar el tamaño de: " + ruta);
+    bytesArchivo = static_cast<uint64_t>(info.st_size);
+    if (desplazamientoTabla < TAM_CABECERA || desplazamientoTabla > bytesArchivo ||
+        numFragmentos > (bytesArchivo - desplazamientoTabla) / sizeof(Fragmento)) {
+        throw std::runtime_error("Tabla de fragmentos fuera del archivo: " + ruta);
+    }
+
+    fragmentos.resize(numFragmentos);
+    archivo.seekg(desplazamientoTabla);
+    archivo.read(reinterpret_cast<char*>(fragmentos.data()), numFragmentos * sizeof(Fragmento));
+    if (!archivo) throw std::runtime_error("Tabla de fragmentos dañada: " + ruta);
+
+    uint64_t filas = 0;
+    for (const auto& f : fragmentos) {
+        if (f.desplazamiento < TAM_CABECERA || f.bytes > desplazamientoTabla ||
+            f.desplazamiento > desplazamientoTabla - f.bytes) {
+            throw std::runtime_error("Un fragmento apunta fuera de los datos de " + ruta);
+        }
+        filas += f.filas;
+        if (f.bytes + f.filas * BYTES_POR_PERSONA > presupuesto) {
+            throw std::runtime_error("Un fragmento de " + std::to_string(f.filas) +
+                                     " filas no cabe en el presupuesto de memoria; regenere el archivo con un presupuesto menor");
+        }
+    }
+    if (filas != totalFilas) throw std::runtime_error("Los fragmentos no suman las filas de la cabecera: " + ruta);
+}
+
+void ColeccionEnDisco::recorrer(const std::function<void(const std::vector<Persona>&)>& visitar,
+                                const ControlOperacion& control) {
+    recorrerFragmentos(visitar, control, nullptr);
+}
+
+std::vector<Persona> ColeccionEnDisco::cargar(const ControlOperacion& control) {
+    std::vector<Persona> personas;
+    personas.reserve(static_cast<size_t>(totalFilas));
+    uint64_t huella = HUELLA_INICIAL;
+    recorrerFragmentos([&](const std::vector<Persona>& fragmento) {
+        personas.insert(personas.end(), fragmento.begin(), fragmento.end());
+    }, control, &huella);
+    if (huella != huellaDatos) throw std::runtime_error("Los datos de " + rutaArchivo + " no coinciden con su huella");
+    return personas;
+}
+
+void ColeccionEnDisco::recorrerFragmentos(const std::function<void(const std::vector<Persona>&)>& visitar,
+                                          const ControlOperacion& control, uint64_t* huella) {
+    int fd = ::open(rutaArchivo.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < bytesArchivo) {
+        ::close(fd);
+        throw std::runtime_error(rutaArchivo + " se truncó después de abrirlo");
+    }
+
+    const uint64_t pagina = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    auto inicio = std::chrono::high_resolution_clock::now();
+    lectura = EstadisticaLectura();
+
+    try {
+        uint64_t filasHechas = 0;
+        for (size_t i = 0; i < fragmentos.size(); ++i) {
+            control.avanzar(filasHechas, totalFilas);
+            const Fragmento& f = fragmentos[i];
+
+            // Lectura anticipada: el kernel trae el siguiente fragmento mientras se procesa este
+            if (i + 1 < fragmentos.size()) {
+                posix_fadvise(fd, fragmentos[i + 1].desplazamiento, fragmentos[i + 1].bytes, POSIX_FADV_WILLNEED);
+            }
+
+            // mmap exige un desplazamiento alineado a página
+            uint64_t alineado = f.desplazamiento - f.desplazamiento % pagina;
+            uint64_t margen = f.desplazamiento - alineado;
+            size_t largo = static_cast<size_t>(f.bytes + margen);
+            void* mapa = ::mmap(nullptr, largo, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(alineado));
+            if (mapa == MAP_FAILED) throw std::runtime_error("No se pudo proyectar un fragmento de " + rutaArchivo);
+            ::madvise(mapa, largo, MADV_SEQUENTIAL);
+
+            if (huella) *huella = huellaBytes(*huella, static_cast<const char*>(mapa) + margen, f.bytes);
+
+            std::vector<Persona> personas;
+            try {
+                personas.reserve(f.filas);
+                LectorRegistros lector(static_cast<const char*>(mapa) + margen, f.bytes);
+                for (uint32_t fila = 0; fila < f.filas; ++fila) personas.push_back(lector.persona());
+            } catch (...) {
+                ::munmap(mapa, largo);
+                throw;
+            }
+            ::munmap(mapa, largo); // Los bytes ya están decodificados
+
+            visitar(personas);
+            filasHechas += f.filas;
+            lectura.bytesLeidos += f.bytes;
+            lectura.fragmentos++;
+        }
+        control.avanzar(totalFilas, totalFilas);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+
+    lectura.milisegundos = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - inicio).count();
+}
+
+void ColeccionEnDisco::descartarCachePaginas() {
+    int fd = ::open(rutaArchivo.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    ::fsync(fd); // Solo las páginas limpias pueden descartarse
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+EstadisticaLectura ColeccionEnDisco::medirLecturaCruda() {
+    descartarCachePaginas();
+    int fd = ::open(rutaArchivo.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    EstadisticaLectura cruda;
+    std::vector<char> bufer(1024 * 1024);
+    auto inicio = std::chrono::high_resolution_clock::now();
+    ssize_t leidos;
+    while ((leidos = ::read(fd, bufer.data(), bufer.size())) > 0) cruda.bytesLeidos += leidos;
+    cruda.milisegundos = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - inicio).count();
+    cruda.fragmentos = fragmentos.size();
+    ::close(fd);
+    return cruda;
+}
+
+// ---------------------------------------------------------------------------
+// Consultas
+// ---------------------------------------------------------------------------
+
+/**
+ * Recorre el disco quedándose con una copia de la persona de mayor valor.
+ *
+ * EMPATES: Gana la primera, como std::max_element
+ */
+template <typename Filtro, typename Valor>
+static Persona buscarMaximo(ColeccionEnDisco& coleccion, Filtro cumple, Valor valor,
+                            const ControlOperacion& control, const std::string& error) {
+    std::unique_ptr<Persona> mejor;
+    coleccion.recorrer([&](const std::vector<Persona>& personas) {
+        for (const auto& p : personas) {
+            if (!cumple(p)) continue;
+            if (!mejor || valor(*mejor) < valor(p)) mejor.reset(new Persona(p));
+        }
+    }, control);
+    if (!mejor) throw std::runtime_error(error);
+    return *mejor;
+}
+
+Persona ColeccionEnDisco::masLongevo(const std::string& ciudad, const ControlOperacion& control) {
+    return buscarMaximo(*this,
+        [&](const Persona& p) { return ciudad.empty() || p.getCiudadNacimiento() == ciudad; },
+        [](const Persona& p) { return p.getEdad(); },
+        control, "No hay personas registradas en la ciudad: " + ciudad);
+}
+
+Persona ColeccionEnDisco::masPatrimonio(const std::string& ciudad, const std::string& grupo,
+                                        const ControlOperacion& control) {
+    return buscarMaximo(*this,
+        [&](const Persona& p) {
+            return (ciudad.empty() || p.getCiudadNacimiento() == ciudad) &&
+                   (grupo.empty() || p.getGrupoDeclaracion() == grupo);
+        },
+        [](const Persona& p) { return p.getPatrimonio(); },
+        control, grupo.empty() ? "No hay personas registradas en la ciudad: " + ciudad
+                               : "No hay personas registradas en el grupo: " + grupo);
+}
+
+ConteoVerificacion ColeccionEnDisco::verificarGrupos(const ControlOperacion& control) {
+    ConteoVerificacion conteo;
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo();
+    recorrer([&](const std::vector<Persona>& personas) {
+        for (const auto& p : personas) {
+            if (verificarGrupoPorReferencia(p, *esquema)) conteo.correctos++;
+            else conteo.incorrectos++;
+        }
+    }, control);
+    return conteo;
+}
+
+std::vector<PromedioGrupo> ColeccionEnDisco::promediosPorGrupo(const ControlOperacion& control) {
+    std::map<std::string, PromedioGrupo> sumas; // Acumula sumas; se dividen al final
+    recorrer([&](const std::vector<Persona>& personas) {
+        for (const auto& p : personas) {
+            PromedioGrupo& g = sumas[p.getGrupoDeclaracion()];
+            g.conteo++;
+            g.promedioPatrimonio += p.getPatrimonio();
+            g.promedioEdad += p.getEdad();
+        }
+    }, control);
+
+    std::vector<PromedioGrupo> promedios;
+    for (auto& s : sumas) {
+        s.second.grupo = s.first;
+        s.second.promedioPatrimonio /= s.second.conteo;
+        s.second.promedioEdad /= s.second.conteo;
+        promedios.push_back(s.second);
+    }
+    return promedios;
+}
@@ -0,0 +1,170 @@
+#ifndef COLECCION_DISCO_H
+#define COLECCION_DISCO_H
+
+#include "persona.h"
+#include "cancelacion.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// COLECCIÓN FUERA DE MEMORIA (POR FRAGMENTOS EN DISCO)
+// ============================================================================
+// Permite analizar conjuntos más grandes que la RAM. Las personas se guardan
+// en un archivo binario dividido en fragmentos; cada fragmento se proyecta
+// con mmap (MADV_SEQUENTIAL), se decodifica, se procesa y se libera, mientras
+// posix_fadvise(WILLNEED) ya va trayendo el siguiente. En memoria nunca hay
+// más de un fragmento decodificado, cuyo tamaño lo fija el presupuesto.
+//
+// FORMATO (orden de bytes nativo):
+//   Cabecera: "PERSDSK2", totalFilas, numFragmentos, desplazamientoTabla,
+//             huella (uint64; FNV-1a de los bytes de todos los fragmentos)
+//   Fragmentos: registros consecutivos
+//   Tabla: por fragmento {desplazamiento, bytes (uint64), filas, 0 (uint32)}
+//   Registro: 6 textos (uint8 longitud + bytes), edad (int32),
+//             ingresos, patrimonio, deudas (double), declarante (uint8)
+// ============================================================================
+
+// Valor inicial de la huella FNV-1a de 64 bits
+const uint64_t HUELLA_INICIAL = 14695981039346656037ULL;
+
+/**
+ * Acumula bytes en una huella FNV-1a de 64 bits.
+ */
+uint64_t huellaBytes(uint64_t huella, const char* datos, size_t bytes);
+
+/**
+ * Resultado de una verificación de grupos sobre disco.
+ */
+struct ConteoVerificacion {
+    size_t correctos = 0;
+    size_t incorrectos = 0;
+};
+
+/**
+ * Promedios de un grupo de declaración.
+ */
+struct PromedioGrupo {
+    std::string grupo;
+    size_t conteo = 0;
+    double promedioPatrimonio = 0.0;
+    double promedioEdad = 0.0;
+};
+
+/**
+ * Bytes leídos y tiempo de la última pasada.
+ */
+struct EstadisticaLectura {
+    uint64_t bytesLeidos = 0;
+    size_t fragmentos = 0;
+    double milisegundos = 0.0;
+
+    double megabytesPorSegundo() const {
+        return milisegundos > 0 ? (bytesLeidos / (1024.0 * 1024.0)) / (milisegundos / 1000.0) : 0.0;
+    }
+};
+
+/**
+ * Colección de personas guardada por fragmentos en un archivo.
+ *
+ * MEMORIA: Un fragmento decodificado a la vez, acotado por el presupuesto
+ * ERRORES: std::runtime_error si el archivo no existe, está dañado o sus
+ *          fragmentos no caben en el presupuesto
+ */
+class ColeccionEnDisco {
+public:
+    static const size_t PRESUPUESTO_POR_DEFECTO = 64 * 1024 * 1024; // 64 MB
+
+    /**
+     * Genera n personas directamente en disco, fragmento a fragmento.
+     *
+     * @param ruta Archivo de salida (se sobrescribe)
+     * @param n Número de personas
+     * @param presupuestoBytes Memoria máxima; fija las filas por fragmento
+     * @param control Cancelación y progreso (por fragmento)
+     * @throws OperacionCancelada si se cancela (el archivo queda incompleto)
+     */
+    static void generar(const std::string& ruta, uint64_t n, size_t presupuestoBytes,
+                        const ControlOperacion& control = ControlOperacion());
+
+    /**
+     * Guarda una colección en memoria con el mismo formato (instantánea).
+     */
+    static void guardar(const std::string& ruta, const std::vector<Persona>& personas,
+                        size_t presupuestoBytes = PRESUPUESTO_POR_DEFECTO,
+                        const ControlOperacion& control = ControlOperacion());
+
+    /**
+     * Abre un archivo existente y lee su tabla de fragmentos.
+     *
+     * @throws std::runtime_error si la cabecera, la tabla o algún fragmento
+     *         apunta fuera del archivo (se valida contra su tamaño antes de
+     *         reservar memoria o proyectar nada)
+     */
+    ColeccionEnDisco(const std::string& ruta, size_t presupuestoBytes = PRESUPUESTO_POR_DEFECTO);
+
+    /**
+     * Recorre todos los fragmentos en orden.
+     *
+     * @param visitar Recibe cada fragmento decodificado (válido solo durante la llamada)
+     * @param control Cancelación y progreso, revisados entre fragmentos
+     */
+    void recorrer(const std::function<void(const std::vector<Persona>&)>& visitar,
+                  const ControlOperacion& control = ControlOperacion());
+
+    /**
+     * Carga toda la colección en memoria comprobando la huella.
+     *
+     * @throws std::runtime_error si los bytes no coinciden con la huella
+     */
+    std::vector<Persona> cargar(const ControlOperacion& control = ControlOperacion());
+
+    // Consultas del menú resueltas fragmento a fragmento.
+    // Ciudad o grupo vacíos = todo el país. Lanzan std::runtime_error si no hay coincidencias.
+    Persona masLongevo(const std::string& ciudad, const ControlOperacion& control = ControlOperacion());
+    Persona masPatrimonio(const std::string& ciudad, const std::string& grupo,
+                          const ControlOperacion& control = ControlOperacion());
+    ConteoVerificacion verificarGrupos(const ControlOperacion& control = ControlOperacion());
+    std::vector<PromedioGrupo> promediosPorGrupo(const ControlOperacion& control = ControlOperacion());
+
+    /**
+     * Lee el archivo completo sin decodificar, con la caché de páginas vacía.
+     *
+     * @return Velocidad cruda de lectura del disco, referencia para las consultas
+     */
+    EstadisticaLectura medirLecturaCruda();
+
+    /**
+     * Pide al kernel descartar las páginas del archivo en caché, para que
+     * la siguiente pasada lea realmente del disco.
+     */
+    void descartarCachePaginas();
+
+    const EstadisticaLectura& ultimaLectura() const { return lectura; }
+    uint64_t total() const { return totalFilas; }
+    uint64_t huella() const { return huellaDatos; }
+    size_t numeroFragmentos() const { return fragmentos.size(); }
+    const std::string& ruta() const { return rutaArchivo; }
+
+private:
+    struct Fragmento {
+        uint64_t desplazamiento;
+        uint64_t bytes;
+        uint32_t filas;
+        uint32_t reservado;
+    };
+
+    void recorrerFragmentos(const std::function<void(const std::vector<Persona>&)>& visitar,
+                            const ControlOperacion& control, uint64_t* huella);
+
+    std::string rutaArchivo;
+    size_t presupuesto;
+    uint64_t totalFilas = 0;
+    uint64_t huellaDatos = 0;
+    uint64_t bytesArchivo = 0; // Tamaño con que se validó la tabla
+    std::vector<Fragmento> fragmentos;
+    EstadisticaLectura lectura;
+};
+
+#endif // COLECCION_DISCO_H
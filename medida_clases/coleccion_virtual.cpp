@@ -0,0 +1,244 @@
+#include "coleccion_virtual.h"
+#include "diccionarios.h"
+#include "esquema_grupos.h"
+#include "generador.h"
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+// Por debajo de este número de filas por hilo no compensa repartir el recorrido
+static const uint64_t MIN_FILAS_POR_HILO = 1 << 16;
+
+std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> c, std::array<uint32_t, 2> k) {
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57; // Multiplicadores de Salmon et al. (2011)
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85; // Incrementos de la clave por ronda
+    for (int ronda = 0; ronda < 10; ++ronda) {
+        uint64_t p0 = static_cast<uint64_t>(M0) * c[0];
+        uint64_t p1 = static_cast<uint64_t>(M1) * c[2];
+        c = {static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0], static_cast<uint32_t>(p1),
+             static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1], static_cast<uint32_t>(p0)};
+        k[0] += W0;
+        k[1] += W1;
+    }
+    return c;
+}
+
+ColeccionVirtual::ColeccionVirtual(uint64_t total, uint64_t semilla) : n(total), clave(semilla) {
+    // Las cédulas deben seguir teniendo 10 dígitos, como las de generarID()
+    if (total > 9000000000ULL) throw std::invalid_argument("El conjunto virtual admite hasta 9.000 millones de filas");
+}
+
+/**
+ * Dos bloques Philox por fila: el primero da los campos de texto y la
+ * fecha, el segundo los montos. Los recorridos que no usan montos se
+ * ahorran el segundo bloque.
+ */
+ColeccionVirtual::Campos ColeccionVirtual::campos(uint64_t indice, bool financieros) const {
+    const std::array<uint32_t, 2> k = {static_cast<uint32_t>(clave), static_cast<uint32_t>(clave >> 32)};
+    std::array<uint32_t, 4> w = philox4x32({static_cast<uint32_t>(indice), static_cast<uint32_t>(indice >> 32), 0, 0}, k);
+
+    Campos c;
+    c.hombre = w[0] & 1;
+    c.nombre = (w[0] >> 1) % (c.hombre ? catalogoNombresMasculinos() : catalogoNombresFemeninos()).size();
+    c.apellido1 = (w[1] & 0xFFFF) % catalogoApellidos().size();
+    c.apellido2 = (w[1] >> 16) % catalogoApellidos().size();
+    c.ciudad = (w[2] & 0xFFFF) % catalogoCiudades().size();
+    c.dia = 1 + static_cast<int>((w[2] >> 16) % 28);
+    c.mes = 1 + static_cast<int>((w[3] & 0xFF) % 12);
+    c.anio = 1960 + static_cast<int>(((w[3] >> 8) & 0xFFF) % 50);
+    c.sorteoDeclarante = (w[3] >> 20) % 100;
+
+    c.ingresos = c.patrimonio = c.deudas = 0.0;
+    if (financieros) {
+        const double escala = 1.0 / 4294967296.0; // [0, 1)
+        std::array<uint32_t, 4> m = philox4x32({static_cast<uint32_t>(indice), static_cast<uint32_t>(indice >> 32), 1, 0}, k);
+        c.ingresos = 10000000 + m[0] * escala * (500000000 - 10000000); // Mismos rangos que generarPersona()
+        c.patrimonio = m[1] * escala * 2000000000;
+        c.deudas = m[2] * escala * c.patrimonio * 0.7;
+    }
+    return c;
+}
+
+int ColeccionVirtual::codigoGrupo(const EsquemaGrupos& esquema, uint64_t indice) {
+    // La cédula es numérica: su sufijo sale de un módulo, sin pasar por texto
+    uint64_t modulo = 1;
+    for (int i = 0; i < esquema.digitos(); ++i) modulo *= 10;
+    return esquema.codigoDeSufijo((PRIMERA_CEDULA + indice) % modulo);
+}
+
+Persona ColeccionVirtual::persona(uint64_t indice) const {
+    return persona(indice, *esquemaGruposActivo());
+}
+
+Persona ColeccionVirtual::persona(uint64_t indice, const EsquemaGrupos& esquema) const {
+    if (indice >= n) throw std::out_of_range("Índice fuera del conjunto virtual: " + std::to_string(indice));
+    Campos c = campos(indice, true);
+    const std::vector<std::string>& nombres = c.hombre ? catalogoNombresMasculinos() : catalogoNombresFemeninos();
+    std::string apellido = catalogoApellidos()[c.apellido1] + " " + catalogoApellidos()[c.apellido2];
+    std::string fecha = std::to_string(c.dia) + "/" + std::to_string(c.mes) + "/" + std::to_string(c.anio);
+    bool declarante = c.ingresos > 50000000 && c.sorteoDeclarante > 30;
+    return Persona(nombres[c.nombre], apellido, std::to_string(PRIMERA_CEDULA + indice), catalogoCiudades()[c.ciudad],
+                   fecha, esquema.nombreGrupo(codigoGrupo(esquema, indice)), 2025 - c.anio, c.ingresos, c.patrimonio, c.deudas, declarante);
+}
+
+long long ColeccionVirtual::indiceDeId(const std::string& id) const {
+    if (id.empty() || id.size() > 19 || !std::all_of(id.begin(), id.end(), [](char ch) { return ch >= '0' && ch <= '9'; })) {
+        return -1;
+    }
+    uint64_t cedula = std::stoull(id);
+    if (cedula < PRIMERA_CEDULA || cedula - PRIMERA_CEDULA >= n || std::to_string(cedula) != id) return -1;
+    return static_cast<long long>(cedula - PRIMERA_CEDULA);
+}
+
+std::vector<Persona> ColeccionVirtual::materializar(uint64_t filas, const ControlOperacion& control) const {
+    const uint64_t total = filas == 0 ? n : std::min(filas, n);
+    std::vector<Persona> personas;
+    personas.reserve(total);
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo(); // Uno solo para todas las filas
+    for (uint64_t inicio = 0; inicio < total; inicio += control.tamFragmento) {
+        control.avanzar(inicio, total);
+        uint64_t fin = std::min<uint64_t>(total, inicio + control.tamFragmento);
+        for (uint64_t i = inicio; i < fin; ++i) personas.push_back(persona(i, *esquema));
+    }
+    control.avanzar(total, total);
+    return personas;
+}
+
+/**
+ * Reparte [0, n) en un tramo contiguo por hilo y devuelve los parciales en
+ * orden de tramo (el orden importa para desempatar por índice menor).
+ *
+ * PROGRESO: Solo el primer tramo lo reporta, escalado al total.
+ */
+template <typename Parcial, typename Procesar>
+static std::vector<Parcial> recorrerEnParalelo(uint64_t n, const ControlOperacion& control, Procesar procesar) {
+    uint64_t hilos = std::max(1u, std::thread::hardware_concurrency());
+    hilos = std::max<uint64_t>(1, std::min(hilos, n / MIN_FILAS_POR_HILO));
+    const uint64_t porHilo = (n + hilos - 1) / hilos;
+
+    std::vector<std::future<Parcial>> tramos;
+    for (uint64_t h = 0; h < hilos; ++h) {
+        uint64_t inicio = std::min(n, h * porHilo);
+        uint64_t fin = std::min(n, inicio + porHilo);
+        ControlOperacion propio;
+        propio.token = control.token;
+        propio.tamFragmento = control.tamFragmento;
+        if (h == 0 && control.progreso) {
+            propio.progreso = [control, hilos, n](size_t hechas, size_t) {
+                control.progreso(std::min<uint64_t>(n, hechas * hilos), n);
+            };
+        }
+        tramos.push_back(std::async(std::launch::async, [=]() {
+            Parcial parcial;
+            for (uint64_t desde = inicio; desde < fin; desde += propio.tamFragmento) {
+                propio.avanzar(desde - inicio, fin - inicio);
+                uint64_t hasta = std::min<uint64_t>(fin, desde + propio.tamFragmento);
+                for (uint64_t i = desde; i < hasta; ++i) procesar(i, parcial);
+            }
+            return parcial;
+        }));
+    }
+
+    std::vector<Parcial> parciales;
+    for (auto& tramo : tramos) parciales.push_back(tramo.get());
+    if (control.progreso) control.progreso(n, n);
+    return parciales;
+}
+
+/**
+ * Mejor fila de un tramo según un valor numérico.
+ */
+struct MejorFila {
+    long long fila = -1;
+    double valor = 0.0;
+
+    void considerar(uint64_t i, double v) {
+        if (fila < 0 || v > valor) { fila = static_cast<long long>(i); valor = v; }
+    }
+};
+
+static long long combinarMejores(const std::vector<MejorFila>& parciales) {
+    MejorFila total;
+    for (const auto& p : parciales) {
+        if (p.fila >= 0) total.considerar(static_cast<uint64_t>(p.fila), p.valor); // Estricto: gana el tramo anterior
+    }
+    return total.fila;
+}
+
+static int codigoCiudad(const std::string& ciudad) {
+    return DICCIONARIO_CIUDADES.codigo(ciudad);
+}
+
+uint64_t ColeccionVirtual::masLongevo(const std::string& ciudad, const ControlOperacion& control) const {
+    const int codigo = ciudad.empty() ? -2 : codigoCiudad(ciudad);
+    long long fila = -1;
+    if (codigo != -1) {
+        fila = combinarMejores(recorrerEnParalelo<MejorFila>(n, control, [this, codigo](uint64_t i, MejorFila& mejor) {
+            Campos c = campos(i, false);
+            if (codigo >= 0 && static_cast<int>(c.ciudad) != codigo) return;
+            mejor.considerar(i, 2025 - c.anio);
+        }));
+    }
+    if (fila < 0) throw std::runtime_error("No hay personas registradas en la ciudad: " + ciudad);
+    return static_cast<uint64_t>(fila);
+}
+
+uint64_t ColeccionVirtual::masPatrimonio(const std::string& ciudad, const std::string& grupo,
+                                        const ControlOperacion& control) const {
+    const int codigo = ciudad.empty() ? -2 : codigoCiudad(ciudad);
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo();
+    const int grupoBuscado = grupo.empty() ? -2 : esquema->codigoDeNombre(grupo);
+    long long fila = -1;
+    if (codigo != -1 && grupoBuscado != -1) {
+        fila = combinarMejores(recorrerEnParalelo<MejorFila>(n, control, [=](uint64_t i, MejorFila& mejor) {
+            if (grupoBuscado >= 0 && codigoGrupo(*esquema, i) != grupoBuscado) return; // Sin Philox: sale del índice
+            Campos c = campos(i, true);
+            if (codigo >= 0 && static_cast<int>(c.ciudad) != codigo) return;
+            mejor.considerar(i, c.patrimonio);
+        }));
+    }
+    if (fila < 0) throw std::runtime_error("No hay personas que cumplan el filtro");
+    return static_cast<uint64_t>(fila);
+}
+
+std::vector<PromedioGrupo> ColeccionVirtual::promediosPorGrupo(const ControlOperacion& control) const {
+    // Un casillero por grupo del esquema, todos en la misma pasada
+    const std::shared_ptr<const EsquemaGrupos> instantanea = esquemaGruposActivo();
+    const EsquemaGrupos& esquema = *instantanea;
+    const size_t grupos = esquema.numeroGrupos();
+    struct Sumas {
+        std::vector<uint64_t> conteo;
+        std::vector<double> patrimonio, edad;
+    };
+    std::vector<Sumas> parciales = recorrerEnParalelo<Sumas>(n, control, [this, grupos, &esquema](uint64_t i, Sumas& s) {
+        if (s.conteo.empty()) {
+            s.conteo.assign(grupos, 0);
+            s.patrimonio.assign(grupos, 0.0);
+            s.edad.assign(grupos, 0.0);
+        }
+        int g = codigoGrupo(esquema, i);
+        Campos c = campos(i, true);
+        s.conteo[g]++;
+        s.patrimonio[g] += c.patrimonio;
+        s.edad[g] += 2025 - c.anio;
+    });
+
+    std::vector<PromedioGrupo> promedios;
+    for (size_t g = 0; g < grupos; ++g) {
+        PromedioGrupo p;
+        p.grupo = esquema.nombreGrupo(g);
+        double patrimonio = 0.0, edad = 0.0;
+        for (const auto& s : parciales) {
+            if (s.conteo.empty()) continue; // Tramo sin filas
+            p.conteo += s.conteo[g];
+            patrimonio += s.patrimonio[g];
+            edad += s.edad[g];
+        }
+        if (p.conteo == 0) continue;
+        p.promedioPatrimonio = patrimonio / p.conteo;
+        p.promedioEdad = edad / p.conteo;
+        promedios.push_back(p);
+    }
+    return promedios;
+}
@@ -0,0 +1,87 @@
+#ifndef COLECCION_VIRTUAL_H
+#define COLECCION_VIRTUAL_H
+
+#include "persona.h"
+#include "cancelacion.h"
+#include "coleccion_disco.h" // PromedioGrupo
+#include "esquema_grupos.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CONJUNTO VIRTUAL CON ACCESO ALEATORIO O(1)
+// ============================================================================
+// generarPersona() depende de estado global (rand(), el contador de
+// generarID()), así que la persona i solo se obtiene generando las i
+// anteriores. Aquí cada persona es una función pura de (semilla, índice):
+// un generador por contador (Philox4x32-10) convierte el índice en números
+// aleatorios sin estado. Consecuencias:
+//   - Un conjunto de mil millones de filas no ocupa memoria.
+//   - Los recorridos se reparten entre hilos sin coordinación.
+//   - buscarPorID es aritmética: la cédula es 1.000.000.000 + índice.
+//   - materializar() produce exactamente las mismas personas, así que las
+//     consultas del menú sobre el vector dan los mismos resultados.
+// ============================================================================
+
+/**
+ * Philox4x32-10: cuatro palabras aleatorias a partir de un contador y una clave.
+ */
+std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> contador, std::array<uint32_t, 2> clave);
+
+/**
+ * Colección definida por su tamaño y su semilla.
+ *
+ * ERRORES: std::out_of_range al pedir un índice fuera del conjunto;
+ *          std::runtime_error si una consulta no tiene coincidencias
+ */
+class ColeccionVirtual {
+public:
+    static const uint64_t PRIMERA_CEDULA = 1000000000ULL;
+
+    ColeccionVirtual(uint64_t total, uint64_t semilla);
+
+    uint64_t total() const { return n; }
+    uint64_t semilla() const { return clave; }
+
+    /** Persona del índice dado, calculada al vuelo. */
+    Persona persona(uint64_t indice) const;
+    Persona persona(uint64_t indice, const EsquemaGrupos& esquema) const; // Con una instantánea ya tomada
+
+    /** Índice de una cédula (-1 si no pertenece al conjunto). O(1). */
+    long long indiceDeId(const std::string& id) const;
+
+    /**
+     * Copia en memoria de las primeras filas (todas si filas = 0), idéntica
+     * fila a fila a persona(i).
+     */
+    std::vector<Persona> materializar(uint64_t filas = 0, const ControlOperacion& control = ControlOperacion()) const;
+
+    // Consultas por recorrido paralelo. Ciudad o grupo vacíos = todo el país.
+    // Ante empates gana el índice menor, como std::max_element sobre el vector.
+    uint64_t masLongevo(const std::string& ciudad, const ControlOperacion& control = ControlOperacion()) const;
+    uint64_t masPatrimonio(const std::string& ciudad, const std::string& grupo,
+                           const ControlOperacion& control = ControlOperacion()) const;
+    std::vector<PromedioGrupo> promediosPorGrupo(const ControlOperacion& control = ControlOperacion()) const;
+
+private:
+    /**
+     * Campos de una fila como códigos y números, sin construir strings.
+     */
+    struct Campos {
+        bool hombre;
+        uint32_t nombre, apellido1, apellido2, ciudad;
+        int dia, mes, anio;
+        uint32_t sorteoDeclarante; // 0..99
+        double ingresos, patrimonio, deudas;
+    };
+
+    Campos campos(uint64_t indice, bool financieros) const;
+    static int codigoGrupo(const EsquemaGrupos& esquema, uint64_t indice); // Código de la fila en ese esquema
+
+    uint64_t n;
+    uint64_t clave;
+};
+
+#endif // COLECCION_VIRTUAL_H
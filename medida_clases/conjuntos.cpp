@@ -0,0 +1,220 @@
+#include "conjuntos.h"
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+// Costo aproximado por entrada de la tabla hash del diccionario (nodo + cubeta)
+static const size_t SOBRECOSTO_ENTRADA_DICCIONARIO = 48;
+
+uint32_t DiccionarioCompartido::codigo(const std::string& texto) {
+    auto it = codigos.find(texto);
+    if (it != codigos.end()) return it->second;
+    uint32_t nuevo = static_cast<uint32_t>(textos.size());
+    textos.push_back(texto);
+    codigos.emplace(texto, nuevo);
+    return nuevo;
+}
+
+size_t DiccionarioCompartido::bytes() const {
+    size_t total = textos.capacity() * sizeof(std::string);
+    for (const auto& t : textos) {
+        // Los textos largos viven fuera del objeto; se cuentan dos veces (vector y tabla hash)
+        size_t fuera = t.capacity() > 15 ? t.capacity() + 1 : 0;
+        total += 2 * fuera + sizeof(std::string) + SOBRECOSTO_ENTRADA_DICCIONARIO;
+    }
+    return total;
+}
+
+size_t ConjuntoCompacto::bytes() const {
+    return id.capacity() * sizeof(uint64_t) +
+           (nombre.capacity() + apellido.capacity() + ciudad.capacity() + fecha.capacity() + grupo.capacity()) * sizeof(uint32_t) +
+           edad.capacity() + declarante.capacity() +
+           (ingresos.capacity() + patrimonio.capacity() + deudas.capacity()) * sizeof(double);
+}
+
+void RegistroConjuntos::guardar(const std::string& nombre, const std::vector<Persona>& personas) {
+    ConjuntoCompacto c;
+    const size_t n = personas.size();
+    c.id.reserve(n);
+    c.nombre.reserve(n);
+    c.apellido.reserve(n);
+    c.ciudad.reserve(n);
+    c.fecha.reserve(n);
+    c.grupo.reserve(n);
+    c.edad.reserve(n);
+    c.ingresos.reserve(n);
+    c.patrimonio.reserve(n);
+    c.deudas.reserve(n);
+    c.declarante.reserve(n);
+
+    for (const auto& p : personas) {
+        const std::string& id = p.getId();
+        uint64_t numero = 0;
+        bool canonico = !id.empty() && id.size() <= 18 && id[0] != '0' &&
+                        std::all_of(id.begin(), id.end(), [](char ch) { return ch >= '0' && ch <= '9'; });
+        if (canonico) numero = std::stoull(id);
+        c.id.push_back(canonico ? numero : (ConjuntoCompacto::ID_EN_DICCIONARIO | diccionario.codigo(id)));
+
+        c.nombre.push_back(diccionario.codigo(p.getNombre()));
+        c.apellido.push_back(diccionario.codigo(p.getApellido()));
+        c.ciudad.push_back(diccionario.codigo(p.getCiudadNacimiento()));
+        c.fecha.push_back(diccionario.codigo(p.getFechaNacimiento()));
+        c.grupo.push_back(diccionario.codigo(p.getGrupoDeclaracion()));
+        c.edad.push_back(static_cast<uint8_t>(std::min(std::max(p.getEdad(), 0), 255)));
+        c.ingresos.push_back(p.getIngresosAnuales());
+        c.patrimonio.push_back(p.getPatrimonio());
+        c.deudas.push_back(p.getDeudas());
+        c.declarante.push_back(p.getDeclaranteRenta() ? 1 : 0);
+    }
+    conjuntos[nombre] = std::move(c);
+}
+
+std::string RegistroConjuntos::idTexto(uint64_t id) const {
+    if (id & ConjuntoCompacto::ID_EN_DICCIONARIO) {
+        return diccionario.texto(static_cast<uint32_t>(id & ~ConjuntoCompacto::ID_EN_DICCIONARIO));
+    }
+    return std::to_string(id);
+}
+
+const ConjuntoCompacto& RegistroConjuntos::buscar(const std::string& nombre) const {
+    auto it = conjuntos.find(nombre);
+    if (it == conjuntos.end()) throw std::invalid_argument("No existe el conjunto: " + nombre);
+    return it->second;
+}
+
+std::vector<Persona> RegistroConjuntos::materializar(const std::string& nombre) const {
+    const ConjuntoCompacto& c = buscar(nombre);
+    std::vector<Persona> personas;
+    personas.reserve(c.size());
+    for (size_t i = 0; i < c.size(); ++i) {
+        personas.emplace_back(diccionario.texto(c.nombre[i]), diccionario.texto(c.apellido[i]), idTexto(c.id[i]),
+                              diccionario.texto(c.ciudad[i]), diccionario.texto(c.fecha[i]),
+                              diccionario.texto(c.grupo[i]), c.edad[i], c.ingresos[i], c.patrimonio[i],
+                              c.deudas[i], c.declarante[i] != 0);
+    }
+    return personas;
+}
+
+void RegistroConjuntos::eliminar(const std::string& nombre) {
+    buscar(nombre);
+    conjuntos.erase(nombre);
+    // Los textos del diccionario se conservan: otros conjuntos pueden usarlos
+}
+
+void RegistroConjuntos::mostrarMemoria(std::ostream& salida) const {
+    salida << "\n=== CONJUNTOS RESIDENTES ===\n";
+    if (conjuntos.empty()) salida << "(ninguno)\n";
+    for (const auto& c : conjuntos) {
+        salida << std::left << std::setw(20) << c.first << std::right << std::setw(12) << c.second.size()
+               << " personas " << std::setw(10) << c.second.bytes() / 1024 << " KB\n";
+    }
+    salida << "Diccionario compartido: " << diccionario.tamano() << " textos, "
+           << diccionario.bytes() / 1024 << " KB\n";
+}
+
+/**
+ * Totales de un conjunto para la comparación.
+ */
+struct ResumenConjunto {
+    double sumaEdad = 0.0;
+    double sumaPatrimonio = 0.0;
+    std::map<std::string, std::pair<size_t, double>> grupos; // conteo, suma de patrimonio
+    std::map<std::string, size_t> ciudades;
+    size_t filaMasRica = 0;
+};
+
+static ResumenConjunto resumir(const ConjuntoCompacto& c, const DiccionarioCompartido& diccionario) {
+    // Acumula por código (arreglos indexados) y solo al final traduce a texto. Los arreglos
+    // llegan hasta el mayor código que usa el conjunto, no hasta el tamaño del diccionario
+    // compartido (que también guarda nombres, apellidos y fechas de todos los conjuntos)
+    auto codigos = [](const std::vector<uint32_t>& columna) {
+        return columna.empty() ? size_t(0) : size_t(*std::max_element(columna.begin(), columna.end())) + 1;
+    };
+    const size_t codigosGrupo = codigos(c.grupo), codigosCiudad = codigos(c.ciudad);
+    std::vector<size_t> conteoGrupo(codigosGrupo, 0), conteoCiudad(codigosCiudad, 0);
+    std::vector<double> patrimonioGrupo(codigosGrupo, 0.0);
+    ResumenConjunto r;
+    for (size_t i = 0; i < c.size(); ++i) {
+        r.sumaEdad += c.edad[i];
+        r.sumaPatrimonio += c.patrimonio[i];
+        conteoGrupo[c.grupo[i]]++;
+        patrimonioGrupo[c.grupo[i]] += c.patrimonio[i];
+        conteoCiudad[c.ciudad[i]]++;
+        if (c.patrimonio[i] > c.patrimonio[r.filaMasRica]) r.filaMasRica = i;
+    }
+    for (uint32_t codigo = 0; codigo < codigosGrupo; ++codigo) {
+        if (conteoGrupo[codigo]) r.grupos[diccionario.texto(codigo)] = {conteoGrupo[codigo], patrimonioGrupo[codigo]};
+    }
+    for (uint32_t codigo = 0; codigo < codigosCiudad; ++codigo) {
+        if (conteoCiudad[codigo]) r.ciudades[diccionario.texto(codigo)] = conteoCiudad[codigo];
+    }
+    return r;
+}
+
+void RegistroConjuntos::comparar(const std::string& a, const std::string& b, std::ostream& salida) const {
+    const ConjuntoCompacto& ca = buscar(a);
+    const ConjuntoCompacto& cb = buscar(b);
+    ResumenConjunto ra = resumir(ca, diccionario);
+    ResumenConjunto rb = resumir(cb, diccionario);
+
+    auto promedio = [](double suma, size_t n) { return n ? suma / n : 0.0; };
+    auto fila = [&salida](const std::string& etiqueta, double va, double vb, int decimales) {
+        salida << std::setprecision(decimales) << std::left << std::setw(28) << etiqueta << std::right
+               << std::setw(18) << va << std::setw(18) << vb << std::setw(18) << vb - va << "\n";
+    };
+
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+    salida << std::fixed;
+    salida << "\n=== COMPARACIÓN " << a << " vs " << b << " ===\n";
+    salida << std::left << std::setw(28) << "" << std::right << std::setw(18) << a << std::setw(18) << b
+           << std::setw(18) << "diferencia" << "\n";
+    fila("Personas", ca.size(), cb.size(), 0);
+    fila("Edad promedio", promedio(ra.sumaEdad, ca.size()), promedio(rb.sumaEdad, cb.size()), 2);
+    fila("Patrimonio promedio", promedio(ra.sumaPatrimonio, ca.size()), promedio(rb.sumaPatrimonio, cb.size()), 2);
+
+    std::map<std::string, bool> grupos;
+    for (const auto& g : ra.grupos) grupos[g.first] = true;
+    for (const auto& g : rb.grupos) grupos[g.first] = true;
+    for (const auto& g : grupos) {
+        auto ga = ra.grupos[g.first];
+        auto gb = rb.grupos[g.first];
+        fila("Grupo " + g.first + " personas", ga.first, gb.first, 0);
+        fila("Grupo " + g.first + " patrimonio prom.", promedio(ga.second, ga.first), promedio(gb.second, gb.first), 2);
+    }
+
+    std::map<std::string, bool> ciudades;
+    for (const auto& c : ra.ciudades) ciudades[c.first] = true;
+    for (const auto& c : rb.ciudades) ciudades[c.first] = true;
+    for (const auto& c : ciudades) fila("Personas en " + c.first, ra.ciudades[c.first], rb.ciudades[c.first], 0);
+
+    if (ca.size() && cb.size()) {
+        salida << std::setprecision(2);
+        salida << "Más rica en " << a << ": " << idTexto(ca.id[ra.filaMasRica]) << " ("
+               << ca.patrimonio[ra.filaMasRica] << ")\n";
+        salida << "Más rica en " << b << ": " << idTexto(cb.id[rb.filaMasRica]) << " ("
+               << cb.patrimonio[rb.filaMasRica] << ")\n";
+    }
+
+    // Cruce por cédula: las IDs de ambos usan la misma codificación. Se cuentan cédulas
+    // distintas (un conjunto importado puede repetirlas); de cada una vale su primera fila
+    std::unordered_map<uint64_t, size_t> filasA;
+    filasA.reserve(ca.size());
+    for (size_t i = 0; i < ca.size(); ++i) filasA.emplace(ca.id[i], i);
+    std::unordered_set<uint64_t> vistasB;
+    vistasB.reserve(cb.size());
+    size_t comunes = 0, cambiaron = 0;
+    for (size_t i = 0; i < cb.size(); ++i) {
+        if (!vistasB.insert(cb.id[i]).second) continue;
+        auto it = filasA.find(cb.id[i]);
+        if (it == filasA.end()) continue;
+        comunes++;
+        if (ca.patrimonio[it->second] != cb.patrimonio[i] || ca.ciudad[it->second] != cb.ciudad[i]) cambiaron++;
+    }
+    salida << "Cédulas comunes: " << comunes << ", solo en " << a << ": " << filasA.size() - comunes
+           << ", solo en " << b << ": " << vistasB.size() - comunes << ", con cambios: " << cambiaron << "\n";
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
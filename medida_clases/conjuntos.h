@@ -0,0 +1,92 @@
+#ifndef CONJUNTOS_H
+#define CONJUNTOS_H
+
+#include "persona.h"
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// CONJUNTOS DE DATOS CON NOMBRE Y DICCIONARIOS COMPARTIDOS
+// ============================================================================
+// Además del conjunto activo (el vector de Persona del menú) se pueden
+// mantener varios conjuntos residentes a la vez, por ejemplo dos
+// generaciones o un antes/después. Cada conjunto guardado se almacena por
+// columnas: los textos (nombres, apellidos, ciudades, fechas, grupos) son
+// códigos de un único diccionario compartido por todos los conjuntos, así
+// que cada conjunto adicional solo paga sus columnas de enteros y números.
+// ============================================================================
+
+/**
+ * Tabla de textos internados, compartida por todos los conjuntos.
+ */
+class DiccionarioCompartido {
+public:
+    /** Código del texto; lo agrega si no existe. */
+    uint32_t codigo(const std::string& texto);
+    const std::string& texto(uint32_t codigo) const { return textos[codigo]; }
+
+    size_t tamano() const { return textos.size(); }
+    size_t bytes() const;
+
+private:
+    std::vector<std::string> textos;
+    std::unordered_map<std::string, uint32_t> codigos;
+};
+
+/**
+ * Conjunto guardado por columnas.
+ *
+ * IDs: Las cédulas numéricas canónicas se guardan como uint64; cualquier
+ *      otra se interna en el diccionario y se marca con el bit alto.
+ */
+struct ConjuntoCompacto {
+    static const uint64_t ID_EN_DICCIONARIO = 1ULL << 63;
+
+    std::vector<uint64_t> id;
+    std::vector<uint32_t> nombre, apellido, ciudad, fecha, grupo; // Códigos del diccionario
+    std::vector<uint8_t> edad;
+    std::vector<double> ingresos, patrimonio, deudas;
+    std::vector<uint8_t> declarante;
+
+    size_t size() const { return id.size(); }
+    size_t bytes() const; // Solo las columnas propias (sin el diccionario)
+};
+
+/**
+ * Conjuntos residentes identificados por nombre.
+ *
+ * ERRORES: std::invalid_argument si el nombre no existe
+ */
+class RegistroConjuntos {
+public:
+    /** Guarda (o reemplaza) una copia compacta de la colección. */
+    void guardar(const std::string& nombre, const std::vector<Persona>& personas);
+
+    /** Reconstruye el vector de Persona de un conjunto guardado. */
+    std::vector<Persona> materializar(const std::string& nombre) const;
+
+    void eliminar(const std::string& nombre);
+    bool existe(const std::string& nombre) const { return conjuntos.count(nombre) > 0; }
+
+    /** Nombre, filas y bytes de cada conjunto, más el diccionario compartido. */
+    void mostrarMemoria(std::ostream& salida) const;
+
+    /**
+     * Compara dos conjuntos: totales, promedios por grupo, personas por
+     * ciudad, más rica de cada uno y cruce por cédula (comunes y cambios).
+     */
+    void comparar(const std::string& a, const std::string& b, std::ostream& salida) const;
+
+private:
+    const ConjuntoCompacto& buscar(const std::string& nombre) const;
+    std::string idTexto(uint64_t id) const;
+
+    DiccionarioCompartido diccionario;
+    std::map<std::string, ConjuntoCompacto> conjuntos;
+};
+
+#endif // CONJUNTOS_H
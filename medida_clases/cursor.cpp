@@ -0,0 +1,78 @@
+#include "cursor.h"
+#include <algorithm> // std::stable_sort, std::min
+#include <chrono>
+#include <cstdlib>   // std::strtoull
+
+ClaveOrden claveOrdenDesdeTexto(const std::string& texto) {
+    if (texto == "id") return ClaveOrden::ID;
+    if (texto == "edad") return ClaveOrden::EDAD;
+    if (texto == "patrimonio") return ClaveOrden::PATRIMONIO;
+    if (texto == "ingresos") return ClaveOrden::INGRESOS;
+    return ClaveOrden::NINGUNA;
+}
+
+/**
+ * Construye el cursor y ordena la selección una sola vez.
+ *
+ * CÓMO: stable_sort sobre los números de fila comparando la clave de cada
+ *       persona; con NINGUNA se conserva el orden de la colección.
+ */
+CursorListado::CursorListado(std::shared_ptr<const std::vector<Persona>> datos, SeleccionFilas seleccion,
+                             std::string consulta, ClaveOrden orden, size_t tamPagina, unsigned columnas)
+    : datos(std::move(datos)),
+      seleccion(std::move(seleccion)),
+      clave(std::move(consulta)),
+      tamPagina(tamPagina == 0 ? 1 : tamPagina),
+      columnas(columnas) {
+    const std::vector<Persona>& personas = *this->datos;
+    switch (orden) {
+        case ClaveOrden::NINGUNA:
+            break;
+        case ClaveOrden::ID:
+            std::stable_sort(this->seleccion.begin(), this->seleccion.end(), [&personas](uint32_t a, uint32_t b) {
+                return std::strtoull(personas[a].getId().c_str(), nullptr, 10) <
+                       std::strtoull(personas[b].getId().c_str(), nullptr, 10);
+            });
+            break;
+        case ClaveOrden::EDAD:
+            std::stable_sort(this->seleccion.begin(), this->seleccion.end(),
+                [&personas](uint32_t a, uint32_t b) { return personas[a].getEdad() > personas[b].getEdad(); });
+            break;
+        case ClaveOrden::PATRIMONIO:
+            std::stable_sort(this->seleccion.begin(), this->seleccion.end(),
+                [&personas](uint32_t a, uint32_t b) { return personas[a].getPatrimonio() > personas[b].getPatrimonio(); });
+            break;
+        case ClaveOrden::INGRESOS:
+            std::stable_sort(this->seleccion.begin(), this->seleccion.end(),
+                [&personas](uint32_t a, uint32_t b) { return personas[a].getIngresosAnuales() > personas[b].getIngresosAnuales(); });
+            break;
+    }
+}
+
+double CursorListado::mostrarPagina() const {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    size_t fin = std::min(inicio + tamPagina, seleccion.size());
+    mostrarSeleccion(*datos, seleccion, inicio, fin, columnas);
+    std::chrono::duration<double, std::milli> duracion = std::chrono::high_resolution_clock::now() - t0;
+
+    size_t paginas = (seleccion.size() + tamPagina - 1) / tamPagina;
+    std::cout << "-- Filas " << (seleccion.empty() ? 0 : inicio + 1) << "-" << fin << " de " << seleccion.size()
+              << " (página " << (seleccion.empty() ? 0 : inicio / tamPagina + 1) << "/" << paginas << ") --\n";
+    return duracion.count();
+}
+
+bool CursorListado::siguiente() {
+    if (inicio + tamPagina >= seleccion.size()) return false;
+    inicio += tamPagina;
+    return true;
+}
+
+bool CursorListado::anterior() {
+    if (inicio == 0) return false;
+    inicio = inicio >= tamPagina ? inicio - tamPagina : 0;
+    return true;
+}
+
+void CursorListado::irA(size_t desplazamiento) {
+    inicio = seleccion.empty() ? 0 : std::min(desplazamiento, seleccion.size() - 1);
+}
@@ -0,0 +1,76 @@
+#ifndef CURSOR_H
+#define CURSOR_H
+
+#include "persona.h"
+#include "seleccion.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CURSORES PAGINADOS PARA LISTADOS
+// ============================================================================
+// Un cursor guarda el vector de selección de una consulta (calculado una sola
+// vez), lo ordena opcionalmente por una clave y lo recorre por páginas. Así
+// cada página cuesta solo sus propias filas y el listado puede retomarse en
+// otra interacción del menú mientras el conjunto de datos no cambie.
+// ============================================================================
+
+/**
+ * Claves de ordenamiento disponibles para un listado.
+ */
+enum class ClaveOrden { NINGUNA, ID, EDAD, PATRIMONIO, INGRESOS };
+
+/**
+ * Interpreta el nombre de una clave de orden ("id", "edad", ...).
+ *
+ * @return La clave correspondiente, o NINGUNA si el texto no coincide
+ */
+ClaveOrden claveOrdenDesdeTexto(const std::string& texto);
+
+/**
+ * Cursor paginado sobre un vector de selección.
+ *
+ * PROPÓSITO: Mostrar resultados grandes de a una página, sin volver a filtrar
+ * DISEÑO: Comparte (no copia) la colección; si la colección le pertenece a
+ *         otro, quien la posee debe descartar el cursor antes de liberarla
+ */
+class CursorListado {
+public:
+    /**
+     * @param datos Colección sobre la que se definen las filas
+     * @param seleccion Filas resultantes del filtro (se mueven al cursor)
+     * @param consulta Clave que identifica la consulta (para reanudar)
+     * @param orden Clave de ordenamiento a aplicar una sola vez
+     * @param tamPagina Filas por página (mínimo 1)
+     * @param columnas Máscara de columnas a proyectar
+     */
+    CursorListado(std::shared_ptr<const std::vector<Persona>> datos, SeleccionFilas seleccion,
+                  std::string consulta, ClaveOrden orden, size_t tamPagina, unsigned columnas);
+
+    /**
+     * Imprime la página actual.
+     *
+     * @return Tiempo de proyección de la página en milisegundos
+     */
+    double mostrarPagina() const;
+
+    bool siguiente();                 // Avanza una página; false si ya es la última
+    bool anterior();                  // Retrocede una página; false si ya es la primera
+    void irA(size_t desplazamiento);  // Salta a una posición (se ajusta al rango)
+
+    size_t desplazamiento() const { return inicio; }
+    size_t total() const { return seleccion.size(); }
+    size_t tamanoPagina() const { return tamPagina; }
+    const std::string& consulta() const { return clave; }
+
+private:
+    std::shared_ptr<const std::vector<Persona>> datos;
+    SeleccionFilas seleccion;
+    std::string clave;
+    size_t tamPagina;
+    unsigned columnas;
+    size_t inicio = 0;
+};
+
+#endif // CURSOR_H
@@ -0,0 +1,430 @@
+#include "declaraciones.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+static const uint64_t SIN_CLAVE = std::numeric_limits<uint64_t>::max(); // Cédula no numérica
+static const size_t TUPLAS_POR_PARTICION = 16384; // 256 KB de tuplas de construcción: caben en L2
+static const unsigned MAXIMO_BITS_RADIX = 14;
+
+/**
+ * Clave y fila de una tabla, lo único que mueve la unión (16 bytes).
+ */
+struct Tupla {
+    uint64_t clave;
+    uint32_t fila;
+    uint32_t relleno;
+};
+
+static bool cedulaNumerica(const std::string& id, uint64_t& clave) {
+    if (id.empty() || id.size() > 19) return false;
+    uint64_t valor = 0;
+    for (char ch : id) {
+        if (ch < '0' || ch > '9') return false;
+        valor = valor * 10 + static_cast<uint64_t>(ch - '0');
+    }
+    clave = valor;
+    return true;
+}
+
+/**
+ * Ejecuta trabajo(h, desde, hasta) sobre [0, n) repartido en tramos contiguos.
+ */
+template <typename Trabajo>
+static void enParalelo(unsigned hilos, size_t n, Trabajo trabajo) {
+    if (hilos <= 1) {
+        trabajo(0u, size_t(0), n);
+        return;
+    }
+    std::vector<std::thread> trabajadores;
+    for (unsigned h = 0; h < hilos; ++h) {
+        trabajadores.emplace_back(trabajo, h, n * h / hilos, n * (h + 1) / hilos);
+    }
+    for (auto& t : trabajadores) t.join();
+}
+
+// ============================================================================
+// GENERACIÓN
+// ============================================================================
+
+static std::vector<Declaracion> generarDeclaraciones(const Persona* personas, size_t n,
+                                                     const ConfiguracionDeclaraciones& c) {
+    if (c.maximoPorPersona < 1) throw std::invalid_argument("Cada persona debe poder tener al menos una declaración");
+    if (c.porcentajeHuerfanas < 0 || c.porcentajeHuerfanas >= 100 || c.porcentajeDiscrepantes < 0 ||
+        c.porcentajeDiscrepantes > 100) {
+        throw std::invalid_argument("Porcentajes de huérfanas o discrepantes fuera de rango");
+    }
+    std::mt19937_64 generador(c.semilla);
+    std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+    std::vector<Declaracion> declaraciones;
+    declaraciones.reserve(n * (c.maximoPorPersona + 1) / 2);
+
+    auto impuesto = [](double ingresos) { return std::max(0.0, ingresos - 50000000) * 0.19; };
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t cedula;
+        if (!cedulaNumerica(personas[i].getId(), cedula)) continue;
+        const int anios = 1 + static_cast<int>(generador() % c.maximoPorPersona);
+        for (int a = 0; a < anios; ++a) {
+            // Ruido normal de ±5%; las discrepantes se alejan entre 15% y 60%
+            double factor = 1.0 + (uniforme(generador) - 0.5) * 0.10;
+            if (uniforme(generador) * 100 < c.porcentajeDiscrepantes) {
+                double desvio = 0.15 + uniforme(generador) * 0.45;
+                factor = uniforme(generador) < 0.5 ? 1.0 - desvio : 1.0 + desvio;
+            }
+            double ingresos = personas[i].getIngresosAnuales() * factor;
+            declaraciones.push_back({cedula, ingresos, impuesto(ingresos), static_cast<uint16_t>(2024 - a)});
+        }
+    }
+
+    // Huérfanas: cédulas de 10 dígitos desde 9.000.000.000, lejos del contador de generarID()
+    const size_t huerfanas = static_cast<size_t>(declaraciones.size() * c.porcentajeHuerfanas / (100 - c.porcentajeHuerfanas));
+    for (size_t k = 0; k < huerfanas; ++k) {
+        double ingresos = 10000000 + uniforme(generador) * (500000000 - 10000000);
+        declaraciones.push_back({9000000000ULL + generador() % 1000000000ULL, ingresos, impuesto(ingresos),
+                                 static_cast<uint16_t>(2020 + generador() % 5)});
+    }
+
+    std::shuffle(declaraciones.begin(), declaraciones.end(), generador); // Sin orden útil, como una tabla real
+    return declaraciones;
+}
+
+std::vector<Declaracion> generarDeclaraciones(const std::vector<Persona>& personas,
+                                              const ConfiguracionDeclaraciones& configuracion) {
+    return generarDeclaraciones(personas.data(), personas.size(), configuracion);
+}
+
+const char* nombreAlgoritmo(AlgoritmoUnion algoritmo) {
+    return algoritmo == AlgoritmoUnion::HASH_RADIX ? "Hash con particionado radix" : "Ordenar y mezclar";
+}
+
+// ============================================================================
+// EXTRACCIÓN DE CLAVES
+// ============================================================================
+
+static std::vector<Tupla> clavesPersonas(const Persona* personas, size_t n, unsigned hilos) {
+    std::vector<Tupla> tuplas(n);
+    enParalelo(hilos, n, [&](unsigned, size_t desde, size_t hasta) {
+        for (size_t i = desde; i < hasta; ++i) {
+            uint64_t clave;
+            tuplas[i] = {cedulaNumerica(personas[i].getId(), clave) ? clave : SIN_CLAVE, static_cast<uint32_t>(i), 0};
+        }
+    });
+    return tuplas;
+}
+
+static std::vector<Tupla> clavesDeclaraciones(const std::vector<Declaracion>& declaraciones, unsigned hilos) {
+    std::vector<Tupla> tuplas(declaraciones.size());
+    enParalelo(hilos, declaraciones.size(), [&](unsigned, size_t desde, size_t hasta) {
+        for (size_t i = desde; i < hasta; ++i) tuplas[i] = {declaraciones[i].cedula, static_cast<uint32_t>(i), 0};
+    });
+    return tuplas;
+}
+
+// ============================================================================
+// HASH CON PARTICIONADO RADIX
+// ============================================================================
+
+static uint64_t mezclar(uint64_t clave) {
+    clave ^= clave >> 33;
+    clave *= 0xff51afd7ed558ccdULL;
+    clave ^= clave >> 33;
+    clave *= 0xc4ceb9fe1a85ec53ULL;
+    clave ^= clave >> 33;
+    return clave;
+}
+
+/**
+ * Reparte las tuplas en 2^bits particiones por los bits altos del hash.
+ *
+ * IMPLEMENTACIÓN: Dos pasadas en paralelo: histograma por hilo y, tras las
+ *                 sumas prefijas, copia de cada tupla a su hueco. Las tuplas
+ *                 sin clave se descartan.
+ * @param inicios Salida: inicio de cada partición (2^bits + 1 entradas)
+ */
+static std::vector<Tupla> particionar(const std::vector<Tupla>& entrada, unsigned bits, unsigned hilos,
+                                      std::vector<size_t>& inicios) {
+    const size_t particiones = size_t(1) << bits;
+    auto particion = [bits](uint64_t clave) { return bits == 0 ? 0 : static_cast<size_t>(mezclar(clave) >> (64 - bits)); };
+
+    std::vector<std::vector<size_t>> histogramas(hilos, std::vector<size_t>(particiones, 0));
+    enParalelo(hilos, entrada.size(), [&](unsigned h, size_t desde, size_t hasta) {
+        for (size_t i = desde; i < hasta; ++i) {
+            if (entrada[i].clave != SIN_CLAVE) histogramas[h][particion(entrada[i].clave)]++;
+        }
+    });
+
+    // Posición de escritura de cada hilo en cada partición
+    inicios.assign(particiones + 1, 0);
+    size_t total = 0;
+    for (size_t p = 0; p < particiones; ++p) {
+        inicios[p] = total;
+        for (unsigned h = 0; h < hilos; ++h) {
+            size_t cuenta = histogramas[h][p];
+            histogramas[h][p] = total;
+            total += cuenta;
+        }
+    }
+    inicios[particiones] = total;
+
+    std::vector<Tupla> salida(total);
+    enParalelo(hilos, entrada.size(), [&](unsigned h, size_t desde, size_t hasta) {
+        std::vector<size_t>& posiciones = histogramas[h];
+        for (size_t i = desde; i < hasta; ++i) {
+            if (entrada[i].clave != SIN_CLAVE) salida[posiciones[particion(entrada[i].clave)]++] = entrada[i];
+        }
+    });
+    return salida;
+}
+
+static std::vector<std::vector<ParUnion>> unirHashRadix(const std::vector<Tupla>& construccion, const std::vector<Tupla>& sondeo,
+                                                         unsigned hilos, const FiltroUnion& filtro) {
+    unsigned bits = 0;
+    while (bits < MAXIMO_BITS_RADIX && (construccion.size() >> bits) > TUPLAS_POR_PARTICION) bits++;
+
+    std::vector<size_t> iniciosC, iniciosS;
+    std::vector<Tupla> particionesC = particionar(construccion, bits, hilos, iniciosC);
+    std::vector<Tupla> particionesS = particionar(sondeo, bits, hilos, iniciosS);
+
+    // Cada hilo toma la siguiente partición libre: las particiones pesadas no atrasan a los demás
+    std::atomic<size_t> siguiente{0};
+    const size_t particiones = size_t(1) << bits;
+    std::vector<std::vector<ParUnion>> resultados(hilos);
+    enParalelo(hilos, hilos, [&](unsigned h, size_t, size_t) {
+        std::vector<uint64_t> claves;
+        std::vector<uint32_t> filas;
+        for (size_t p; (p = siguiente.fetch_add(1)) < particiones;) {
+            const size_t tamC = iniciosC[p + 1] - iniciosC[p];
+            if (tamC == 0 || iniciosS[p + 1] == iniciosS[p]) continue;
+
+            // Direccionamiento abierto con sondeo lineal, ocupación <= 50%
+            size_t capacidad = 1;
+            while (capacidad < 2 * tamC) capacidad <<= 1;
+            const size_t mascara = capacidad - 1;
+            claves.assign(capacidad, SIN_CLAVE);
+            filas.resize(capacidad);
+            for (size_t i = iniciosC[p]; i < iniciosC[p + 1]; ++i) {
+                size_t hueco = mezclar(particionesC[i].clave) & mascara;
+                while (claves[hueco] != SIN_CLAVE) hueco = (hueco + 1) & mascara;
+                claves[hueco] = particionesC[i].clave;
+                filas[hueco] = particionesC[i].fila;
+            }
+
+            for (size_t i = iniciosS[p]; i < iniciosS[p + 1]; ++i) {
+                const Tupla& t = particionesS[i];
+                for (size_t hueco = mezclar(t.clave) & mascara; claves[hueco] != SIN_CLAVE; hueco = (hueco + 1) & mascara) {
+                    if (claves[hueco] == t.clave && (!filtro || filtro(filas[hueco], t.fila))) {
+                        resultados[h].push_back({filas[hueco], t.fila});
+                    }
+                }
+            }
+        }
+    });
+    return resultados;
+}
+
+// ============================================================================
+// ORDENAR Y MEZCLAR
+// ============================================================================
+
+static bool porClave(const Tupla& a, const Tupla& b) {
+    return a.clave < b.clave;
+}
+
+/**
+ * Ordena por clave: cada hilo ordena un tramo y luego se mezclan los tramos
+ * por pares, también en paralelo.
+ */
+static void ordenarEnParalelo(std::vector<Tupla>& tuplas, unsigned hilos) {
+    std::vector<size_t> cortes;
+    for (unsigned h = 0; h <= hilos; ++h) cortes.push_back(tuplas.size() * h / hilos);
+    enParalelo(hilos, hilos, [&](unsigned h, size_t, size_t) {
+        std::sort(tuplas.begin() + cortes[h], tuplas.begin() + cortes[h + 1], porClave);
+    });
+
+    std::vector<Tupla> auxiliar(tuplas.size());
+    while (cortes.size() > 2) {
+        std::vector<size_t> nuevos;
+        const size_t pares = (cortes.size() - 1) / 2;
+        enParalelo(static_cast<unsigned>(pares), pares, [&](unsigned, size_t desde, size_t hasta) {
+            for (size_t k = desde; k < hasta; ++k) {
+                std::merge(tuplas.begin() + cortes[2 * k], tuplas.begin() + cortes[2 * k + 1],
+                           tuplas.begin() + cortes[2 * k + 1], tuplas.begin() + cortes[2 * k + 2],
+                           auxiliar.begin() + cortes[2 * k], porClave);
+            }
+        });
+        for (size_t k = 0; k < 2 * pares; k += 2) nuevos.push_back(cortes[k]);
+        if ((cortes.size() - 1) % 2 == 1) { // Tramo sin pareja: se copia sin mezclar
+            const size_t ultimo = cortes[cortes.size() - 2];
+            std::copy(tuplas.begin() + ultimo, tuplas.end(), auxiliar.begin() + ultimo);
+            nuevos.push_back(ultimo);
+        }
+        nuevos.push_back(tuplas.size());
+        tuplas.swap(auxiliar);
+        cortes.swap(nuevos);
+    }
+}
+
+static std::vector<std::vector<ParUnion>> unirOrdenarMezclar(std::vector<Tupla> construccion, std::vector<Tupla> sondeo,
+                                                              unsigned hilos, const FiltroUnion& filtro) {
+    ordenarEnParalelo(construccion, hilos);
+    ordenarEnParalelo(sondeo, hilos);
+
+    // El sondeo se corta en tramos que no parten un grupo de claves iguales
+    std::vector<size_t> cortes = {0};
+    for (unsigned h = 1; h < hilos; ++h) {
+        size_t corte = std::max(cortes.back(), sondeo.size() * h / hilos);
+        while (corte > 0 && corte < sondeo.size() && sondeo[corte].clave == sondeo[corte - 1].clave) corte++;
+        cortes.push_back(corte);
+    }
+    cortes.push_back(sondeo.size());
+
+    std::vector<std::vector<ParUnion>> resultados(hilos);
+    enParalelo(hilos, hilos, [&](unsigned h, size_t, size_t) {
+        size_t s = cortes[h];
+        const size_t finS = cortes[h + 1];
+        if (s >= finS) return;
+        size_t c = std::lower_bound(construccion.begin(), construccion.end(), sondeo[s], porClave) - construccion.begin();
+        while (s < finS && c < construccion.size() && construccion[c].clave != SIN_CLAVE) {
+            if (sondeo[s].clave < construccion[c].clave) {
+                s++;
+            } else if (construccion[c].clave < sondeo[s].clave) {
+                c++;
+            } else {
+                // Grupo de claves iguales en ambos lados: producto cruzado
+                const uint64_t clave = sondeo[s].clave;
+                size_t finC = c;
+                while (finC < construccion.size() && construccion[finC].clave == clave) finC++;
+                for (; s < finS && sondeo[s].clave == clave; ++s) {
+                    for (size_t k = c; k < finC; ++k) {
+                        if (!filtro || filtro(construccion[k].fila, sondeo[s].fila)) {
+                            resultados[h].push_back({construccion[k].fila, sondeo[s].fila});
+                        }
+                    }
+                }
+                c = finC;
+            }
+        }
+    });
+    return resultados;
+}
+
+// ============================================================================
+// INTERFAZ
+// ============================================================================
+
+static std::vector<ParUnion> unirPorCedula(const Persona* personas, size_t n, const std::vector<Declaracion>& declaraciones,
+                                           AlgoritmoUnion algoritmo, unsigned hilos, const FiltroUnion& filtro) {
+    const size_t maximo = std::numeric_limits<uint32_t>::max();
+    if (n > maximo || declaraciones.size() > maximo) {
+        throw std::invalid_argument("La unión admite hasta 2^32 - 1 filas por tabla");
+    }
+    hilos = std::max(1u, hilos);
+    std::vector<Tupla> construccion = clavesPersonas(personas, n, hilos);
+    std::vector<Tupla> sondeo = clavesDeclaraciones(declaraciones, hilos);
+
+    std::vector<std::vector<ParUnion>> parciales = algoritmo == AlgoritmoUnion::HASH_RADIX
+        ? unirHashRadix(construccion, sondeo, hilos, filtro)
+        : unirOrdenarMezclar(std::move(construccion), std::move(sondeo), hilos, filtro);
+
+    size_t total = 0;
+    for (const auto& p : parciales) total += p.size();
+    std::vector<ParUnion> pares;
+    pares.reserve(total);
+    for (const auto& p : parciales) pares.insert(pares.end(), p.begin(), p.end());
+    return pares;
+}
+
+std::vector<ParUnion> unirPorCedula(const std::vector<Persona>& personas, const std::vector<Declaracion>& declaraciones,
+                                    AlgoritmoUnion algoritmo, unsigned hilos, const FiltroUnion& filtro) {
+    return unirPorCedula(personas.data(), personas.size(), declaraciones, algoritmo, hilos, filtro);
+}
+
+std::vector<ParUnion> declarantesConDiscrepancia(const std::vector<Persona>& personas,
+                                                 const std::vector<Declaracion>& declaraciones, double porcentaje,
+                                                 AlgoritmoUnion algoritmo, unsigned hilos) {
+    const double fraccion = porcentaje / 100.0;
+    return unirPorCedula(personas, declaraciones, algoritmo, hilos, [&](uint32_t p, uint32_t d) {
+        const Persona& persona = personas[p];
+        if (!persona.getDeclaranteRenta()) return false;
+        const double ingresos = persona.getIngresosAnuales();
+        return std::fabs(declaraciones[d].ingresosDeclarados - ingresos) > fraccion * ingresos;
+    });
+}
+
+// ============================================================================
+// COMPARACIÓN
+// ============================================================================
+
+static double mediana(std::vector<double> tiempos) {
+    std::sort(tiempos.begin(), tiempos.end());
+    size_t n = tiempos.size();
+    return n % 2 ? tiempos[n / 2] : (tiempos[n / 2 - 1] + tiempos[n / 2]) / 2;
+}
+
+std::vector<PuntoUnion> compararAlgoritmosUnion(const std::vector<Persona>& personas,
+                                                const ConfiguracionDeclaraciones& configuracion,
+                                                const std::vector<size_t>& tamanos, const std::vector<unsigned>& hilos,
+                                                size_t repeticiones) {
+    repeticiones = std::max<size_t>(1, repeticiones);
+    std::vector<PuntoUnion> puntos;
+    for (size_t tamano : tamanos) {
+        tamano = std::min(tamano, personas.size());
+        std::vector<Declaracion> declaraciones = generarDeclaraciones(personas.data(), tamano, configuracion);
+        for (unsigned h : hilos) {
+            PuntoUnion punto;
+            punto.personas = tamano;
+            punto.declaraciones = declaraciones.size();
+            punto.hilos = h;
+
+            // Intercaladas para que la deriva térmica afecte igual a ambas
+            std::vector<double> tiemposHash, tiemposOrdenar;
+            std::vector<ParUnion> paresHash, paresOrdenar;
+            for (size_t r = 0; r < repeticiones; ++r) {
+                auto t0 = std::chrono::steady_clock::now();
+                paresHash = unirPorCedula(personas.data(), tamano, declaraciones, AlgoritmoUnion::HASH_RADIX, h, nullptr);
+                auto t1 = std::chrono::steady_clock::now();
+                paresOrdenar = unirPorCedula(personas.data(), tamano, declaraciones, AlgoritmoUnion::ORDENAR_MEZCLAR, h, nullptr);
+                auto t2 = std::chrono::steady_clock::now();
+                tiemposHash.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+                tiemposOrdenar.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+            }
+            punto.hashMs = mediana(tiemposHash);
+            punto.ordenarMezclarMs = mediana(tiemposOrdenar);
+            punto.pares = paresHash.size();
+            std::sort(paresHash.begin(), paresHash.end());
+            std::sort(paresOrdenar.begin(), paresOrdenar.end());
+            punto.coinciden = paresHash == paresOrdenar;
+            puntos.push_back(punto);
+        }
+    }
+    return puntos;
+}
+
+void mostrarComparacionUnion(const std::vector<PuntoUnion>& puntos, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+
+    salida << "\n=== UNIÓN POR CÉDULA: HASH RADIX VS ORDENAR Y MEZCLAR (mediana, ms) ===\n";
+    salida << std::right << std::setw(12) << "Personas" << std::setw(14) << "Declaraciones" << std::setw(7) << "Hilos"
+           << std::setw(12) << "Pares" << std::setw(12) << "Hash" << std::setw(12) << "Ord+Mezcla" << std::setw(11)
+           << "Relación" << std::setw(14) << "Mtuplas/s" << "\n";
+    salida << std::fixed;
+    for (const auto& p : puntos) {
+        const double mejor = std::min(p.hashMs, p.ordenarMezclarMs);
+        salida << std::setw(12) << p.personas << std::setw(14) << p.declaraciones << std::setw(7) << p.hilos
+               << std::setw(12) << p.pares << std::setprecision(2) << std::setw(12) << p.hashMs << std::setw(12)
+               << p.ordenarMezclarMs << std::setw(9) << p.ordenarMezclarMs / p.hashMs << "x" << std::setw(14)
+               << (p.personas + p.declaraciones) / (mejor * 1000.0)
+               << (p.coinciden ? "" : "  ¡PARES DISTINTOS!") << "\n";
+    }
+    salida << "Relación = ordenar y mezclar / hash (> 1: hash más rápido). Mtuplas/s con el mejor algoritmo.\n";
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
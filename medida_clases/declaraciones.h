@@ -0,0 +1,121 @@
+#ifndef DECLARACIONES_H
+#define DECLARACIONES_H
+
+#include "persona.h"
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// DECLARACIONES DE RENTA Y UNIÓN POR CÉDULA
+// ============================================================================
+// Segunda tabla: declaraciones anuales de renta con la cédula como clave
+// foránea hacia Persona. Cada persona tiene varias (una por año declarado),
+// algunas declaran ingresos distintos de ingresosAnuales y hay declaraciones
+// huérfanas cuya cédula no está en la colección.
+//
+// La unión por cédula tiene dos implementaciones:
+//   - Hash con particionado radix: ambas tablas se reparten por los bits
+//     altos del hash de la clave en particiones cuya tabla hash cabe en L2;
+//     cada partición se construye y se sondea sin fallos de caché.
+//   - Ordenar y mezclar: ambas tablas se ordenan por cédula y se recorren
+//     a la par.
+// Las dos reparten el trabajo entre hilos y devuelven los mismos pares.
+// ============================================================================
+
+/**
+ * Declaración de renta de un año (32 bytes).
+ */
+struct Declaracion {
+    uint64_t cedula;            // Numérica: la de Persona convertida una vez
+    double ingresosDeclarados;
+    double impuestoPagado;
+    uint16_t anio;
+};
+
+struct ConfiguracionDeclaraciones {
+    int maximoPorPersona = 5;          // Años declarados: 1..máximo (años recientes)
+    double porcentajeHuerfanas = 3.0;  // Sobre el total generado
+    double porcentajeDiscrepantes = 8.0; // Declaraciones con ingresos alterados entre 15% y 60%
+    uint64_t semilla = 2024;
+};
+
+/**
+ * Genera las declaraciones de las personas dadas, en orden aleatorio.
+ *
+ * NOTA: Los no declarantes también pueden tener declaraciones (años en que
+ *       sí declararon); usa su propio generador y no altera rand()
+ * @throws std::invalid_argument si la configuración no es válida
+ */
+std::vector<Declaracion> generarDeclaraciones(const std::vector<Persona>& personas,
+                                              const ConfiguracionDeclaraciones& configuracion);
+
+enum class AlgoritmoUnion { HASH_RADIX, ORDENAR_MEZCLAR };
+
+const char* nombreAlgoritmo(AlgoritmoUnion algoritmo);
+
+/**
+ * Par de filas unidas (índices en personas y en declaraciones).
+ */
+struct ParUnion {
+    uint32_t persona;
+    uint32_t declaracion;
+
+    bool operator<(const ParUnion& otro) const {
+        return persona != otro.persona ? persona < otro.persona : declaracion < otro.declaracion;
+    }
+    bool operator==(const ParUnion& otro) const {
+        return persona == otro.persona && declaracion == otro.declaracion;
+    }
+};
+
+/**
+ * Condición sobre un par unido; vacía = todos los pares.
+ */
+using FiltroUnion = std::function<bool(uint32_t filaPersona, uint32_t filaDeclaracion)>;
+
+/**
+ * Une personas y declaraciones por cédula.
+ *
+ * ORDEN: El de los pares depende del algoritmo y de los hilos
+ * NOTA: Las cédulas no numéricas no se unen con nada
+ * @throws std::invalid_argument si alguna tabla supera 2^32 - 1 filas
+ */
+std::vector<ParUnion> unirPorCedula(const std::vector<Persona>& personas, const std::vector<Declaracion>& declaraciones,
+                                    AlgoritmoUnion algoritmo, unsigned hilos, const FiltroUnion& filtro = nullptr);
+
+/**
+ * Declarantes cuyo ingreso declarado difiere de ingresosAnuales en más del
+ * porcentaje dado (en cualquier dirección).
+ */
+std::vector<ParUnion> declarantesConDiscrepancia(const std::vector<Persona>& personas,
+                                                 const std::vector<Declaracion>& declaraciones, double porcentaje,
+                                                 AlgoritmoUnion algoritmo, unsigned hilos);
+
+/**
+ * Una medición de la comparación hash vs ordenar y mezclar.
+ */
+struct PuntoUnion {
+    size_t personas = 0;
+    size_t declaraciones = 0;
+    unsigned hilos = 1;
+    size_t pares = 0;
+    double hashMs = 0.0;          // Mediana
+    double ordenarMezclarMs = 0.0; // Mediana
+    bool coinciden = true;        // Mismos pares con ambos algoritmos
+};
+
+/**
+ * Mide ambos algoritmos sobre prefijos de personas (con sus declaraciones
+ * generadas) para cada tamaño y número de hilos.
+ */
+std::vector<PuntoUnion> compararAlgoritmosUnion(const std::vector<Persona>& personas,
+                                                const ConfiguracionDeclaraciones& configuracion,
+                                                const std::vector<size_t>& tamanos, const std::vector<unsigned>& hilos,
+                                                size_t repeticiones);
+
+void mostrarComparacionUnion(const std::vector<PuntoUnion>& puntos, std::ostream& salida = std::cout);
+
+#endif // DECLARACIONES_H
@@ -0,0 +1,193 @@
+#ifndef DICCIONARIOS_H
+#define DICCIONARIOS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// ============================================================================
+// DICCIONARIOS CON HASH PERFECTO MÍNIMO (CIUDADES, NOMBRES Y APELLIDOS)
+// ============================================================================
+// Los catálogos de la generación son listas fijas conocidas al compilar, así
+// que su función hash se busca también al compilar (constexpr), con el
+// esquema de dos niveles "hash y desplazamiento" (CHD):
+//   1. La firma de cada clave (longitud, dos primeros y dos últimos bytes)
+//      la reparte en N/2 cubetas.
+//   2. Cada cubeta guarda una semilla elegida para que sus claves caigan en
+//      ranuras libres de una tabla de exactamente N ranuras.
+// Traducir un texto a su código del catálogo es entonces: firma -> cubeta ->
+// semilla -> ranura -> una comparación de verificación, con N ranuras y N/2
+// semillas por catálogo y sin ranuras vacías.
+// Si alguna vez un catálogo nuevo no admite semillas, la compilación falla
+// en la construcción de su diccionario.
+//
+// Los códigos son las posiciones en el catálogo, los mismos que usan
+// generarPersona() y el conjunto virtual.
+// ============================================================================
+
+// Principales ciudades colombianas ordenadas por población e importancia económica
+constexpr const char* CIUDADES_COLOMBIA[] = {
+    "Bogotá", "Medellín", "Cali", "Barranquilla", "Cartagena", "Bucaramanga", "Pereira", "Santa Marta", "Cúcuta", "Ibagué",
+    "Manizales", "Pasto", "Neiva", "Villavicencio", "Armenia", "Sincelejo", "Valledupar", "Montería", "Popayán", "Tunja"
+};
+
+// Nombres femeninos más populares en Colombia según registros civiles
+constexpr const char* NOMBRES_FEMENINOS[] = {
+    "María", "Luisa", "Carmen", "Ana", "Sofía", "Isabel", "Laura", "Andrea", "Paula", "Valentina",
+    "Camila", "Daniela", "Carolina", "Fernanda", "Gabriela", "Patricia", "Claudia", "Diana", "Lucía", "Ximena"
+};
+
+// Nombres masculinos más populares en Colombia según registros civiles
+constexpr const char* NOMBRES_MASCULINOS[] = {
+    "Juan", "Carlos", "José", "James", "Andrés", "Miguel", "Luis", "Pedro", "Alejandro", "Ricardo",
+    "Felipe", "David", "Jorge", "Santiago", "Daniel", "Fernando", "Diego", "Rafael", "Martín", "Óscar",
+    "Edison", "Nestor", "Gertridis"
+};
+
+// Apellidos más comunes en Colombia basados en estadísticas del DANE
+constexpr const char* APELLIDOS[] = {
+    "Gómez", "Rodríguez", "Martínez", "López", "García", "Pérez", "González", "Sánchez", "Ramírez", "Torres",
+    "Díaz", "Vargas", "Castro", "Ruiz", "Álvarez", "Romero", "Suárez", "Rojas", "Moreno", "Muñoz", "Valencia",
+};
+
+/**
+ * Firma de 40 bits de un texto: longitud y dos bytes de cada extremo.
+ *
+ * NOTA: Solo separa las claves del catálogo; un texto ajeno puede tener la
+ *       misma firma que una clave, por eso la búsqueda siempre verifica
+ */
+constexpr uint64_t firmaTexto(const char* datos, size_t largo) {
+    if (largo == 0) return 0;
+    const size_t segundo = largo > 1 ? 1 : 0;
+    return static_cast<uint64_t>(largo & 0xFF) |
+           static_cast<uint64_t>(static_cast<unsigned char>(datos[0])) << 8 |
+           static_cast<uint64_t>(static_cast<unsigned char>(datos[segundo])) << 16 |
+           static_cast<uint64_t>(static_cast<unsigned char>(datos[largo - 1])) << 24 |
+           static_cast<uint64_t>(static_cast<unsigned char>(datos[largo - 1 - segundo])) << 32;
+}
+
+/**
+ * Mezcla de 64 bits de una firma con una semilla (finalizador de splitmix64).
+ */
+constexpr uint64_t mezclarFirma(uint64_t firma, uint64_t semilla) {
+    uint64_t x = firma + semilla * 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/** h reducido a [0, n) con una multiplicación en vez de una división. */
+constexpr size_t reducirRango(uint64_t h, size_t n) {
+    return static_cast<size_t>(((h >> 32) * n) >> 32);
+}
+
+/**
+ * Catálogo fijo con su función hash perfecta mínima.
+ *
+ * PROPÓSITO: Validar y codificar textos de catálogo en la carga masiva sin
+ *            recorrer la lista ni calcular un hash de todos los bytes
+ * IMPLEMENTACIÓN: El constructor es constexpr: reparte las firmas en
+ *                 cubetas y, de la más llena a la más vacía, prueba semillas
+ *                 hasta que todas las claves de la cubeta caen en ranuras
+ *                 aún libres de la tabla de N ranuras
+ * @throws std::logic_error (al compilar, si se construye como constexpr) si
+ *         dos claves tienen la misma firma o alguna cubeta no admite semilla
+ */
+template <size_t N>
+class DiccionarioPerfecto {
+    static_assert(N > 0 && N < 256, "El código de una clave debe caber en un byte");
+
+public:
+    static const size_t CUBETAS = (N + 1) / 2;
+
+    constexpr explicit DiccionarioPerfecto(const char* const (&entradas)[N])
+        : claves(entradas), largos{}, semillas{}, codigos{} {
+        uint64_t firmas[N] = {};
+        for (size_t i = 0; i < N; ++i) {
+            size_t largo = 0;
+            while (entradas[i][largo] != '\0') ++largo;
+            if (largo == 0 || largo > 255) throw std::logic_error("Clave de catálogo vacía o de más de 255 bytes");
+            largos[i] = static_cast<uint8_t>(largo);
+            firmas[i] = firmaTexto(entradas[i], largo);
+            for (size_t j = 0; j < i; ++j) {
+                if (firmas[j] == firmas[i]) throw std::logic_error("Dos claves del catálogo tienen la misma firma");
+            }
+        }
+
+        size_t cubetaDe[N] = {};
+        size_t tamanoCubeta[CUBETAS] = {};
+        for (size_t i = 0; i < N; ++i) {
+            cubetaDe[i] = reducirRango(mezclarFirma(firmas[i], 0), CUBETAS);
+            ++tamanoCubeta[cubetaDe[i]];
+        }
+
+        // Las cubetas grandes primero, mientras la tabla tiene más ranuras libres
+        bool ocupada[N] = {};
+        for (size_t tamano = N; tamano > 0; --tamano) {
+            for (size_t c = 0; c < CUBETAS; ++c) {
+                if (tamanoCubeta[c] != tamano) continue;
+                bool ubicada = false;
+                for (uint32_t semilla = 1; semilla <= SEMILLA_MAXIMA && !ubicada; ++semilla) {
+                    size_t ranuras[N] = {};
+                    size_t tomadas = 0;
+                    bool choca = false;
+                    for (size_t i = 0; i < N && !choca; ++i) {
+                        if (cubetaDe[i] != c) continue;
+                        const size_t ranura = reducirRango(mezclarFirma(firmas[i], semilla), N);
+                        choca = ocupada[ranura];
+                        for (size_t t = 0; t < tomadas && !choca; ++t) choca = ranuras[t] == ranura;
+                        ranuras[tomadas++] = ranura;
+                    }
+                    if (choca) continue;
+                    for (size_t i = 0, t = 0; i < N; ++i) {
+                        if (cubetaDe[i] != c) continue;
+                        ocupada[ranuras[t]] = true;
+                        codigos[ranuras[t++]] = static_cast<uint8_t>(i);
+                    }
+                    semillas[c] = static_cast<uint16_t>(semilla);
+                    ubicada = true;
+                }
+                if (!ubicada) throw std::logic_error("Ninguna semilla ubica una cubeta del catálogo");
+            }
+        }
+    }
+
+    /** Código de la clave (posición en el catálogo) o -1. */
+    int codigo(const char* datos, size_t largo) const {
+        const uint64_t firma = firmaTexto(datos, largo);
+        const uint16_t semilla = semillas[reducirRango(mezclarFirma(firma, 0), CUBETAS)];
+        const uint8_t c = codigos[reducirRango(mezclarFirma(firma, semilla), N)];
+        if (largos[c] != largo || std::memcmp(claves[c], datos, largo) != 0) return -1;
+        return c;
+    }
+    int codigo(const std::string& texto) const { return codigo(texto.data(), texto.size()); }
+
+    const char* clave(size_t codigo) const { return claves[codigo]; }
+    constexpr size_t tamano() const { return N; }
+
+    /** Bytes de las tablas de búsqueda (semillas y códigos), sin las claves. */
+    constexpr size_t bytesTablas() const { return sizeof(semillas) + sizeof(codigos); }
+
+private:
+    static const uint32_t SEMILLA_MAXIMA = 65535;
+
+    const char* const* claves;
+    uint8_t largos[N];
+    uint16_t semillas[CUBETAS]; // Por cubeta
+    uint8_t codigos[N];         // Código de la clave en cada ranura (todas ocupadas)
+};
+
+template <size_t N>
+constexpr DiccionarioPerfecto<N> diccionarioPerfecto(const char* const (&entradas)[N]) {
+    return DiccionarioPerfecto<N>(entradas);
+}
+
+// Construidos al compilar: un catálogo sin función perfecta no compila
+constexpr auto DICCIONARIO_CIUDADES = diccionarioPerfecto(CIUDADES_COLOMBIA);
+constexpr auto DICCIONARIO_NOMBRES_FEMENINOS = diccionarioPerfecto(NOMBRES_FEMENINOS);
+constexpr auto DICCIONARIO_NOMBRES_MASCULINOS = diccionarioPerfecto(NOMBRES_MASCULINOS);
+constexpr auto DICCIONARIO_APELLIDOS = diccionarioPerfecto(APELLIDOS);
+
+#endif // DICCIONARIOS_H
@@ -0,0 +1,191 @@
+#include "esquema_grupos.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static const uint8_t SIN_GRUPO = 0xFF; // Marca de sufijo no asignado durante la compilación
+
+static std::string recortar(const std::string& texto) {
+    size_t inicio = texto.find_first_not_of(" \t\r");
+    if (inicio == std::string::npos) return "";
+    size_t fin = texto.find_last_not_of(" \t\r");
+    return texto.substr(inicio, fin - inicio + 1);
+}
+
+/**
+ * Entero no negativo de solo dígitos (sin signo ni espacios internos).
+ */
+static bool leerNumero(const std::string& texto, uint64_t& valor) {
+    if (texto.empty() || texto.size() > 18) return false;
+    valor = 0;
+    for (char ch : texto) {
+        if (ch < '0' || ch > '9') return false;
+        valor = valor * 10 + static_cast<uint64_t>(ch - '0');
+    }
+    return true;
+}
+
+static std::string sufijoConCeros(uint64_t sufijo, int digitos) {
+    std::string texto = std::to_string(sufijo);
+    return std::string(digitos > static_cast<int>(texto.size()) ? digitos - texto.size() : 0, '0') + texto;
+}
+
+EsquemaGrupos EsquemaGrupos::predeterminado() {
+    return desdeTexto("nombre=Predeterminado (00-39 A, 40-79 B, 80-99 C)\n"
+                      "digitos=2\n"
+                      "A=00-39\n"
+                      "B=40-79\n"
+                      "C=80-99\n",
+                      "esquema predeterminado");
+}
+
+EsquemaGrupos EsquemaGrupos::desdeTexto(const std::string& texto, const std::string& origen) {
+    auto error = [&origen](size_t numeroLinea, const std::string& detalle) {
+        return std::invalid_argument(origen + (numeroLinea ? ", línea " + std::to_string(numeroLinea) : "") + ": " + detalle);
+    };
+
+    EsquemaGrupos esquema;
+    std::vector<std::pair<std::string, size_t>> reglas; // Rangos de cada grupo y su línea, en orden
+    std::istringstream lineas(texto);
+    std::string linea;
+    for (size_t numeroLinea = 1; std::getline(lineas, linea); ++numeroLinea) {
+        linea = recortar(linea.substr(0, linea.find('#')));
+        if (linea.empty()) continue;
+        size_t igual = linea.find('=');
+        if (igual == std::string::npos) throw error(numeroLinea, "se esperaba clave=valor");
+        std::string clave = recortar(linea.substr(0, igual));
+        std::string valor = recortar(linea.substr(igual + 1));
+
+        if (clave == "nombre") {
+            esquema.titulo = valor;
+        } else if (clave == "digitos") {
+            uint64_t k = 0;
+            if (!leerNumero(valor, k) || k < 1 || k > DIGITOS_MAXIMOS) {
+                throw error(numeroLinea, "digitos debe estar entre 1 y " + std::to_string(DIGITOS_MAXIMOS));
+            }
+            esquema.k = static_cast<int>(k);
+        } else {
+            if (clave.empty() || clave.find_first_of(" ,") != std::string::npos) {
+                throw error(numeroLinea, "nombre de grupo inválido: '" + clave + "'");
+            }
+            if (esquema.codigoDeNombre(clave) >= 0) throw error(numeroLinea, "grupo repetido: " + clave);
+            if (esquema.nombres.size() == GRUPOS_MAXIMOS) {
+                throw error(numeroLinea, "más de " + std::to_string(GRUPOS_MAXIMOS) + " grupos");
+            }
+            esquema.nombres.push_back(clave);
+            reglas.emplace_back(valor, numeroLinea);
+        }
+    }
+    if (esquema.k == 0) throw error(0, "falta digitos=");
+    if (esquema.nombres.empty()) throw error(0, "no define ningún grupo");
+
+    // Compilación: cada rango escribe su código en la tabla
+    for (int i = 0; i < esquema.k; ++i) esquema.modulo *= 10;
+    esquema.tabla.assign(esquema.modulo, SIN_GRUPO);
+    for (size_t g = 0; g < reglas.size(); ++g) {
+        std::istringstream rangos(reglas[g].first);
+        std::string rango;
+        while (std::getline(rangos, rango, ',')) {
+            rango = recortar(rango);
+            size_t guion = rango.find('-');
+            uint64_t desde = 0, hasta = 0;
+            bool valido;
+            if (guion == std::string::npos) {
+                valido = leerNumero(rango, desde);
+                hasta = desde;
+            } else {
+                valido = leerNumero(recortar(rango.substr(0, guion)), desde) &&
+                         leerNumero(recortar(rango.substr(guion + 1)), hasta);
+            }
+            if (!valido || desde > hasta || hasta >= esquema.modulo) {
+                throw error(reglas[g].second, "rango inválido '" + rango + "' (sufijos de 0 a " +
+                                                  std::to_string(esquema.modulo - 1) + ")");
+            }
+            for (uint64_t s = desde; s <= hasta; ++s) {
+                if (esquema.tabla[s] != SIN_GRUPO) {
+                    throw error(reglas[g].second, "el sufijo " + sufijoConCeros(s, esquema.k) + " ya está en el grupo " +
+                                                      esquema.nombres[esquema.tabla[s]]);
+                }
+                esquema.tabla[s] = static_cast<uint8_t>(g);
+            }
+        }
+    }
+    for (uint64_t s = 0; s < esquema.modulo; ++s) {
+        if (esquema.tabla[s] == SIN_GRUPO) throw error(0, "el sufijo " + sufijoConCeros(s, esquema.k) + " no tiene grupo");
+    }
+    if (esquema.titulo.empty()) esquema.titulo = origen;
+    return esquema;
+}
+
+EsquemaGrupos EsquemaGrupos::desdeArchivo(const std::string& ruta) {
+    std::ifstream archivo(ruta);
+    if (!archivo) throw std::runtime_error("No se pudo abrir " + ruta);
+    std::ostringstream contenido;
+    contenido << archivo.rdbuf();
+    return desdeTexto(contenido.str(), ruta);
+}
+
+int EsquemaGrupos::codigoDeNombre(const std::string& grupo) const {
+    for (size_t g = 0; g < nombres.size(); ++g) {
+        if (nombres[g] == grupo) return static_cast<int>(g);
+    }
+    return -1;
+}
+
+uint8_t EsquemaGrupos::codigo(const std::string& cedula) const {
+    if (cedula.size() < static_cast<size_t>(k)) {
+        throw std::invalid_argument("La cédula debe tener al menos " + std::to_string(k) + " dígitos");
+    }
+    // Sufijo sin ramas por dígito: los no dígitos solo encienden una marca
+    const char* p = cedula.data() + cedula.size() - k;
+    uint64_t sufijo = 0;
+    unsigned noDigito = 0;
+    for (int i = 0; i < k; ++i) {
+        unsigned d = static_cast<unsigned>(static_cast<unsigned char>(p[i])) - '0';
+        noDigito |= d > 9;
+        sufijo = sufijo * 10 + d;
+    }
+    if (noDigito) throw std::invalid_argument("La cédula debe terminar en " + std::to_string(k) + " dígitos: " + cedula);
+    return tabla[sufijo];
+}
+
+std::string EsquemaGrupos::listaGrupos() const {
+    std::string lista;
+    for (size_t g = 0; g < nombres.size(); ++g) {
+        if (g > 0) lista += g + 1 == nombres.size() ? " o " : ", ";
+        lista += nombres[g];
+    }
+    return lista;
+}
+
+std::string EsquemaGrupos::describir() const {
+    std::string texto = "nombre=" + titulo + "\ndigitos=" + std::to_string(k) + "\n";
+    for (size_t g = 0; g < nombres.size(); ++g) {
+        texto += nombres[g] + "=";
+        bool primero = true;
+        for (uint64_t s = 0; s < modulo; ++s) {
+            if (tabla[s] != g || (s > 0 && tabla[s - 1] == g)) continue; // Solo inicios de tramo
+            uint64_t fin = s;
+            while (fin + 1 < modulo && tabla[fin + 1] == g) ++fin;
+            texto += (primero ? "" : ",") + sufijoConCeros(s, k);
+            if (fin > s) texto += "-" + sufijoConCeros(fin, k);
+            primero = false;
+        }
+        texto += "\n";
+    }
+    return texto;
+}
+
+static std::shared_ptr<const EsquemaGrupos>& esquemaActivo() {
+    static std::shared_ptr<const EsquemaGrupos> esquema = std::make_shared<const EsquemaGrupos>(EsquemaGrupos::predeterminado());
+    return esquema;
+}
+
+std::shared_ptr<const EsquemaGrupos> esquemaGruposActivo() {
+    return std::atomic_load(&esquemaActivo());
+}
+
+void activarEsquemaGrupos(EsquemaGrupos esquema) {
+    // El anterior se libera cuando la última operación que lo usa suelta su instantánea
+    std::atomic_store(&esquemaActivo(), std::make_shared<const EsquemaGrupos>(std::move(esquema)));
+}
@@ -0,0 +1,109 @@
+#ifndef ESQUEMA_GRUPOS_H
+#define ESQUEMA_GRUPOS_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// ESQUEMAS DE GRUPOS DE DECLARACIÓN
+// ============================================================================
+// El grupo de una persona sale de los últimos k dígitos de su cédula. Las
+// reglas cambian cada año (otros cortes, más grupos, otros dígitos), así que
+// se describen en un archivo de texto y se compilan al cargarlo en una tabla
+// densa de 10^k códigos: clasificar es leer tabla[cédula % 10^k], sin
+// comparaciones por rango.
+//
+// Formato (líneas "clave=valor"; '#' inicia un comentario):
+//   nombre=Reglas 2025
+//   digitos=2
+//   A=00-39
+//   B=40-79
+//   C=80-99
+// Cada grupo lista uno o más rangos "desde-hasta" (o sufijos sueltos)
+// separados por comas. Los rangos deben cubrir cada sufijo exactamente una
+// vez; los grupos conservan el orden del archivo.
+// ============================================================================
+
+/**
+ * Reglas de clasificación compiladas en una tabla.
+ *
+ * NOTA: Es inmutable una vez construida; varias lecturas concurrentes son seguras
+ */
+class EsquemaGrupos {
+public:
+    static const int DIGITOS_MAXIMOS = 6;   // Tabla de hasta 1 MB
+    static const size_t GRUPOS_MAXIMOS = 255;
+
+    /** Las reglas originales: dos dígitos, 00-39 A, 40-79 B, 80-99 C. */
+    static EsquemaGrupos predeterminado();
+
+    /**
+     * @param origen Nombre para los mensajes de error (ej. la ruta)
+     * @throws std::invalid_argument si el texto no es válido o los rangos
+     *         dejan sufijos sin grupo o con más de uno
+     */
+    static EsquemaGrupos desdeTexto(const std::string& texto, const std::string& origen = "esquema");
+
+    /**
+     * @throws std::runtime_error si no se puede leer el archivo
+     * @throws std::invalid_argument como desdeTexto
+     */
+    static EsquemaGrupos desdeArchivo(const std::string& ruta);
+
+    const std::string& nombre() const { return titulo; }
+    int digitos() const { return k; }
+    size_t numeroGrupos() const { return nombres.size(); }
+    const std::string& nombreGrupo(size_t codigo) const { return nombres[codigo]; }
+    const std::vector<std::string>& grupos() const { return nombres; }
+
+    /** Código del grupo con ese nombre; -1 si el esquema no lo tiene. */
+    int codigoDeNombre(const std::string& grupo) const;
+
+    /** Código del sufijo (cédula % 10^k, ya reducida). */
+    uint8_t codigoDeSufijo(uint64_t sufijo) const { return tabla[sufijo]; }
+
+    /**
+     * Código del grupo de una cédula en texto: k dígitos finales y una
+     * lectura de la tabla.
+     *
+     * @throws std::invalid_argument si tiene menos de k caracteres o sus
+     *         últimos k no son dígitos
+     */
+    uint8_t codigo(const std::string& cedula) const;
+
+    /** Nombre del grupo de una cédula (sin copiar el texto). */
+    const std::string& clasificar(const std::string& cedula) const { return nombres[codigo(cedula)]; }
+
+    /** "A, B o C" para los mensajes del menú. */
+    std::string listaGrupos() const;
+
+    /** Reglas en el formato del archivo (rangos reconstruidos desde la tabla). */
+    std::string describir() const;
+
+private:
+    EsquemaGrupos() = default;
+
+    std::string titulo;
+    int k = 0;
+    uint64_t modulo = 1;              // 10^k
+    std::vector<uint8_t> tabla;       // Código de cada sufijo
+    std::vector<std::string> nombres; // Por código
+};
+
+/**
+ * Esquema con que se generan y verifican las personas (el predeterminado
+ * mientras no se active otro).
+ *
+ * IMPLEMENTACIÓN: Devuelve una instantánea compartida; una operación la toma
+ *                 una vez y la usa en todas sus filas, así que activar otro
+ *                 esquema mientras tanto (ej. con el precálculo en otro
+ *                 hilo) no cambia ni libera el que está usando
+ * ADVERTENCIA: Cambiarlo no reclasifica los datos ya generados; la
+ *              verificación mostrará cuáles no siguen las reglas nuevas
+ */
+std::shared_ptr<const EsquemaGrupos> esquemaGruposActivo();
+void activarEsquemaGrupos(EsquemaGrupos esquema);
+
+#endif // ESQUEMA_GRUPOS_H
@@ -1,9 +1,14 @@
 #include "generador.h"
+#include "diccionarios.h"
+#include "esquema_grupos.h"
 #include <cstdlib>   // rand(), srand()
 #include <ctime>     // time()
 #include <random>    // std::mt19937, std::uniform_real_distribution
 #include <vector>
 #include <algorithm> // std::find_if
+#include <iterator>  // std::begin, std::end
+#include <cmath>     // std::ceil
+#include <cstdint>   // SIZE_MAX
 
 // ========================================================================
 // BASES DE DATOS PARA GENERACIÓN REALISTA DE PERSONAS COLOMBIANAS
@@ -11,30 +16,17 @@
 // Estas bases de datos contienen nombres, apellidos y ciudades comunes
 // en Colombia para generar datos realistas y representativos del país.
 
-// Nombres femeninos más populares en Colombia según registros civiles
-const std::vector<std::string> nombresFemeninos = {
-    "María", "Luisa", "Carmen", "Ana", "Sofía", "Isabel", "Laura", "Andrea", "Paula", "Valentina",
-    "Camila", "Daniela", "Carolina", "Fernanda", "Gabriela", "Patricia", "Claudia", "Diana", "Lucía", "Ximena"
-};
+// Las listas están en diccionarios.h, junto con sus funciones hash perfectas;
+// aquí se copian como std::string una vez al arrancar
+const std::vector<std::string> nombresFemeninos(std::begin(NOMBRES_FEMENINOS), std::end(NOMBRES_FEMENINOS));
+const std::vector<std::string> nombresMasculinos(std::begin(NOMBRES_MASCULINOS), std::end(NOMBRES_MASCULINOS));
+const std::vector<std::string> apellidos(std::begin(APELLIDOS), std::end(APELLIDOS));
+const std::vector<std::string> ciudadesColombia(std::begin(CIUDADES_COLOMBIA), std::end(CIUDADES_COLOMBIA));
 
-// Nombres masculinos más populares en Colombia según registros civiles
-const std::vector<std::string> nombresMasculinos = {
-    "Juan", "Carlos", "José", "James", "Andrés", "Miguel", "Luis", "Pedro", "Alejandro", "Ricardo",
-    "Felipe", "David", "Jorge", "Santiago", "Daniel", "Fernando", "Diego", "Rafael", "Martín", "Óscar",
-    "Edison", "Nestor", "Gertridis"
-};
-
-// Apellidos más comunes en Colombia basados en estadísticas del DANE
-const std::vector<std::string> apellidos = {
-    "Gómez", "Rodríguez", "Martínez", "López", "García", "Pérez", "González", "Sánchez", "Ramírez", "Torres",
-    "Díaz", "Vargas", "Castro", "Ruiz", "Álvarez", "Romero", "Suárez", "Rojas", "Moreno", "Muñoz", "Valencia",
-};
-
-// Principales ciudades colombianas ordenadas por población e importancia económica
-const std::vector<std::string> ciudadesColombia = {
-    "Bogotá", "Medellín", "Cali", "Barranquilla", "Cartagena", "Bucaramanga", "Pereira", "Santa Marta", "Cúcuta", "Ibagué",
-    "Manizales", "Pasto", "Neiva", "Villavicencio", "Armenia", "Sincelejo", "Valledupar", "Montería", "Popayán", "Tunja"
-};
+const std::vector<std::string>& catalogoNombresFemeninos() { return nombresFemeninos; }
+const std::vector<std::string>& catalogoNombresMasculinos() { return nombresMasculinos; }
+const std::vector<std::string>& catalogoApellidos() { return apellidos; }
+const std::vector<std::string>& catalogoCiudades() { return ciudadesColombia; }
 
 // ========================================================================
 // FUNCIONES DE VALIDACIÓN Y UTILIDAD
@@ -46,11 +38,11 @@ const std::vector<std::string> ciudadesColombia = {
  * @param ciudad Nombre de la ciudad a validar
  * @return true si la ciudad es válida, false en caso contrario
  * 
- * COMPLEJIDAD: O(n) donde n es el número de ciudades
+ * COMPLEJIDAD: O(1): hash perfecto del catálogo y una comparación
  * USO: Validación de entrada en formularios y APIs
  */
 bool ciudadValida(const std::string& ciudad) {
-    return std::find(ciudadesColombia.begin(), ciudadesColombia.end(), ciudad) != ciudadesColombia.end();
+    return DICCIONARIO_CIUDADES.codigo(ciudad) >= 0;
 }
 
 // ========================================================================
@@ -125,13 +117,12 @@ double randomDouble(double min, double max) {
  * 3. Construye apellido compuesto (dos apellidos aleatorios)
  * 4. Genera ID secuencial único
  * 5. Asigna ciudad aleatoria de Colombia
- * 6. Calcula grupo de declaración basado en últimos 2 dígitos del ID
+ * 6. Calcula grupo de declaración con los últimos dígitos del ID
  * 7. Genera datos financieros realistas con correlaciones lógicas
  * 
- * LÓGICA DE GRUPOS:
- * - Grupo A: ID termina en 00-39 (40% de la población)
- * - Grupo B: ID termina en 40-79 (40% de la población)  
- * - Grupo C: ID termina en 80-99 (20% de la población)
+ * LÓGICA DE GRUPOS (esquema activo, ver esquema_grupos.h):
+ * - Predeterminado: 00-39 A (40%), 40-79 B (40%), 80-99 C (20%)
+ * - Una lectura de la tabla del esquema, sin cadena de comparaciones
  * 
  * DATOS FINANCIEROS REALISTAS:
  * - Ingresos: 10M-500M COP (rango clase media-alta colombiana)
@@ -142,6 +133,10 @@ double randomDouble(double min, double max) {
  * @return Objeto Persona completamente inicializado
  */
 Persona generarPersona() {
+    return generarPersona(*esquemaGruposActivo());
+}
+
+Persona generarPersona(const EsquemaGrupos& esquema) {
     // Decide si es hombre o mujer (50% probabilidad cada uno)
     bool esHombre = rand() % 2;
     
@@ -160,18 +155,8 @@ Persona generarPersona() {
     std::string ciudad = ciudadesColombia[rand() % ciudadesColombia.size()];
     std::string fecha = generarFechaNacimiento();
 
-    // Calcula grupo de declaración basado en los últimos 2 dígitos del ID
-    int ultDigitos = std::stoi(id.substr(id.length() - 2));
-    std::string grupo;
-
-    // Asigna el grupo según las reglas establecidas
-    if (ultDigitos >= 0 && ultDigitos <= 39) {
-        grupo = "A";        // 40% de la población
-    } else if (ultDigitos >= 40 && ultDigitos <= 79) {
-        grupo = "B";        // 40% de la población
-    } else {
-        grupo = "C";        // 20% de la población
-    }
+    // Grupo de declaración según los últimos dígitos del ID (esquema recibido)
+    const std::string& grupo = esquema.clasificar(id);
 
     // Calcula edad aproximada basada en el año de nacimiento
     int edad = 2025 - std::stoi(fecha.substr(fecha.find_last_of('/') + 1));
@@ -195,22 +180,67 @@ Persona generarPersona() {
  * - push_back: construcción eficiente de objetos
  * 
  * @param n Número de personas a generar
+ * @param control Token de cancelación y progreso (revisados por fragmento)
  * @return Vector con n personas generadas aleatoriamente
+ * @throws OperacionCancelada si se cancela antes de terminar
  * 
  * COMPLEJIDAD: O(n) tiempo, O(n) espacio
  * USO: Creación de datasets para pruebas, simulaciones, benchmarks
  */
-std::vector<Persona> generarColeccion(int n) {
+std::vector<Persona> generarColeccion(size_t n, const ControlOperacion& control) {
     std::vector<Persona> personas;
     personas.reserve(n); // Reserva espacio para n personas (eficiencia)
     
-    for (int i = 0; i < n; ++i) {
-        personas.push_back(generarPersona());
+    // Genera por fragmentos; entre fragmentos se revisa cancelación y progreso
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo(); // Uno solo para toda la colección
+    const size_t total = n;
+    for (size_t inicio = 0; inicio < total; inicio += control.tamFragmento) {
+        control.avanzar(inicio, total);
+        size_t fin = std::min(total, inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            personas.push_back(generarPersona(*esquema));
+        }
     }
+    control.avanzar(total, total);
     
     return personas;
 }
 
+/**
+ * Memoria dinámica de un std::string de la longitud dada.
+ * 
+ * NOTA: Hasta 15 bytes caben en el búfer interno (libstdc++); por encima se
+ * reserva longitud + 1 y malloc redondea a 16 con 8 bytes de cabecera.
+ */
+static size_t memoriaTexto(size_t longitud) {
+    if (longitud <= 15) return 0;
+    return std::max<size_t>(32, (longitud + 1 + 8 + 15) / 16 * 16);
+}
+
+// Promedio de memoriaTexto sobre una lista de valores equiprobables
+static double memoriaPromedio(const std::vector<std::string>& valores) {
+    double suma = 0.0;
+    for (const auto& v : valores) suma += memoriaTexto(v.size());
+    return suma / valores.size();
+}
+
+size_t estimarMemoriaColeccion(size_t n) {
+    // Apellido compuesto: todas las parejas son equiprobables
+    double apellido = 0.0;
+    for (const auto& a : apellidos) {
+        for (const auto& b : apellidos) apellido += memoriaTexto(a.size() + 1 + b.size());
+    }
+    apellido /= apellidos.size() * apellidos.size();
+
+    // ID (10 dígitos), fecha (DD/MM/AAAA) y grupo siempre caben en el búfer interno
+    double porPersona = sizeof(Persona) + apellido + memoriaPromedio(ciudadesColombia) +
+                        (memoriaPromedio(nombresFemeninos) + memoriaPromedio(nombresMasculinos)) / 2;
+
+    size_t bytesPorPersona = static_cast<size_t>(std::ceil(porPersona));
+    if (n > SIZE_MAX / bytesPorPersona) return SIZE_MAX;
+    return n * bytesPorPersona;
+}
+
 // ========================================================================
 // FUNCIONES DE BÚSQUEDA Y CONSULTA
 // ========================================================================
@@ -247,6 +277,44 @@ const Persona* buscarPorID(const std::vector<Persona>& personas, const std::stri
 // BÚSQUEDAS DE PERSONA MÁS LONGEVA
 // ========================================================================
 
+/**
+ * Posición del máximo de valor(persona), recorriendo por fragmentos
+ * cancelables. Ante empates gana la primera, como std::max_element.
+ */
+template <typename Valor>
+static size_t posicionMaximo(const std::vector<Persona>& personas, Valor valor, const ControlOperacion& control) {
+    size_t mejor = 0;
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            if (valor(personas[mejor]) < valor(personas[i])) mejor = i;
+        }
+    }
+    control.avanzar(personas.size(), personas.size());
+    return mejor;
+}
+
+/**
+ * Copias de las personas que cumplen el criterio, por fragmentos cancelables.
+ */
+template <typename Criterio>
+static std::vector<Persona> filtrarCopias(const std::vector<Persona>& personas, Criterio cumple, const ControlOperacion& control) {
+    std::vector<Persona> filtradas;
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            if (cumple(personas[i])) filtradas.push_back(personas[i]);
+        }
+    }
+    control.avanzar(personas.size(), personas.size());
+    return filtradas;
+}
+
+static int edadDe(const Persona& p) { return p.getEdad(); }
+static double patrimonioDe(const Persona& p) { return p.getPatrimonio(); }
+
 /**
  * Busca la persona más longeva (VERSIÓN POR VALOR).
  * 
@@ -263,9 +331,8 @@ const Persona* buscarPorID(const std::vector<Persona>& personas, const std::stri
  * 
  * COMPLEJIDAD: O(n) tiempo, O(n) espacio adicional
  */
-Persona buscarMasLongevoPorValor(std::vector<Persona> personas) {
-    return *std::max_element(personas.begin(), personas.end(),
-        [](const Persona& a, const Persona& b) { return a.getEdad() < b.getEdad(); });
+Persona buscarMasLongevoPorValor(std::vector<Persona> personas, const ControlOperacion& control) {
+    return personas[posicionMaximo(personas, edadDe, control)];
 }
 
 /**
@@ -308,14 +375,11 @@ const Persona* buscarMasLongevoPorReferencia(const std::vector<Persona>& persona
  * 
  * COMPLEJIDAD: O(n) tiempo, O(k) espacio donde k = personas en la ciudad
  */
-Persona buscarMasLongevoPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad) {
+Persona buscarMasLongevoPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad,
+                                         const ControlOperacion& control) {
     // Filtrar solo personas de la ciudad especificada
-    std::vector<Persona> filtradas;
-    for (const auto& p : personas) {
-        if (p.getCiudadNacimiento() == ciudad) {
-            filtradas.push_back(p);
-        }
-    }
+    std::vector<Persona> filtradas = filtrarCopias(personas,
+        [&](const Persona& p) { return p.getCiudadNacimiento() == ciudad; }, control);
 
     if (filtradas.empty()) {
         throw std::runtime_error("No hay personas registradas en la ciudad: " + ciudad);
@@ -329,7 +393,7 @@ Persona buscarMasLongevoPorValorEnCiudad(std::vector<Persona> personas, const st
 /**
  * Busca la persona más longeva en una ciudad específica (VERSIÓN POR REFERENCIA).
  * 
- * OPTIMIZACIÓN: Usa vector de punteros para evitar copiar objetos Persona
+ * OPTIMIZACIÓN: Filtra números de fila (uint32_t) para evitar copiar objetos Persona
  * 
  * @param personas Vector de personas (referencia constante)
  * @param ciudad Ciudad donde buscar
@@ -339,11 +403,11 @@ Persona buscarMasLongevoPorValorEnCiudad(std::vector<Persona> personas, const st
  * VENTAJA: Más eficiente en memoria que la versión por valor
  */
 const Persona* buscarMasLongevoPorReferenciaEnCiudad(const std::vector<Persona>& personas, const std::string& ciudad) {
-    // Filtrar usando punteros para mayor eficiencia
-    std::vector<const Persona*> filtradas;
-    for (const auto& p : personas) {
-        if (p.getCiudadNacimiento() == ciudad) {
-            filtradas.push_back(&p);
+    // Filtrar por número de fila (4 bytes por coincidencia)
+    SeleccionFilas filtradas;
+    for (uint32_t fila = 0; fila < personas.size(); ++fila) {
+        if (personas[fila].getCiudadNacimiento() == ciudad) {
+            filtradas.push_back(fila);
         }
     }
 
@@ -351,9 +415,9 @@ const Persona* buscarMasLongevoPorReferenciaEnCiudad(const std::vector<Persona>&
         throw std::runtime_error("No hay personas registradas en la ciudad: " + ciudad);
     }
 
-    // Buscar el más longevo usando comparación de punteros
-    return *std::max_element(filtradas.begin(), filtradas.end(),
-        [](const Persona* a, const Persona* b) { return a->getEdad() < b->getEdad(); });
+    // Buscar el más longevo entre las filas filtradas
+    return &personas[*std::max_element(filtradas.begin(), filtradas.end(),
+        [&](uint32_t a, uint32_t b) { return personas[a].getEdad() < personas[b].getEdad(); })];
 }
 
 // ========================================================================
@@ -364,9 +428,8 @@ const Persona* buscarMasLongevoPorReferenciaEnCiudad(const std::vector<Persona>&
  * Busca la persona con mayor patrimonio (VERSIÓN POR VALOR).
  * Similar a buscarMasLongevoPorValor pero comparando patrimonio.
  */
-Persona buscarMasPatrimonioPorValor(std::vector<Persona> personas) {
-    return *std::max_element(personas.begin(), personas.end(),
-        [](const Persona& a, const Persona& b) { return a.getPatrimonio() < b.getPatrimonio(); });
+Persona buscarMasPatrimonioPorValor(std::vector<Persona> personas, const ControlOperacion& control) {
+    return personas[posicionMaximo(personas, patrimonioDe, control)];
 }
 
 /**
@@ -397,14 +460,11 @@ const Persona* buscarMasPatrimonioPorReferencia(const std::vector<Persona>& pers
  * 
  * COMPLEJIDAD: O(n) tiempo, O(k) espacio donde k = personas en la ciudad
  */
-Persona buscarMasPatrimonioPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad) {
+Persona buscarMasPatrimonioPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad,
+                                            const ControlOperacion& control) {
     // Filtrar solo personas de la ciudad especificada
-    std::vector<Persona> filtradas;
-    for (const auto& p : personas) {
-        if (p.getCiudadNacimiento() == ciudad) {
-            filtradas.push_back(p);
-        }
-    }
+    std::vector<Persona> filtradas = filtrarCopias(personas,
+        [&](const Persona& p) { return p.getCiudadNacimiento() == ciudad; }, control);
 
     if (filtradas.empty()) {
         throw std::runtime_error("No hay personas registradas en la ciudad: " + ciudad);
@@ -418,7 +478,7 @@ Persona buscarMasPatrimonioPorValorEnCiudad(std::vector<Persona> personas, const
 /**
  * Busca la persona con mayor patrimonio en una ciudad específica (VERSIÓN POR REFERENCIA).
  * 
- * OPTIMIZACIÓN: Usa vector de punteros para evitar copiar objetos Persona
+ * OPTIMIZACIÓN: Filtra números de fila (uint32_t) para evitar copiar objetos Persona
  * 
  * @param personas Vector de personas (referencia constante)
  * @param ciudad Ciudad donde buscar
@@ -428,11 +488,11 @@ Persona buscarMasPatrimonioPorValorEnCiudad(std::vector<Persona> personas, const
  * VENTAJA: Más eficiente en memoria que la versión por valor
  */
 const Persona* buscarMasPatrimonioPorReferenciaEnCiudad(const std::vector<Persona>& personas, const std::string& ciudad) {
-    // Filtrar usando punteros para mayor eficiencia
-    std::vector<const Persona*> filtradas;
-    for (const auto& p : personas) {
-        if (p.getCiudadNacimiento() == ciudad) {
-            filtradas.push_back(&p);
+    // Filtrar por número de fila (4 bytes por coincidencia)
+    SeleccionFilas filtradas;
+    for (uint32_t fila = 0; fila < personas.size(); ++fila) {
+        if (personas[fila].getCiudadNacimiento() == ciudad) {
+            filtradas.push_back(fila);
         }
     }
 
@@ -440,9 +500,9 @@ const Persona* buscarMasPatrimonioPorReferenciaEnCiudad(const std::vector<Person
         throw std::runtime_error("No hay personas registradas en la ciudad: " + ciudad);
     }
 
-    // Buscar el más rico usando comparación de punteros
-    return *std::max_element(filtradas.begin(), filtradas.end(),
-        [](const Persona* a, const Persona* b) { return a->getPatrimonio() < b->getPatrimonio(); });
+    // Buscar el más rico entre las filas filtradas
+    return &personas[*std::max_element(filtradas.begin(), filtradas.end(),
+        [&](uint32_t a, uint32_t b) { return personas[a].getPatrimonio() < personas[b].getPatrimonio(); })];
 }
 
 /**
@@ -460,14 +520,11 @@ const Persona* buscarMasPatrimonioPorReferenciaEnCiudad(const std::vector<Person
  * 
  * COMPLEJIDAD: O(n) tiempo, O(k) espacio donde k = personas en el grupo
  */
-Persona buscarMasPatrimonioPorValorEnGrupo(std::vector<Persona> personas, const std::string& grupo) {
+Persona buscarMasPatrimonioPorValorEnGrupo(std::vector<Persona> personas, const std::string& grupo,
+                                           const ControlOperacion& control) {
     // Filtrar solo personas del grupo especificado
-    std::vector<Persona> filtradas;
-    for (const auto& p : personas) {
-        if (p.getGrupoDeclaracion() == grupo) {
-            filtradas.push_back(p);
-        }
-    }
+    std::vector<Persona> filtradas = filtrarCopias(personas,
+        [&](const Persona& p) { return p.getGrupoDeclaracion() == grupo; }, control);
 
     if (filtradas.empty()) {
         throw std::runtime_error("No hay personas registradas en el grupo: " + grupo);
@@ -481,7 +538,7 @@ Persona buscarMasPatrimonioPorValorEnGrupo(std::vector<Persona> personas, const
 /**
  * Busca la persona con mayor patrimonio en un grupo específico (VERSIÓN POR REFERENCIA).
  * 
- * OPTIMIZACIÓN: Usa vector de punteros para evitar copiar objetos Persona
+ * OPTIMIZACIÓN: Filtra números de fila (uint32_t) para evitar copiar objetos Persona
  * 
  * @param personas Vector de personas (referencia constante)
  * @param grupo Grupo de declaración donde buscar
@@ -491,11 +548,11 @@ Persona buscarMasPatrimonioPorValorEnGrupo(std::vector<Persona> personas, const
  * VENTAJA: Más eficiente en memoria que la versión por valor
  */
 const Persona* buscarMasPatrimonioPorReferenciaEnGrupo(const std::vector<Persona>& personas, const std::string& grupo) {
-    // Filtrar usando punteros para mayor eficiencia
-    std::vector<const Persona*> filtradas;
-    for (const auto& p : personas) {
-        if (p.getGrupoDeclaracion() == grupo) {
-            filtradas.push_back(&p);
+    // Filtrar por número de fila (4 bytes por coincidencia)
+    SeleccionFilas filtradas;
+    for (uint32_t fila = 0; fila < personas.size(); ++fila) {
+        if (personas[fila].getGrupoDeclaracion() == grupo) {
+            filtradas.push_back(fila);
         }
     }
 
@@ -503,14 +560,17 @@ const Persona* buscarMasPatrimonioPorReferenciaEnGrupo(const std::vector<Persona
         throw std::runtime_error("No hay personas registradas en el grupo: " + grupo);
     }
 
-    // Buscar el más rico usando comparación de punteros
-    return *std::max_element(filtradas.begin(), filtradas.end(),
-        [](const Persona* a, const Persona* b) { return a->getPatrimonio() < b->getPatrimonio(); });
+    // Buscar el más rico entre las filas filtradas
+    return &personas[*std::max_element(filtradas.begin(), filtradas.end(),
+        [&](uint32_t a, uint32_t b) { return personas[a].getPatrimonio() < personas[b].getPatrimonio(); })];
 }
 
 /**
  * Lista y cuenta personas de un grupo (por valor).
  * 
+ * NOTA: Solo filtra; la impresión se hace después sobre el resultado
+ * (ver seleccion.h) para no mezclar E/S con el recorrido.
+ * 
  * @param personas  Vector de personas.
  * @param grupo     Grupo de declaración a filtrar (ej. "A", "B", "C").
  * @return Vector con las personas del grupo especificado.
@@ -519,7 +579,6 @@ std::vector<Persona> listarPersonasPorValorEnGrupo(std::vector<Persona> personas
     std::vector<Persona> filtradas;
     for (const auto& p : personas) {
         if (p.getGrupoDeclaracion() == grupo) {
-            p.mostrarResumen();
             filtradas.push_back(p);
         }
     }
@@ -529,18 +588,20 @@ std::vector<Persona> listarPersonasPorValorEnGrupo(std::vector<Persona> personas
 /**
  * Lista y cuenta personas de un grupo (por referencia).
  * 
+ * NOTA: Solo filtra; la impresión se hace después sobre el resultado.
+ * 
  * @param personas  Vector de personas.
  * @param grupo     Grupo de declaración a filtrar.
- * @return Vector de punteros a personas del grupo especificado.
+ * @return Filas de las personas del grupo especificado.
  */
-std::vector<const Persona*> listarPersonasPorReferenciaEnGrupo(const std::vector<Persona>& personas, const std::string& grupo) {
-    std::vector<const Persona*> filtradas;
-    for (const auto& p : personas) {
-        if (p.getGrupoDeclaracion() == grupo) {
-            p.mostrarResumen();
-            filtradas.push_back(&p);
+ConjuntoFilas listarPersonasPorReferenciaEnGrupo(const std::vector<Persona>& personas, const std::string& grupo) {
+    ConjuntoFilas filtradas(personas.size());
+    for (uint32_t fila = 0; fila < personas.size(); ++fila) {
+        if (personas[fila].getGrupoDeclaracion() == grupo) {
+            filtradas.agregar(fila);
         }
     }
+    filtradas.compactar();
     return filtradas;
 }
 
@@ -551,33 +612,21 @@ std::vector<const Persona*> listarPersonasPorReferenciaEnGrupo(const std::vector
 /**
  * Calcula el grupo de declaración correcto basado en los últimos dígitos de la cédula.
  * 
- * REGLAS DE ASIGNACIÓN:
- * - Últimos 2 dígitos 00-39: Grupo A (40% población)
- * - Últimos 2 dígitos 40-79: Grupo B (40% población)
- * - Últimos 2 dígitos 80-99: Grupo C (20% población)
+ * REGLAS DE ASIGNACIÓN: Las del esquema activo (por defecto, últimos 2
+ * dígitos 00-39 A, 40-79 B, 80-99 C), compiladas en una tabla por sufijo.
  * 
  * @param cedula Número de cédula como string
- * @return Grupo calculado ("A", "B", o "C")
- * @throws std::invalid_argument si la cédula tiene menos de 2 dígitos
+ * @return Grupo calculado según el esquema
+ * @throws std::invalid_argument si la cédula tiene menos dígitos que el esquema
  * 
  * USO: Verificación de consistencia de datos, auditorías
  */
 std::string calcularGrupoCorrectoPorCedula(const std::string& cedula) {
-    if (cedula.length() < 2) {
-        throw std::invalid_argument("La cédula debe tener al menos 2 dígitos");
-    }
-    
-    // Extraer los últimos 2 dígitos
-    int ultDigitos = std::stoi(cedula.substr(cedula.length() - 2));
-    
-    // Aplicar las reglas de asignación
-    if (ultDigitos >= 0 && ultDigitos <= 39) {
-        return "A";
-    } else if (ultDigitos >= 40 && ultDigitos <= 79) {
-        return "B";
-    } else { // 80-99
-        return "C";
-    }
+    return calcularGrupoCorrectoPorCedula(cedula, *esquemaGruposActivo());
+}
+
+std::string calcularGrupoCorrectoPorCedula(const std::string& cedula, const EsquemaGrupos& esquema) {
+    return esquema.clasificar(cedula);
 }
 
 // ========================================================================
@@ -600,9 +649,14 @@ std::string calcularGrupoCorrectoPorCedula(const std::string& cedula) {
  * DESVENTAJAS: Costo de copia del objeto
  */
 bool verificarGrupoPorValor(Persona persona) {
+    return verificarGrupoPorValor(std::move(persona), *esquemaGruposActivo());
+}
+
+bool verificarGrupoPorValor(Persona persona, const EsquemaGrupos& esquema) {
     try {
-        std::string grupoCalculado = calcularGrupoCorrectoPorCedula(persona.getId());
-        std::string grupoAsignado = persona.getGrupoDeclaracion();
+        // Consulta a la tabla del esquema; el nombre no se copia
+        const std::string& grupoCalculado = esquema.clasificar(persona.getId());
+        const std::string& grupoAsignado = persona.getGrupoDeclaracion();
         
         bool esCorrect = (grupoCalculado == grupoAsignado);
         
@@ -625,9 +679,14 @@ bool verificarGrupoPorValor(Persona persona) {
  * COMPLEJIDAD: O(1) tiempo, O(1) espacio adicional
  */
 bool verificarGrupoPorReferencia(const Persona& persona) {
+    return verificarGrupoPorReferencia(persona, *esquemaGruposActivo());
+}
+
+bool verificarGrupoPorReferencia(const Persona& persona, const EsquemaGrupos& esquema) {
     try {
-        std::string grupoCalculado = calcularGrupoCorrectoPorCedula(persona.getId());
-        std::string grupoAsignado = persona.getGrupoDeclaracion();
+        // Consulta a la tabla del esquema; el nombre no se copia
+        const std::string& grupoCalculado = esquema.clasificar(persona.getId());
+        const std::string& grupoAsignado = persona.getGrupoDeclaracion();
         
         bool esCorrect = (grupoCalculado == grupoAsignado);
         
@@ -655,23 +714,25 @@ bool verificarGrupoPorReferencia(const Persona& persona) {
  * SALIDA: Imprime estadísticas detalladas en consola
  * USO: Auditorías de calidad de datos, validación de sistemas
  */
-void verificarGruposMasivoPorValor(std::vector<Persona> personas) {
+void verificarGruposMasivoPorValor(std::vector<Persona> personas, const ControlOperacion& control) {
     std::vector<bool> resultados;
-    int correctos = 0;
-    int incorrectos = 0;
+    size_t correctos = 0;
+    size_t incorrectos = 0;
     
     std::cout << "\n=== VERIFICACIÓN MASIVA POR VALOR ===" << std::endl;
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo(); // Uno solo para toda la pasada
     
-    for (const auto& persona : personas) {
-        bool resultado = verificarGrupoPorValor(persona);
-        resultados.push_back(resultado);
-        
-        if (resultado) {
-            correctos++;
-        } else {
-            incorrectos++;
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            bool resultado = verificarGrupoPorValor(personas[i], *esquema);
+            resultados.push_back(resultado);
+            correctos += resultado; // Sin rama por fila
         }
     }
+    incorrectos = personas.size() - correctos;
+    control.avanzar(personas.size(), personas.size());
     
     std::cout << "\n--- RESUMEN VERIFICACIÓN MASIVA ---" << std::endl;
     std::cout << "Total personas verificadas: " << personas.size() << std::endl;
@@ -691,23 +752,25 @@ void verificarGruposMasivoPorValor(std::vector<Persona> personas) {
  * 
  * VENTAJA: Significativamente más rápido para datasets grandes
  */
-void verificarGruposMasivoPorReferencia(const std::vector<Persona>& personas) {
+void verificarGruposMasivoPorReferencia(const std::vector<Persona>& personas, const ControlOperacion& control) {
     std::vector<bool> resultados;
-    int correctos = 0;
-    int incorrectos = 0;
+    size_t correctos = 0;
+    size_t incorrectos = 0;
     
     std::cout << "\n=== VERIFICACIÓN MASIVA POR REFERENCIA ===" << std::endl;
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo(); // Uno solo para toda la pasada
     
-    for (const auto& persona : personas) {
-        bool resultado = verificarGrupoPorReferencia(persona);
-        resultados.push_back(resultado);
-        
-        if (resultado) {
-            correctos++;
-        } else {
-            incorrectos++;
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            bool resultado = verificarGrupoPorReferencia(personas[i], *esquema);
+            resultados.push_back(resultado);
+            correctos += resultado; // Sin rama por fila
         }
     }
+    incorrectos = personas.size() - correctos;
+    control.avanzar(personas.size(), personas.size());
     
     std::cout << "\n--- RESUMEN VERIFICACIÓN MASIVA ---" << std::endl;
     std::cout << "Total personas verificadas: " << personas.size() << std::endl;
@@ -721,13 +784,61 @@ void verificarGruposMasivoPorReferencia(const std::vector<Persona>& personas) {
 // ANÁLISIS ESTADÍSTICO POR GRUPOS
 // ========================================================================
 
+/**
+ * Sumas y conteos por grupo acumulados en una sola pasada.
+ * 
+ * CÓMO: Un casillero por grupo del esquema activo, en su orden; los pocos
+ * nombres se comparan en secuencia. Un grupo que el esquema no conoce
+ * (datos generados con otras reglas) recibe un casillero nuevo al final.
+ */
+class AcumuladorGrupos {
+public:
+    AcumuladorGrupos() : grupos(esquemaGruposActivo()->grupos()), sumas(grupos.size(), 0.0), conteos(grupos.size(), 0) {}
+
+    void agregar(const std::string& grupo, double valor) {
+        size_t g = 0;
+        while (g < grupos.size() && grupos[g] != grupo) ++g;
+        if (g == grupos.size()) {
+            grupos.push_back(grupo);
+            sumas.push_back(0.0);
+            conteos.push_back(0);
+        }
+        sumas[g] += valor;
+        conteos[g]++;
+    }
+
+    /**
+     * Imprime el promedio de cada grupo con personas y devuelve el mayor
+     * (vacío si ninguno supera 0).
+     */
+    std::string mayorPromedio(const std::string& campo) const {
+        std::string grupoMayor;
+        double mayorPromedio = 0.0;
+        for (size_t g = 0; g < grupos.size(); ++g) {
+            if (conteos[g] == 0) continue;
+            double promedio = sumas[g] / conteos[g];
+            std::cout << "Grupo " << grupos[g] << " - Promedio " << campo << ": " << promedio << std::endl;
+            if (promedio > mayorPromedio) {
+                mayorPromedio = promedio;
+                grupoMayor = grupos[g];
+            }
+        }
+        return grupoMayor;
+    }
+
+private:
+    std::vector<std::string> grupos;
+    std::vector<double> sumas;
+    std::vector<size_t> conteos;
+};
+
 /**
  * Encuentra el grupo con mayor patrimonio promedio (VERSIÓN POR VALOR).
  * 
  * ALGORITMO:
- * 1. Itera sobre cada grupo (A, B, C)
- * 2. Filtra personas de cada grupo
- * 3. Calcula promedio de patrimonio
+ * 1. Recorre la colección una sola vez (copiando cada persona)
+ * 2. Acumula patrimonio y conteo en el casillero de su grupo
+ * 3. Calcula el promedio de cada grupo
  * 4. Determina el grupo con mayor promedio
  * 
  * @param personas Vector de personas (copiado)
@@ -736,50 +847,30 @@ void verificarGruposMasivoPorReferencia(const std::vector<Persona>& personas) {
  * SALIDA: Imprime promedios de cada grupo para análisis
  * USO: Análisis socioeconómico, segmentación de mercado
  */
-std::string encontrarGrupoMayorPatrimonioPorValor(std::vector<Persona> personas) {
-    
-    std::vector<std::string> grupos = {"A", "B", "C"};
-    std::string grupoMayor;
-    double mayorPromedio = 0.0;
-    std::vector<Persona> filtradas;
-    
-    for (auto grupo : grupos) {
-        // Filtrar personas del grupo actual
-        for (auto p : personas) {
-            if (p.getGrupoDeclaracion() == grupo) {
-                filtradas.push_back(p);
-            }
-        }
-
-        if (filtradas.empty()) continue;
-        
-        // Calcular promedio de patrimonio del grupo
-        double sumaPatrimonio = 0.0;
-        for (const auto& p : filtradas) {
-            sumaPatrimonio += p.getPatrimonio();
-        }
-        double promedio = sumaPatrimonio / filtradas.size();
-
-        std::cout << "Grupo " << grupo << " - Promedio Patrimonio: " << promedio << std::endl;
-        
-        // Actualizar grupo con mayor promedio
-        if (promedio > mayorPromedio) {
-            mayorPromedio = promedio;
-            grupoMayor = grupo;
+std::string encontrarGrupoMayorPatrimonioPorValor(std::vector<Persona> personas, const ControlOperacion& control) {
+    AcumuladorGrupos acumulador;
+
+    // Todos los grupos en la misma pasada (por fragmentos cancelables)
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            auto p = personas[i];
+            acumulador.agregar(p.getGrupoDeclaracion(), p.getPatrimonio());
         }
-        filtradas.clear();
     }
-    
-    return grupoMayor;
+    control.avanzar(personas.size(), personas.size());
+
+    return acumulador.mayorPromedio("Patrimonio");
 }
 
 /**
  * Encuentra el grupo con mayor patrimonio promedio (VERSIÓN POR REFERENCIA).
  * 
  * ALGORITMO:
- * 1. Itera sobre cada grupo (A, B, C)
- * 2. Filtra personas de cada grupo usando punteros
- * 3. Calcula promedio de patrimonio
+ * 1. Recorre la colección una sola vez (referencias, sin copias)
+ * 2. Acumula patrimonio y conteo en el casillero de su grupo
+ * 3. Calcula el promedio de cada grupo
  * 4. Determina el grupo con mayor promedio
  * 
  * @param personas Vector de personas (referencia constante)
@@ -788,49 +879,30 @@ std::string encontrarGrupoMayorPatrimonioPorValor(std::vector<Persona> personas)
  * SALIDA: Imprime promedios de cada grupo para análisis
  * USO: Análisis socioeconómico, segmentación de mercado
  */
-std::string encontrarGrupoMayorPatrimonioPorReferencia(const std::vector<Persona>& personas) {
-    std::vector<std::string> grupos = {"A", "B", "C"};
-    std::string grupoMayor;
-    double mayorPromedio = 0.0;
-    std::vector<const Persona*> filtradas;
-
-    for (const auto& grupo : grupos) {
-        // Filtrar personas del grupo actual usando punteros
-        for (const auto& p : personas) {
-            if (p.getGrupoDeclaracion() == grupo) {
-                filtradas.push_back(&p);
-            }
+std::string encontrarGrupoMayorPatrimonioPorReferencia(const std::vector<Persona>& personas, const ControlOperacion& control) {
+    AcumuladorGrupos acumulador;
+
+    // Todos los grupos en la misma pasada (por fragmentos cancelables)
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            const Persona& p = personas[i];
+            acumulador.agregar(p.getGrupoDeclaracion(), p.getPatrimonio());
         }
-
-        if (filtradas.empty()) continue;
-
-        // Calcular promedio de patrimonio del grupo
-        double sumaPatrimonio = 0.0;
-        for (const auto& p : filtradas) {
-            sumaPatrimonio += p->getPatrimonio();
-        }
-        double promedio = sumaPatrimonio / filtradas.size();
-
-        std::cout << "Grupo " << grupo << " - Promedio Patrimonio: " << promedio << std::endl;
-
-        // Actualizar grupo con mayor promedio
-        if (promedio > mayorPromedio) {
-            mayorPromedio = promedio;
-            grupoMayor = grupo;
-        }
-        filtradas.clear();
     }
+    control.avanzar(personas.size(), personas.size());
 
-    return grupoMayor;
+    return acumulador.mayorPromedio("Patrimonio");
 }
 
 /**
  * Encuentra el grupo con mayor longevidad promedio (VERSIÓN POR VALOR).
  * 
  * ALGORITMO:
- * 1. Itera sobre cada grupo (A, B, C)
- * 2. Filtra personas de cada grupo
- * 3. Calcula promedio de edad
+ * 1. Recorre la colección una sola vez (copiando cada persona)
+ * 2. Acumula edad y conteo en el casillero de su grupo
+ * 3. Calcula el promedio de cada grupo
  * 4. Determina el grupo con mayor promedio
  * 
  * @param personas Vector de personas (copiado)
@@ -839,49 +911,30 @@ std::string encontrarGrupoMayorPatrimonioPorReferencia(const std::vector<Persona
  * SALIDA: Imprime promedios de cada grupo para análisis
  * USO: Análisis socioeconómico, segmentación de mercado
  */
-std::string encontrarGrupoMayorLongevidadPorValor(std::vector<Persona> personas) {
-    
-    std::vector<std::string> grupos = {"A", "B", "C"};
-    std::string grupoMayor;
-    double mayorPromedio = 0.0;
-    std::vector<Persona> filtradas;
-    for (auto grupo : grupos) {
-        // Filtrar personas del grupo actual
-        for (auto p : personas) {
-            if (p.getGrupoDeclaracion() == grupo) {
-                filtradas.push_back(p);
-            }
-        }
-
-        if (filtradas.empty()) continue;
-        
-        // Calcular promedio de edad del grupo
-        double sumaEdad = 0.0;
-        for (const auto& p : filtradas) {
-            sumaEdad += p.getEdad();
+std::string encontrarGrupoMayorLongevidadPorValor(std::vector<Persona> personas, const ControlOperacion& control) {
+    AcumuladorGrupos acumulador;
+
+    // Todos los grupos en la misma pasada (por fragmentos cancelables)
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            auto p = personas[i];
+            acumulador.agregar(p.getGrupoDeclaracion(), p.getEdad());
         }
-        double promedio = sumaEdad / filtradas.size();
-
-        std::cout << "Grupo " << grupo << " - Promedio Edad: " << promedio << std::endl;
-        
-        // Actualizar grupo con mayor promedio
-        if (promedio > mayorPromedio) {
-            mayorPromedio = promedio;
-            grupoMayor = grupo;
-        }
-        filtradas.clear();
     }
-    
-    return grupoMayor;
+    control.avanzar(personas.size(), personas.size());
+
+    return acumulador.mayorPromedio("Edad");
 }
 
 /**
  * Encuentra el grupo con mayor longevidad promedio (VERSIÓN POR REFERENCIA).
  * 
  * ALGORITMO:
- * 1. Itera sobre cada grupo (A, B, C)
- * 2. Filtra personas de cada grupo usando punteros
- * 3. Calcula promedio de edad
+ * 1. Recorre la colección una sola vez (referencias, sin copias)
+ * 2. Acumula edad y conteo en el casillero de su grupo
+ * 3. Calcula el promedio de cada grupo
  * 4. Determina el grupo con mayor promedio
  * 
  * @param personas Vector de personas (referencia constante)
@@ -890,38 +943,19 @@ std::string encontrarGrupoMayorLongevidadPorValor(std::vector<Persona> personas)
  * SALIDA: Imprime promedios de cada grupo para análisis
  * USO: Análisis socioeconómico, segmentación de mercado
  */
-std::string encontrarGrupoMayorLongevidadPorReferencia(const std::vector<Persona>& personas) {
-    std::vector<std::string> grupos = {"A", "B", "C"};
-    std::string grupoMayor;
-    double mayorPromedio = 0.0;
-    std::vector<const Persona*> filtradas;
-
-    for (const auto& grupo : grupos) {
-        // Filtrar personas del grupo actual usando punteros
-        for (const auto& p : personas) {
-            if (p.getGrupoDeclaracion() == grupo) {
-                filtradas.push_back(&p);
-            }
-        }
-
-        if (filtradas.empty()) continue;
-
-        // Calcular promedio de edad del grupo
-        double sumaEdad = 0.0;
-        for (const auto& p : filtradas) {
-            sumaEdad += p->getEdad();
-        }
-        double promedio = sumaEdad / filtradas.size();
-
-        std::cout << "Grupo " << grupo << " - Promedio Edad: " << promedio << std::endl;
-
-        // Actualizar grupo con mayor promedio
-        if (promedio > mayorPromedio) {
-            mayorPromedio = promedio;
-            grupoMayor = grupo;
+std::string encontrarGrupoMayorLongevidadPorReferencia(const std::vector<Persona>& personas, const ControlOperacion& control) {
+    AcumuladorGrupos acumulador;
+
+    // Todos los grupos en la misma pasada (por fragmentos cancelables)
+    for (size_t inicio = 0; inicio < personas.size(); inicio += control.tamFragmento) {
+        control.avanzar(inicio, personas.size());
+        size_t fin = std::min(personas.size(), inicio + control.tamFragmento);
+        for (size_t i = inicio; i < fin; ++i) {
+            const Persona& p = personas[i];
+            acumulador.agregar(p.getGrupoDeclaracion(), p.getEdad());
         }
-        filtradas.clear();
     }
+    control.avanzar(personas.size(), personas.size());
 
-    return grupoMayor;
+    return acumulador.mayorPromedio("Edad");
 }
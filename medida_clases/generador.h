@@ -2,6 +2,9 @@
 #define GENERADOR_H
 
 #include "persona.h"
+#include "cancelacion.h"
+#include "esquema_grupos.h"
+#include "seleccion.h"
 #include <vector>
 
 // ============================================================================
@@ -23,11 +26,22 @@
  * @return true si la ciudad es válida, false en caso contrario
  * 
  * PROPÓSITO: Garantizar que solo se usen ciudades válidas en el sistema
- * IMPLEMENTACIÓN: Compara contra una lista de ciudades permitidas
+ * IMPLEMENTACIÓN: Hash perfecto sobre la lista de ciudades (diccionarios.h)
  * USO: Validación de entrada antes de asignar ciudad a una persona
  */
 bool ciudadValida(const std::string& ciudad);
 
+/**
+ * Catálogos usados por generarPersona().
+ * 
+ * PROPÓSITO: Que otros generadores (p. ej. el conjunto virtual) elijan de las
+ *            mismas listas y produzcan personas indistinguibles
+ */
+const std::vector<std::string>& catalogoNombresFemeninos();
+const std::vector<std::string>& catalogoNombresMasculinos();
+const std::vector<std::string>& catalogoApellidos();
+const std::vector<std::string>& catalogoCiudades();
+
 /**
  * Genera una fecha de nacimiento aleatoria entre 1960 y 2010.
  * 
@@ -83,19 +97,36 @@ double randomDouble(double min, double max);
  * USO: Crear personas individuales para pruebas o poblado de datos
  */
 Persona generarPersona();
+Persona generarPersona(const EsquemaGrupos& esquema); // Con una instantánea ya tomada
 
 /**
  * Genera una colección de n personas con datos aleatorios.
  * 
- * @param n Número de personas a generar (debe ser > 0)
+ * @param n Número de personas a generar (debe ser > 0; admite más de 2^31)
+ * @param control Cancelación y progreso opcionales, revisados por fragmento
  * @return Vector conteniendo n personas generadas
+ * @throws OperacionCancelada si el token se activa durante la generación
  * 
  * PROPÓSITO: Crear conjuntos de datos de diferentes tamaños para pruebas
- * IMPLEMENTACIÓN: Llama a generarPersona() n veces
+ * IMPLEMENTACIÓN: Llama a generarPersona() n veces, con el esquema de grupos
+ *                 tomado una sola vez para toda la colección
  * EFICIENCIA: O(n) en tiempo, cada persona se genera independientemente
  * USO: Pruebas de rendimiento, análisis estadísticos, poblado masivo de datos
  */
-std::vector<Persona> generarColeccion(int n);
+std::vector<Persona> generarColeccion(size_t n, const ControlOperacion& control = ControlOperacion());
+
+/**
+ * Estima la memoria que ocupará generarColeccion(n), antes de generar.
+ * 
+ * @param n Número de personas
+ * @return Bytes estimados (SIZE_MAX si el cálculo se desborda)
+ * 
+ * PROPÓSITO: Fallar de inmediato en lugar de agotar la RAM tras minutos de trabajo
+ * IMPLEMENTACIÓN: sizeof(Persona) por fila (el vector se reserva exacto) más el
+ *                 promedio de memoria dinámica de los textos que no caben en el
+ *                 búfer interno de std::string, calculado sobre los diccionarios
+ */
+size_t estimarMemoriaColeccion(size_t n);
 
 // ============================================================================
 // FUNCIONES DE BÚSQUEDA BÁSICA
@@ -125,13 +156,14 @@ const Persona* buscarPorID(const std::vector<Persona>& personas, const std::stri
  * 
  * @param personas Vector de personas (copia por valor)
  * @return Copia de la persona más longeva
+ * @throws OperacionCancelada si el token se activa durante el recorrido
  * 
  * PROPÓSITO: Identificar la persona de mayor edad en la colección
  * IMPLEMENTACIÓN: Recorre todo el vector comparando edades
  * COMPLEJIDAD: O(n) tiempo, O(n) espacio (por la copia)
  * NOTA: Menos eficiente que la versión por referencia
  */
-Persona buscarMasLongevoPorValor(std::vector<Persona> personas);
+Persona buscarMasLongevoPorValor(std::vector<Persona> personas, const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra la persona más longeva (mayor edad) - versión por referencia.
@@ -152,13 +184,15 @@ const Persona* buscarMasLongevoPorReferencia(const std::vector<Persona>& persona
  * @param personas Vector de personas (copia por valor)
  * @param ciudad Ciudad donde buscar
  * @return Copia de la persona más longeva en esa ciudad
+ * @throws OperacionCancelada si el token se activa durante el recorrido
  * 
  * PROPÓSITO: Análisis demográfico por ubicación geográfica
  * IMPLEMENTACIÓN: Filtra por ciudad y luego busca el máximo
  * COMPLEJIDAD: O(n) tiempo, O(n) espacio
  * USO: Estadísticas regionales, análisis por ciudad
  */
-Persona buscarMasLongevoPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad);
+Persona buscarMasLongevoPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad,
+                                         const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra la persona más longeva en una ciudad específica - versión por referencia.
@@ -183,12 +217,13 @@ const Persona* buscarMasLongevoPorReferenciaEnCiudad(const std::vector<Persona>&
  * 
  * @param personas Vector de personas (copia por valor)
  * @return Copia de la persona con mayor patrimonio
+ * @throws OperacionCancelada si el token se activa durante el recorrido
  * 
  * PROPÓSITO: Identificar la persona más adinerada
  * IMPLEMENTACIÓN: Recorre comparando valores de patrimonio
  * USO: Análisis financiero, identificación de personas de alto patrimonio
  */
-Persona buscarMasPatrimonioPorValor(std::vector<Persona> personas);
+Persona buscarMasPatrimonioPorValor(std::vector<Persona> personas, const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra la persona con mayor patrimonio - versión por referencia.
@@ -207,11 +242,13 @@ const Persona* buscarMasPatrimonioPorReferencia(const std::vector<Persona>& pers
  * @param personas Vector de personas (copia por valor)
  * @param ciudad Ciudad donde buscar
  * @return Copia de la persona con mayor patrimonio en esa ciudad
+ * @throws OperacionCancelada si el token se activa durante el recorrido
  * 
  * PROPÓSITO: Análisis financiero regional
  * USO: Identificar personas adineradas por ubicación geográfica
  */
-Persona buscarMasPatrimonioPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad);
+Persona buscarMasPatrimonioPorValorEnCiudad(std::vector<Persona> personas, const std::string& ciudad,
+                                            const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra la persona con mayor patrimonio en una ciudad - versión por referencia.
@@ -230,11 +267,13 @@ const Persona* buscarMasPatrimonioPorReferenciaEnCiudad(const std::vector<Person
  * @param personas Vector de personas (copia por valor)
  * @param grupo Identificador del grupo (probablemente basado en cédula)
  * @return Copia de la persona con mayor patrimonio en ese grupo
+ * @throws OperacionCancelada si el token se activa durante el recorrido
  * 
  * PROPÓSITO: Análisis financiero por segmentación demográfica
  * USO: Comparaciones entre diferentes grupos poblacionales
  */
-Persona buscarMasPatrimonioPorValorEnGrupo(std::vector<Persona> personas, const std::string& grupo);
+Persona buscarMasPatrimonioPorValorEnGrupo(std::vector<Persona> personas, const std::string& grupo,
+                                           const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra la persona con mayor patrimonio en un grupo específico - versión por referencia.
@@ -269,16 +308,21 @@ std::vector<Persona> listarPersonasPorValorEnGrupo(std::vector<Persona> personas
  * 
  * @param personas Vector de personas (referencia constante)
  * @param grupo Identificador del grupo a filtrar
- * @return Vector de punteros const a las personas del grupo
+ * @return Filas de las personas del grupo (ver ConjuntoFilas en seleccion.h)
  * 
  * PROPÓSITO: Obtener subconjuntos eficientemente sin copiar datos
- * VENTAJA: Menor uso de memoria para grandes colecciones
+ * VENTAJA: 4 bytes por coincidencia (o un mapa de bits si el grupo es denso)
+ *          en vez de 8 de un puntero; sigue siendo válido tras realojar o
+ *          recargar la colección
  */
-std::vector<const Persona*> listarPersonasPorReferenciaEnGrupo(const std::vector<Persona>& personas, const std::string& grupo);
+ConjuntoFilas listarPersonasPorReferenciaEnGrupo(const std::vector<Persona>& personas, const std::string& grupo);
 
 // ============================================================================
 // FUNCIONES DE VALIDACIÓN Y VERIFICACIÓN DE GRUPOS
 // ============================================================================
+// Las funciones masivas de esta sección y de la siguiente aceptan un
+// ControlOperacion opcional (ver cancelacion.h) para cancelarlas y reportar
+// su avance; lanzan OperacionCancelada si se cancelan.
 
 /**
  * Calcula el grupo correcto basado en el número de cédula.
@@ -287,10 +331,11 @@ std::vector<const Persona*> listarPersonasPorReferenciaEnGrupo(const std::vector
  * @return String identificando el grupo correcto
  * 
  * PROPÓSITO: Determinar la clasificación grupal según algoritmo de cédula
- * IMPLEMENTACIÓN: Probablemente usa dígitos específicos o módulo de la cédula
+ * IMPLEMENTACIÓN: Tabla del esquema activo indexada por cédula % 10^k (esquema_grupos.h)
  * USO: Validar asignaciones de grupo, corregir datos inconsistentes
  */
 std::string calcularGrupoCorrectoPorCedula(const std::string& cedula);
+std::string calcularGrupoCorrectoPorCedula(const std::string& cedula, const EsquemaGrupos& esquema); // Con una instantánea ya tomada
 
 /**
  * Verifica si una persona está asignada al grupo correcto - versión por valor.
@@ -302,6 +347,7 @@ std::string calcularGrupoCorrectoPorCedula(const std::string& cedula);
  * IMPLEMENTACIÓN: Compara grupo actual vs grupo calculado por cédula
  */
 bool verificarGrupoPorValor(Persona persona);
+bool verificarGrupoPorValor(Persona persona, const EsquemaGrupos& esquema); // Con una instantánea ya tomada
 
 /**
  * Verifica si una persona está asignada al grupo correcto - versión por referencia.
@@ -312,6 +358,7 @@ bool verificarGrupoPorValor(Persona persona);
  * PROPÓSITO: Verificación eficiente sin copia de datos
  */
 bool verificarGrupoPorReferencia(const Persona& persona);
+bool verificarGrupoPorReferencia(const Persona& persona, const EsquemaGrupos& esquema); // Con una instantánea ya tomada
 
 /**
  * Verifica masivamente la correctitud de grupos para toda una colección - versión por valor.
@@ -322,7 +369,7 @@ bool verificarGrupoPorReferencia(const Persona& persona);
  * IMPLEMENTACIÓN: Verifica cada persona y probablemente reporta inconsistencias
  * USO: Validación de integridad después de importar datos
  */
-void verificarGruposMasivoPorValor(std::vector<Persona> personas);
+void verificarGruposMasivoPorValor(std::vector<Persona> personas, const ControlOperacion& control = ControlOperacion());
 
 /**
  * Verifica masivamente la correctitud de grupos para toda una colección - versión por referencia.
@@ -332,7 +379,7 @@ void verificarGruposMasivoPorValor(std::vector<Persona> personas);
  * PROPÓSITO: Auditoría eficiente de calidad de datos
  * VENTAJA: Sin overhead de copia para verificaciones masivas
  */
-void verificarGruposMasivoPorReferencia(const std::vector<Persona>& personas);
+void verificarGruposMasivoPorReferencia(const std::vector<Persona>& personas, const ControlOperacion& control = ControlOperacion());
 
 // ============================================================================
 // FUNCIONES DE ANÁLISIS ESTADÍSTICO POR GRUPOS
@@ -348,7 +395,7 @@ void verificarGruposMasivoPorReferencia(const std::vector<Persona>& personas);
  * IMPLEMENTACIÓN: Calcula estadísticas por grupo y encuentra el máximo
  * USO: Estudios socioeconómicos, análisis de desigualdad
  */
-std::string encontrarGrupoMayorPatrimonioPorValor(std::vector<Persona> personas);
+std::string encontrarGrupoMayorPatrimonioPorValor(std::vector<Persona> personas, const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra el grupo con mayor patrimonio promedio/total - versión por referencia.
@@ -358,7 +405,7 @@ std::string encontrarGrupoMayorPatrimonioPorValor(std::vector<Persona> personas)
  * 
  * PROPÓSITO: Análisis eficiente de riqueza por grupos
  */
-std::string encontrarGrupoMayorPatrimonioPorReferencia(const std::vector<Persona>& personas);
+std::string encontrarGrupoMayorPatrimonioPorReferencia(const std::vector<Persona>& personas, const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra el grupo con mayor longevidad promedio - versión por valor.
@@ -370,7 +417,7 @@ std::string encontrarGrupoMayorPatrimonioPorReferencia(const std::vector<Persona
  * IMPLEMENTACIÓN: Calcula edad promedio por grupo y encuentra el máximo
  * USO: Estudios de salud pública, análisis actuariales
  */
-std::string encontrarGrupoMayorLongevidadPorValor(std::vector<Persona> personas);
+std::string encontrarGrupoMayorLongevidadPorValor(std::vector<Persona> personas, const ControlOperacion& control = ControlOperacion());
 
 /**
  * Encuentra el grupo con mayor longevidad promedio - versión por referencia.
@@ -380,6 +427,6 @@ std::string encontrarGrupoMayorLongevidadPorValor(std::vector<Persona> personas)
  * 
  * PROPÓSITO: Análisis eficiente de longevidad por grupos
  */
-std::string encontrarGrupoMayorLongevidadPorReferencia(const std::vector<Persona>& personas);
+std::string encontrarGrupoMayorLongevidadPorReferencia(const std::vector<Persona>& personas, const ControlOperacion& control = ControlOperacion());
 
 #endif // GENERADOR_H
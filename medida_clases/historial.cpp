@@ -0,0 +1,306 @@
+#include "historial.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+static const uint8_t CODEC_DELTA = 0;
+static const uint8_t CODEC_XOR = 1;
+static const size_t FILAS_POR_LOTE = 1024; // Filas decodificadas juntas en las consultas
+
+const char* nombreCampoHistorial(CampoHistorial campo) {
+    switch (campo) {
+        case CampoHistorial::INGRESOS: return "Ingresos";
+        case CampoHistorial::PATRIMONIO: return "Patrimonio";
+        case CampoHistorial::DEUDAS: return "Deudas";
+    }
+    return "";
+}
+
+// ============================================================================
+// CÓDECS
+// ============================================================================
+
+static uint64_t aBits(double valor) {
+    uint64_t bits;
+    std::memcpy(&bits, &valor, sizeof(bits));
+    return bits;
+}
+
+static double deBits(uint64_t bits) {
+    double valor;
+    std::memcpy(&valor, &bits, sizeof(valor));
+    return valor;
+}
+
+static void escribirVarint(std::vector<uint8_t>& salida, uint64_t valor) {
+    while (valor >= 0x80) {
+        salida.push_back(static_cast<uint8_t>(valor | 0x80));
+        valor >>= 7;
+    }
+    salida.push_back(static_cast<uint8_t>(valor));
+}
+
+static uint64_t leerVarint(const uint8_t*& p) {
+    uint64_t valor = 0;
+    for (int desplazamiento = 0;; desplazamiento += 7) {
+        uint8_t byte = *p++;
+        valor |= static_cast<uint64_t>(byte & 0x7F) << desplazamiento;
+        if (!(byte & 0x80)) return valor;
+    }
+}
+
+// Zigzag: los negativos pequeños también ocupan pocos bytes
+static uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+static int64_t desZigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+static void codificarDelta(const std::vector<int64_t>& serie, std::vector<uint8_t>& salida) {
+    int64_t anterior = 0;
+    for (int64_t v : serie) {
+        escribirVarint(salida, zigzag(v - anterior));
+        anterior = v;
+    }
+}
+
+/**
+ * Escritor y lector de bits (más significativo primero).
+ */
+class EscritorBits {
+public:
+    explicit EscritorBits(std::vector<uint8_t>& salida) : salida(salida) {}
+    void escribir(uint64_t valor, int bits) {
+        for (int b = bits - 1; b >= 0; --b) {
+            if (usados == 0) salida.push_back(0);
+            if ((valor >> b) & 1) salida.back() |= static_cast<uint8_t>(0x80 >> usados);
+            usados = (usados + 1) & 7;
+        }
+    }
+private:
+    std::vector<uint8_t>& salida;
+    int usados = 0; // Bits ocupados del último byte
+};
+
+class LectorBits {
+public:
+    explicit LectorBits(const uint8_t* datos) : p(datos) {}
+    uint64_t leer(int bits) {
+        uint64_t valor = 0;
+        for (int b = 0; b < bits; ++b) {
+            valor = (valor << 1) | ((*p >> (7 - usados)) & 1);
+            if (++usados == 8) { usados = 0; ++p; }
+        }
+        return valor;
+    }
+private:
+    const uint8_t* p;
+    int usados = 0;
+};
+
+/**
+ * Gorilla: '0' = mismo valor; '10' = XOR dentro de la ventana anterior de
+ * bits significativos; '11' + 5 bits de ceros iniciales + 6 bits de largo
+ * = ventana nueva.
+ */
+static void codificarXor(const std::vector<int64_t>& serie, std::vector<uint8_t>& salida) {
+    EscritorBits escritor(salida);
+    uint64_t anterior = aBits(static_cast<double>(serie[0]));
+    escritor.escribir(anterior, 64);
+    int cerosIniciales = -1, cerosFinales = 0;
+    for (size_t i = 1; i < serie.size(); ++i) {
+        uint64_t actual = aBits(static_cast<double>(serie[i]));
+        uint64_t x = actual ^ anterior;
+        anterior = actual;
+        if (x == 0) {
+            escritor.escribir(0, 1);
+            continue;
+        }
+        int iniciales = std::min(31, __builtin_clzll(x));
+        int finales = __builtin_ctzll(x);
+        if (cerosIniciales >= 0 && iniciales >= cerosIniciales && finales >= cerosFinales) {
+            escritor.escribir(2, 2);
+            escritor.escribir(x >> cerosFinales, 64 - cerosIniciales - cerosFinales);
+        } else {
+            int significativos = 64 - iniciales - finales;
+            escritor.escribir(3, 2);
+            escritor.escribir(static_cast<uint64_t>(iniciales), 5);
+            escritor.escribir(static_cast<uint64_t>(significativos - 1), 6);
+            escritor.escribir(x >> finales, significativos);
+            cerosIniciales = iniciales;
+            cerosFinales = finales;
+        }
+    }
+}
+
+static void decodificarXor(const uint8_t* datos, int cuantos, double* valores) {
+    LectorBits lector(datos);
+    uint64_t anterior = lector.leer(64);
+    valores[0] = deBits(anterior);
+    int cerosIniciales = 0, cerosFinales = 0;
+    for (int i = 1; i < cuantos; ++i) {
+        if (lector.leer(1) == 1) {
+            if (lector.leer(1) == 1) {
+                cerosIniciales = static_cast<int>(lector.leer(5));
+                cerosFinales = 64 - cerosIniciales - (static_cast<int>(lector.leer(6)) + 1);
+            }
+            anterior ^= lector.leer(64 - cerosIniciales - cerosFinales) << cerosFinales;
+        }
+        valores[i] = deBits(anterior);
+    }
+}
+
+// ============================================================================
+// CONSTRUCCIÓN
+// ============================================================================
+
+HistorialFinanciero::HistorialFinanciero(const std::vector<Persona>& personas, int anios, uint64_t semilla,
+                                         const ControlOperacion& control)
+    : n(personas.size()), numAnios(anios) {
+    if (anios < 2 || anios > 40) throw std::invalid_argument("El historial debe tener entre 2 y 40 años");
+
+    std::mt19937_64 generador(semilla);
+    // Crecimiento anual: media y dispersión por campo (las deudas son las más volátiles)
+    std::normal_distribution<double> crecimiento[3] = {
+        std::normal_distribution<double>(0.045, 0.07),  // Ingresos
+        std::normal_distribution<double>(0.06, 0.15),   // Patrimonio
+        std::normal_distribution<double>(0.03, 0.20)};  // Deudas
+    std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+
+    for (auto& c : columnas) {
+        c.baseBloque.reserve((n + FILAS_POR_BLOQUE - 1) / FILAS_POR_BLOQUE);
+        c.desplazamiento.reserve(n);
+    }
+    std::vector<int64_t> serie(anios);
+    std::vector<uint8_t> delta, conXor;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % ControlOperacion::FRAGMENTO_POR_DEFECTO == 0) control.avanzar(i, n);
+        const Persona& p = personas[i];
+        const double actuales[3] = {p.getIngresosAnuales(), p.getPatrimonio(), p.getDeudas()};
+        // Uno de cada diez no tuvo cambios de deuda (misma cuota pactada): series que XOR comprime mejor
+        const bool deudaFija = uniforme(generador) < 0.10;
+
+        for (int campo = 0; campo < 3; ++campo) {
+            // Hacia atrás desde la foto actual: valor(t-1) = valor(t) / (1 + crecimiento)
+            double valor = actuales[campo];
+            for (int t = anios - 1; t >= 0; --t) {
+                serie[t] = std::llround(valor);
+                double g = campo == 2 && deudaFija ? 0.0 : std::max(-0.5, std::min(1.0, crecimiento[campo](generador)));
+                valor /= 1.0 + g;
+            }
+
+            Columna& c = columnas[campo];
+            if (i % FILAS_POR_BLOQUE == 0) c.baseBloque.push_back(c.datos.size());
+            c.desplazamiento.push_back(static_cast<uint16_t>(c.datos.size() - c.baseBloque.back()));
+
+            delta.assign(1, CODEC_DELTA);
+            codificarDelta(serie, delta);
+            conXor.assign(1, CODEC_XOR);
+            codificarXor(serie, conXor);
+            const std::vector<uint8_t>& elegida = conXor.size() < delta.size() ? conXor : delta;
+            if (&elegida == &conXor) c.seriesXor++;
+            c.datos.insert(c.datos.end(), elegida.begin(), elegida.end());
+        }
+    }
+    control.avanzar(n, n);
+    for (auto& c : columnas) c.datos.shrink_to_fit();
+}
+
+size_t HistorialFinanciero::bytes() const {
+    size_t total = 0;
+    for (const auto& c : columnas) {
+        total += c.datos.size() + c.baseBloque.size() * sizeof(uint64_t) + c.desplazamiento.size() * sizeof(uint16_t);
+    }
+    return total;
+}
+
+// ============================================================================
+// CONSULTAS
+// ============================================================================
+
+void HistorialFinanciero::decodificar(const Columna& columna, size_t fila, double* valores) const {
+    const uint8_t* p = columna.serie(fila);
+    if (*p++ == CODEC_XOR) {
+        decodificarXor(p, numAnios, valores);
+        return;
+    }
+    int64_t valor = 0;
+    for (int t = 0; t < numAnios; ++t) {
+        valor += desZigzag(leerVarint(p));
+        valores[t] = static_cast<double>(valor);
+    }
+}
+
+std::vector<double> HistorialFinanciero::serie(size_t fila, CampoHistorial campo) const {
+    if (fila >= n) throw std::out_of_range("Fila fuera del historial: " + std::to_string(fila));
+    std::vector<double> valores(numAnios);
+    decodificar(columnas[static_cast<int>(campo)], fila, valores.data());
+    return valores;
+}
+
+std::vector<CrecimientoCiudad> HistorialFinanciero::mayorCrecimientoPorCiudad(const std::vector<Persona>& personas,
+                                                                             CampoHistorial campo, int desde,
+                                                                             const ControlOperacion& control) const {
+    if (personas.size() != n) throw std::invalid_argument("El historial es de otra colección; vuelva a generarlo");
+    if (desde < primerAnio() || desde >= ANIO_ACTUAL) {
+        throw std::invalid_argument("El año inicial debe estar entre " + std::to_string(primerAnio()) + " y " +
+                                    std::to_string(ANIO_ACTUAL - 1));
+    }
+    const Columna& columna = columnas[static_cast<int>(campo)];
+    const int indiceDesde = desde - primerAnio();
+
+    std::unordered_map<std::string, uint32_t> codigos;
+    std::vector<CrecimientoCiudad> mejores;
+    std::vector<double> serieFila(numAnios);
+    std::vector<double> iniciales(FILAS_POR_LOTE), finales(FILAS_POR_LOTE);
+    std::vector<uint32_t> ciudades(FILAS_POR_LOTE);
+
+    for (size_t inicio = 0; inicio < n; inicio += FILAS_POR_LOTE) {
+        if (inicio % ControlOperacion::FRAGMENTO_POR_DEFECTO == 0) control.avanzar(inicio, n);
+        const size_t fin = std::min(n, inicio + FILAS_POR_LOTE);
+
+        // Paso 1: decodificar las series del lote y quedarse con los dos años pedidos
+        for (size_t i = inicio; i < fin; ++i) {
+            decodificar(columna, i, serieFila.data());
+            iniciales[i - inicio] = serieFila[indiceDesde];
+            finales[i - inicio] = serieFila[numAnios - 1];
+            auto it = codigos.find(personas[i].getCiudadNacimiento());
+            if (it == codigos.end()) {
+                it = codigos.emplace(personas[i].getCiudadNacimiento(), static_cast<uint32_t>(mejores.size())).first;
+                mejores.emplace_back();
+                mejores.back().ciudad = personas[i].getCiudadNacimiento();
+                mejores.back().crecimiento = -INFINITY;
+            }
+            ciudades[i - inicio] = it->second;
+        }
+
+        // Paso 2: bucle sin decodificación ni strings sobre los arreglos del lote
+        for (size_t k = 0; k < fin - inicio; ++k) {
+            double crecimiento = finales[k] - iniciales[k];
+            CrecimientoCiudad& mejor = mejores[ciudades[k]];
+            if (crecimiento > mejor.crecimiento) {
+                mejor.crecimiento = crecimiento;
+                mejor.fila = inicio + k;
+                mejor.inicial = iniciales[k];
+                mejor.final = finales[k];
+            }
+        }
+    }
+    control.avanzar(n, n);
+    std::sort(mejores.begin(), mejores.end(),
+              [](const CrecimientoCiudad& a, const CrecimientoCiudad& b) { return a.ciudad < b.ciudad; });
+    return mejores;
+}
+
+std::vector<double> HistorialFinanciero::promedioPorAnio(CampoHistorial campo, const ControlOperacion& control) const {
+    const Columna& columna = columnas[static_cast<int>(campo)];
+    std::vector<double> sumas(numAnios, 0.0), serieFila(numAnios);
+    for (size_t i = 0; i < n; ++i) {
+        if (i % ControlOperacion::FRAGMENTO_POR_DEFECTO == 0) control.avanzar(i, n);
+        decodificar(columna, i, serieFila.data());
+        for (int t = 0; t < numAnios; ++t) sumas[t] += serieFila[t];
+    }
+    control.avanzar(n, n);
+    if (n > 0) for (double& s : sumas) s /= static_cast<double>(n);
+    return sumas;
+}
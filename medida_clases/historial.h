@@ -0,0 +1,113 @@
+#ifndef HISTORIAL_H
+#define HISTORIAL_H
+
+#include "persona.h"
+#include "cancelacion.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// HISTORIAL FINANCIERO MULTIANUAL COMPRIMIDO
+// ============================================================================
+// Persona guarda una sola foto de ingresos, patrimonio y deudas. El
+// historial agrega, al lado de la colección y fila a fila, la serie anual
+// de esos tres campos (el último año es la foto actual) sin agrandar
+// Persona: quien no lo pide no paga nada.
+//
+// Almacenamiento columnar: una columna por campo; cada fila es una serie
+// comprimida (montos al peso) con el códec que resulte más corto:
+//   - DELTA: primer valor y diferencias año a año, en zigzag + varint.
+//   - XOR:   estilo Gorilla; cada valor (double) se guarda como XOR con el
+//            anterior, solo los bits significativos. Gana en series que
+//            repiten valores.
+// Las series se ubican con una base de 64 bits cada 64 filas y un
+// desplazamiento de 16 bits por fila (~2 bytes por fila y columna).
+//
+// Las consultas decodifican por lotes de filas solo la columna que
+// necesitan, en arreglos pequeños que caben en L1; nunca se expande una
+// columna completa en memoria.
+// ============================================================================
+
+enum class CampoHistorial { INGRESOS = 0, PATRIMONIO = 1, DEUDAS = 2 };
+
+const char* nombreCampoHistorial(CampoHistorial campo);
+
+/**
+ * Mayor crecimiento de un campo en una ciudad.
+ */
+struct CrecimientoCiudad {
+    std::string ciudad;
+    size_t fila = 0;
+    double inicial = 0.0;
+    double final = 0.0;
+    double crecimiento = 0.0;   // final - inicial
+};
+
+/**
+ * Series anuales de ingresos, patrimonio y deudas de una colección.
+ *
+ * ADVERTENCIA: Como los índices, describe una colección concreta (fila a
+ *              fila) y debe regenerarse si esta cambia
+ */
+class HistorialFinanciero {
+public:
+    static const int ANIO_ACTUAL = 2025; // El de getEdad(): la foto de Persona es este año
+    static const size_t FILAS_POR_BLOQUE = 64;
+
+    /**
+     * Genera la historia hacia atrás desde los valores actuales, con deriva
+     * anual aleatoria (crecimiento medio positivo y años malos).
+     *
+     * @param anios Años de historia, incluido el actual (2 a 40)
+     * @throws std::invalid_argument si anios está fuera de rango
+     */
+    HistorialFinanciero(const std::vector<Persona>& personas, int anios, uint64_t semilla = 7,
+                        const ControlOperacion& control = ControlOperacion());
+
+    size_t filas() const { return n; }
+    int anios() const { return numAnios; }
+    int primerAnio() const { return ANIO_ACTUAL - numAnios + 1; }
+
+    /** Serie completa de una fila (primerAnio()..ANIO_ACTUAL). */
+    std::vector<double> serie(size_t fila, CampoHistorial campo) const;
+
+    /** Bytes comprimidos (datos + ubicación de series) y sin comprimir. */
+    size_t bytes() const;
+    size_t bytesSinComprimir() const { return n * numAnios * 3 * sizeof(double); }
+
+    /** Series de un campo codificadas con XOR (el resto, con DELTA). */
+    size_t seriesXor(CampoHistorial campo) const { return columnas[static_cast<int>(campo)].seriesXor; }
+
+    /**
+     * Por ciudad, la persona con mayor crecimiento del campo entre desde y
+     * ANIO_ACTUAL. Ciudades ordenadas por nombre.
+     *
+     * @throws std::invalid_argument si desde no está en el historial o
+     *         personas no es la colección del historial
+     */
+    std::vector<CrecimientoCiudad> mayorCrecimientoPorCiudad(const std::vector<Persona>& personas, CampoHistorial campo,
+                                                             int desde, const ControlOperacion& control = ControlOperacion()) const;
+
+    /** Promedio del campo en cada año, en una pasada por la columna. */
+    std::vector<double> promedioPorAnio(CampoHistorial campo, const ControlOperacion& control = ControlOperacion()) const;
+
+private:
+    struct Columna {
+        std::vector<uint8_t> datos;
+        std::vector<uint64_t> baseBloque;     // Inicio de cada bloque de FILAS_POR_BLOQUE filas
+        std::vector<uint16_t> desplazamiento; // Inicio de cada fila dentro de su bloque
+        size_t seriesXor = 0;
+
+        const uint8_t* serie(size_t fila) const { return datos.data() + baseBloque[fila / FILAS_POR_BLOQUE] + desplazamiento[fila]; }
+    };
+
+    /** Decodifica la serie de una fila en valores[0..numAnios). */
+    void decodificar(const Columna& columna, size_t fila, double* valores) const;
+
+    size_t n;
+    int numAnios;
+    Columna columnas[3];
+};
+
+#endif // HISTORIAL_H
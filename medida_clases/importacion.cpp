@@ -0,0 +1,581 @@
+#include "importacion.h"
+#include "diccionarios.h"
+#include "esquema_grupos.h"
+#include "generador.h"
+#include "texto.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+
+static const char MAGICO[8] = {'P', 'E', 'R', 'S', 'D', 'I', 'C', '1'};
+static const uint8_t FUERA_DE_CATALOGO = 0xFF;
+static const uint64_t ID_COMO_TEXTO = 1ULL << 63;
+static const char ENCABEZADO[] = "nombre,apellido,id,ciudad,fecha,grupo,edad,ingresos,patrimonio,deudas,declarante";
+static const size_t COLUMNAS = 11;
+static const size_t REPETICIONES = 3;
+static const size_t BYTES_MINIMOS_REGISTRO = 43; // Todo en códigos, fecha y grupo vacíos
+
+// Un solo espacio de códigos para los nombres: femeninos y luego masculinos
+static const size_t TOTAL_NOMBRES = DICCIONARIO_NOMBRES_FEMENINOS.tamano() + DICCIONARIO_NOMBRES_MASCULINOS.tamano();
+static_assert(TOTAL_NOMBRES < FUERA_DE_CATALOGO, "Los códigos de nombre deben caber en un byte");
+
+static int codigoNombre(const char* datos, size_t largo) {
+    int codigo = DICCIONARIO_NOMBRES_FEMENINOS.codigo(datos, largo);
+    if (codigo >= 0) return codigo;
+    codigo = DICCIONARIO_NOMBRES_MASCULINOS.codigo(datos, largo);
+    return codigo < 0 ? -1 : static_cast<int>(DICCIONARIO_NOMBRES_FEMENINOS.tamano()) + codigo;
+}
+
+static const std::string& nombreDeCodigo(size_t codigo) {
+    const std::vector<std::string>& femeninos = catalogoNombresFemeninos();
+    return codigo < femeninos.size() ? femeninos[codigo] : catalogoNombresMasculinos()[codigo - femeninos.size()];
+}
+
+/**
+ * Códigos de los dos apellidos de "Primero Segundo"; false si no son dos
+ * apellidos del catálogo separados por un espacio.
+ */
+static bool codigosApellido(const char* datos, size_t largo, int& primero, int& segundo) {
+    const char* espacio = static_cast<const char*>(std::memchr(datos, ' ', largo));
+    if (!espacio) return false;
+    const size_t corte = static_cast<size_t>(espacio - datos);
+    primero = DICCIONARIO_APELLIDOS.codigo(datos, corte);
+    segundo = DICCIONARIO_APELLIDOS.codigo(espacio + 1, largo - corte - 1);
+    return primero >= 0 && segundo >= 0;
+}
+
+static bool soloDigitos(const char* datos, size_t largo) {
+    for (size_t i = 0; i < largo; ++i) {
+        if (datos[i] < '0' || datos[i] > '9') return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// CSV
+// ---------------------------------------------------------------------------
+
+static void agregarCampo(std::string& linea, const std::string& texto) {
+    if (texto.find_first_of(",\n\r") != std::string::npos) {
+        throw std::runtime_error("El texto '" + texto + "' no se puede exportar a CSV sin comillas");
+    }
+    linea += texto;
+    linea += ',';
+}
+
+static void agregarMonto(std::string& linea, double valor) {
+    char texto[32];
+    std::snprintf(texto, sizeof(texto), "%.17g", valor);
+    linea += texto;
+    linea += ',';
+}
+
+void exportarCSV(const std::vector<Persona>& personas, const std::string& ruta, const ControlOperacion& control) {
+    std::ofstream archivo(ruta, std::ios::binary | std::ios::trunc);
+    if (!archivo) throw std::runtime_error("No se pudo crear " + ruta);
+    archivo << ENCABEZADO << '\n';
+
+    std::string bloque;
+    for (size_t desde = 0; desde < personas.size(); desde += control.tamFragmento) {
+        control.avanzar(desde, personas.size());
+        bloque.clear();
+        size_t hasta = std::min(personas.size(), desde + control.tamFragmento);
+        for (size_t i = desde; i < hasta; ++i) {
+            const Persona& p = personas[i];
+            agregarCampo(bloque, p.getNombre());
+            agregarCampo(bloque, p.getApellido());
+            agregarCampo(bloque, p.getId());
+            agregarCampo(bloque, p.getCiudadNacimiento());
+            agregarCampo(bloque, p.getFechaNacimiento());
+            agregarCampo(bloque, p.getGrupoDeclaracion());
+            bloque += std::to_string(p.getEdad());
+            bloque += ',';
+            agregarMonto(bloque, p.getIngresosAnuales());
+            agregarMonto(bloque, p.getPatrimonio());
+            agregarMonto(bloque, p.getDeudas());
+            bloque += p.getDeclaranteRenta() ? '1' : '0';
+            bloque += '\n';
+        }
+        archivo.write(bloque.data(), static_cast<std::streamsize>(bloque.size()));
+    }
+    control.avanzar(personas.size(), personas.size());
+    if (!archivo.flush()) throw std::runtime_error("Error al escribir " + ruta);
+}
+
+/**
+ * Fecha D/M/AAAA como la escribe generarFechaNacimiento (día y mes de una o
+ * dos cifras, sin relleno).
+ */
+static bool fechaValida(const char* texto, size_t largo) {
+    const char* fin = texto + largo;
+    int partes[3] = {0, 0, 0};
+    int cifras[3] = {0, 0, 0};
+    int k = 0;
+    for (const char* p = texto; p < fin; ++p) {
+        if (*p == '/') {
+            if (++k > 2) return false;
+        } else if (*p >= '0' && *p <= '9') {
+            partes[k] = partes[k] * 10 + (*p - '0');
+            cifras[k]++;
+        } else {
+            return false;
+        }
+    }
+    return k == 2 && cifras[0] >= 1 && cifras[0] <= 2 && cifras[1] >= 1 && cifras[1] <= 2 && cifras[2] == 4 &&
+           partes[0] >= 1 && partes[0] <= 31 && partes[1] >= 1 && partes[1] <= 12;
+}
+
+static bool leerMonto(const char* texto, double& valor) {
+    char* fin = nullptr;
+    valor = std::strtod(texto, &fin);
+    return fin != texto && *fin == '\0' && std::isfinite(valor);
+}
+
+/**
+ * El grupo no es libre: lo fija la cédula, igual que en generarPersona().
+ * Lo comparten el CSV y el binario.
+ *
+ * @return Vacío si el grupo es el de la cédula; si no, el motivo del rechazo
+ */
+static std::string motivoGrupoInvalido(const std::string& cedula, const std::string& grupo,
+                                       const EsquemaGrupos& esquema) {
+    const int codigo = esquema.codigoDeNombre(grupo);
+    if (codigo < 0) return "grupo que no está en el esquema activo: " + grupo;
+    int grupoCedula = -1;
+    try {
+        grupoCedula = esquema.codigo(cedula);
+    } catch (const std::invalid_argument& e) {
+        return e.what(); // Menos dígitos de los que usa el esquema, o un id de texto
+    }
+    if (grupoCedula != codigo) {
+        return "el grupo de la cédula " + cedula + " es " + esquema.nombreGrupo(grupoCedula) + ", no " + grupo;
+    }
+    return "";
+}
+
+static bool edadValida(long edad) { return edad >= 0 && edad <= 150; }
+
+/**
+ * Valida una línea del CSV y agrega la persona.
+ *
+ * @return Vacío si se agregó; si no, el motivo del rechazo
+ */
+static std::string leerFilaCSV(std::string& linea, const EsquemaGrupos& esquema, std::vector<Persona>& personas) {
+    // Corte en su lugar: cada coma pasa a ser el fin del campo anterior
+    const char* campos[COLUMNAS];
+    size_t largos[COLUMNAS];
+    size_t k = 0;
+    char* inicio = &linea[0];
+    char* const fin = inicio + linea.size();
+    for (char* q = inicio; q <= fin; ++q) {
+        if (q != fin && *q != ',') continue;
+        if (k == COLUMNAS) return "más de " + std::to_string(COLUMNAS) + " columnas";
+        campos[k] = inicio;
+        largos[k] = static_cast<size_t>(q - inicio);
+        ++k;
+        if (q != fin) *q = '\0';
+        inicio = q + 1;
+    }
+    if (k != COLUMNAS) return "se esperaban " + std::to_string(COLUMNAS) + " columnas y hay " + std::to_string(k);
+
+    const int nombre = codigoNombre(campos[0], largos[0]);
+    if (nombre < 0) return "nombre fuera del catálogo: " + std::string(campos[0], largos[0]);
+    int apellido1 = -1, apellido2 = -1;
+    if (!codigosApellido(campos[1], largos[1], apellido1, apellido2)) {
+        return "apellidos fuera del catálogo: " + std::string(campos[1], largos[1]);
+    }
+    if (largos[2] == 0 || largos[2] > 18 || !soloDigitos(campos[2], largos[2])) {
+        return "cédula inválida: " + std::string(campos[2], largos[2]);
+    }
+    const int ciudad = DICCIONARIO_CIUDADES.codigo(campos[3], largos[3]);
+    if (ciudad < 0) return "ciudad fuera del catálogo: " + std::string(campos[3], largos[3]);
+
+    if (!fechaValida(campos[4], largos[4])) return "fecha inválida (D/M/AAAA): " + std::string(campos[4], largos[4]);
+
+    const std::string cedula(campos[2], largos[2]);
+    const std::string grupo(campos[5], largos[5]);
+    std::string motivo = motivoGrupoInvalido(cedula, grupo, esquema);
+    if (!motivo.empty()) return motivo;
+
+    char* finEdad = nullptr;
+    const long edad = std::strtol(campos[6], &finEdad, 10);
+    if (finEdad == campos[6] || *finEdad != '\0' || !edadValida(edad)) {
+        return "edad inválida: " + std::string(campos[6], largos[6]);
+    }
+    double ingresos, patrimonio, deudas;
+    if (!leerMonto(campos[7], ingresos) || !leerMonto(campos[8], patrimonio) || !leerMonto(campos[9], deudas)) {
+        return "monto inválido";
+    }
+    if (largos[10] != 1 || (campos[10][0] != '0' && campos[10][0] != '1')) return "declarante debe ser 1 o 0";
+
+    personas.emplace_back(nombreDeCodigo(nombre), std::string(campos[1], largos[1]), cedula,
+                          catalogoCiudades()[ciudad], std::string(campos[4], largos[4]), grupo,
+                          static_cast<int>(edad), ingresos, patrimonio, deudas, campos[10][0] == '1');
+    return "";
+}
+
+ResultadoImportacion importarCSV(const std::string& ruta, const ControlOperacion& control) {
+    std::ifstream archivo(ruta, std::ios::binary | std::ios::ate);
+    if (!archivo) throw std::runtime_error("No se pudo abrir " + ruta);
+    const size_t totalBytes = static_cast<size_t>(archivo.tellg());
+    archivo.seekg(0);
+
+    std::string linea;
+    if (!std::getline(archivo, linea)) throw std::runtime_error(ruta + " está vacío");
+    if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+    if (linea != ENCABEZADO) throw std::runtime_error(ruta + ": la primera línea debe ser el encabezado " + ENCABEZADO);
+
+    const std::shared_ptr<const EsquemaGrupos> instantanea = esquemaGruposActivo();
+    const EsquemaGrupos& esquema = *instantanea;
+    ResultadoImportacion resultado;
+    size_t bytesLeidos = linea.size() + 1;
+    for (size_t numeroLinea = 2; std::getline(archivo, linea); ++numeroLinea) {
+        if (numeroLinea % control.tamFragmento == 0) control.avanzar(std::min(bytesLeidos, totalBytes), totalBytes);
+        bytesLeidos += linea.size() + 1;
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (linea.empty()) continue;
+
+        if (resultado.personas.size() == FILAS_MAXIMAS_EN_MEMORIA) {
+            throw std::runtime_error(ruta + " tiene más filas de las que admite una colección en memoria");
+        }
+        std::string error = leerFilaCSV(linea, esquema, resultado.personas);
+        if (error.empty()) continue;
+        resultado.rechazadas++;
+        if (resultado.errores.size() < MAX_ERRORES_REPORTADOS) {
+            resultado.errores.push_back("Línea " + std::to_string(numeroLinea) + ": " + error);
+        }
+    }
+    control.avanzar(totalBytes, totalBytes);
+    return resultado;
+}
+
+// ---------------------------------------------------------------------------
+// Binario codificado
+// ---------------------------------------------------------------------------
+
+template <typename T>
+static void escribirValor(std::string& salida, T valor) {
+    salida.append(reinterpret_cast<const char*>(&valor), sizeof(T));
+}
+
+static void escribirTexto(std::string& salida, const std::string& texto) {
+    if (texto.size() > 255) throw std::runtime_error("Texto demasiado largo para el formato binario: " + texto);
+    salida.push_back(static_cast<char>(texto.size()));
+    salida.append(texto);
+}
+
+// Código del catálogo en un byte, o la marca y el texto literal
+static void escribirCodigo(std::string& salida, int codigo, const std::string& texto) {
+    if (codigo >= 0) {
+        salida.push_back(static_cast<char>(codigo));
+    } else {
+        salida.push_back(static_cast<char>(FUERA_DE_CATALOGO));
+        escribirTexto(salida, texto);
+    }
+}
+
+static void codificar(std::string& salida, const Persona& p) {
+    escribirCodigo(salida, codigoNombre(p.getNombre().data(), p.getNombre().size()), p.getNombre());
+
+    const std::string& apellido = p.getApellido();
+    int apellido1 = -1, apellido2 = -1;
+    if (codigosApellido(apellido.data(), apellido.size(), apellido1, apellido2)) {
+        salida.push_back(static_cast<char>(apellido1));
+        salida.push_back(static_cast<char>(apellido2));
+    } else {
+        escribirCodigo(salida, -1, apellido);
+    }
+
+    escribirCodigo(salida, DICCIONARIO_CIUDADES.codigo(p.getCiudadNacimiento()), p.getCiudadNacimiento());
+
+    // Cédula canónica (solo dígitos, sin ceros a la izquierda) como número
+    const std::string& id = p.getId();
+    if (!id.empty() && id.size() <= 18 && (id[0] != '0' || id.size() == 1) && soloDigitos(id.data(), id.size())) {
+        escribirValor<uint64_t>(salida, std::stoull(id));
+    } else {
+        escribirValor<uint64_t>(salida, ID_COMO_TEXTO);
+        escribirTexto(salida, id);
+    }
+
+    escribirTexto(salida, p.getFechaNacimiento());
+    escribirTexto(salida, p.getGrupoDeclaracion());
+    escribirValor<int32_t>(salida, p.getEdad());
+    escribirValor<double>(salida, p.getIngresosAnuales());
+    escribirValor<double>(salida, p.getPatrimonio());
+    escribirValor<double>(salida, p.getDeudas());
+    escribirValor<uint8_t>(salida, p.getDeclaranteRenta() ? 1 : 0);
+}
+
+void exportarBinario(const std::vector<Persona>& personas, const std::string& ruta, const ControlOperacion& control) {
+    std::ofstream archivo(ruta, std::ios::binary | std::ios::trunc);
+    if (!archivo) throw std::runtime_error("No se pudo crear " + ruta);
+    std::string bloque(MAGICO, sizeof(MAGICO));
+    escribirValor<uint64_t>(bloque, personas.size());
+    archivo.write(bloque.data(), static_cast<std::streamsize>(bloque.size()));
+
+    for (size_t desde = 0; desde < personas.size(); desde += control.tamFragmento) {
+        control.avanzar(desde, personas.size());
+        size_t hasta = std::min(personas.size(), desde + control.tamFragmento);
+        bloque.assign(2 * sizeof(uint32_t), '\0'); // Cabecera del bloque, se completa al final
+        for (size_t i = desde; i < hasta; ++i) codificar(bloque, personas[i]);
+        if (bloque.size() - 2 * sizeof(uint32_t) > UINT32_MAX) {
+            throw std::runtime_error("Bloque de más de 4 GB; use un fragmento menor");
+        }
+        const uint32_t cabecera[2] = {static_cast<uint32_t>(hasta - desde),
+                                      static_cast<uint32_t>(bloque.size() - sizeof(cabecera))};
+        std::memcpy(&bloque[0], cabecera, sizeof(cabecera));
+        archivo.write(bloque.data(), static_cast<std::streamsize>(bloque.size()));
+    }
+    control.avanzar(personas.size(), personas.size());
+    if (!archivo.flush()) throw std::runtime_error("Error al escribir " + ruta);
+}
+
+/**
+ * Decodifica registros de un bloque ya leído, con límites comprobados.
+ */
+class LectorBloque {
+public:
+    LectorBloque(const char* datos, size_t bytes) : actual(datos), fin(datos + bytes) {}
+
+    template <typename T>
+    T valor() {
+        comprobar(sizeof(T));
+        T v;
+        std::memcpy(&v, actual, sizeof(T));
+        actual += sizeof(T);
+        return v;
+    }
+
+    std::string texto() {
+        size_t largo = valor<uint8_t>();
+        comprobar(largo);
+        std::string t(actual, largo);
+        actual += largo;
+        return t;
+    }
+
+    Persona persona() {
+        const std::vector<std::string>& apellidos = catalogoApellidos();
+        std::string nombre = deCatalogo(TOTAL_NOMBRES, "nombre", nombreDeCodigo);
+        std::string apellido;
+        uint8_t primero = valor<uint8_t>();
+        if (primero == FUERA_DE_CATALOGO) {
+            apellido = texto();
+        } else {
+            uint8_t segundo = valor<uint8_t>();
+            if (primero >= apellidos.size() || segundo >= apellidos.size()) danado("apellido");
+            apellido = apellidos[primero] + " " + apellidos[segundo];
+        }
+        std::string ciudad = deCatalogo(catalogoCiudades().size(), "ciudad",
+                                        [](size_t c) -> const std::string& { return catalogoCiudades()[c]; });
+        uint64_t cedula = valor<uint64_t>();
+        std::string id = cedula == ID_COMO_TEXTO ? texto() : std::to_string(cedula);
+        std::string fecha = texto();
+        std::string grupo = texto();
+        int edad = valor<int32_t>();
+        double ingresos = valor<double>();
+        double patrimonio = valor<double>();
+        double deudas = valor<double>();
+        bool declara = valor<uint8_t>() != 0;
+        return Persona(std::move(nombre), std::move(apellido), std::move(id), std::move(ciudad), std::move(fecha),
+                       std::move(grupo), edad, ingresos, patrimonio, deudas, declara);
+    }
+
+    bool terminado() const { return actual == fin; }
+
+private:
+    template <typename Texto>
+    std::string deCatalogo(size_t tamano, const char* campo, Texto textoDe) {
+        uint8_t codigo = valor<uint8_t>();
+        if (codigo == FUERA_DE_CATALOGO) return texto();
+        if (codigo >= tamano) danado(campo);
+        return textoDe(codigo);
+    }
+
+    void comprobar(size_t bytes) const {
+        if (static_cast<size_t>(fin - actual) < bytes) throw std::runtime_error("Archivo binario dañado: registro truncado");
+    }
+
+    [[noreturn]] static void danado(const char* campo) {
+        throw std::runtime_error(std::string("Archivo binario dañado: código de ") + campo + " fuera del catálogo");
+    }
+
+    const char* actual;
+    const char* fin;
+};
+
+ResultadoImportacion importarBinario(const std::string& ruta, const ControlOperacion& control) {
+    std::ifstream archivo(ruta, std::ios::binary | std::ios::ate);
+    if (!archivo) throw std::runtime_error("No se pudo abrir " + ruta);
+    const uint64_t totalBytes = static_cast<uint64_t>(archivo.tellg());
+    archivo.seekg(0);
+    char magico[sizeof(MAGICO)];
+    uint64_t total = 0;
+    archivo.read(magico, sizeof(magico));
+    archivo.read(reinterpret_cast<char*>(&total), sizeof(total));
+    if (!archivo || std::memcmp(magico, MAGICO, sizeof(MAGICO)) != 0) {
+        throw std::runtime_error(ruta + " no es un archivo binario de personas (PERSDIC1)");
+    }
+    if (total > totalBytes / BYTES_MINIMOS_REGISTRO) { // Antes de reservar memoria para una cabecera dañada
+        throw std::runtime_error("Archivo binario dañado: declara más filas de las que caben en " + ruta);
+    }
+    if (total > FILAS_MAXIMAS_EN_MEMORIA) {
+        throw std::runtime_error(ruta + " tiene más filas de las que admite una colección en memoria");
+    }
+
+    const std::shared_ptr<const EsquemaGrupos> instantanea = esquemaGruposActivo();
+    const EsquemaGrupos& esquema = *instantanea;
+    ResultadoImportacion resultado;
+    resultado.personas.reserve(static_cast<size_t>(total));
+    std::string bloque;
+    uint64_t leidos = sizeof(magico) + sizeof(total);
+    uint64_t registros = 0; // Decodificados, incluidos los rechazados
+    while (registros < total) {
+        control.avanzar(static_cast<size_t>(registros), static_cast<size_t>(total));
+        uint32_t cabecera[2];
+        archivo.read(reinterpret_cast<char*>(cabecera), sizeof(cabecera));
+        if (!archivo) throw std::runtime_error("Archivo binario dañado: faltan bloques en " + ruta);
+        leidos += sizeof(cabecera);
+        // La cabecera del bloque se contrasta con lo que queda antes de reservar nada
+        if (cabecera[1] > totalBytes - leidos) throw std::runtime_error("Archivo binario dañado: bloque más largo que el archivo " + ruta);
+        if (cabecera[0] > total - registros) {
+            throw std::runtime_error("Archivo binario dañado: más filas que las declaradas");
+        }
+        bloque.resize(cabecera[1]);
+        archivo.read(&bloque[0], cabecera[1]);
+        if (!archivo) throw std::runtime_error("Archivo binario dañado: bloque truncado en " + ruta);
+        leidos += cabecera[1];
+
+        LectorBloque lector(bloque.data(), bloque.size());
+        for (uint32_t i = 0; i < cabecera[0]; ++i) {
+            Persona p = lector.persona();
+            ++registros;
+            // Mismas reglas que una fila CSV: el formato no garantiza que el contenido sea coherente
+            std::string error = motivoGrupoInvalido(p.getId(), p.getGrupoDeclaracion(), esquema);
+            if (error.empty() && !edadValida(p.getEdad())) error = "edad inválida: " + std::to_string(p.getEdad());
+            if (error.empty()) {
+                resultado.personas.push_back(std::move(p));
+                continue;
+            }
+            resultado.rechazadas++;
+            if (resultado.errores.size() < MAX_ERRORES_REPORTADOS) {
+                resultado.errores.push_back("Registro " + std::to_string(registros) + ": " + error);
+            }
+        }
+        if (!lector.terminado()) throw std::runtime_error("Archivo binario dañado: bytes sobrantes en un bloque");
+    }
+    if (registros != total) throw std::runtime_error("Archivo binario dañado: más filas que las declaradas");
+    control.avanzar(static_cast<size_t>(total), static_cast<size_t>(total));
+    return resultado;
+}
+
+// ---------------------------------------------------------------------------
+// Medición de los diccionarios
+// ---------------------------------------------------------------------------
+
+enum Catalogo { FEMENINOS, MASCULINOS, APELLIDOS_CATALOGO, CIUDADES, NUM_CATALOGOS };
+
+/**
+ * Busca los cuatro textos de catálogo de cada persona y cuenta los hallados.
+ */
+template <typename Buscar>
+static double codificarColeccion(const std::vector<Persona>& personas, const ControlOperacion& control, Buscar buscar,
+                                 size_t& encontrados) {
+    auto inicio = std::chrono::steady_clock::now();
+    size_t hallados = 0;
+    for (size_t desde = 0; desde < personas.size(); desde += control.tamFragmento) {
+        control.avanzar(desde, personas.size());
+        size_t hasta = std::min(personas.size(), desde + control.tamFragmento);
+        for (size_t i = desde; i < hasta; ++i) {
+            const Persona& p = personas[i];
+            const std::string& nombre = p.getNombre();
+            hallados += buscar(FEMENINOS, nombre.data(), nombre.size()) >= 0 ||
+                        buscar(MASCULINOS, nombre.data(), nombre.size()) >= 0;
+
+            const std::string& apellido = p.getApellido();
+            size_t corte = apellido.find(' ');
+            if (corte != std::string::npos) {
+                hallados += buscar(APELLIDOS_CATALOGO, apellido.data(), corte) >= 0;
+                hallados += buscar(APELLIDOS_CATALOGO, apellido.data() + corte + 1, apellido.size() - corte - 1) >= 0;
+            }
+            const std::string& ciudad = p.getCiudadNacimiento();
+            hallados += buscar(CIUDADES, ciudad.data(), ciudad.size()) >= 0;
+        }
+    }
+    std::chrono::duration<double, std::milli> duracion = std::chrono::steady_clock::now() - inicio;
+    encontrados = hallados;
+    return duracion.count();
+}
+
+std::vector<MedicionDiccionario> medirDiccionarios(const std::vector<Persona>& personas, const ControlOperacion& control) {
+    const std::vector<std::string>* listas[NUM_CATALOGOS] = {&catalogoNombresFemeninos(), &catalogoNombresMasculinos(),
+                                                             &catalogoApellidos(), &catalogoCiudades()};
+    std::unordered_map<std::string, int> mapas[NUM_CATALOGOS];
+    for (int c = 0; c < NUM_CATALOGOS; ++c) {
+        for (size_t i = 0; i < listas[c]->size(); ++i) mapas[c].emplace((*listas[c])[i], static_cast<int>(i));
+    }
+
+    auto perfecto = [](int catalogo, const char* datos, size_t largo) {
+        switch (catalogo) {
+            case FEMENINOS: return DICCIONARIO_NOMBRES_FEMENINOS.codigo(datos, largo);
+            case MASCULINOS: return DICCIONARIO_NOMBRES_MASCULINOS.codigo(datos, largo);
+            case APELLIDOS_CATALOGO: return DICCIONARIO_APELLIDOS.codigo(datos, largo);
+            default: return DICCIONARIO_CIUDADES.codigo(datos, largo);
+        }
+    };
+    auto lineal = [&listas](int catalogo, const char* datos, size_t largo) {
+        const std::vector<std::string>& lista = *listas[catalogo];
+        auto it = std::find_if(lista.begin(), lista.end(), [datos, largo](const std::string& t) {
+            return t.size() == largo && std::memcmp(t.data(), datos, largo) == 0;
+        });
+        return it == lista.end() ? -1 : static_cast<int>(it - lista.begin());
+    };
+    auto mapa = [&mapas](int catalogo, const char* datos, size_t largo) {
+        auto it = mapas[catalogo].find(std::string(datos, largo));
+        return it == mapas[catalogo].end() ? -1 : it->second;
+    };
+
+    std::vector<MedicionDiccionario> mediciones(3);
+    mediciones[0].estructura = "Hash perfecto";
+    mediciones[1].estructura = "std::find";
+    mediciones[2].estructura = "unordered_map";
+    std::vector<std::vector<double>> tiempos(3);
+    // Repeticiones intercaladas: la deriva de la máquina se reparte entre las tres
+    for (size_t r = 0; r < REPETICIONES; ++r) {
+        tiempos[0].push_back(codificarColeccion(personas, control, perfecto, mediciones[0].encontrados));
+        tiempos[1].push_back(codificarColeccion(personas, control, lineal, mediciones[1].encontrados));
+        tiempos[2].push_back(codificarColeccion(personas, control, mapa, mediciones[2].encontrados));
+    }
+    for (size_t m = 0; m < mediciones.size(); ++m) {
+        std::sort(tiempos[m].begin(), tiempos[m].end());
+        mediciones[m].ms = tiempos[m][tiempos[m].size() / 2];
+    }
+    return mediciones;
+}
+
+void mostrarMedicionDiccionarios(const std::vector<MedicionDiccionario>& mediciones, size_t filas, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+
+    salida << "\n=== CODIFICACIÓN DE TEXTOS DE CATÁLOGO (" << filas << " personas, 4 textos cada una, mediana de "
+           << REPETICIONES << ") ===\n";
+    salida << rellenar("Estructura", 16) << std::setw(12) << "ms" << std::setw(12) << "ns/texto" << std::setw(14)
+           << "Encontrados" << "\n";
+    salida << std::fixed;
+    for (const auto& m : mediciones) {
+        salida << rellenar(m.estructura, 16) << std::setprecision(2) << std::setw(12) << m.ms << std::setw(12)
+               << m.ms * 1e6 / std::max<size_t>(1, 4 * filas) << std::setw(14) << m.encontrados << "\n";
+    }
+    salida << "Hash perfecto mínimo: una ranura por clave; tablas de " << DICCIONARIO_CIUDADES.bytesTablas() << " (ciudades), "
+           << DICCIONARIO_NOMBRES_FEMENINOS.bytesTablas() << "/" << DICCIONARIO_NOMBRES_MASCULINOS.bytesTablas()
+           << " (nombres) y " << DICCIONARIO_APELLIDOS.bytesTablas() << " (apellidos) bytes, calculadas al compilar.\n";
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
@@ -0,0 +1,101 @@
+#ifndef IMPORTACION_H
+#define IMPORTACION_H
+
+#include "cancelacion.h"
+#include "persona.h"
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// IMPORTACIÓN Y EXPORTACIÓN DE PERSONAS (CSV Y BINARIO CODIFICADO)
+// ============================================================================
+// Los textos de catálogo (nombre, los dos apellidos, ciudad) se traducen a su
+// código con los diccionarios de hash perfecto de diccionarios.h:
+//   - CSV: cada fila se valida contra los catálogos y el esquema de grupos
+//     activo (el grupo debe ser el que fija su cédula); las filas inválidas
+//     se rechazan con su número de línea y la importación sigue.
+//   - Binario: cada texto de catálogo ocupa un byte (su código); un texto
+//     fuera del catálogo se escribe literal tras la marca 0xFF. Importarlo
+//     es indexar el catálogo, sin comparar textos. El grupo y la edad de
+//     cada registro se validan como en el CSV y los inválidos se rechazan.
+//
+// CSV: encabezado y columnas
+//   nombre,apellido,id,ciudad,fecha,grupo,edad,ingresos,patrimonio,deudas,declarante
+// con fecha D/M/AAAA (como la genera generarPersona), montos con 17 cifras (ida y vuelta exacta) y
+// declarante 1/0.
+//
+// BINARIO (orden de bytes nativo): "PERSDIC1", total de filas (uint64) y
+// bloques {filas, bytes (uint32), registros}. Registro: nombre (uint8
+// código), apellido (dos códigos), ciudad (código), id (uint64; bit alto =
+// sigue un texto), fecha y grupo (uint8 longitud + bytes), edad (int32),
+// ingresos, patrimonio, deudas (double), declarante (uint8). Un nombre,
+// apellido o ciudad fuera del catálogo se escribe como 0xFF + texto.
+// ============================================================================
+
+/**
+ * Resultado de una importación.
+ */
+struct ResultadoImportacion {
+    std::vector<Persona> personas;
+    size_t rechazadas = 0;
+    std::vector<std::string> errores; // Los primeros MAX_ERRORES_REPORTADOS
+};
+
+const size_t MAX_ERRORES_REPORTADOS = 10;
+
+/**
+ * @throws std::runtime_error si no se puede escribir
+ * @throws OperacionCancelada si se cancela (el archivo queda incompleto)
+ */
+void exportarCSV(const std::vector<Persona>& personas, const std::string& ruta,
+                 const ControlOperacion& control = ControlOperacion());
+
+/**
+ * IMPLEMENTACIÓN: Una línea a la vez, cortada en su lugar por las comas;
+ *                 el progreso se mide en bytes leídos
+ * @throws std::runtime_error si no se puede abrir o falta el encabezado
+ * @throws OperacionCancelada si se cancela
+ */
+ResultadoImportacion importarCSV(const std::string& ruta, const ControlOperacion& control = ControlOperacion());
+
+/**
+ * Bloques de control.tamFragmento filas.
+ *
+ * @throws std::runtime_error si no se puede escribir o un texto pasa de 255 bytes
+ * @throws OperacionCancelada si se cancela
+ */
+void exportarBinario(const std::vector<Persona>& personas, const std::string& ruta,
+                     const ControlOperacion& control = ControlOperacion());
+
+/**
+ * @throws std::runtime_error si el archivo no es de este formato, está
+ *         truncado o tiene códigos fuera de los catálogos
+ * @throws OperacionCancelada si se cancela
+ */
+ResultadoImportacion importarBinario(const std::string& ruta, const ControlOperacion& control = ControlOperacion());
+
+/**
+ * Tiempo de codificar los textos de catálogo de una colección con cada
+ * estructura (mismos textos, mismo orden).
+ */
+struct MedicionDiccionario {
+    std::string estructura;
+    double ms = 0.0;
+    size_t encontrados = 0; // Debe coincidir entre estructuras
+};
+
+/**
+ * Codifica nombre, apellidos y ciudad de cada persona con el hash perfecto,
+ * con std::find sobre el catálogo y con std::unordered_map<std::string, int>.
+ *
+ * @throws OperacionCancelada si se cancela
+ */
+std::vector<MedicionDiccionario> medirDiccionarios(const std::vector<Persona>& personas,
+                                                   const ControlOperacion& control = ControlOperacion());
+
+void mostrarMedicionDiccionarios(const std::vector<MedicionDiccionario>& mediciones, size_t filas,
+                                 std::ostream& salida = std::cout);
+
+#endif // IMPORTACION_H
@@ -0,0 +1,370 @@
+#include "indice_concurrente.h"
+#include "generador.h"
+#include "texto.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "El índice necesita atómicos de 64 bits sin candados");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Las ranuras se reservan como enteros en cero");
+
+static const uint64_t VACIA = 0;
+static const uint64_t MASCARA_FILA = (1ull << IndiceCedulasConcurrente::BITS_FILA) - 1;
+static const size_t MIN_FILAS_POR_HILO = 1 << 14;  // Por debajo no compensa lanzar otro hilo
+static const size_t LOTE_INDEXADO = 4096;          // Filas que publica el generador / toma un indexador
+static const size_t REPETICIONES = 3;
+static const size_t BUSQUEDAS_MAXIMAS = 1 << 20;
+static const uint64_t SEMILLA_BUSQUEDAS = 99;
+
+static volatile long long sumidero = 0;
+
+/**
+ * Ranura inicial: los bits bajos de la cédula, con los altos plegados.
+ *
+ * POR QUÉ no una mezcla completa: las cédulas de una colección suelen ser
+ * consecutivas (generarID, conjunto virtual), y así caen en ranuras
+ * consecutivas: cada hilo de la construcción escribe un tramo contiguo de
+ * la tabla, sin fallos de caché aleatorios ni líneas compartidas con otros
+ * hilos. El pliegue permuta dentro de ventanas de 2^14 ranuras para que
+ * cédulas múltiplo de una potencia de dos no se amontonen.
+ */
+static uint64_t ranuraInicial(uint64_t cedula) {
+    return cedula ^ (cedula >> 20);
+}
+
+// Carga máxima ~70%: capacidad = potencia de dos >= filas / 0,7
+static uint64_t capacidadPara(size_t filas) {
+    uint64_t capacidad = 16;
+    while (capacidad < filas + filas * 3 / 7) capacidad <<= 1;
+    return capacidad;
+}
+
+bool cedulaNumerica(const std::string& texto, uint64_t& cedula) {
+    if (texto.empty() || texto.size() > 11) return false;
+    cedula = 0;
+    for (char ch : texto) {
+        if (ch < '0' || ch > '9') return false;
+        cedula = cedula * 10 + static_cast<uint64_t>(ch - '0');
+    }
+    return cedula <= IndiceCedulasConcurrente::CEDULA_MAXIMA;
+}
+
+IndiceCedulasConcurrente::IndiceCedulasConcurrente(size_t filasPrevistas) {
+    if (filasPrevistas > FILAS_MAXIMAS) {
+        throw std::length_error("El índice de cédulas admite hasta " + std::to_string(FILAS_MAXIMAS) + " filas");
+    }
+    uint64_t capacidad = capacidadPara(filasPrevistas);
+    // calloc entrega páginas nuevas ya en cero sin recorrerlas; el primer
+    // toque de cada una ocurre en el hilo que inserta allí
+    void* memoria = std::calloc(capacidad, sizeof(std::atomic<uint64_t>));
+    if (!memoria) throw std::bad_alloc();
+    ranuras.reset(static_cast<std::atomic<uint64_t>*>(memoria));
+    mascara = capacidad - 1;
+}
+
+size_t IndiceCedulasConcurrente::bytesPara(size_t filasPrevistas) {
+    return capacidadPara(filasPrevistas) * sizeof(std::atomic<uint64_t>);
+}
+
+bool IndiceCedulasConcurrente::insertar(uint64_t cedula, uint32_t fila) {
+    if (cedula > CEDULA_MAXIMA || fila > MASCARA_FILA) {
+        throw std::invalid_argument("Entrada fuera de rango para el índice: cédula " + std::to_string(cedula) +
+                                    ", fila " + std::to_string(fila));
+    }
+    const uint64_t clave = cedula + 1;
+    const uint64_t entrada = (clave << BITS_FILA) | fila;
+    std::atomic<uint64_t>* tabla = ranuras.get();
+
+    uint64_t i = ranuraInicial(cedula) & mascara;
+    for (uint64_t sondeos = 0; sondeos <= mascara; ++sondeos, i = (i + 1) & mascara) {
+        uint64_t actual = tabla[i].load(std::memory_order_acquire);
+        if (actual == VACIA) {
+            if (tabla[i].compare_exchange_strong(actual, entrada, std::memory_order_release, std::memory_order_acquire)) {
+                return true;
+            }
+            // Otro hilo ganó la ranura: actual tiene su entrada
+        }
+        if ((actual >> BITS_FILA) != clave) continue;
+
+        // Cédula repetida: se queda la fila menor (la que encontraría buscarPorID)
+        while ((actual & MASCARA_FILA) > fila &&
+               !tabla[i].compare_exchange_weak(actual, entrada, std::memory_order_release, std::memory_order_acquire)) {
+        }
+        contadorRepetidas.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    throw std::length_error("El índice de cédulas está lleno (" + std::to_string(capacidad()) + " ranuras)");
+}
+
+void IndiceCedulasConcurrente::insertarTramo(const Persona* personas, size_t desde, size_t hasta) {
+    for (size_t fila = desde; fila < hasta; ++fila) {
+        uint64_t cedula;
+        if (!cedulaNumerica(personas[fila].getId(), cedula)) {
+            throw std::invalid_argument("La cédula no es numérica y no se puede indexar: " + personas[fila].getId());
+        }
+        insertar(cedula, static_cast<uint32_t>(fila));
+    }
+}
+
+long long IndiceCedulasConcurrente::buscar(uint64_t cedula) const {
+    if (cedula > CEDULA_MAXIMA) return -1;
+    const uint64_t clave = cedula + 1;
+    const std::atomic<uint64_t>* tabla = ranuras.get();
+
+    // A lo sumo una vuelta completa; con carga <= 70% termina en pocos sondeos
+    uint64_t i = ranuraInicial(cedula) & mascara;
+    for (uint64_t sondeos = 0; sondeos <= mascara; ++sondeos, i = (i + 1) & mascara) {
+        uint64_t actual = tabla[i].load(std::memory_order_acquire);
+        if (actual == VACIA) return -1;
+        if ((actual >> BITS_FILA) == clave) return static_cast<long long>(actual & MASCARA_FILA);
+    }
+    return -1;
+}
+
+long long IndiceCedulasConcurrente::buscar(const std::string& cedula) const {
+    uint64_t numero;
+    return cedulaNumerica(cedula, numero) ? buscar(numero) : -1;
+}
+
+std::unique_ptr<IndiceCedulasConcurrente> construirIndiceCedulas(const std::vector<Persona>& personas, unsigned hilos,
+                                                                 const ControlOperacion& control) {
+    const size_t n = personas.size();
+    auto indice = std::make_unique<IndiceCedulasConcurrente>(n);
+    if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+    hilos = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(hilos, n / MIN_FILAS_POR_HILO)));
+    const size_t porHilo = (n + hilos - 1) / hilos;
+
+    std::vector<std::future<void>> tramos;
+    for (unsigned h = 0; h < hilos; ++h) {
+        size_t inicio = std::min(n, h * porHilo);
+        size_t fin = std::min(n, inicio + porHilo);
+        ControlOperacion propio;
+        propio.token = control.token;
+        propio.tamFragmento = control.tamFragmento;
+        if (h == 0 && control.progreso) {
+            propio.progreso = [control, hilos, n](size_t hechas, size_t) {
+                control.progreso(std::min<size_t>(n, hechas * hilos), n);
+            };
+        }
+        tramos.push_back(std::async(std::launch::async, [&personas, &indice, inicio, fin, propio]() {
+            for (size_t desde = inicio; desde < fin; desde += propio.tamFragmento) {
+                propio.avanzar(desde - inicio, fin - inicio);
+                indice->insertarTramo(personas.data(), desde, std::min(fin, desde + propio.tamFragmento));
+            }
+        }));
+    }
+    for (auto& tramo : tramos) tramo.wait(); // Todos terminan antes de propagar un error
+    for (auto& tramo : tramos) tramo.get();
+    if (control.progreso) control.progreso(n, n);
+    return indice;
+}
+
+std::vector<Persona> generarColeccionIndexada(size_t n, std::unique_ptr<IndiceCedulasConcurrente>& indice, unsigned hilos,
+                                              const ControlOperacion& control) {
+    indice.reset();
+    if (hilos == 0) hilos = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    auto nuevo = std::make_unique<IndiceCedulasConcurrente>(n);
+
+    std::vector<Persona> personas;
+    personas.reserve(n);
+    const Persona* filas = personas.data(); // No cambia: nunca se supera la reserva
+
+    // Los indexadores que alcanzan al generador duermen hasta el próximo lote
+    // publicado en vez de girar: con menos núcleos que hilos, un indexador
+    // girando le quitaría tiempo justamente al generador al que espera
+    std::mutex candado;
+    std::condition_variable publicado;
+    size_t listas = 0;                 // Filas ya construidas y publicadas (protegido por candado)
+    bool detener = false;              // Idem
+    std::atomic<size_t> siguiente{0};  // Próximo lote sin indexador asignado
+
+    std::vector<std::future<void>> indexadores;
+    for (unsigned h = 0; h < hilos; ++h) {
+        indexadores.push_back(std::async(std::launch::async, [&, n]() {
+            for (;;) {
+                size_t desde = siguiente.fetch_add(LOTE_INDEXADO, std::memory_order_relaxed);
+                if (desde >= n) return;
+                size_t hasta = std::min(n, desde + LOTE_INDEXADO);
+                {
+                    std::unique_lock<std::mutex> espera(candado);
+                    publicado.wait(espera, [&] { return listas >= hasta || detener; });
+                    if (listas < hasta) return; // Generación cancelada
+                }
+                nuevo->insertarTramo(filas, desde, hasta);
+            }
+        }));
+    }
+
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo(); // Uno solo para toda la colección
+    try {
+        for (size_t inicio = 0; inicio < n; inicio += control.tamFragmento) {
+            control.avanzar(inicio, n);
+            size_t fin = std::min(n, inicio + control.tamFragmento);
+            for (size_t i = inicio; i < fin;) {
+                size_t corte = std::min(fin, i + LOTE_INDEXADO);
+                for (; i < corte; ++i) personas.push_back(generarPersona(*esquema));
+                {
+                    std::lock_guard<std::mutex> publicar(candado); // También ordena las filas antes que el contador
+                    listas = i;
+                }
+                publicado.notify_all();
+            }
+        }
+        control.avanzar(n, n);
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> cancelar(candado);
+            detener = true;
+        }
+        publicado.notify_all();
+        for (auto& indexador : indexadores) indexador.wait();
+        throw;
+    }
+    for (auto& indexador : indexadores) indexador.get();
+    indice = std::move(nuevo);
+    return personas;
+}
+
+/**
+ * Tiempo en ms de repartir [0, total) en tramos contiguos entre varios hilos.
+ */
+template <typename Tramo>
+static double medirEnHilos(unsigned hilos, size_t total, Tramo tramo) {
+    auto inicio = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> tareas;
+    const size_t porHilo = (total + hilos - 1) / hilos;
+    for (unsigned h = 0; h < hilos; ++h) {
+        size_t desde = std::min(total, h * porHilo);
+        size_t hasta = std::min(total, desde + porHilo);
+        tareas.push_back(std::async(std::launch::async, [=]() { tramo(desde, hasta); }));
+    }
+    for (auto& tarea : tareas) tarea.get();
+    std::chrono::duration<double, std::milli> duracion = std::chrono::steady_clock::now() - inicio;
+    return duracion.count();
+}
+
+static double mediana(std::vector<double> tiempos) {
+    std::sort(tiempos.begin(), tiempos.end());
+    return tiempos[tiempos.size() / 2];
+}
+
+ReporteEscalamiento medirEscalamientoIndice(const std::vector<Persona>& personas, const ControlOperacion& control) {
+    ReporteEscalamiento reporte;
+    reporte.filas = personas.size();
+
+    // Cédulas existentes en orden aleatorio (sin tocar rand(), que usa la generación)
+    std::vector<uint64_t> claves;
+    std::mt19937_64 azar(SEMILLA_BUSQUEDAS);
+    std::uniform_int_distribution<size_t> fila(0, personas.size() - 1);
+    reporte.busquedas = std::min(BUSQUEDAS_MAXIMAS, personas.size());
+    claves.reserve(reporte.busquedas);
+    for (size_t i = 0; i < reporte.busquedas; ++i) {
+        uint64_t cedula;
+        if (!cedulaNumerica(personas[fila(azar)].getId(), cedula)) {
+            throw std::invalid_argument("Hay cédulas no numéricas; el índice no se puede construir");
+        }
+        claves.push_back(cedula);
+    }
+
+    std::vector<unsigned> candidatos;
+    const unsigned maximo = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned h = 1; h < maximo; h *= 2) candidatos.push_back(h);
+    candidatos.push_back(maximo);
+
+    ControlOperacion sinProgreso;
+    sinProgreso.token = control.token;
+    sinProgreso.tamFragmento = control.tamFragmento;
+    const size_t pasos = candidatos.size() + 1;
+
+    for (size_t c = 0; c < candidatos.size(); ++c) {
+        control.avanzar(c, pasos);
+        const unsigned hilos = candidatos[c];
+        MedicionIndice medicion;
+        medicion.estructura = "Concurrente";
+        medicion.hilos = hilos;
+        std::vector<double> construir, buscar;
+        for (size_t r = 0; r < REPETICIONES; ++r) {
+            auto inicio = std::chrono::steady_clock::now();
+            std::unique_ptr<IndiceCedulasConcurrente> indice = construirIndiceCedulas(personas, hilos, sinProgreso);
+            std::chrono::duration<double, std::milli> duracion = std::chrono::steady_clock::now() - inicio;
+            construir.push_back(duracion.count());
+            buscar.push_back(medirEnHilos(hilos, claves.size(), [&claves, &indice](size_t desde, size_t hasta) {
+                long long suma = 0;
+                for (size_t i = desde; i < hasta; ++i) suma += indice->buscar(claves[i]);
+                sumidero = sumidero + suma;
+            }));
+            medicion.bytes = indice->bytes();
+        }
+        medicion.msConstruir = mediana(construir);
+        medicion.msBuscar = mediana(buscar);
+        reporte.mediciones.push_back(medicion);
+    }
+
+    // Referencia: std::unordered_map de un solo hilo con la reserva ya hecha
+    control.avanzar(candidatos.size(), pasos);
+    MedicionIndice mapa;
+    mapa.estructura = "unordered_map";
+    std::vector<double> construir, buscar;
+    for (size_t r = 0; r < REPETICIONES; ++r) {
+        auto inicio = std::chrono::steady_clock::now();
+        std::unordered_map<uint64_t, uint32_t> indice;
+        indice.reserve(personas.size());
+        for (size_t desde = 0; desde < personas.size(); desde += control.tamFragmento) {
+            sinProgreso.avanzar(desde, personas.size());
+            size_t hasta = std::min(personas.size(), desde + control.tamFragmento);
+            for (size_t i = desde; i < hasta; ++i) {
+                uint64_t cedula = 0;
+                cedulaNumerica(personas[i].getId(), cedula);
+                indice.emplace(cedula, static_cast<uint32_t>(i));
+            }
+        }
+        std::chrono::duration<double, std::milli> duracion = std::chrono::steady_clock::now() - inicio;
+        construir.push_back(duracion.count());
+        buscar.push_back(medirEnHilos(1, claves.size(), [&claves, &indice](size_t desde, size_t hasta) {
+            long long suma = 0;
+            for (size_t i = desde; i < hasta; ++i) suma += indice.find(claves[i])->second;
+            sumidero = sumidero + suma;
+        }));
+        // Cubetas más un nodo por entrada (siguiente + par, redondeado por malloc)
+        mapa.bytes = indice.bucket_count() * sizeof(void*) + indice.size() * 32;
+    }
+    mapa.msConstruir = mediana(construir);
+    mapa.msBuscar = mediana(buscar);
+    reporte.mediciones.push_back(mapa);
+    control.avanzar(pasos, pasos);
+    return reporte;
+}
+
+void mostrarEscalamientoIndice(const ReporteEscalamiento& reporte, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+
+    salida << "\n=== ÍNDICE DE CÉDULAS (" << reporte.filas << " filas, " << reporte.busquedas
+           << " búsquedas, mediana de " << REPETICIONES << ") ===\n";
+    salida << rellenar("Estructura", 16) << std::setw(6) << "Hilos" << std::setw(14) << "Construir ms" << std::setw(12)
+           << "Acelera" << std::setw(14) << "Buscar ms" << std::setw(12) << "ns/búsq" << std::setw(10) << "MB" << "\n";
+    salida << std::fixed;
+    const double base = reporte.mediciones.empty() ? 0.0 : reporte.mediciones.front().msConstruir;
+    for (const auto& m : reporte.mediciones) {
+        salida << rellenar(m.estructura, 16) << std::setw(6) << m.hilos << std::setprecision(1) << std::setw(14)
+               << m.msConstruir << std::setprecision(2) << std::setw(11) << (m.msConstruir > 0 ? base / m.msConstruir : 0.0)
+               << "x" << std::setprecision(1) << std::setw(14) << m.msBuscar << std::setw(12)
+               << m.msBuscar * 1e6 / std::max<size_t>(1, reporte.busquedas) << std::setw(10)
+               << m.bytes / (1024.0 * 1024.0) << "\n";
+    }
+    salida << "Aceleración respecto a la construcción concurrente con 1 hilo; ns/búsqueda es tiempo de pared\n"
+              "dividido entre todas las búsquedas (con varios hilos, se reparten).\n";
+    if (std::thread::hardware_concurrency() <= 1) {
+        salida << "Esta máquina expone un solo hilo de hardware: el escalamiento no se puede observar aquí.\n";
+    }
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
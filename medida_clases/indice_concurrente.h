@@ -0,0 +1,165 @@
+#ifndef INDICE_CONCURRENTE_H
+#define INDICE_CONCURRENTE_H
+
+#include "cancelacion.h"
+#include "persona.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// ÍNDICE DE CÉDULAS CONCURRENTE (SIN CANDADOS)
+// ============================================================================
+// Tabla hash de direccionamiento abierto con sondeo lineal, de capacidad fija
+// (potencia de dos, carga máxima ~70%). Cada ranura es un único entero
+// atómico de 64 bits que empaqueta cédula + 1 (34 bits altos; 0 = vacía) y
+// fila (30 bits bajos), así que una inserción es un solo compare-and-swap y
+// una lectura nunca ve una entrada a medio escribir.
+// La ranura inicial sale de los bits bajos de la cédula, de modo que
+// cédulas consecutivas ocupan ranuras consecutivas y cada hilo escribe en
+// su propia zona de la tabla.
+//   - Insertar es lock-free: un hilo solo reintenta si otro ganó la ranura,
+//     y entonces ese otro avanzó.
+//   - Buscar es wait-free: cargas atómicas hasta la cédula o una ranura
+//     vacía, sin reintentos ni esperas por otros hilos.
+// Varios hilos insertan a la vez sin coordinarse, de modo que el índice se
+// puede construir por tramos en paralelo o mientras la generación todavía
+// está produciendo filas.
+// ============================================================================
+
+/**
+ * Índice cédula -> fila con inserciones concurrentes.
+ *
+ * NOTA: Cédulas repetidas conservan la fila menor, como buscarPorID, sin
+ *       importar el orden en que los hilos las inserten
+ * ADVERTENCIA: No admite borrados; debe reconstruirse si las filas cambian
+ *              de posición o la colección se regenera
+ */
+class IndiceCedulasConcurrente {
+public:
+    static const int BITS_FILA = 30;
+    static const uint64_t FILAS_MAXIMAS = 1ull << BITS_FILA;          // ~1.070 millones
+    static const uint64_t CEDULA_MAXIMA = (1ull << (64 - BITS_FILA)) - 2; // Cubre cualquier cédula de 10 dígitos
+
+    /**
+     * Reserva la tabla para hasta filasPrevistas entradas; las páginas se
+     * piden ya en cero al sistema, así que se asignan a medida que los
+     * hilos insertan y no en un recorrido previo de un solo hilo.
+     *
+     * @throws std::length_error si filasPrevistas supera FILAS_MAXIMAS
+     * @throws std::bad_alloc si no hay memoria
+     */
+    explicit IndiceCedulasConcurrente(size_t filasPrevistas);
+
+    /** Bytes que ocupará la tabla para filasPrevistas (para estimar antes de generar). */
+    static size_t bytesPara(size_t filasPrevistas);
+
+    /**
+     * Inserta una entrada. Seguro desde varios hilos a la vez.
+     *
+     * @return false si la cédula ya estaba (queda la fila menor)
+     * @throws std::invalid_argument si la cédula o la fila no caben
+     * @throws std::length_error si la tabla está llena (más filas de las previstas)
+     */
+    bool insertar(uint64_t cedula, uint32_t fila);
+
+    /**
+     * Inserta las filas [desde, hasta) de un arreglo de personas.
+     *
+     * @throws std::invalid_argument si alguna cédula no es numérica
+     */
+    void insertarTramo(const Persona* personas, size_t desde, size_t hasta);
+
+    /** Fila de la cédula o -1. Wait-free; seguro durante inserciones. */
+    long long buscar(uint64_t cedula) const;
+
+    /** Como buscar, con la cédula en texto; -1 también si no es numérica. */
+    long long buscar(const std::string& cedula) const;
+
+    size_t capacidad() const { return mascara + 1; }
+    size_t bytes() const { return capacidad() * sizeof(std::atomic<uint64_t>); }
+
+    /** Inserciones que encontraron su cédula ya presente. */
+    size_t repetidas() const { return contadorRepetidas.load(std::memory_order_relaxed); }
+
+private:
+    struct LiberarRanuras {
+        void operator()(std::atomic<uint64_t>* p) const { std::free(p); }
+    };
+
+    std::unique_ptr<std::atomic<uint64_t>, LiberarRanuras> ranuras;
+    uint64_t mascara = 0;
+    std::atomic<size_t> contadorRepetidas{0};
+};
+
+/**
+ * Cédula en texto como número (solo dígitos, hasta CEDULA_MAXIMA).
+ */
+bool cedulaNumerica(const std::string& texto, uint64_t& cedula);
+
+/**
+ * Índice de una colección existente, construido con varios hilos.
+ *
+ * IMPLEMENTACIÓN: Un tramo contiguo de filas por hilo, por fragmentos de
+ *                 control.tamFragmento; el progreso lo reporta el hilo 0
+ * @param hilos 0 = hardware_concurrency()
+ * @throws std::invalid_argument si alguna cédula no es numérica
+ * @throws OperacionCancelada si se cancela
+ */
+std::unique_ptr<IndiceCedulasConcurrente> construirIndiceCedulas(const std::vector<Persona>& personas, unsigned hilos = 0,
+                                                                 const ControlOperacion& control = ControlOperacion());
+
+/**
+ * Genera n personas como generarColeccion y, a la vez, las indexa.
+ *
+ * IMPLEMENTACIÓN: El hilo que llama genera (generarPersona usa rand(), que
+ *                 no es seguro entre hilos) y publica cuántas filas están
+ *                 listas; los hilos indexadores toman lotes de filas ya
+ *                 publicadas (durmiendo en una variable de condición si
+ *                 todavía no lo están) y los insertan en la tabla sin
+ *                 candados. El vector se
+ *                 reserva completo antes de empezar, así que las filas
+ *                 publicadas no se mueven mientras se leen
+ * @param hilos Hilos indexadores (0 = hardware_concurrency() - 1, mínimo 1)
+ * @param indice Recibe el índice; queda vacío si se cancela
+ * @throws std::length_error si n supera IndiceCedulasConcurrente::FILAS_MAXIMAS
+ * @throws OperacionCancelada si se cancela (los indexadores se detienen antes)
+ */
+std::vector<Persona> generarColeccionIndexada(size_t n, std::unique_ptr<IndiceCedulasConcurrente>& indice,
+                                              unsigned hilos = 0, const ControlOperacion& control = ControlOperacion());
+
+/**
+ * Una fila de la tabla de escalamiento.
+ */
+struct MedicionIndice {
+    std::string estructura; // "Concurrente", "unordered_map", ...
+    unsigned hilos = 1;
+    double msConstruir = 0.0; // Mediana
+    double msBuscar = 0.0;    // Mediana de las búsquedas de muestra
+    size_t bytes = 0;
+};
+
+struct ReporteEscalamiento {
+    size_t filas = 0;
+    size_t busquedas = 0;
+    std::vector<MedicionIndice> mediciones;
+};
+
+/**
+ * Mide la construcción del índice con 1, 2, 4, ... hasta hardware_concurrency()
+ * hilos (y ese máximo si no es potencia de dos), frente a un
+ * std::unordered_map de un solo hilo con reserva previa. Las búsquedas usan
+ * las mismas cédulas existentes en orden aleatorio.
+ *
+ * @throws OperacionCancelada si se cancela
+ */
+ReporteEscalamiento medirEscalamientoIndice(const std::vector<Persona>& personas,
+                                            const ControlOperacion& control = ControlOperacion());
+
+void mostrarEscalamientoIndice(const ReporteEscalamiento& reporte, std::ostream& salida = std::cout);
+
+#endif // INDICE_CONCURRENTE_H
@@ -0,0 +1,198 @@
+#include "indices_persistentes.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+static const char MAGICO[8] = {'P', 'E', 'R', 'S', 'I', 'D', 'X', '1'};
+
+// Orden de las secciones en el archivo
+enum SeccionIndice {
+    SEC_ID,             // {id uint64, fila uint32, 0 uint32}
+    SEC_CIUDADES_OFF,   // Offsets de los nombres (uint32, ciudades + 1)
+    SEC_CIUDADES_TXT,   // Nombres concatenados
+    SEC_INICIO_CIUDAD,
+    SEC_FILAS_CIUDAD,
+    SEC_GRUPOS_OFF,
+    SEC_GRUPOS_TXT,
+    SEC_INICIO_GRUPO,
+    SEC_FILAS_GRUPO,
+    SEC_ORDEN_EDAD,
+    SEC_EDADES,         // int32
+    NUM_SECCIONES
+};
+
+struct CabeceraIndices {
+    char magico[8];
+    uint64_t huella;
+    uint64_t filas;
+    uint64_t numSecciones;
+};
+
+struct Seccion {
+    uint64_t desplazamiento; // Desde el inicio del archivo
+    uint64_t bytes;
+};
+
+static_assert(sizeof(IndicesColeccion::EntradaID) == 16, "EntradaID debe ocupar 16 bytes en disco");
+static_assert(sizeof(int) == 4, "Las edades se guardan como int32");
+
+std::string rutaIndices(const std::string& rutaInstantanea) {
+    return rutaInstantanea + ".idx";
+}
+
+/**
+ * Agrega una sección al cuerpo, alineada a 8 bytes para poder leerla
+ * directamente desde la proyección en memoria.
+ */
+static void agregarSeccion(std::string& cuerpo, std::vector<Seccion>& secciones, uint64_t base,
+                           const void* datos, size_t bytes) {
+    cuerpo.append((8 - cuerpo.size() % 8) % 8, '\0');
+    secciones.push_back({base + cuerpo.size(), bytes});
+    cuerpo.append(static_cast<const char*>(datos), bytes);
+}
+
+static void agregarTextos(std::string& cuerpo, std::vector<Seccion>& secciones, uint64_t base,
+                          const std::vector<std::string>& textos) {
+    std::vector<uint32_t> offsets(1, 0);
+    std::string concatenados;
+    for (const auto& t : textos) {
+        concatenados += t;
+        offsets.push_back(static_cast<uint32_t>(concatenados.size()));
+    }
+    agregarSeccion(cuerpo, secciones, base, offsets.data(), offsets.size() * sizeof(uint32_t));
+    agregarSeccion(cuerpo, secciones, base, concatenados.data(), concatenados.size());
+}
+
+template <typename T>
+static void agregarVector(std::string& cuerpo, std::vector<Seccion>& secciones, uint64_t base,
+                          const std::vector<T>& v) {
+    agregarSeccion(cuerpo, secciones, base, v.data(), v.size() * sizeof(T));
+}
+
+void guardarIndices(const std::string& ruta, const IndicesColeccion& indices, uint64_t huella, uint64_t filas) {
+    const uint64_t base = sizeof(CabeceraIndices) + NUM_SECCIONES * sizeof(Seccion);
+    std::string cuerpo;
+    std::vector<Seccion> secciones;
+
+    // Entradas copiadas a un búfer en ceros para no escribir el relleno sin inicializar
+    std::vector<IndicesColeccion::EntradaID> ids(indices.idOrdenado.size());
+    std::memset(static_cast<void*>(ids.data()), 0, ids.size() * sizeof(ids[0]));
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ids[i].id = indices.idOrdenado[i].id;
+        ids[i].fila = indices.idOrdenado[i].fila;
+    }
+    agregarVector(cuerpo, secciones, base, ids);
+    agregarTextos(cuerpo, secciones, base, indices.ciudades);
+    agregarVector(cuerpo, secciones, base, indices.inicioCiudad);
+    agregarVector(cuerpo, secciones, base, indices.filasCiudad);
+    agregarTextos(cuerpo, secciones, base, indices.grupos);
+    agregarVector(cuerpo, secciones, base, indices.inicioGrupo);
+    agregarVector(cuerpo, secciones, base, indices.filasGrupo);
+    agregarVector(cuerpo, secciones, base, indices.ordenEdad);
+    agregarVector(cuerpo, secciones, base, indices.edadesOrdenadas);
+
+    CabeceraIndices cabecera;
+    std::memcpy(cabecera.magico, MAGICO, sizeof(MAGICO));
+    cabecera.huella = huella;
+    cabecera.filas = filas;
+    cabecera.numSecciones = NUM_SECCIONES;
+
+    std::ofstream archivo(ruta, std::ios::binary | std::ios::trunc);
+    archivo.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    archivo.write(reinterpret_cast<const char*>(secciones.data()), secciones.size() * sizeof(Seccion));
+    archivo.write(cuerpo.data(), cuerpo.size());
+    if (!archivo) throw std::runtime_error("No se pudieron guardar los índices en " + ruta);
+}
+
+/**
+ * Vista de solo lectura sobre el archivo proyectado.
+ */
+class ArchivoIndices {
+public:
+    explicit ArchivoIndices(const std::string& ruta) : ruta(ruta) {
+        int fd = ::open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("No hay índices guardados en " + ruta);
+        struct stat info;
+        const off_t minimo = sizeof(CabeceraIndices) + NUM_SECCIONES * sizeof(Seccion);
+        if (::fstat(fd, &info) != 0 || info.st_size < minimo) {
+            ::close(fd);
+            throw std::runtime_error("Archivo de índices dañado: " + ruta);
+        }
+        tamano = static_cast<size_t>(info.st_size);
+        mapa = ::mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // La proyección sigue válida sin el descriptor
+        if (mapa == MAP_FAILED) throw std::runtime_error("No se pudo proyectar " + ruta);
+    }
+
+    ~ArchivoIndices() { ::munmap(mapa, tamano); }
+    ArchivoIndices(const ArchivoIndices&) = delete;
+    ArchivoIndices& operator=(const ArchivoIndices&) = delete;
+
+    const CabeceraIndices& cabecera() const { return *static_cast<const CabeceraIndices*>(mapa); }
+
+    /**
+     * Copia una sección a un vector comprobando límites y tamaño.
+     */
+    template <typename T>
+    void copiar(size_t numero, std::vector<T>& destino) const {
+        const Seccion& s = seccion(numero);
+        if (s.bytes % sizeof(T) != 0) throw std::runtime_error("Sección de índices dañada en " + ruta);
+        destino.resize(s.bytes / sizeof(T));
+        if (s.bytes) std::memcpy(static_cast<void*>(destino.data()), base() + s.desplazamiento, s.bytes);
+    }
+
+    void copiarTextos(size_t numOffsets, size_t numTexto, std::vector<std::string>& destino) const {
+        std::vector<uint32_t> offsets;
+        copiar(numOffsets, offsets);
+        const Seccion& texto = seccion(numTexto);
+        destino.clear();
+        for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+            if (offsets[i] > offsets[i + 1] || offsets[i + 1] > texto.bytes) {
+                throw std::runtime_error("Diccionario de índices dañado en " + ruta);
+            }
+            destino.emplace_back(base() + texto.desplazamiento + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+    }
+
+private:
+    const char* base() const { return static_cast<const char*>(mapa); }
+
+    const Seccion& seccion(size_t numero) const {
+        const Seccion& s = reinterpret_cast<const Seccion*>(base() + sizeof(CabeceraIndices))[numero];
+        if (s.desplazamiento > tamano || s.bytes > tamano - s.desplazamiento) {
+            throw std::runtime_error("Sección de índices fuera del archivo en " + ruta);
+        }
+        return s;
+    }
+
+    std::string ruta;
+    void* mapa = nullptr;
+    size_t tamano = 0;
+};
+
+IndicesColeccion cargarIndices(const std::string& ruta, uint64_t huella, uint64_t filas) {
+    ArchivoIndices archivo(ruta);
+    const CabeceraIndices& cabecera = archivo.cabecera();
+    if (std::memcmp(cabecera.magico, MAGICO, sizeof(MAGICO)) != 0 || cabecera.numSecciones != NUM_SECCIONES) {
+        throw std::runtime_error("Archivo de índices no válido: " + ruta);
+    }
+    if (cabecera.huella != huella || cabecera.filas != filas) {
+        throw std::runtime_error("Los índices de " + ruta + " pertenecen a otro conjunto de datos");
+    }
+
+    IndicesColeccion indices;
+    archivo.copiar(SEC_ID, indices.idOrdenado);
+    archivo.copiarTextos(SEC_CIUDADES_OFF, SEC_CIUDADES_TXT, indices.ciudades);
+    archivo.copiar(SEC_INICIO_CIUDAD, indices.inicioCiudad);
+    archivo.copiar(SEC_FILAS_CIUDAD, indices.filasCiudad);
+    archivo.copiarTextos(SEC_GRUPOS_OFF, SEC_GRUPOS_TXT, indices.grupos);
+    archivo.copiar(SEC_INICIO_GRUPO, indices.inicioGrupo);
+    archivo.copiar(SEC_FILAS_GRUPO, indices.filasGrupo);
+    archivo.copiar(SEC_ORDEN_EDAD, indices.ordenEdad);
+    archivo.copiar(SEC_EDADES, indices.edadesOrdenadas);
+    return indices;
+}
@@ -0,0 +1,42 @@
+#ifndef INDICES_PERSISTENTES_H
+#define INDICES_PERSISTENTES_H
+
+#include "planificador.h"
+#include <cstdint>
+#include <string>
+
+// ============================================================================
+// ÍNDICES PERSISTENTES JUNTO A LA INSTANTÁNEA DE DATOS
+// ============================================================================
+// Los índices del planificador (IndicesColeccion) se guardan en un archivo
+// propio al lado de la instantánea (<ruta>.idx). Son vectores planos de
+// enteros y offsets, así que el archivo es una cabecera con una tabla de
+// secciones (desplazamiento + bytes, alineadas a 8) seguida de los arreglos
+// tal cual: se proyecta con mmap y se copia sin reconstruir nada.
+//
+// La cabecera guarda la huella de la instantánea; si no coincide con la de
+// los datos cargados, los índices se rechazan y se reconstruyen.
+// ============================================================================
+
+/**
+ * Ruta del archivo de índices asociado a una instantánea.
+ */
+std::string rutaIndices(const std::string& rutaInstantanea);
+
+/**
+ * Guarda los índices con la huella de la instantánea a la que pertenecen.
+ *
+ * @throws std::runtime_error si no se puede escribir
+ */
+void guardarIndices(const std::string& ruta, const IndicesColeccion& indices, uint64_t huella, uint64_t filas);
+
+/**
+ * Carga índices guardados con guardarIndices.
+ *
+ * @param huella Huella esperada (la de la instantánea cargada)
+ * @param filas Filas esperadas
+ * @throws std::runtime_error si el archivo falta, está dañado o es de otros datos
+ */
+IndicesColeccion cargarIndices(const std::string& ruta, uint64_t huella, uint64_t filas);
+
+#endif // INDICES_PERSISTENTES_H
@@ -5,6 +5,33 @@
 #include "persona.h"
 #include "generador.h"
 #include "monitor.h"
+#include "planificador.h"
+#include "zonas.h"
+#include "seleccion.h"
+#include "cursor.h"
+#include "cancelacion.h"
+#include "cache_resultados.h"
+#include "precalculo.h"
+#include "coleccion_disco.h"
+#include "indices_persistentes.h"
+#include "conjuntos.h"
+#include "banco_pruebas.h"
+#include "patrones_acceso.h"
+#include "mapas_bits.h"
+#include "coleccion_virtual.h"
+#include "traza.h"
+#include "carga.h"
+#include "declaraciones.h"
+#include "historial.h"
+#include "autoajuste.h"
+#include "esquema_grupos.h"
+#include "indice_concurrente.h"
+#include "importacion.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
 
 /**
  * Muestra el menú principal de la aplicación.
@@ -16,15 +43,15 @@
 void mostrarMenu() {
     std::cout << "\n\n=== MENÚ PRINCIPAL ===";
     std::cout << "\n0. Crear nuevo conjunto de datos.";
-    std::cout << "\n1. Mostrar resumen de todas las personas.";
+    std::cout << "\n1. Mostrar resumen de todas las personas (paginado).";
     std::cout << "\n2. Mostrar detalle completo por índice.";
     std::cout << "\n3. Buscar persona por ID.";
     std::cout << "\n4. Buscar persona mas longeva por valor.";
     std::cout << "\n5. Buscar persona mas longeva por referencia.";
     std::cout << "\n6. Buscar persona con mas patrimonio por valor.";
     std::cout << "\n7. Buscar persona con mas patrimonio por referencia.";
-    std::cout << "\n8. Listar personas por grupo (A, B o C) por valor.";
-    std::cout << "\n9. Listar personas por grupo (A, B o C) por referencia.";
+    std::cout << "\n8. Listar personas por grupo de declaración por valor (paginado).";
+    std::cout << "\n9. Listar personas por grupo de declaración por referencia (paginado).";
     std::cout << "\n10. Verificar grupos por valor.";
     std::cout << "\n11. Verificar grupos por referencia.";
     std::cout << "\n12. Encontrar grupo con mayor patrimonio en promedio por valor.";
@@ -34,9 +61,221 @@ void mostrarMenu() {
     std::cout << "\n16. Mostrar estadísticas de rendimiento.";
     std::cout << "\n17. Exportar estadísticas a CSV.";
     std::cout << "\n18. Salir.";
+    std::cout << "\n19. Consulta combinada con planificador (EXPLAIN).";
+    std::cout << "\n20. Consultas con mapas de zonas por bloque.";
+    std::cout << "\n21. Medir sobrecosto de la cancelación cooperativa.";
+    std::cout << "\n22. Activar/desactivar precálculo en segundo plano.";
+    std::cout << "\n23. Conjunto en disco (más grande que la memoria).";
+    std::cout << "\n24. Guardar/cargar instantánea con índices.";
+    std::cout << "\n25. Conjuntos con nombre (comparar generaciones).";
+    std::cout << "\n26. Banco de pruebas sin ruido (valor vs referencia, clase vs estructura).";
+    std::cout << "\n27. Mapa de patrones de acceso (contiguo, punteros, índices) por nivel de caché.";
+    std::cout << "\n28. Filtros combinados con mapas de bits (ciudad, grupo, declarante).";
+    std::cout << "\n29. Conjunto virtual (cada persona calculada desde semilla e índice).";
+    std::cout << "\n30. Grabar/reproducir la sesión (traza de operaciones).";
+    std::cout << "\n31. Prueba de carga concurrente con claves Zipf (latencia p50/p99/p99.9).";
+    std::cout << "\n32. Declaraciones de renta: unión por cédula (hash radix vs ordenar y mezclar).";
+    std::cout << "\n33. Historial financiero multianual comprimido (crecimiento por ciudad).";
+    std::cout << "\n34. Calibrar fragmento, lote y prefetch para esta máquina.";
+    std::cout << "\n35. Esquema de grupos de declaración (reglas por dígitos de la cédula).";
+    std::cout << "\n36. Índice de cédulas concurrente (construcción en paralelo, búsqueda y escalamiento).";
+    std::cout << "\n37. Importar/exportar personas (CSV o binario con diccionarios de hash perfecto).";
     std::cout << "\nSeleccione una opción: ";
 }
 
+/**
+ * Copia plana de Persona para la comparación clase vs estructura.
+ * 
+ * POR QUÉ: medida_estructuras es otro programa; comparar entre procesos mezcla ruido de ambos.
+ * CÓMO: Los mismos once campos, en el mismo orden, públicos y sin getters, como el struct de ese programa.
+ * PARA QUÉ: Medir las dos formas con el mismo tamaño de registro (misma huella en caché) y los mismos datos.
+ */
+struct PersonaPlana {
+    std::string nombre;
+    std::string apellido;
+    std::string id;
+    std::string ciudadNacimiento;
+    std::string fechaNacimiento;
+    std::string grupoDeclaracion;
+    int edad;
+    double ingresosAnuales;
+    double patrimonio;
+    double deudas;
+    bool declaranteRenta;
+};
+
+/**
+ * Envuelve la colección en un shared_ptr que no la libera.
+ * 
+ * POR QUÉ: Los cursores comparten la colección sin ser sus dueños.
+ * CÓMO: shared_ptr con un borrador vacío.
+ * PARA QUÉ: Usar el mismo cursor para resultados propios (copias) y ajenos.
+ */
+std::shared_ptr<const std::vector<Persona>> vistaCompartida(const std::vector<Persona>& personas) {
+    return std::shared_ptr<const std::vector<Persona>>(&personas, [](const std::vector<Persona>*) {});
+}
+
+/**
+ * Pide el tamaño de página y la clave de orden de un listado nuevo.
+ * 
+ * POR QUÉ: Cada listado paginado necesita ambos parámetros.
+ * CÓMO: Leyendo de la entrada estándar con valores por defecto ante errores.
+ * PARA QUÉ: Reutilizar el mismo diálogo en las opciones 1, 8 y 9.
+ */
+void pedirPaginacion(size_t& tamPagina, ClaveOrden& orden) {
+    std::string textoOrden;
+    std::cout << "Tamaño de página: ";
+    if (!(std::cin >> tamPagina) || tamPagina == 0) {
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        tamPagina = 20;
+    }
+    std::cout << "Ordenar por (ninguno, id, edad, patrimonio, ingresos): ";
+    std::cin >> textoOrden;
+    orden = claveOrdenDesdeTexto(textoOrden);
+}
+
+/**
+ * Ofrece reanudar el cursor abierto si corresponde a la misma consulta.
+ * 
+ * POR QUÉ: El filtro de una consulta ya calculada no debe repetirse.
+ * CÓMO: Comparando la clave de la consulta con la del cursor activo.
+ * PARA QUÉ: Continuar un listado largo entre interacciones del menú.
+ * @return true si el usuario decide reanudar
+ */
+bool reanudarCursor(const std::unique_ptr<CursorListado>& cursor, const std::string& consulta) {
+    if (!cursor || cursor->consulta() != consulta) return false;
+    std::cout << "\nHay un listado abierto para esta consulta en la fila " << cursor->desplazamiento() + 1
+              << " de " << cursor->total() << ". ¿Reanudar? (s/n): ";
+    std::string respuesta;
+    std::cin >> respuesta;
+    return respuesta == "s";
+}
+
+/**
+ * Recorre un cursor página a página según los comandos del usuario.
+ * 
+ * POR QUÉ: Evitar volcar millones de filas a la terminal.
+ * CÓMO: Mostrando una página y esperando el siguiente comando.
+ * PARA QUÉ: Pagar solo el costo de las filas que realmente se muestran.
+ * @return Tiempo de proyección acumulado de las páginas mostradas (ms)
+ */
+double navegarCursor(CursorListado& cursor) {
+    double tiempo = cursor.mostrarPagina();
+    std::string comando;
+    while (true) {
+        std::cout << "[s]iguiente, [a]nterior, [i]r a fila, [q] volver al menú: ";
+        if (!(std::cin >> comando) || comando == "q") break;
+
+        if (comando == "s") {
+            if (!cursor.siguiente()) { std::cout << "Ya está en la última página.\n"; continue; }
+        } else if (comando == "a") {
+            if (!cursor.anterior()) { std::cout << "Ya está en la primera página.\n"; continue; }
+        } else if (comando == "i") {
+            size_t fila;
+            std::cout << "Fila (1-" << cursor.total() << "): ";
+            if (!(std::cin >> fila)) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                continue;
+            }
+            cursor.irA(fila > 0 ? fila - 1 : 0);
+        } else {
+            std::cout << "Comando inválido!\n";
+            continue;
+        }
+        tiempo += cursor.mostrarPagina();
+    }
+    return tiempo;
+}
+
+/**
+ * Ejecuta una consulta pasando por la caché de resultados.
+ * 
+ * POR QUÉ: Las mismas preguntas sobre datos sin cambios no deben recalcularse.
+ * CÓMO: Si hay acierto imprime la salida guardada; si no, ejecuta la consulta
+ *       capturando lo que imprime, lo muestra y lo guarda.
+ * PARA QUÉ: Responder en microsegundos las consultas repetidas.
+ * @param calcular Función que resuelve la consulta e imprime su resultado
+ * @return true si la respuesta salió de la caché (no se ejecutó nada)
+ */
+template <typename Calculo>
+bool consultarConCache(CacheResultados& cache, Monitor& monitor, const std::string& operacion,
+                       const std::string& parametros, unsigned long version, Calculo calcular) {
+    std::string resultado;
+    if (cache.buscar(operacion, parametros, version, resultado)) {
+        monitor.registrar_acierto_cache();
+        std::cout << "\n(Resultado desde caché)\n" << resultado;
+        return true;
+    }
+    monitor.registrar_fallo_cache();
+
+    std::ostringstream captura;
+    std::streambuf* salidaOriginal = std::cout.rdbuf(captura.rdbuf());
+    try {
+        calcular();
+    } catch (...) {
+        std::cout.rdbuf(salidaOriginal);
+        throw;
+    }
+    std::cout.rdbuf(salidaOriginal);
+
+    resultado = captura.str();
+    std::cout << resultado;
+    cache.guardar(operacion, parametros, version, resultado);
+    return false;
+}
+
+/**
+ * De dónde salió la respuesta de una consulta de las opciones 4-15.
+ */
+enum class OrigenRespuesta {
+    EJECUCION,  // Se recorrió la colección
+    CACHE,      // Acierto en la caché de resultados
+    PRECALCULO  // Respuesta del hilo de fondo
+};
+
+/**
+ * Nombre con que se registra en el monitor una consulta según su origen.
+ * 
+ * POR QUÉ: Una respuesta de la caché o del precálculo tarda microsegundos; sumada
+ *          a las ejecuciones reales rebajaría su promedio en las estadísticas
+ *          (opciones 16 y 17).
+ * CÓMO: Las que no se ejecutaron llevan el sufijo " (caché)" o " (precálculo)".
+ * PARA QUÉ: Comparar ejecuciones con ejecuciones y respuestas guardadas entre sí.
+ */
+std::string nombreRegistrado(const std::string& operacion, OrigenRespuesta origen) {
+    switch (origen) {
+        case OrigenRespuesta::CACHE:      return operacion + " (caché)";
+        case OrigenRespuesta::PRECALCULO: return operacion + " (precálculo)";
+        default:                          return operacion;
+    }
+}
+
+/**
+ * Responde desde el precálculo en segundo plano, si ya terminó.
+ * 
+ * POR QUÉ: Tras generar datos, un hilo de fondo calcula todas las respuestas.
+ * CÓMO: Consulta el resultado sin bloquear; si no está listo (o es de otra
+ *       versión de los datos) no imprime nada.
+ * PARA QUÉ: Respuesta instantánea o, en su defecto, cálculo bajo demanda.
+ * @return true si la respuesta se imprimió
+ */
+bool responderDesdePrecalculo(PrecalculoEnSegundoPlano& precalculo, unsigned long version,
+                              const std::vector<Persona>& personas, PreguntaPrecalculada pregunta,
+                              const std::string& parametro = "") {
+    const RespuestasPrecalculadas* respuestas = precalculo.listas(version);
+    if (!respuestas) return false;
+
+    std::ostringstream salida;
+    std::streambuf* salidaOriginal = std::cout.rdbuf(salida.rdbuf());
+    bool respondida = responderPrecalculado(*respuestas, personas, pregunta, parametro);
+    std::cout.rdbuf(salidaOriginal);
+
+    if (respondida) std::cout << "\n(Respuesta precalculada)\n" << salida.str();
+    return respondida;
+}
+
 /**
  * Punto de entrada principal del programa.
  *  
@@ -44,14 +283,228 @@ void mostrarMenu() {
  * CÓMO: Mediante un bucle que muestra el menú y procesa la opción seleccionada.
  * PARA QUÉ: Ejecutar las funcionalidades del sistema.
  */
-int main() {
+int main(int argc, char* argv[]) {
     srand(time(nullptr)); // Semilla para generación aleatoria
+    instalarManejadorInterrupcion(); // Ctrl-C cancela la operación en curso
+
+    // --precalcular: calcular en segundo plano las respuestas tras cada generación
+    // --memoria-max=MB: presupuesto para generar en RAM (por defecto, MemAvailable)
+    // --instantanea=ruta: arrancar cargando una instantánea guardada con la opción 24
+    // --grabar=ruta: grabar desde el inicio las operaciones de la sesión (opción 30)
+    // --ajuste=ruta: archivo de parámetros calibrados (por defecto, ajuste.cfg)
+    // --calibrar: volver a calibrar al arrancar aunque el archivo exista
+    // --grupos=ruta: esquema de grupos de declaración a usar (opción 35)
+    bool modoPrecalculo = false;
+    long presupuestoMemoriaKB = 0;
+    std::string instantaneaInicial;
+    std::string trazaInicial;
+    std::string rutaAjuste = "ajuste.cfg";
+    bool forzarCalibracion = false;
+    std::string esquemaInicial;
+    for (int i = 1; i < argc; ++i) {
+        std::string argumento = argv[i];
+        if (argumento == "--precalcular") modoPrecalculo = true;
+        if (argumento.compare(0, 14, "--memoria-max=") == 0) {
+            presupuestoMemoriaKB = std::atol(argumento.c_str() + 14) * 1024;
+        }
+        if (argumento.compare(0, 14, "--instantanea=") == 0) instantaneaInicial = argumento.substr(14);
+        if (argumento.compare(0, 9, "--grabar=") == 0) trazaInicial = argumento.substr(9);
+        if (argumento.compare(0, 9, "--ajuste=") == 0) rutaAjuste = argumento.substr(9);
+        if (argumento == "--calibrar") forzarCalibracion = true;
+        if (argumento.compare(0, 9, "--grupos=") == 0) esquemaInicial = argumento.substr(9);
+    }
+
+    if (!esquemaInicial.empty()) {
+        try {
+            activarEsquemaGrupos(EsquemaGrupos::desdeArchivo(esquemaInicial));
+            std::cout << "Esquema de grupos: " << esquemaGruposActivo()->nombre() << "\n";
+        } catch (const std::exception& e) {
+            std::cout << e.what() << "\nSe usa el esquema predeterminado.\n";
+        }
+    }
+
+    // Parámetros de los núcleos por fragmentos y lotes (opción 34)
+    // POR QUÉ: Su mejor valor depende de las cachés de la máquina.
+    // CÓMO: Se cargan del archivo; en el primer arranque, si el archivo no viene
+    //       de una calibración o es de otra máquina (otras cachés), se calibran y se guardan.
+    ParametrosAjuste ajuste;
+    bool calibrarAlInicio = forzarCalibracion;
+    if (!calibrarAlInicio) {
+        try {
+            ajuste = cargarParametros(rutaAjuste);
+            calibrarAlInicio = !ajuste.calibrado || ajuste.caches != cachesActuales();
+        } catch (const std::exception&) {
+            calibrarAlInicio = true;
+        }
+    }
+    if (calibrarAlInicio) {
+        std::cout << "Calibrando parámetros para esta máquina (" << rutaAjuste << ")...\n";
+        try {
+            ajuste = calibrarParametros().parametros;
+            guardarParametros(ajuste, rutaAjuste);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << "; se usan los valores calibrados hasta ahora.\n";
+        }
+        mostrarParametros(ajuste);
+    }
     
     // Puntero inteligente para gestionar la colección de personas
     // POR QUÉ: Evitar fugas de memoria y garantizar liberación automática.
     std::unique_ptr<std::vector<Persona>> personas = nullptr;
     
+    // Índices y estadísticas del planificador, construidos bajo demanda
+    // POR QUÉ: Dependen del conjunto actual; se descartan al regenerarlo.
+    std::unique_ptr<Planificador> planificador = nullptr;
+    std::unique_ptr<MapaZonas> zonas = nullptr; // Mapas de zonas, también bajo demanda
+    std::unique_ptr<CursorListado> cursor = nullptr; // Último listado paginado (opciones 1, 8 y 9)
+    std::unique_ptr<IndicesMapaBits> mapasBits = nullptr; // Ciudad/grupo/declarante (opción 28)
+
+    // Versión del conjunto de datos: se incrementa con cada regeneración o modificación
+    // POR QUÉ: Forma parte de la clave de la caché, así nunca se sirven respuestas viejas.
+    unsigned long versionDatos = 0;
+    CacheResultados cache; // Resultados de consultas repetidas (LRU, memoria acotada)
+    PrecalculoEnSegundoPlano precalculo; // Respuestas de las opciones 4-15 calculadas en un hilo de fondo
+
+    // Conjunto fuera de memoria (opción 23) y velocidad cruda de lectura de su archivo
+    std::unique_ptr<ColeccionEnDisco> enDisco = nullptr;
+    EstadisticaLectura lecturaCruda;
+
+    // Conjunto virtual (opción 29): solo tamaño y semilla, sin memoria por fila
+    std::unique_ptr<ColeccionVirtual> coleccionVirtual = nullptr;
+    // Semilla del conjunto actual si salió de materializar uno virtual (opción 29-6)
+    // POR QUÉ: Las filas de la opción 0 no vienen de ninguna semilla; solo estas se pueden comparar.
+    bool hayMaterializado = false;
+    uint64_t semillaMaterializada = 0;
+    unsigned long versionMaterializada = 0; // ...vigente solo si versionMaterializada == versionDatos
+
+    // Declaraciones de renta (opción 32): tabla aparte, unida con personas por cédula
+    // POR QUÉ: No se descarta al regenerar; sus cédulas sin persona son huérfanas.
+    std::unique_ptr<std::vector<Declaracion>> declaraciones = nullptr;
+
+    // Historial financiero (opción 33): series anuales alineadas fila a fila con personas
+    std::unique_ptr<HistorialFinanciero> historial = nullptr;
+
+    // Índice cédula -> fila (opción 36): se llena en paralelo mientras la opción 0 genera, o al cargar o importar
+    std::unique_ptr<IndiceCedulasConcurrente> indiceCedulas = nullptr;
+
+    // Grabación de la sesión (opción 30): cada opción con lo que leyó y su tiempo
+    GrabadoraTraza grabadora;
+
+    // Conjuntos guardados por nombre (opción 25), con diccionarios de texto compartidos
+    RegistroConjuntos conjuntos;
+
+    // Último resultado del planificador (opción 19), para intersecarlo o unirlo con el siguiente
+    // POR QUÉ: Son números de fila, así que siguen valiendo si se recarga la instantánea
+    //          de la misma colección; la huella de datos identifica esa colección.
+    ConjuntoFilas resultadoAnterior;
+    unsigned long versionResultado = 0;
+    uint64_t huellaResultado = 0;            // 0 = colección nunca guardada ni cargada
+    uint64_t huellaDatos = 0;                // Huella del conjunto activo...
+    unsigned long versionHuella = 0;         // ...válida solo si versionHuella == versionDatos
+
     Monitor monitor; // Monitor para medir rendimiento
+
+    /**
+     * Aplica un cambio a las filas del conjunto activo e invalida todo lo que
+     * se derivó de ellas.
+     *
+     * POR QUÉ: Índices, zonas, mapas de bits, historial, cursor y precálculo
+     *          guardan números de fila o leen la colección desde otro hilo.
+     * CÓMO: Detiene el precálculo antes del cambio, sube versionDatos (las
+     *       cachés por versión dejan de servir) y lo relanza después.
+     * PARA QUÉ: Un solo lugar que recordar al agregar una estructura derivada.
+     */
+    auto cambiarConjunto = [&](auto cambio) {
+        precalculo.cancelar(); // El hilo de fondo no debe leer filas a medio cambiar
+        cambio();
+        versionDatos++;
+        planificador.reset();
+        zonas.reset();
+        mapasBits.reset();
+        historial.reset();
+        indiceCedulas.reset();
+        cursor.reset();
+        if (modoPrecalculo && personas && !personas->empty()) precalculo.iniciar(*personas, versionDatos);
+    };
+    auto reemplazarConjunto = [&](std::vector<Persona>& nuevas) {
+        cambiarConjunto([&] { personas = std::make_unique<std::vector<Persona>>(std::move(nuevas)); });
+    };
+    // Índice de cédulas de un conjunto que llega entero (instantánea, importación): en
+    // paralelo apenas se carga, como la opción 0 lo llena mientras genera
+    auto indexarCedulas = [&]() {
+        try {
+            OperacionCancelable operacion;
+            indiceCedulas = construirIndiceCedulas(*personas, 0, operacion.control("Indexando cédulas", ajuste.tamFragmento));
+        } catch (const std::exception& e) {
+            std::cout << "\nÍndice de cédulas sin construir (" << e.what() << "); la opción 36 lo reintenta.\n";
+        }
+    };
+
+    /**
+     * Carga una instantánea (datos + índices) como conjunto actual.
+     * 
+     * POR QUÉ: Reconstruir los índices tras cada arranque cuesta segundos o minutos.
+     * CÓMO: Los datos se validan con su huella; los índices se proyectan desde
+     *       <ruta>.idx si su huella coincide, y si no se reconstruyen y se guardan.
+     * PARA QUÉ: Un reinicio utilizable en milisegundos.
+     */
+    auto cargarInstantanea = [&](const std::string& ruta) {
+        monitor.iniciar_tiempo();
+        long memoria_inicio = monitor.obtener_memoria();
+        std::unique_ptr<ColeccionEnDisco> instantanea;
+        std::vector<Persona> cargadas;
+        try {
+            instantanea = std::make_unique<ColeccionEnDisco>(ruta);
+            OperacionCancelable operacion;
+            cargadas = instantanea->cargar(operacion.control("Cargando datos", ajuste.tamFragmento));
+        } catch (const std::exception& e) {
+            std::cout << "\n" << e.what() << ". Se conserva el conjunto anterior.\n";
+            return;
+        }
+        reemplazarConjunto(cargadas);
+        indexarCedulas();
+        huellaDatos = instantanea->huella();
+        versionHuella = versionDatos;
+        if (huellaResultado != 0 && huellaResultado == huellaDatos && resultadoAnterior.universo() == personas->size()) {
+            versionResultado = versionDatos; // Mismas filas en el mismo orden
+        }
+        double tiempo_datos = monitor.detener_tiempo();
+        long memoria_datos = monitor.obtener_memoria() - memoria_inicio;
+        std::cout << "\nCargadas " << personas->size() << " personas en " << tiempo_datos << " ms, Memoria: " << memoria_datos << " KB\n";
+        monitor.registrar("Cargar instantánea de datos", tiempo_datos, memoria_datos);
+
+        monitor.iniciar_tiempo();
+        memoria_inicio = monitor.obtener_memoria();
+        try {
+            planificador = std::make_unique<Planificador>(*personas,
+                cargarIndices(rutaIndices(ruta), instantanea->huella(), personas->size()));
+            double tiempo_indices = monitor.detener_tiempo();
+            long memoria_indices = monitor.obtener_memoria() - memoria_inicio;
+            std::cout << "Índices cargados en " << tiempo_indices << " ms, Memoria: " << memoria_indices << " KB\n";
+            monitor.registrar("Cargar índices persistentes", tiempo_indices, memoria_indices);
+        } catch (const std::exception& e) {
+            std::cout << e.what() << ". Reconstruyendo índices...\n";
+            planificador = std::make_unique<Planificador>(*personas);
+            try {
+                guardarIndices(rutaIndices(ruta), planificador->indices(), instantanea->huella(), personas->size());
+            } catch (const std::exception& e) {
+                std::cout << e.what() << "\n";
+            }
+            double tiempo_indices = monitor.detener_tiempo();
+            long memoria_indices = monitor.obtener_memoria() - memoria_inicio;
+            std::cout << "Índices reconstruidos en " << tiempo_indices << " ms, Memoria: " << memoria_indices << " KB\n";
+            monitor.registrar("Construir índices del planificador", tiempo_indices, memoria_indices);
+        }
+    };
+    if (!instantaneaInicial.empty()) cargarInstantanea(instantaneaInicial);
+    if (!trazaInicial.empty()) {
+        try {
+            grabadora.iniciar(trazaInicial);
+            std::cout << "\nGrabando la sesión en " << trazaInicial << "\n";
+        } catch (const std::exception& e) {
+            std::cout << "\n" << e.what() << "\n";
+        }
+    }
     
     std::string opcionString;
     int opcion;
@@ -72,27 +525,109 @@ int main() {
         std::string idBusqueda;
         
         long memoria_inicio = monitor.obtener_memoria();
+
+        // Lo que se lea desde aquí son los parámetros de la opción
+        size_t registrosAntes = monitor.cantidad_registros();
+        grabadora.comenzarOperacion(opcion);
         
         switch(opcion) {
             case 0: { // Crear nuevo conjunto de datos
-                int n;
+                std::string textoN;
                 std::cout << "\nIngrese el número de personas a generar: ";
-                std::cin >> n;
-                
-                if (n <= 0) {
+                std::cin >> textoN;
+
+                // Tamaños de 64 bits; stoull acepta "-5", por eso se revisa el signo aparte
+                size_t n = 0;
+                try {
+                    if (!textoN.empty() && textoN[0] != '-') n = std::stoull(textoN);
+                } catch (const std::exception&) {
+                    n = 0;
+                }
+                if (n == 0) {
                     std::cout << "Error: Debe generar al menos 1 persona\n";
                     break;
                 }
 
+                // Estimar la memoria antes de empezar: fallar rápido en lugar de morir por OOM
+                // Más filas de las que numeran 32 bits tampoco caben en memoria, haya RAM o no
+                // El índice de cédulas empaqueta la fila en 30 bits: por encima de
+                // IndiceCedulasConcurrente::FILAS_MAXIMAS se genera sin él
+                const bool excedeFilas = n > FILAS_MAXIMAS_EN_MEMORIA;
+                const bool conIndice = n <= IndiceCedulasConcurrente::FILAS_MAXIMAS;
+                size_t estimadaKB = excedeFilas ? 0 : (estimarMemoriaColeccion(n) +
+                                                       (conIndice ? IndiceCedulasConcurrente::bytesPara(n) : 0)) / 1024;
+                long disponibleKB = presupuestoMemoriaKB > 0 ? presupuestoMemoriaKB : monitor.obtener_memoria_disponible();
+                if (excedeFilas || (disponibleKB > 0 && estimadaKB > static_cast<size_t>(disponibleKB))) {
+                    if (excedeFilas) {
+                        std::cout << "Una colección en memoria admite hasta " << FILAS_MAXIMAS_EN_MEMORIA
+                                  << " personas (números de fila de 32 bits).\n";
+                    } else {
+                        std::cout << "Se estiman " << estimadaKB / 1024 << " MB para " << n << " personas y el presupuesto es de "
+                                  << disponibleKB / 1024 << " MB.\n";
+                    }
+                    std::cout << "¿Generar en disco por fragmentos en su lugar (opción 23)? (s/n): ";
+                    std::string respuesta;
+                    std::cin >> respuesta;
+                    if (respuesta != "s" && respuesta != "S") {
+                        std::cout << "Generación rechazada. Se conserva el conjunto anterior.\n";
+                        break;
+                    }
+
+                    std::string ruta;
+                    std::cout << "Ruta del archivo: ";
+                    std::cin >> ruta;
+                    // Una cuarta parte del presupuesto, sin pasar del valor por defecto
+                    size_t presupuestoDisco = disponibleKB <= 0 ? ColeccionEnDisco::PRESUPUESTO_POR_DEFECTO :
+                                              std::min<size_t>(ColeccionEnDisco::PRESUPUESTO_POR_DEFECTO,
+                                                               static_cast<size_t>(disponibleKB) * 1024 / 4);
+
+                    monitor.iniciar_tiempo();
+                    long memoria_inicio = monitor.obtener_memoria();
+                    try {
+                        OperacionCancelable operacion;
+                        ColeccionEnDisco::generar(ruta, n, presupuestoDisco, operacion.control("Generando en disco", ajuste.tamFragmento));
+                        enDisco = std::make_unique<ColeccionEnDisco>(ruta, presupuestoDisco);
+                        lecturaCruda = enDisco->medirLecturaCruda();
+                    } catch (const std::exception& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        enDisco.reset();
+                        break;
+                    }
+                    double tiempo_gen = monitor.detener_tiempo();
+                    long memoria_gen = monitor.obtener_memoria() - memoria_inicio;
+                    std::cout << "Generadas " << n << " personas en disco (" << enDisco->numeroFragmentos()
+                              << " fragmentos) en " << tiempo_gen << " ms, Memoria: " << memoria_gen << " KB\n";
+                    std::cout << "Use la opción 23 para consultarlas.\n";
+                    monitor.registrar("Generar conjunto en disco", tiempo_gen, memoria_gen);
+                    break;
+                }
+
                 monitor.iniciar_tiempo();
                 long memoria_inicio = monitor.obtener_memoria();
                 
-                // Generar el nuevo conjunto de personas
-                auto nuevasPersonas = generarColeccion(n);
+                // Generar el nuevo conjunto de personas (Ctrl-C cancela sin perder el conjunto actual)
+                // El índice de cédulas se llena en otros hilos mientras se generan las filas
+                std::vector<Persona> nuevasPersonas;
+                std::unique_ptr<IndiceCedulasConcurrente> nuevoIndice;
+                try {
+                    OperacionCancelable operacion;
+                    if (conIndice) {
+                        nuevasPersonas = generarColeccionIndexada(n, nuevoIndice, 0, operacion.control("Generando", ajuste.tamFragmento));
+                    } else {
+                        nuevasPersonas = generarColeccion(n, operacion.control("Generando", ajuste.tamFragmento));
+                    }
+                } catch (const OperacionCancelada& e) {
+                    std::cout << "\n" << e.what() << ". Se conserva el conjunto anterior.\n";
+                    break;
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << ". Se conserva el conjunto anterior.\n";
+                    break;
+                }
                 tam = nuevasPersonas.size();
                 
                 // Mover el conjunto al puntero inteligente (propiedad única)
-                personas = std::make_unique<std::vector<Persona>>(std::move(nuevasPersonas));
+                reemplazarConjunto(nuevasPersonas); // Los índices anteriores ya no son válidos
+                indiceCedulas = std::move(nuevoIndice);
                 
                 // Medir tiempo y memoria usada
                 double tiempo_gen = monitor.detener_tiempo();
@@ -100,9 +635,25 @@ int main() {
                 
                 std::cout << "Generadas " << tam << " personas en " 
                           << tiempo_gen << " ms, Memoria: " << memoria_gen << " KB\n";
+                if (indiceCedulas) {
+                    std::cout << "Índice de cédulas llenado durante la generación (" << indiceCedulas->bytes() / 1024
+                              << " KB, opción 36).\n";
+                } else {
+                    std::cout << "Sin índice de cédulas: admite hasta " << IndiceCedulasConcurrente::FILAS_MAXIMAS << " filas.\n";
+                }
                 
                 // Registrar la operación
                 monitor.registrar("Crear datos por valor", tiempo_gen, memoria_gen);
+
+                // Mapas de bits de ciudad, grupo y declarante: se construyen una vez por generación
+                monitor.iniciar_tiempo();
+                memoria_inicio = monitor.obtener_memoria();
+                mapasBits = std::make_unique<IndicesMapaBits>(*personas);
+                double tiempo_mapas = monitor.detener_tiempo();
+                long memoria_mapas = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Mapas de bits construidos en " << tiempo_mapas << " ms (" << mapasBits->bytes() / 1024
+                          << " KB), Memoria: " << memoria_mapas << " KB\n";
+                monitor.registrar("Construir mapas de bits", tiempo_mapas, memoria_mapas);
                 break;
             }
 
@@ -115,18 +666,21 @@ int main() {
                     break; // rompe solo el switch
                 }
 
-                monitor.iniciar_tiempo();
-                long memoria_inicio = monitor.obtener_memoria();
-                
-                tam = personas->size();
-                std::cout << "\n=== RESUMEN DE PERSONAS (" << tam << ") ===\n";
-                for(size_t i = 0; i < tam; ++i) {
-                    std::cout << i << ". ";
-                    (*personas)[i].mostrarResumen();
-                    std::cout << "\n";
+                std::string consulta = "todas";
+                double tiempo_filtro = 0;
+                if (!reanudarCursor(cursor, consulta)) {
+                    size_t tamPagina;
+                    ClaveOrden orden;
+                    pedirPaginacion(tamPagina, orden);
+
+                    monitor.iniciar_tiempo();
+                    cursor = std::make_unique<CursorListado>(vistaCompartida(*personas), seleccionarTodas(personas->size()),
+                                                             consulta, orden, tamPagina, COLUMNAS_RESUMEN);
+                    tiempo_filtro = monitor.detener_tiempo();
                 }
-                
-                double tiempo_mostrar = monitor.detener_tiempo();
+
+                std::cout << "\n=== RESUMEN DE PERSONAS (" << cursor->total() << ") ===\n";
+                double tiempo_mostrar = tiempo_filtro + navegarCursor(*cursor);
                 long memoria_mostrar = monitor.obtener_memoria() - memoria_inicio;
                 std::cout << "Proceso terminado en " << tiempo_mostrar << " ms, Memoria: " << memoria_mostrar << " KB\n";
                 monitor.registrar("Mostrar resumen", tiempo_mostrar, memoria_mostrar);
@@ -212,14 +766,25 @@ int main() {
 
                     std::cout << "\nBuscando persona más longeva del país...";
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    Persona encontrada = buscarMasLongevoPorValor(*personas);
-                    encontrada.mostrar();
+                    try {
+                        if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_LONGEVO)) {
+                            origen = OrigenRespuesta::PRECALCULO;
+                        } else {
+                            OperacionCancelable operacion;
+                            Persona encontrada = buscarMasLongevoPorValor(*personas, operacion.control("Buscando", ajuste.tamFragmento));
+                            encontrada.mostrar();
+                        }
+                    } catch (const OperacionCancelada& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        break;
+                    }
                     
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar persona más longeva por valor", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar persona más longeva por valor", origen), tiempo_busqueda, memoria_busqueda);
                     break;
 
                 } else if (opcionBusqueda == 2) {
@@ -233,14 +798,29 @@ int main() {
                         break;
                     }
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    Persona encontrada = buscarMasLongevoPorValorEnCiudad(*personas, ciudad);
-                    encontrada.mostrar();
+                    try {
+                        if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_LONGEVO_CIUDAD, ciudad)) {
+                            origen = OrigenRespuesta::PRECALCULO;
+                        } else {
+                            OperacionCancelable operacion;
+                            if (consultarConCache(cache, monitor, "buscarMasLongevoPorValorEnCiudad", ciudad, versionDatos, [&] {
+                                Persona encontrada = buscarMasLongevoPorValorEnCiudad(*personas, ciudad, operacion.control("Buscando", ajuste.tamFragmento));
+                                encontrada.mostrar();
+                            })) {
+                                origen = OrigenRespuesta::CACHE;
+                            }
+                        }
+                    } catch (const OperacionCancelada& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        break;
+                    }
                     
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar persona más longeva por valor en ciudad", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar persona más longeva por valor en ciudad", origen), tiempo_busqueda, memoria_busqueda);
                     break;
                 } else {
                     std::cout << "Opción inválida!\n";
@@ -268,14 +848,19 @@ int main() {
 
                     std::cout << "\nBuscando persona más longeva por referencia...";
                     
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    const Persona* encontrada = buscarMasLongevoPorReferencia(*personas);
-                    encontrada->mostrar();
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_LONGEVO)) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        const Persona* encontrada = buscarMasLongevoPorReferencia(*personas);
+                        encontrada->mostrar();
+                    }
                     
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar mas longeva por referencia", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar mas longeva por referencia", origen), tiempo_busqueda, memoria_busqueda);
                     break;
 
                 } else if (opcionBusqueda == 2) {
@@ -289,14 +874,23 @@ int main() {
                         break;
                     }
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    const Persona* encontrada = buscarMasLongevoPorReferenciaEnCiudad(*personas, ciudad);
-                    encontrada->mostrar();
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_LONGEVO_CIUDAD, ciudad)) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        if (consultarConCache(cache, monitor, "buscarMasLongevoPorReferenciaEnCiudad", ciudad, versionDatos, [&] {
+                            const Persona* encontrada = buscarMasLongevoPorReferenciaEnCiudad(*personas, ciudad);
+                            encontrada->mostrar();
+                        })) {
+                            origen = OrigenRespuesta::CACHE;
+                        }
+                    }
                     
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar persona más longeva por referencia en ciudad", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar persona más longeva por referencia en ciudad", origen), tiempo_busqueda, memoria_busqueda);
                     break;
                 } else {
                     std::cout << "Opción inválida!\n";
@@ -316,7 +910,7 @@ int main() {
                 
                 std::cout << "\nPresione 1 para buscar por país";
                 std::cout << "\nPresione 2 para buscar por ciudad";
-                std::cout << "\nPresione 3 para buscar por grupo de declaración (A, B o C)\n";
+                std::cout << "\nPresione 3 para buscar por grupo de declaración (" << esquemaGruposActivo()->listaGrupos() << ")\n";
 
                 int opcionBusqueda;
                 std::cin >> opcionBusqueda;
@@ -325,14 +919,25 @@ int main() {
 
                     std::cout << "\nBuscando persona más rica por valor...";
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    Persona encontrada = buscarMasPatrimonioPorValor(*personas);
-                    encontrada.mostrar();
+                    try {
+                        if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_PATRIMONIO)) {
+                            origen = OrigenRespuesta::PRECALCULO;
+                        } else {
+                            OperacionCancelable operacion;
+                            Persona encontrada = buscarMasPatrimonioPorValor(*personas, operacion.control("Buscando", ajuste.tamFragmento));
+                            encontrada.mostrar();
+                        }
+                    } catch (const OperacionCancelada& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        break;
+                    }
                     
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar mas rica por valor", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar mas rica por valor", origen), tiempo_busqueda, memoria_busqueda);
                     break;
 
                 } else if (opcionBusqueda == 2) {
@@ -346,34 +951,64 @@ int main() {
                         break;
                     }
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    Persona encontrada = buscarMasPatrimonioPorValorEnCiudad(*personas, ciudad);
-                    encontrada.mostrar();
+                    try {
+                        if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_PATRIMONIO_CIUDAD, ciudad)) {
+                            origen = OrigenRespuesta::PRECALCULO;
+                        } else {
+                            OperacionCancelable operacion;
+                            if (consultarConCache(cache, monitor, "buscarMasPatrimonioPorValorEnCiudad", ciudad, versionDatos, [&] {
+                                Persona encontrada = buscarMasPatrimonioPorValorEnCiudad(*personas, ciudad, operacion.control("Buscando", ajuste.tamFragmento));
+                                encontrada.mostrar();
+                            })) {
+                                origen = OrigenRespuesta::CACHE;
+                            }
+                        }
+                    } catch (const OperacionCancelada& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        break;
+                    }
 
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar persona más rica por valor en ciudad", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar persona más rica por valor en ciudad", origen), tiempo_busqueda, memoria_busqueda);
                     break;
                 } else if (opcionBusqueda == 3) {
 
-                    std::cout << "\nIngrese el grupo de declaración (A, B o C): ";
+                    std::cout << "\nIngrese el grupo de declaración (" << esquemaGruposActivo()->listaGrupos() << "): ";
                     std::string grupo;
                     std::cin >> grupo;
 
-                    if (grupo != "A" && grupo != "B" && grupo != "C") {
-                        std::cout << "Grupo inválido. Debe ser A, B o C.\n";
+                    if (esquemaGruposActivo()->codigoDeNombre(grupo) < 0) {
+                        std::cout << "Grupo inválido. Debe ser " << esquemaGruposActivo()->listaGrupos() << ".\n";
                         break;
                     }
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    Persona encontrada = buscarMasPatrimonioPorValorEnGrupo(*personas, grupo);
-                    encontrada.mostrar();
+                    try {
+                        if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_PATRIMONIO_GRUPO, grupo)) {
+                            origen = OrigenRespuesta::PRECALCULO;
+                        } else {
+                            OperacionCancelable operacion;
+                            if (consultarConCache(cache, monitor, "buscarMasPatrimonioPorValorEnGrupo", grupo, versionDatos, [&] {
+                                Persona encontrada = buscarMasPatrimonioPorValorEnGrupo(*personas, grupo, operacion.control("Buscando", ajuste.tamFragmento));
+                                encontrada.mostrar();
+                            })) {
+                                origen = OrigenRespuesta::CACHE;
+                            }
+                        }
+                    } catch (const OperacionCancelada& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        break;
+                    }
 
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar persona más rica por valor en grupo", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar persona más rica por valor en grupo", origen), tiempo_busqueda, memoria_busqueda);
                     break;
                 } else {
                     std::cout << "Opción inválida!\n";
@@ -393,7 +1028,7 @@ int main() {
                 
                 std::cout << "\nPresione 1 para buscar por país";
                 std::cout << "\nPresione 2 para buscar por ciudad";
-                std::cout << "\nPresione 3 para buscar por grupo de declaración (A, B o C)\n";
+                std::cout << "\nPresione 3 para buscar por grupo de declaración (" << esquemaGruposActivo()->listaGrupos() << ")\n";
 
                 int opcionBusqueda;
                 std::cin >> opcionBusqueda;
@@ -402,14 +1037,19 @@ int main() {
 
                     std::cout << "\nBuscando persona más rica por referencia...";
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    const Persona* encontrada = buscarMasPatrimonioPorReferencia(*personas);
-                    encontrada->mostrar();
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_PATRIMONIO)) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        const Persona* encontrada = buscarMasPatrimonioPorReferencia(*personas);
+                        encontrada->mostrar();
+                    }
                     
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar mas rica por referencia", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar mas rica por referencia", origen), tiempo_busqueda, memoria_busqueda);
                     break;
 
                 } else if (opcionBusqueda == 2) {
@@ -423,34 +1063,52 @@ int main() {
                         break;
                     }
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    const Persona* encontrada = buscarMasPatrimonioPorReferenciaEnCiudad(*personas, ciudad);
-                    encontrada->mostrar();
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_PATRIMONIO_CIUDAD, ciudad)) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        if (consultarConCache(cache, monitor, "buscarMasPatrimonioPorReferenciaEnCiudad", ciudad, versionDatos, [&] {
+                            const Persona* encontrada = buscarMasPatrimonioPorReferenciaEnCiudad(*personas, ciudad);
+                            encontrada->mostrar();
+                        })) {
+                            origen = OrigenRespuesta::CACHE;
+                        }
+                    }
 
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar persona más rica por referencia en ciudad", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar persona más rica por referencia en ciudad", origen), tiempo_busqueda, memoria_busqueda);
                     break;
                 } else if (opcionBusqueda == 3) {
 
-                    std::cout << "\nIngrese el grupo de declaración (A, B o C): ";
+                    std::cout << "\nIngrese el grupo de declaración (" << esquemaGruposActivo()->listaGrupos() << "): ";
                     std::string grupo;
                     std::cin >> grupo;
 
-                    if (grupo != "A" && grupo != "B" && grupo != "C") {
-                        std::cout << "Grupo inválido. Debe ser A, B o C.\n";
+                    if (esquemaGruposActivo()->codigoDeNombre(grupo) < 0) {
+                        std::cout << "Grupo inválido. Debe ser " << esquemaGruposActivo()->listaGrupos() << ".\n";
                         break;
                     }
 
+                    OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                     monitor.iniciar_tiempo();
-                    const Persona* encontrada = buscarMasPatrimonioPorReferenciaEnGrupo(*personas, grupo);
-                    encontrada->mostrar();
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::MAS_PATRIMONIO_GRUPO, grupo)) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        if (consultarConCache(cache, monitor, "buscarMasPatrimonioPorReferenciaEnGrupo", grupo, versionDatos, [&] {
+                            const Persona* encontrada = buscarMasPatrimonioPorReferenciaEnGrupo(*personas, grupo);
+                            encontrada->mostrar();
+                        })) {
+                            origen = OrigenRespuesta::CACHE;
+                        }
+                    }
 
                     double tiempo_busqueda = monitor.detener_tiempo();
                     long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                     std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                    monitor.registrar("Buscar persona más rica por referencia en grupo", tiempo_busqueda, memoria_busqueda);
+                    monitor.registrar(nombreRegistrado("Buscar persona más rica por referencia en grupo", origen), tiempo_busqueda, memoria_busqueda);
                     break;
                 } else {
                     std::cout << "Opción inválida!\n";
@@ -473,13 +1131,34 @@ int main() {
                 std::cout << "\nIngrese el grupo a listar: ";
                 std::cin >> grupo;
 
-                monitor.iniciar_tiempo();
-                
-                auto personasGrupoA_valor = listarPersonasPorValorEnGrupo(*personas, grupo);
-                std::cout << "\n\nPersonas en grupo " << grupo << " por valor: " << personasGrupoA_valor.size() << "\n";
+                std::string consulta = "valor:grupo=" + grupo;
+                double tiempo_filtro = 0;
+                if (!reanudarCursor(cursor, consulta)) {
+                    std::string textoColumnas;
+                    std::cout << "Columnas a mostrar (ej. id,nombre,edad o resumen): ";
+                    std::cin >> textoColumnas;
+                    size_t tamPagina;
+                    ClaveOrden orden;
+                    pedirPaginacion(tamPagina, orden);
+
+                    // Etapa 1: filtrado sin E/S (una sola vez por consulta)
+                    monitor.iniciar_tiempo();
+                    auto personasGrupoA_valor = std::make_shared<const std::vector<Persona>>(
+                        listarPersonasPorValorEnGrupo(*personas, grupo));
+                    tiempo_filtro = monitor.detener_tiempo();
+                    std::cout << "\nPersonas en grupo " << grupo << " por valor: " << personasGrupoA_valor->size() << "\n";
+                    monitor.registrar("Listar por grupo por valor (solo filtrado)", tiempo_filtro, monitor.obtener_memoria() - memoria_inicio);
+
+                    cursor = std::make_unique<CursorListado>(personasGrupoA_valor, seleccionarTodas(personasGrupoA_valor->size()),
+                                                             consulta, orden, tamPagina, columnasDesdeTexto(textoColumnas));
+                }
+
+                // Etapa 2: proyección página a página
+                double tiempo_proyeccion = navegarCursor(*cursor);
                 
-                double tiempo_busqueda = monitor.detener_tiempo();
+                double tiempo_busqueda = tiempo_filtro + tiempo_proyeccion;
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Filtrado: " << tiempo_filtro << " ms, Proyección: " << tiempo_proyeccion << " ms\n";
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
                 monitor.registrar("Listar por grupo por valor", tiempo_busqueda, memoria_busqueda);
                 break;
@@ -499,13 +1178,34 @@ int main() {
                 std::cout << "\nIngrese el grupo a listar: ";
                 std::cin >> grupo;
 
-                monitor.iniciar_tiempo();
-                
-                auto personasGrupoA_ref = listarPersonasPorReferenciaEnGrupo(*personas, grupo);
-                std::cout << "\n\nPersonas en grupo " << grupo << " por referencia: " << personasGrupoA_ref.size() << "\n";
+                std::string consulta = "referencia:grupo=" + grupo;
+                double tiempo_filtro = 0;
+                if (!reanudarCursor(cursor, consulta)) {
+                    std::string textoColumnas;
+                    std::cout << "Columnas a mostrar (ej. id,nombre,edad o resumen): ";
+                    std::cin >> textoColumnas;
+                    size_t tamPagina;
+                    ClaveOrden orden;
+                    pedirPaginacion(tamPagina, orden);
+
+                    // Etapa 1: filtrado sin E/S (una sola vez por consulta)
+                    monitor.iniciar_tiempo();
+                    ConjuntoFilas personasGrupoA_ref = listarPersonasPorReferenciaEnGrupo(*personas, grupo);
+                    tiempo_filtro = monitor.detener_tiempo();
+                    std::cout << "\nPersonas en grupo " << grupo << " por referencia: " << personasGrupoA_ref.size()
+                              << " (" << personasGrupoA_ref.bytes() / 1024 << " KB de resultado)\n";
+                    monitor.registrar("Listar por grupo por referencia (solo filtrado)", tiempo_filtro, monitor.obtener_memoria() - memoria_inicio);
+
+                    cursor = std::make_unique<CursorListado>(vistaCompartida(*personas), personasGrupoA_ref.filas(),
+                                                             consulta, orden, tamPagina, columnasDesdeTexto(textoColumnas));
+                }
+
+                // Etapa 2: proyección página a página
+                double tiempo_proyeccion = navegarCursor(*cursor);
                 
-                double tiempo_busqueda = monitor.detener_tiempo();
+                double tiempo_busqueda = tiempo_filtro + tiempo_proyeccion;
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Filtrado: " << tiempo_filtro << " ms, Proyección: " << tiempo_proyeccion << " ms\n";
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
                 monitor.registrar("Listar por grupo por referencia", tiempo_busqueda, memoria_busqueda);
                 break;
@@ -520,14 +1220,25 @@ int main() {
                     break; // rompe solo el switch
                 }
 
+                OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                 monitor.iniciar_tiempo();
 
-                verificarGruposMasivoPorValor(*personas);
+                try {
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::VERIFICACION, "valor")) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        OperacionCancelable operacion;
+                        verificarGruposMasivoPorValor(*personas, operacion.control("Verificando", ajuste.tamFragmento));
+                    }
+                } catch (const OperacionCancelada& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
 
                 double tiempo_busqueda = monitor.detener_tiempo();
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                monitor.registrar("Verificar grupo por valor", tiempo_busqueda, memoria_busqueda);
+                monitor.registrar(nombreRegistrado("Verificar grupo por valor", origen), tiempo_busqueda, memoria_busqueda);
                 break;
             }
 
@@ -540,14 +1251,25 @@ int main() {
                     break; // rompe solo el switch
                 }
 
+                OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                 monitor.iniciar_tiempo();
 
-                verificarGruposMasivoPorReferencia(*personas);
+                try {
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::VERIFICACION, "referencia")) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        OperacionCancelable operacion;
+                        verificarGruposMasivoPorReferencia(*personas, operacion.control("Verificando", ajuste.tamFragmento));
+                    }
+                } catch (const OperacionCancelada& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
 
                 double tiempo_busqueda = monitor.detener_tiempo();
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                monitor.registrar("Verificar grupo por referencia", tiempo_busqueda, memoria_busqueda);
+                monitor.registrar(nombreRegistrado("Verificar grupo por referencia", origen), tiempo_busqueda, memoria_busqueda);
                 break;
             }
 
@@ -560,15 +1282,30 @@ int main() {
                     break; // rompe solo el switch
                 }
 
+                OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                 monitor.iniciar_tiempo();
 
-                std::string grupoMayor = encontrarGrupoMayorPatrimonioPorValor(*personas);
-                std::cout << "\nGrupo con mayor patrimonio en promedio por valor: " << grupoMayor << "\n";
+                try {
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::GRUPO_MAYOR_PATRIMONIO, "valor")) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        OperacionCancelable operacion;
+                        if (consultarConCache(cache, monitor, "encontrarGrupoMayorPatrimonioPorValor", "", versionDatos, [&] {
+                            std::string grupoMayor = encontrarGrupoMayorPatrimonioPorValor(*personas, operacion.control("Analizando", ajuste.tamFragmento));
+                            std::cout << "\nGrupo con mayor patrimonio en promedio por valor: " << grupoMayor << "\n";
+                        })) {
+                            origen = OrigenRespuesta::CACHE;
+                        }
+                    }
+                } catch (const OperacionCancelada& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
 
                 double tiempo_busqueda = monitor.detener_tiempo();
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                monitor.registrar("Encontrar grupo con mayor patrimonio (valor)", tiempo_busqueda, memoria_busqueda);
+                monitor.registrar(nombreRegistrado("Encontrar grupo con mayor patrimonio (valor)", origen), tiempo_busqueda, memoria_busqueda);
                 break;
             }
 
@@ -581,15 +1318,30 @@ int main() {
                     break; // rompe solo el switch
                 }
 
+                OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                 monitor.iniciar_tiempo();
 
-                std::string grupoMayor = encontrarGrupoMayorPatrimonioPorReferencia(*personas);
-                std::cout << "\nGrupo con mayor patrimonio en promedio por referencia: " << grupoMayor << "\n";
+                try {
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::GRUPO_MAYOR_PATRIMONIO, "referencia")) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        OperacionCancelable operacion;
+                        if (consultarConCache(cache, monitor, "encontrarGrupoMayorPatrimonioPorReferencia", "", versionDatos, [&] {
+                            std::string grupoMayor = encontrarGrupoMayorPatrimonioPorReferencia(*personas, operacion.control("Analizando", ajuste.tamFragmento));
+                            std::cout << "\nGrupo con mayor patrimonio en promedio por referencia: " << grupoMayor << "\n";
+                        })) {
+                            origen = OrigenRespuesta::CACHE;
+                        }
+                    }
+                } catch (const OperacionCancelada& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
 
                 double tiempo_busqueda = monitor.detener_tiempo();
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                monitor.registrar("Encontrar grupo con mayor patromonio (referencia)", tiempo_busqueda, memoria_busqueda);
+                monitor.registrar(nombreRegistrado("Encontrar grupo con mayor patromonio (referencia)", origen), tiempo_busqueda, memoria_busqueda);
                 break;
             }
 
@@ -602,15 +1354,30 @@ int main() {
                     break; // rompe solo el switch
                 }
 
+                OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                 monitor.iniciar_tiempo();
 
-                std::string grupoMayor = encontrarGrupoMayorLongevidadPorValor(*personas);
-                std::cout << "\nGrupo con mayor longevidad en promedio por valor: " << grupoMayor << "\n";
+                try {
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::GRUPO_MAYOR_LONGEVIDAD, "valor")) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        OperacionCancelable operacion;
+                        if (consultarConCache(cache, monitor, "encontrarGrupoMayorLongevidadPorValor", "", versionDatos, [&] {
+                            std::string grupoMayor = encontrarGrupoMayorLongevidadPorValor(*personas, operacion.control("Analizando", ajuste.tamFragmento));
+                            std::cout << "\nGrupo con mayor longevidad en promedio por valor: " << grupoMayor << "\n";
+                        })) {
+                            origen = OrigenRespuesta::CACHE;
+                        }
+                    }
+                } catch (const OperacionCancelada& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
 
                 double tiempo_busqueda = monitor.detener_tiempo();
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                monitor.registrar("Encontrar grupo con mayor longevidad (valor)", tiempo_busqueda, memoria_busqueda);
+                monitor.registrar(nombreRegistrado("Encontrar grupo con mayor longevidad (valor)", origen), tiempo_busqueda, memoria_busqueda);
                 break;
             }
 
@@ -623,15 +1390,30 @@ int main() {
                     break; // rompe solo el switch
                 }
 
+                OrigenRespuesta origen = OrigenRespuesta::EJECUCION;
                 monitor.iniciar_tiempo();
 
-                std::string grupoMayor = encontrarGrupoMayorLongevidadPorReferencia(*personas);
-                std::cout << "\nGrupo con mayor longevidad en promedio por referencia: " << grupoMayor << "\n";
+                try {
+                    if (responderDesdePrecalculo(precalculo, versionDatos, *personas, PreguntaPrecalculada::GRUPO_MAYOR_LONGEVIDAD, "referencia")) {
+                        origen = OrigenRespuesta::PRECALCULO;
+                    } else {
+                        OperacionCancelable operacion;
+                        if (consultarConCache(cache, monitor, "encontrarGrupoMayorLongevidadPorReferencia", "", versionDatos, [&] {
+                            std::string grupoMayor = encontrarGrupoMayorLongevidadPorReferencia(*personas, operacion.control("Analizando", ajuste.tamFragmento));
+                            std::cout << "\nGrupo con mayor longevidad en promedio por referencia: " << grupoMayor << "\n";
+                        })) {
+                            origen = OrigenRespuesta::CACHE;
+                        }
+                    }
+                } catch (const OperacionCancelada& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
 
                 double tiempo_busqueda = monitor.detener_tiempo();
                 long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
                 std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
-                monitor.registrar("Encontrar grupo con mayor longevidad (referencia)", tiempo_busqueda, memoria_busqueda);
+                monitor.registrar(nombreRegistrado("Encontrar grupo con mayor longevidad (referencia)", origen), tiempo_busqueda, memoria_busqueda);
                 break;
             }
                 
@@ -643,12 +1425,1489 @@ int main() {
                 monitor.exportar_csv();
                 break;
                 
-            case 18: // Salir
-                std::cout << "Saliendo...\n";
+            case 19: { // Consulta combinada con planificador
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    std::cout << "Presione Enter para continuar...";
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cin.get();
+                    break; // rompe solo el switch
+                }
+
+                if (!planificador) {
+                    monitor.iniciar_tiempo();
+                    planificador = std::make_unique<Planificador>(*personas);
+                    double tiempo_indices = monitor.detener_tiempo();
+                    long memoria_indices = monitor.obtener_memoria() - memoria_inicio;
+                    std::cout << "\nÍndices construidos en " << tiempo_indices << " ms, Memoria: " << memoria_indices << " KB\n";
+                    monitor.registrar("Construir índices del planificador", tiempo_indices, memoria_indices);
+                    memoria_inicio = monitor.obtener_memoria();
+                }
+
+                // Cada filtro se omite ingresando '*' (o -1 en las edades)
+                Consulta consulta;
+                std::cout << "\nIngrese el ID (* para cualquiera): ";
+                std::cin >> consulta.id;
+                std::cout << "Ingrese la ciudad (* para cualquiera): ";
+                std::cin >> consulta.ciudad;
+                std::cout << "Ingrese el grupo (* para cualquiera): ";
+                std::cin >> consulta.grupo;
+                std::cout << "Ingrese la edad mínima y máxima (-1 para sin límite): ";
+                if (!(std::cin >> consulta.edadMin >> consulta.edadMax)) {
+                    std::cout << "Entrada inválida!\n";
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    break;
+                }
+                if (consulta.id == "*") consulta.id.clear();
+                if (consulta.ciudad == "*") consulta.ciudad.clear();
+                if (consulta.grupo == "*") consulta.grupo.clear();
+
+                monitor.iniciar_tiempo();
+
+                std::vector<uint32_t> filasPlan = planificador->explicar(consulta, true);
+                ConjuntoFilas resultado(personas->size());
+                for (uint32_t fila : filasPlan) resultado.agregar(fila); // Ya vienen en orden ascendente
+                resultado.compactar();
+
+                if (versionResultado == versionDatos && !resultadoAnterior.empty()) {
+                    int combinacion = 0;
+                    std::cout << "Combinar con el resultado anterior de " << resultadoAnterior.size()
+                              << " filas (0 = no, 1 = intersección, 2 = unión): ";
+                    std::cin >> combinacion;
+                    if (combinacion == 1) resultado = ConjuntoFilas::interseccion(resultadoAnterior, resultado);
+                    if (combinacion == 2) resultado = ConjuntoFilas::unir(resultadoAnterior, resultado);
+                }
+
+                size_t mostradas = 0;
+                resultado.paraCada([&](uint32_t fila) {
+                    if (mostradas++ >= 10) return;
+                    std::cout << fila << ". ";
+                    (*personas)[fila].mostrarResumen();
+                    std::cout << "\n";
+                });
+                if (resultado.size() > 10) {
+                    std::cout << "... (" << resultado.size() - 10 << " filas más)\n";
+                }
+                std::cout << "Resultado: " << resultado.size() << " filas en " << resultado.bytes() / 1024.0 << " KB ("
+                          << (resultado.esMapaBits() ? "mapa de bits" : "filas de 32 bits") << "; con punteros serían "
+                          << resultado.size() * sizeof(const Persona*) / 1024.0 << " KB)\n";
+
+                resultadoAnterior = std::move(resultado);
+                versionResultado = versionDatos;
+                huellaResultado = versionHuella == versionDatos ? huellaDatos : 0;
+
+                double tiempo_busqueda = monitor.detener_tiempo();
+                long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
+                monitor.registrar("Consulta con planificador", tiempo_busqueda, memoria_busqueda);
                 break;
-                
-            default:
-                std::cout << "Opción inválida!\n";
+            }
+
+            case 20: { // Consultas con mapas de zonas
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    std::cout << "Presione Enter para continuar...";
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cin.get();
+                    break; // rompe solo el switch
+                }
+
+                std::cout << "\nPresione 1 para contar personas con patrimonio mayor a X";
+                std::cout << "\nPresione 2 para contar personas con edad mayor a X";
+                std::cout << "\nPresione 3 para contar personas de una ciudad";
+                std::cout << "\nPresione 4 para buscar la persona más rica de una ciudad";
+                std::cout << "\nPresione 5 para buscar la persona más rica de un grupo";
+                std::cout << "\nPresione 6 para agrupar la colección (mejora los saltos)\n";
+
+                int opcionZonas;
+                if (!(std::cin >> opcionZonas)) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+
+                if (opcionZonas == 6) {
+                    std::cout << "\nAgrupar por: 1 ciudad, 2 edad, 3 patrimonio: ";
+                    int criterio = 0;
+                    if (!(std::cin >> criterio)) {
+                        std::cin.clear();
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    }
+                    if (criterio < 1 || criterio > 3) {
+                        std::cout << "Opción inválida!\n";
+                        break;
+                    }
+
+                    monitor.iniciar_tiempo();
+                    cambiarConjunto([&] { // Las filas cambian de posición
+                        agruparColeccion(*personas, criterio == 1 ? CriterioAgrupacion::CIUDAD :
+                                                    criterio == 2 ? CriterioAgrupacion::EDAD :
+                                                                    CriterioAgrupacion::PATRIMONIO);
+                    });
+
+                    double tiempo_agrupar = monitor.detener_tiempo();
+                    long memoria_agrupar = monitor.obtener_memoria() - memoria_inicio;
+                    std::cout << "Proceso terminado en " << tiempo_agrupar << " ms, Memoria: " << memoria_agrupar << " KB\n";
+                    monitor.registrar("Agrupar colección", tiempo_agrupar, memoria_agrupar);
+                    break;
+                }
+
+                if (opcionZonas < 1 || opcionZonas > 5) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+
+                if (!zonas) {
+                    monitor.iniciar_tiempo();
+                    zonas = std::make_unique<MapaZonas>(*personas);
+                    double tiempo_zonas = monitor.detener_tiempo();
+                    std::cout << "\nMapa de " << zonas->numeroBloques() << " bloques construido en " << tiempo_zonas << " ms\n";
+                    monitor.registrar("Construir mapas de zonas", tiempo_zonas, monitor.obtener_memoria() - memoria_inicio);
+                    memoria_inicio = monitor.obtener_memoria();
+                }
+
+                std::string operacion;
+                std::string parametro;
+                double umbral = 0;
+                if (opcionZonas <= 2) {
+                    std::cout << "\nIngrese el valor de X: ";
+                    if (!(std::cin >> umbral)) {
+                        std::cin.clear();
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        std::cout << "Entrada inválida!\n";
+                        break;
+                    }
+                } else if (opcionZonas <= 4) {
+                    std::cout << "\nIngrese la ciudad: ";
+                    std::cin >> parametro;
+                    if (parametro.empty()) {
+                        std::cout << "Ciudad no puede estar vacía!\n";
+                        break;
+                    }
+                    if (!ciudadValida(parametro)) {
+                        std::cout << "Ciudad inválida: " << parametro << " no está en el catálogo!\n";
+                        break;
+                    }
+                } else {
+                    std::cout << "\nIngrese el grupo de declaración: ";
+                    std::cin >> parametro;
+                }
+
+                monitor.iniciar_tiempo();
+
+                EstadisticaSalto salto;
+                const Persona* encontrada = nullptr;
+                switch (opcionZonas) {
+                    case 1:
+                        operacion = "Contar patrimonio mayor (zonas)";
+                        std::cout << "Personas con patrimonio > " << umbral << ": " << zonas->contarPatrimonioMayorQue(umbral, salto) << "\n";
+                        break;
+                    case 2:
+                        operacion = "Contar edad mayor (zonas)";
+                        std::cout << "Personas con edad > " << umbral << ": " << zonas->contarEdadMayorQue(static_cast<int>(umbral), salto) << "\n";
+                        break;
+                    case 3:
+                        operacion = "Contar en ciudad (zonas)";
+                        std::cout << "Personas en " << parametro << ": " << zonas->contarEnCiudad(parametro, salto) << "\n";
+                        break;
+                    case 4:
+                        operacion = "Más rica en ciudad (zonas)";
+                        encontrada = zonas->masPatrimonioEnCiudad(parametro, salto);
+                        break;
+                    case 5:
+                        operacion = "Más rica en grupo (zonas)";
+                        encontrada = zonas->masPatrimonioEnGrupo(parametro, salto);
+                        break;
+                }
+                if (opcionZonas >= 4) {
+                    if (encontrada) {
+                        encontrada->mostrar();
+                    } else {
+                        std::cout << "No hay personas registradas con ese criterio: " << parametro << "\n";
+                    }
+                }
+
+                double tiempo_busqueda = monitor.detener_tiempo();
+                long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Bloques leídos: " << salto.bloquesLeidos << ", saltados: " << salto.bloquesSaltados << "\n";
+                std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
+                monitor.registrar(operacion, tiempo_busqueda, memoria_busqueda);
+                monitor.registrar_saltos(operacion, salto.bloquesLeidos, salto.bloquesSaltados);
+                break;
+            }
+
+            case 21: { // Medir sobrecosto de la cancelación cooperativa
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    std::cout << "Presione Enter para continuar...";
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cin.get();
+                    break; // rompe solo el switch
+                }
+
+                // Misma verificación con y sin token/callback, intercalando
+                // las variantes y quedándose con el mejor tiempo de cada una
+                const int repeticiones = 5;
+                TokenCancelacion token;
+                ControlOperacion control;
+                control.token = &token;
+                control.progreso = [](size_t, size_t) {};
+
+                double tiempo_sin = 0, tiempo_con = 0;
+                std::streambuf* salidaOriginal = std::cout.rdbuf(nullptr); // Silencia los resúmenes
+                for (int r = 0; r < repeticiones; ++r) {
+                    monitor.iniciar_tiempo();
+                    verificarGruposMasivoPorReferencia(*personas);
+                    double t = monitor.detener_tiempo();
+                    tiempo_sin = (r == 0 || t < tiempo_sin) ? t : tiempo_sin;
+
+                    monitor.iniciar_tiempo();
+                    verificarGruposMasivoPorReferencia(*personas, control);
+                    t = monitor.detener_tiempo();
+                    tiempo_con = (r == 0 || t < tiempo_con) ? t : tiempo_con;
+                }
+                std::cout.rdbuf(salidaOriginal);
+                std::cout.clear();
+
+                long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "\nVerificación sin cancelación: " << tiempo_sin << " ms";
+                std::cout << "\nVerificación con cancelación: " << tiempo_con << " ms";
+                std::cout << "\nSobrecosto: " << (tiempo_sin > 0 ? (tiempo_con - tiempo_sin) * 100.0 / tiempo_sin : 0.0) << "%\n";
+                monitor.registrar("Verificar sin cancelación (mejor de 5)", tiempo_sin, memoria_busqueda);
+                monitor.registrar("Verificar con cancelación (mejor de 5)", tiempo_con, memoria_busqueda);
+                break;
+            }
+
+            case 22: { // Activar/desactivar precálculo en segundo plano
+                modoPrecalculo = !modoPrecalculo;
+                if (!modoPrecalculo) {
+                    precalculo.cancelar();
+                } else if (personas && !personas->empty()) {
+                    precalculo.iniciar(*personas, versionDatos); // No espera a la próxima generación
+                }
+                std::cout << "\nPrecálculo en segundo plano "
+                          << (modoPrecalculo ? "activado" : "desactivado") << ".\n";
+                break;
+            }
+
+            case 25: { // Conjuntos con nombre
+                std::cout << "\nPresione 1 para guardar el conjunto actual con un nombre";
+                std::cout << "\nPresione 2 para activar un conjunto guardado";
+                std::cout << "\nPresione 3 para comparar dos conjuntos";
+                std::cout << "\nPresione 4 para ver la memoria de cada conjunto";
+                std::cout << "\nPresione 5 para eliminar un conjunto\n";
+                int opcionConjunto;
+                std::cin >> opcionConjunto;
+
+                std::string nombre, otro;
+                if (opcionConjunto == 1 && (!personas || personas->empty())) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+                if (opcionConjunto == 1 || opcionConjunto == 2 || opcionConjunto == 5) {
+                    std::cout << "\nNombre del conjunto: ";
+                    std::cin >> nombre;
+                } else if (opcionConjunto == 3) {
+                    std::cout << "\nNombres de los dos conjuntos: ";
+                    std::cin >> nombre >> otro;
+                } else if (opcionConjunto != 4) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+
+                monitor.iniciar_tiempo();
+                std::string nombreOperacion;
+                try {
+                    if (opcionConjunto == 1) {
+                        nombreOperacion = "Guardar conjunto con nombre";
+                        conjuntos.guardar(nombre, *personas);
+                        std::cout << "Conjunto '" << nombre << "' guardado.\n";
+                    } else if (opcionConjunto == 2) {
+                        nombreOperacion = "Activar conjunto con nombre";
+                        std::vector<Persona> activadas = conjuntos.materializar(nombre);
+                        reemplazarConjunto(activadas);
+                        std::cout << "Conjunto '" << nombre << "' activo (" << personas->size() << " personas).\n";
+                    } else if (opcionConjunto == 3) {
+                        nombreOperacion = "Comparar conjuntos";
+                        conjuntos.comparar(nombre, otro, std::cout);
+                    } else if (opcionConjunto == 4) {
+                        nombreOperacion = "Memoria de conjuntos";
+                        conjuntos.mostrarMemoria(std::cout);
+                        if (personas) {
+                            std::cout << "Conjunto activo: " << personas->size() << " personas, ~"
+                                      << estimarMemoriaColeccion(personas->size()) / 1024 << " KB (vector de Persona)\n";
+                        }
+                    } else {
+                        nombreOperacion = "Eliminar conjunto con nombre";
+                        conjuntos.eliminar(nombre);
+                        std::cout << "Conjunto '" << nombre << "' eliminado.\n";
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_conjunto = monitor.detener_tiempo();
+                long memoria_conjunto = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_conjunto << " ms, Memoria: " << memoria_conjunto << " KB\n";
+                monitor.registrar(nombreOperacion, tiempo_conjunto, memoria_conjunto);
+                break;
+            }
+
+            case 24: { // Guardar/cargar instantánea con índices
+                std::cout << "\nPresione 1 para guardar el conjunto actual";
+                std::cout << "\nPresione 2 para cargar una instantánea\n";
+                int opcionInstantanea;
+                std::cin >> opcionInstantanea;
+                if (opcionInstantanea != 1 && opcionInstantanea != 2) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+
+                std::string ruta;
+                std::cout << "\nRuta de la instantánea: ";
+                std::cin >> ruta;
+                if (opcionInstantanea == 2) {
+                    cargarInstantanea(ruta);
+                    break;
+                }
+
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+
+                monitor.iniciar_tiempo();
+                try {
+                    if (!planificador) planificador = std::make_unique<Planificador>(*personas);
+                    OperacionCancelable operacion;
+                    ColeccionEnDisco::guardar(ruta, *personas, ColeccionEnDisco::PRESUPUESTO_POR_DEFECTO,
+                                              operacion.control("Guardando datos", ajuste.tamFragmento));
+                    ColeccionEnDisco guardada(ruta);
+                    guardarIndices(rutaIndices(ruta), planificador->indices(), guardada.huella(), personas->size());
+                    huellaDatos = guardada.huella();
+                    versionHuella = versionDatos;
+                    if (versionResultado == versionDatos) huellaResultado = huellaDatos;
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+                double tiempo_guardar = monitor.detener_tiempo();
+                long memoria_guardar = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Instantánea guardada en " << ruta << " y " << rutaIndices(ruta) << "\n";
+                std::cout << "Proceso terminado en " << tiempo_guardar << " ms, Memoria: " << memoria_guardar << " KB\n";
+                monitor.registrar("Guardar instantánea con índices", tiempo_guardar, memoria_guardar);
+                break;
+            }
+
+            case 23: { // Conjunto en disco
+                std::cout << "\nPresione 1 para generar un conjunto en disco";
+                std::cout << "\nPresione 2 para abrir un conjunto existente";
+                std::cout << "\nPresione 3 para buscar la persona más longeva";
+                std::cout << "\nPresione 4 para buscar la persona más rica";
+                std::cout << "\nPresione 5 para buscar la persona más rica de un grupo";
+                std::cout << "\nPresione 6 para verificar grupos";
+                std::cout << "\nPresione 7 para calcular promedios por grupo\n";
+
+                int opcionDisco;
+                std::cin >> opcionDisco;
+
+                if (opcionDisco == 1 || opcionDisco == 2) {
+                    std::string ruta;
+                    uint64_t n = 0;
+                    size_t presupuestoMB = 0;
+                    std::cout << "\nRuta del archivo: ";
+                    std::cin >> ruta;
+                    if (opcionDisco == 1) {
+                        std::cout << "Número de personas: ";
+                        std::cin >> n;
+                    }
+                    std::cout << "Presupuesto de memoria (MB): ";
+                    std::cin >> presupuestoMB;
+                    if (!std::cin || presupuestoMB == 0 || (opcionDisco == 1 && n == 0)) {
+                        std::cout << "Entrada inválida!\n";
+                        std::cin.clear();
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        break;
+                    }
+
+                    monitor.iniciar_tiempo();
+                    try {
+                        if (opcionDisco == 1) {
+                            OperacionCancelable operacion;
+                            ColeccionEnDisco::generar(ruta, n, presupuestoMB * 1024 * 1024, operacion.control("Generando en disco", ajuste.tamFragmento));
+                        }
+                        enDisco = std::make_unique<ColeccionEnDisco>(ruta, presupuestoMB * 1024 * 1024);
+                        lecturaCruda = enDisco->medirLecturaCruda();
+                    } catch (const std::exception& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        enDisco.reset();
+                        break;
+                    }
+
+                    double tiempo_disco = monitor.detener_tiempo();
+                    long memoria_disco = monitor.obtener_memoria() - memoria_inicio;
+                    std::cout << enDisco->total() << " personas en " << enDisco->numeroFragmentos() << " fragmentos ("
+                              << lecturaCruda.bytesLeidos / (1024 * 1024) << " MB). Lectura cruda del disco: "
+                              << lecturaCruda.megabytesPorSegundo() << " MB/s\n";
+                    std::cout << "Proceso terminado en " << tiempo_disco << " ms, Memoria: " << memoria_disco << " KB\n";
+                    monitor.registrar(opcionDisco == 1 ? "Generar conjunto en disco" : "Abrir conjunto en disco", tiempo_disco, memoria_disco);
+                    break;
+                }
+
+                if (opcionDisco < 3 || opcionDisco > 7) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+                if (!enDisco) {
+                    std::cout << "\nNo hay conjunto en disco. Genere o abra uno primero.\n";
+                    break;
+                }
+
+                std::string parametro;
+                if (opcionDisco == 3 || opcionDisco == 4) {
+                    std::cout << "\nIngrese la ciudad (* para todo el país): ";
+                    std::cin >> parametro;
+                    if (parametro == "*") parametro.clear();
+                } else if (opcionDisco == 5) {
+                    std::cout << "\nIngrese el grupo de declaración: ";
+                    std::cin >> parametro;
+                }
+
+                enDisco->descartarCachePaginas(); // Lectura en frío, comparable con la cruda
+                monitor.iniciar_tiempo();
+                std::string nombreOperacion;
+                try {
+                    OperacionCancelable operacion;
+                    ControlOperacion control = operacion.control("Leyendo fragmentos", 1);
+                    if (opcionDisco == 3) {
+                        nombreOperacion = "Más longeva en disco";
+                        enDisco->masLongevo(parametro, control).mostrar();
+                    } else if (opcionDisco == 4) {
+                        nombreOperacion = "Más rica en disco";
+                        enDisco->masPatrimonio(parametro, "", control).mostrar();
+                    } else if (opcionDisco == 5) {
+                        nombreOperacion = "Más rica de grupo en disco";
+                        enDisco->masPatrimonio("", parametro, control).mostrar();
+                    } else if (opcionDisco == 6) {
+                        nombreOperacion = "Verificar grupos en disco";
+                        ConteoVerificacion conteo = enDisco->verificarGrupos(control);
+                        std::cout << "\nCorrectos: " << conteo.correctos << ", Incorrectos: " << conteo.incorrectos << "\n";
+                    } else {
+                        nombreOperacion = "Promedios por grupo en disco";
+                        for (const auto& g : enDisco->promediosPorGrupo(control)) {
+                            std::cout << "Grupo " << g.grupo << " - Promedio Patrimonio: " << g.promedioPatrimonio
+                                      << ", Promedio Edad: " << g.promedioEdad << " (" << g.conteo << " personas)\n";
+                        }
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_busqueda = monitor.detener_tiempo();
+                long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
+                const EstadisticaLectura& leida = enDisco->ultimaLectura();
+                std::cout << "Leídos " << leida.bytesLeidos / (1024 * 1024) << " MB en " << leida.fragmentos << " fragmentos: "
+                          << leida.megabytesPorSegundo() << " MB/s (disco crudo: " << lecturaCruda.megabytesPorSegundo()
+                          << " MB/s, " << (lecturaCruda.megabytesPorSegundo() > 0 ? leida.megabytesPorSegundo() * 100.0 / lecturaCruda.megabytesPorSegundo() : 0.0)
+                          << "%)\n";
+                std::cout << "Proceso terminado en " << tiempo_busqueda << " ms, Memoria: " << memoria_busqueda << " KB\n";
+                monitor.registrar(nombreOperacion, tiempo_busqueda, memoria_busqueda);
+                break;
+            }
+
+            case 26: { // Banco de pruebas sin ruido
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    std::cout << "Presione Enter para continuar...";
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cin.get();
+                    break; // rompe solo el switch
+                }
+
+                std::cout << "\nPresione 1 para comparar más longevo por valor vs referencia";
+                std::cout << "\nPresione 2 para comparar verificación por valor vs referencia";
+                std::cout << "\nPresione 3 para comparar grupo de mayor patrimonio por valor vs referencia";
+                std::cout << "\nPresione 4 para comparar clase vs estructura y el costo de copiar en los getters (conteo por ciudad)\n";
+                int opcionBanco;
+                std::cin >> opcionBanco;
+                if (opcionBanco < 1 || opcionBanco > 4) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+
+                ConfiguracionBanco configBanco;
+                int modoCache = 1;
+                long long repeticionesBanco = 0; // Con signo: un negativo no debe volverse un size_t enorme
+                std::cout << "Repeticiones por variante: ";
+                std::cin >> repeticionesBanco;
+                std::cout << "Cachés antes de cada repetición (0 = sin tocar, 1 = vaciar, 2 = precalentar): ";
+                std::cin >> modoCache;
+                std::cout << "Núcleo (-1 = automático): ";
+                std::cin >> configBanco.nucleo;
+                if (!std::cin) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+                if (repeticionesBanco <= 0) {
+                    std::cout << "Las repeticiones deben ser mayores que cero!\n";
+                    break;
+                }
+                configBanco.repeticiones = static_cast<size_t>(repeticionesBanco);
+                configBanco.cache = modoCache == 0 ? ModoCache::NINGUNO
+                                  : modoCache == 2 ? ModoCache::PRECALENTAR : ModoCache::VACIAR;
+
+                // Copia plana preparada fuera de la medición: solo se mide el recorrido
+                std::vector<PersonaPlana> planas;
+                std::string ciudadBanco;
+                volatile size_t sumidero = 0; // Evita que el compilador descarte resultados
+                std::vector<VarianteBanco> variantes;
+                const std::vector<Persona>& datos = *personas;
+                if (opcionBanco == 1) {
+                    variantes.push_back({"Más longevo por valor", [&] { sumidero = buscarMasLongevoPorValor(datos).getEdad(); }});
+                    variantes.push_back({"Más longevo por referencia", [&] { sumidero = buscarMasLongevoPorReferencia(datos)->getEdad(); }});
+                } else if (opcionBanco == 2) {
+                    variantes.push_back({"Verificar por valor", [&] { verificarGruposMasivoPorValor(datos); }});
+                    variantes.push_back({"Verificar por referencia", [&] { verificarGruposMasivoPorReferencia(datos); }});
+                } else if (opcionBanco == 3) {
+                    variantes.push_back({"Mayor patrimonio por valor", [&] { sumidero = encontrarGrupoMayorPatrimonioPorValor(datos).size(); }});
+                    variantes.push_back({"Mayor patrimonio por referencia", [&] { sumidero = encontrarGrupoMayorPatrimonioPorReferencia(datos).size(); }});
+                } else {
+                    std::cout << "Ciudad: ";
+                    std::cin >> ciudadBanco;
+                    planas.reserve(datos.size());
+                    for (const auto& p : datos) {
+                        planas.push_back({p.getNombre(), p.getApellido(), p.getId(), p.getCiudadNacimiento(),
+                                          p.getFechaNacimiento(), p.getGrupoDeclaracion(), p.getEdad(),
+                                          p.getIngresosAnuales(), p.getPatrimonio(), p.getDeudas(),
+                                          p.getDeclaranteRenta()});
+                    }
+                    variantes.push_back({"Clase (getters)", [&] {
+                        size_t n = 0;
+                        for (const auto& p : datos) n += p.getCiudadNacimiento() == ciudadBanco;
+                        sumidero = n;
+                    }});
+                    variantes.push_back({"Estructura (campos)", [&] {
+                        size_t n = 0;
+                        for (const auto& p : planas) n += p.ciudadNacimiento == ciudadBanco;
+                        sumidero = n;
+                    }});
+                    // Lo que hacían los getters antes de devolver referencias: una copia por fila
+                    variantes.push_back({"Clase (getter con copia)", [&] {
+                        size_t n = 0;
+                        for (const auto& p : datos) {
+                            std::string copia = p.getCiudadNacimiento();
+                            n += copia == ciudadBanco;
+                        }
+                        sumidero = n;
+                    }});
+                }
+
+                try {
+                    BancoPruebas banco(configBanco);
+                    for (const auto& advertencia : banco.advertenciasEntorno()) {
+                        std::cout << "ADVERTENCIA: " << advertencia << "\n";
+                    }
+                    std::cout << "Midiendo en el núcleo " << banco.nucleo() << "...\n";
+                    std::vector<ResultadoVariante> resultados = banco.ejecutar(variantes);
+                    BancoPruebas::mostrar(resultados, std::cout);
+                    if (opcionBanco == 4) {
+                        double nsPorFila = (resultados[2].mediana - resultados[0].mediana) * 1e6 / datos.size();
+                        std::cout << "Costo de copiar el string en el getter: " << nsPorFila << " ns por fila\n";
+                    }
+
+                    long memoria_banco = monitor.obtener_memoria() - memoria_inicio;
+                    for (const auto& r : resultados) {
+                        monitor.registrar("Banco: " + r.nombre + " (mediana)", r.mediana, memoria_banco);
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                }
+                break;
+            }
+
+            case 27: { // Mapa de patrones de acceso por nivel de caché
+                ConfiguracionBanco configBanco;
+                size_t maximoMB = 0;
+                long long repeticionesMapa = 0; // Con signo: un negativo no debe volverse un size_t enorme
+                std::cout << "\nRepeticiones por tamaño: ";
+                std::cin >> repeticionesMapa;
+                std::cout << "Conjunto de trabajo máximo en MB (0 = el doble de la última caché): ";
+                std::cin >> maximoMB;
+                if (!std::cin) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+                if (repeticionesMapa <= 0) {
+                    std::cout << "Las repeticiones deben ser mayores que cero!\n";
+                    break;
+                }
+                configBanco.repeticiones = static_cast<size_t>(repeticionesMapa);
+
+                size_t maximoBytes = maximoMB * 1024 * 1024;
+                if (maximoBytes == 0) {
+                    std::vector<NivelCache> caches = cachesDelNucleo(0);
+                    maximoBytes = caches.empty() ? 256 * 1024 * 1024 : 2 * caches.back().bytes;
+                }
+                // Registros más punteros e índices: no pasar de un cuarto de la memoria libre
+                long disponibleKB = monitor.obtener_memoria_disponible();
+                if (disponibleKB > 0) {
+                    size_t tope = static_cast<size_t>(disponibleKB) * 1024 / 4 / (sizeof(Persona) + 24) * sizeof(Persona);
+                    if (maximoBytes > tope) {
+                        std::cout << "Limitado a " << tope / (1024 * 1024) << " MB por la memoria disponible.\n";
+                        maximoBytes = tope;
+                    }
+                }
+
+                monitor.iniciar_tiempo();
+                try {
+                    MapaPatrones mapa = medirPatronesAcceso(configBanco, maximoBytes);
+                    mostrarMapaPatrones(mapa, std::cout);
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_mapa = monitor.detener_tiempo();
+                long memoria_mapa = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_mapa << " ms, Memoria: " << memoria_mapa << " KB\n";
+                monitor.registrar("Mapa de patrones de acceso", tiempo_mapa, memoria_mapa);
+                break;
+            }
+
+            case 28: { // Filtros combinados con mapas de bits
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    std::cout << "Presione Enter para continuar...";
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cin.get();
+                    break; // rompe solo el switch
+                }
+
+                if (!mapasBits) { // Datos cargados, activados o reagrupados desde la última generación
+                    monitor.iniciar_tiempo();
+                    mapasBits = std::make_unique<IndicesMapaBits>(*personas);
+                    double tiempo_mapas = monitor.detener_tiempo();
+                    long memoria_mapas = monitor.obtener_memoria() - memoria_inicio;
+                    std::cout << "\nMapas de bits construidos en " << tiempo_mapas << " ms, Memoria: " << memoria_mapas << " KB\n";
+                    monitor.registrar("Construir mapas de bits", tiempo_mapas, memoria_mapas);
+                    memoria_inicio = monitor.obtener_memoria();
+                }
+
+                // Varios valores de un campo separados por comas se combinan con OR
+                auto leerValores = [](const std::string& texto) {
+                    std::vector<std::string> valores;
+                    std::stringstream partes(texto);
+                    std::string valor;
+                    while (std::getline(partes, valor, ',')) {
+                        if (!valor.empty() && valor != "*") valores.push_back(valor);
+                    }
+                    return valores;
+                };
+                FiltroCategorico filtro;
+                std::string textoCiudades, textoGrupos, textoDeclarante;
+                std::cout << "\nCiudades separadas por comas (* para cualquiera): ";
+                std::cin >> textoCiudades;
+                std::cout << "Grupos separados por comas (* para cualquiera): ";
+                std::cin >> textoGrupos;
+                std::cout << "Declarante (1 = sí, 0 = no, * = cualquiera): ";
+                std::cin >> textoDeclarante;
+                filtro.ciudades = leerValores(textoCiudades);
+                filtro.grupos = leerValores(textoGrupos);
+                filtro.declarante = textoDeclarante == "1" ? 1 : textoDeclarante == "0" ? 0 : -1;
+
+                monitor.iniciar_tiempo();
+                uint64_t conteo = mapasBits->contar(filtro);
+                double tiempo_conteo = monitor.detener_tiempo();
+
+                monitor.iniciar_tiempo();
+                MapaBitsRoaring filas = mapasBits->filtrar(filtro);
+                ResumenFiltro resumen = mapasBits->resumir(*personas, filas, ajuste.filasPorLote, ajuste.distanciaPrefetch);
+                double tiempo_mapas = monitor.detener_tiempo();
+                long memoria_mapas = monitor.obtener_memoria() - memoria_inicio;
+
+                // El mismo cálculo recorriendo toda la colección, para comparar
+                monitor.iniciar_tiempo();
+                ResumenFiltro referencia = resumirPorRecorrido(*personas, filtro);
+                double tiempo_recorrido = monitor.detener_tiempo();
+
+                std::cout << "\nPersonas que cumplen el filtro: " << conteo << " (popcount en " << tiempo_conteo << " ms)\n";
+                if (resumen.conteo > 0) {
+                    std::cout << "Patrimonio promedio: " << resumen.sumaPatrimonio / resumen.conteo
+                              << ", Edad promedio: " << resumen.sumaEdad / resumen.conteo << "\n";
+                    std::cout << "Persona con más patrimonio:";
+                    (*personas)[resumen.filaMasPatrimonio].mostrar();
+                    std::cout << "Persona más longeva:";
+                    (*personas)[resumen.filaMasLongevo].mostrar();
+                }
+                bool coincide = referencia.conteo == resumen.conteo && referencia.filaMasPatrimonio == resumen.filaMasPatrimonio &&
+                                referencia.filaMasLongevo == resumen.filaMasLongevo;
+                std::cout << "Mapas de bits: " << tiempo_mapas << " ms, recorrido completo: " << tiempo_recorrido
+                          << " ms (" << (coincide ? "mismo resultado" : "¡RESULTADOS DISTINTOS!") << ")\n";
+                std::cout << "Proceso terminado en " << tiempo_mapas << " ms, Memoria: " << memoria_mapas << " KB\n";
+                monitor.registrar("Filtro combinado con mapas de bits", tiempo_mapas, memoria_mapas);
+                monitor.registrar("Filtro combinado por recorrido completo", tiempo_recorrido, memoria_mapas);
+                break;
+            }
+
+            case 29: { // Conjunto virtual
+                std::cout << "\nPresione 1 para crear un conjunto virtual (tamaño y semilla)";
+                std::cout << "\nPresione 2 para buscar por ID (aritmética, sin recorrido)";
+                std::cout << "\nPresione 3 para buscar la persona más longeva";
+                std::cout << "\nPresione 4 para buscar la persona con más patrimonio";
+                std::cout << "\nPresione 5 para calcular promedios por grupo";
+                std::cout << "\nPresione 6 para materializarlo como conjunto actual";
+                std::cout << "\nPresione 7 para comparar el conjunto actual materializado en 6 con uno virtual de su semilla\n";
+                int opcionVirtual;
+                std::cin >> opcionVirtual;
+                if (opcionVirtual < 1 || opcionVirtual > 7) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+                if (opcionVirtual != 1 && !coleccionVirtual) {
+                    std::cout << "\nNo hay conjunto virtual. Use la opción 1 primero.\n";
+                    break;
+                }
+
+                std::string nombreOperacion;
+                std::string ciudad, grupo, id;
+                uint64_t totalVirtual = 0, semilla = 0;
+                if (opcionVirtual == 1) {
+                    std::cout << "\nNúmero de personas y semilla: ";
+                    if (!(std::cin >> totalVirtual >> semilla)) {
+                        std::cin.clear();
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        std::cout << "Entrada inválida!\n";
+                        break;
+                    }
+                } else if (opcionVirtual == 2) {
+                    std::cout << "\nIngrese el ID: ";
+                    std::cin >> id;
+                } else if (opcionVirtual == 3 || opcionVirtual == 4) {
+                    std::cout << "\nIngrese la ciudad (* para todo el país): ";
+                    std::cin >> ciudad;
+                    if (ciudad == "*") ciudad.clear();
+                    if (opcionVirtual == 4) {
+                        std::cout << "Ingrese el grupo (* para cualquiera): ";
+                        std::cin >> grupo;
+                        if (grupo == "*") grupo.clear();
+                    }
+                } else if (opcionVirtual == 7 && (!hayMaterializado || versionMaterializada != versionDatos ||
+                                                  !personas || personas->empty())) {
+                    std::cout << "\nEl conjunto actual no es un conjunto virtual materializado (o cambió después). Use la opción 6 primero.\n";
+                    break;
+                }
+
+                monitor.iniciar_tiempo();
+                try {
+                    OperacionCancelable operacion;
+                    if (opcionVirtual == 1) {
+                        nombreOperacion = "Crear conjunto virtual";
+                        coleccionVirtual = std::make_unique<ColeccionVirtual>(totalVirtual, semilla);
+                        std::cout << "Conjunto virtual de " << totalVirtual << " personas (semilla " << semilla
+                                  << "), 0 bytes por fila.\n";
+                    } else if (opcionVirtual == 2) {
+                        nombreOperacion = "Buscar por ID en conjunto virtual";
+                        long long indice = coleccionVirtual->indiceDeId(id);
+                        if (indice < 0) std::cout << "No existe una persona con ID " << id << "\n";
+                        else coleccionVirtual->persona(static_cast<uint64_t>(indice)).mostrar();
+                    } else if (opcionVirtual == 3) {
+                        nombreOperacion = "Más longeva en conjunto virtual";
+                        coleccionVirtual->persona(coleccionVirtual->masLongevo(ciudad, operacion.control("Recorriendo", ajuste.tamFragmento))).mostrar();
+                    } else if (opcionVirtual == 4) {
+                        nombreOperacion = "Más patrimonio en conjunto virtual";
+                        coleccionVirtual->persona(coleccionVirtual->masPatrimonio(ciudad, grupo, operacion.control("Recorriendo", ajuste.tamFragmento))).mostrar();
+                    } else if (opcionVirtual == 5) {
+                        nombreOperacion = "Promedios por grupo en conjunto virtual";
+                        for (const auto& g : coleccionVirtual->promediosPorGrupo(operacion.control("Recorriendo", ajuste.tamFragmento))) {
+                            std::cout << "Grupo " << g.grupo << " - Promedio Patrimonio: " << g.promedioPatrimonio
+                                      << ", Promedio Edad: " << g.promedioEdad << " (" << g.conteo << " personas)\n";
+                        }
+                    } else if (opcionVirtual == 6) {
+                        nombreOperacion = "Materializar conjunto virtual";
+                        if (coleccionVirtual->total() > FILAS_MAXIMAS_EN_MEMORIA) {
+                            throw std::runtime_error("Una colección en memoria admite hasta " +
+                                                     std::to_string(FILAS_MAXIMAS_EN_MEMORIA) + " personas");
+                        }
+                        size_t estimado = estimarMemoriaColeccion(coleccionVirtual->total());
+                        long disponibleKB = monitor.obtener_memoria_disponible();
+                        if (disponibleKB > 0 && estimado / 1024 > static_cast<size_t>(disponibleKB)) {
+                            throw std::runtime_error("Se necesitan ~" + std::to_string(estimado / (1024 * 1024)) +
+                                                     " MB y hay " + std::to_string(disponibleKB / 1024) + " MB disponibles");
+                        }
+                        std::vector<Persona> materializadas = coleccionVirtual->materializar(0, operacion.control("Materializando", ajuste.tamFragmento));
+                        reemplazarConjunto(materializadas);
+                        hayMaterializado = true;
+                        semillaMaterializada = coleccionVirtual->semilla();
+                        versionMaterializada = versionDatos;
+                        std::cout << "\nConjunto actual: " << personas->size() << " personas (semilla " << semillaMaterializada << ").\n";
+                    } else {
+                        // Misma semilla y tamaño con que se materializó el conjunto actual, para comparar fila a fila
+                        nombreOperacion = "Comparar conjunto virtual con el actual";
+                        ColeccionVirtual virtualActual(personas->size(), semillaMaterializada);
+                        size_t distintas = 0;
+                        const size_t muestras = std::min<size_t>(personas->size(), 1000);
+                        for (size_t k = 0; k < muestras; ++k) {
+                            size_t fila = k * personas->size() / muestras;
+                            Persona v = virtualActual.persona(fila);
+                            const Persona& m = (*personas)[fila];
+                            if (v.getId() != m.getId() || v.getNombre() != m.getNombre() || v.getApellido() != m.getApellido() ||
+                                v.getCiudadNacimiento() != m.getCiudadNacimiento() || v.getFechaNacimiento() != m.getFechaNacimiento() ||
+                                v.getGrupoDeclaracion() != m.getGrupoDeclaracion() || v.getEdad() != m.getEdad() ||
+                                v.getPatrimonio() != m.getPatrimonio() || v.getDeclaranteRenta() != m.getDeclaranteRenta()) {
+                                distintas++;
+                            }
+                        }
+                        std::cout << "\nFilas de muestra distintas: " << distintas << " de " << muestras << "\n";
+
+                        uint64_t longevoVirtual = virtualActual.masLongevo("", operacion.control("Recorriendo", ajuste.tamFragmento));
+                        size_t longevoVector = buscarMasLongevoPorReferencia(*personas) - personas->data();
+                        uint64_t ricoVirtual = virtualActual.masPatrimonio("", "", operacion.control("Recorriendo", ajuste.tamFragmento));
+                        size_t ricoVector = buscarMasPatrimonioPorReferencia(*personas) - personas->data();
+                        std::cout << "Más longeva: fila " << longevoVirtual << " (virtual) vs " << longevoVector << " (vector)\n";
+                        std::cout << "Más patrimonio: fila " << ricoVirtual << " (virtual) vs " << ricoVector << " (vector)\n";
+                        std::cout << (distintas == 0 && longevoVirtual == longevoVector && ricoVirtual == ricoVector
+                                      ? "Los resultados coinciden.\n" : "¡LOS RESULTADOS NO COINCIDEN!\n");
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_virtual = monitor.detener_tiempo();
+                long memoria_virtual = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_virtual << " ms, Memoria: " << memoria_virtual << " KB\n";
+                monitor.registrar(nombreOperacion, tiempo_virtual, memoria_virtual);
+                break;
+            }
+
+            case 30: { // Grabar/reproducir la sesión
+                std::cout << "\nPresione 1 para empezar a grabar la sesión";
+                std::cout << "\nPresione 2 para detener la grabación";
+                std::cout << "\nPresione 3 para reproducir una traza sobre el conjunto actual\n";
+                int opcionTraza;
+                std::cin >> opcionTraza;
+
+                if (opcionTraza == 1) {
+                    std::string ruta;
+                    std::cout << "\nRuta del archivo de traza: ";
+                    std::cin >> ruta;
+                    try {
+                        grabadora.iniciar(ruta);
+                        std::cout << "Grabando la sesión en " << ruta << " (la opción 30 no se graba).\n";
+                    } catch (const std::exception& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                    }
+                    break;
+                } else if (opcionTraza == 2) {
+                    if (!grabadora.activa()) {
+                        std::cout << "\nNo hay una grabación en curso.\n";
+                        break;
+                    }
+                    std::cout << "\nTraza " << grabadora.ruta() << " cerrada con " << grabadora.eventos() << " operaciones.\n";
+                    grabadora.detener();
+                    break;
+                } else if (opcionTraza != 3) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+                std::string ruta;
+                ConfiguracionReproduccion config;
+                int variante;
+                std::cout << "\nRuta del archivo de traza: ";
+                std::cin >> ruta;
+                std::cout << "Aceleración (0 = sin esperas, 1 = ritmo original, 10 = diez veces más rápido): ";
+                std::cin >> config.aceleracion;
+                std::cout << "Hilos (cada uno reproduce la traza completa): ";
+                std::cin >> config.hilos;
+                std::cout << "Variante (0 = la grabada, 1 = siempre por valor, 2 = siempre por referencia): ";
+                std::cin >> variante;
+                if (!std::cin || variante < 0 || variante > 2 || config.hilos == 0 || config.hilos > 256) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+                config.variante = static_cast<VarianteReproduccion>(variante);
+
+                monitor.iniciar_tiempo();
+                try {
+                    std::vector<EventoTraza> traza = leerTraza(ruta);
+                    OperacionCancelable operacion;
+                    ReporteReproduccion reporte = reproducirTraza(traza, *personas, config, operacion.control("Reproduciendo", ajuste.tamFragmento));
+                    mostrarReporteReproduccion(reporte);
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_traza = monitor.detener_tiempo();
+                long memoria_traza = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_traza << " ms, Memoria: " << memoria_traza << " KB\n";
+                monitor.registrar("Reproducir traza", tiempo_traza, memoria_traza);
+                break;
+            }
+
+            case 31: { // Prueba de carga con claves Zipf
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+
+                ConfiguracionCarga config;
+                std::cout << "\nClientes concurrentes: ";
+                std::cin >> config.clientes;
+                std::cout << "Tasa objetivo total en consultas/s (0 = sin límite): ";
+                std::cin >> config.tasaObjetivo;
+                std::cout << "Duración en segundos: ";
+                std::cin >> config.duracionSegundos;
+                std::cout << "Exponente Zipf (p. ej. 0.8 suave, 1.2 muy concentrado): ";
+                std::cin >> config.exponenteZipf;
+                std::cout << "Mezcla en % (por ID, máximo por ciudad, máximo por grupo; ej. 70 20 10): ";
+                std::cin >> config.pesoPorId >> config.pesoCiudad >> config.pesoGrupo;
+                if (!std::cin) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+
+                monitor.iniciar_tiempo();
+                try {
+                    OperacionCancelable operacion;
+                    ReporteCarga reporte = ejecutarCarga(*personas, config, operacion.control("Generando carga", ajuste.tamFragmento));
+                    mostrarReporteCarga(reporte);
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_carga = monitor.detener_tiempo();
+                long memoria_carga = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_carga << " ms, Memoria: " << memoria_carga << " KB\n";
+                monitor.registrar("Prueba de carga Zipf", tiempo_carga, memoria_carga);
+                break;
+            }
+
+            case 32: { // Declaraciones de renta y unión por cédula
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+                std::cout << "\nPresione 1 para generar las declaraciones del conjunto actual";
+                std::cout << "\nPresione 2 para buscar declarantes con ingresos declarados distintos";
+                std::cout << "\nPresione 3 para comparar los algoritmos de unión por tamaño e hilos\n";
+                int opcionUnion;
+                std::cin >> opcionUnion;
+                if (opcionUnion < 1 || opcionUnion > 3) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+                if (opcionUnion == 2 && !declaraciones) {
+                    std::cout << "\nNo hay declaraciones. Use la opción 1 primero.\n";
+                    break;
+                }
+
+                ConfiguracionDeclaraciones configDeclaraciones;
+                double porcentaje = 0.0;
+                int algoritmo = 1;
+                unsigned hilos = 1;
+                size_t repeticiones = 5;
+                if (opcionUnion == 1 || opcionUnion == 3) {
+                    std::cout << "\nDeclaraciones máximas por persona, % huérfanas y % discrepantes (ej. 5 3 8): ";
+                    std::cin >> configDeclaraciones.maximoPorPersona >> configDeclaraciones.porcentajeHuerfanas
+                             >> configDeclaraciones.porcentajeDiscrepantes;
+                }
+                if (opcionUnion == 2) {
+                    std::cout << "\nDiferencia mínima en % respecto a ingresosAnuales: ";
+                    std::cin >> porcentaje;
+                    std::cout << "Algoritmo (1 = hash radix, 2 = ordenar y mezclar): ";
+                    std::cin >> algoritmo;
+                }
+                if (opcionUnion == 2 || opcionUnion == 3) {
+                    std::cout << (opcionUnion == 2 ? "Hilos: " : "Hilos máximos (se prueban potencias de 2): ");
+                    std::cin >> hilos;
+                }
+                if (opcionUnion == 3) {
+                    std::cout << "Repeticiones por medición: ";
+                    std::cin >> repeticiones;
+                }
+                if (!std::cin || (algoritmo != 1 && algoritmo != 2) || hilos == 0 || hilos > 256) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+
+                std::string nombreOperacion;
+                monitor.iniciar_tiempo();
+                try {
+                    if (opcionUnion == 1) {
+                        nombreOperacion = "Generar declaraciones de renta";
+                        declaraciones = std::make_unique<std::vector<Declaracion>>(
+                            generarDeclaraciones(*personas, configDeclaraciones));
+                        size_t unidas = unirPorCedula(*personas, *declaraciones, AlgoritmoUnion::HASH_RADIX, 1).size();
+                        std::cout << "\n" << declaraciones->size() << " declaraciones ("
+                                  << declaraciones->size() * sizeof(Declaracion) / 1024 << " KB), "
+                                  << declaraciones->size() - unidas << " huérfanas.\n";
+                    } else if (opcionUnion == 2) {
+                        AlgoritmoUnion elegido = algoritmo == 1 ? AlgoritmoUnion::HASH_RADIX : AlgoritmoUnion::ORDENAR_MEZCLAR;
+                        nombreOperacion = std::string("Declarantes con discrepancia (") + nombreAlgoritmo(elegido) + ")";
+                        std::vector<ParUnion> pares = declarantesConDiscrepancia(*personas, *declaraciones, porcentaje, elegido, hilos);
+                        std::sort(pares.begin(), pares.end());
+                        size_t personasDistintas = 0;
+                        for (size_t i = 0; i < pares.size(); ++i) {
+                            if (i == 0 || pares[i].persona != pares[i - 1].persona) personasDistintas++;
+                        }
+                        std::cout << "\n" << pares.size() << " declaraciones de " << personasDistintas
+                                  << " declarantes difieren más de " << porcentaje << "% de sus ingresos anuales.\n";
+                        for (size_t i = 0; i < std::min<size_t>(10, pares.size()); ++i) {
+                            const Persona& p = (*personas)[pares[i].persona];
+                            const Declaracion& d = (*declaraciones)[pares[i].declaracion];
+                            std::ostringstream linea; // Formato fijo sin alterar el de std::cout
+                            linea << std::fixed << std::setprecision(0) << "  " << p.getId() << " " << p.getNombre() << " "
+                                  << p.getApellido() << " (" << d.anio << "): ingresos " << p.getIngresosAnuales()
+                                  << ", declarados " << d.ingresosDeclarados << " (" << std::showpos << std::setprecision(1)
+                                  << (d.ingresosDeclarados - p.getIngresosAnuales()) * 100.0 / p.getIngresosAnuales() << "%)\n";
+                            std::cout << linea.str();
+                        }
+                    } else {
+                        nombreOperacion = "Comparar algoritmos de unión";
+                        std::vector<size_t> tamanos;
+                        for (size_t divisor : {10, 4, 2, 1}) {
+                            size_t t = std::max<size_t>(1, personas->size() / divisor);
+                            if (tamanos.empty() || tamanos.back() != t) tamanos.push_back(t);
+                        }
+                        std::vector<unsigned> listaHilos;
+                        for (unsigned h = 1; h <= hilos; h *= 2) listaHilos.push_back(h);
+                        if (listaHilos.back() != hilos) listaHilos.push_back(hilos);
+                        mostrarComparacionUnion(compararAlgoritmosUnion(*personas, configDeclaraciones, tamanos,
+                                                                        listaHilos, repeticiones));
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_union = monitor.detener_tiempo();
+                long memoria_union = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_union << " ms, Memoria: " << memoria_union << " KB\n";
+                monitor.registrar(nombreOperacion, tiempo_union, memoria_union);
+                break;
+            }
+
+            case 33: { // Historial financiero multianual
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+                std::cout << "\nPresione 1 para generar el historial del conjunto actual";
+                std::cout << "\nPresione 2 para ver el historial de una persona por ID";
+                std::cout << "\nPresione 3 para buscar el mayor crecimiento por ciudad desde un año";
+                std::cout << "\nPresione 4 para ver el promedio de un campo por año\n";
+                int opcionHistorial;
+                std::cin >> opcionHistorial;
+                if (opcionHistorial < 1 || opcionHistorial > 4) {
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+                if (opcionHistorial > 1 && (!historial || historial->filas() != personas->size())) {
+                    std::cout << "\nNo hay historial para el conjunto actual. Use la opción 1 primero.\n";
+                    break;
+                }
+
+                int anios = 0, desde = 0, campo = 1;
+                std::string idHistorial;
+                if (opcionHistorial == 1) {
+                    std::cout << "\nAños de historia, incluido " << HistorialFinanciero::ANIO_ACTUAL << " (2 a 40): ";
+                    std::cin >> anios;
+                } else if (opcionHistorial == 2) {
+                    std::cout << "\nIngrese el ID a buscar: ";
+                    std::cin >> idHistorial;
+                } else {
+                    std::cout << "\nCampo (1 = ingresos, 2 = patrimonio, 3 = deudas): ";
+                    std::cin >> campo;
+                    if (opcionHistorial == 3) {
+                        std::cout << "Año inicial (" << historial->primerAnio() << " a "
+                                  << HistorialFinanciero::ANIO_ACTUAL - 1 << "): ";
+                        std::cin >> desde;
+                    }
+                }
+                if (!std::cin || campo < 1 || campo > 3) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+                CampoHistorial campoElegido = static_cast<CampoHistorial>(campo - 1);
+
+                std::string nombreOperacion;
+                monitor.iniciar_tiempo();
+                try {
+                    if (opcionHistorial == 1) {
+                        nombreOperacion = "Generar historial financiero";
+                        historial = std::make_unique<HistorialFinanciero>(*personas, anios);
+                        std::cout << "\nHistorial " << historial->primerAnio() << "-" << HistorialFinanciero::ANIO_ACTUAL
+                                  << ": " << historial->bytes() / 1024 << " KB comprimido vs "
+                                  << historial->bytesSinComprimir() / 1024 << " KB sin comprimir.\n";
+                        for (CampoHistorial c : {CampoHistorial::INGRESOS, CampoHistorial::PATRIMONIO, CampoHistorial::DEUDAS}) {
+                            std::cout << "  " << nombreCampoHistorial(c) << ": " << historial->seriesXor(c)
+                                      << " series con XOR, " << historial->filas() - historial->seriesXor(c) << " con DELTA\n";
+                        }
+                    } else if (opcionHistorial == 2) {
+                        nombreOperacion = "Historial de una persona";
+                        const Persona* encontrada = buscarPorID(*personas, idHistorial);
+                        if (!encontrada) {
+                            std::cout << "\nNo se encontró la persona con ID " << idHistorial << "\n";
+                        } else {
+                            size_t fila = static_cast<size_t>(encontrada - personas->data());
+                            std::vector<double> series[3];
+                            for (int c = 0; c < 3; ++c) series[c] = historial->serie(fila, static_cast<CampoHistorial>(c));
+                            std::ostringstream tabla; // Formato fijo sin alterar el de std::cout
+                            tabla << std::fixed << std::setprecision(0) << "\n" << encontrada->getNombre() << " "
+                                  << encontrada->getApellido() << " (" << encontrada->getCiudadNacimiento() << ")\n"
+                                  << "  Año" << std::setw(18) << "Ingresos" << std::setw(18) << "Patrimonio"
+                                  << std::setw(18) << "Deudas" << "\n";
+                            for (int t = 0; t < historial->anios(); ++t) {
+                                tabla << "  " << historial->primerAnio() + t << std::setw(18) << series[0][t]
+                                      << std::setw(18) << series[1][t] << std::setw(18) << series[2][t] << "\n";
+                            }
+                            std::cout << tabla.str();
+                        }
+                    } else if (opcionHistorial == 3) {
+                        nombreOperacion = std::string("Mayor crecimiento por ciudad (") + nombreCampoHistorial(campoElegido) + ")";
+                        std::vector<CrecimientoCiudad> mejores = historial->mayorCrecimientoPorCiudad(*personas, campoElegido, desde);
+                        std::cout << "\nMayor crecimiento de " << nombreCampoHistorial(campoElegido) << " entre " << desde
+                                  << " y " << HistorialFinanciero::ANIO_ACTUAL << " por ciudad:\n";
+                        for (const CrecimientoCiudad& m : mejores) {
+                            const Persona& p = (*personas)[m.fila];
+                            std::ostringstream linea;
+                            linea << std::fixed << std::setprecision(0) << "  " << m.ciudad << ": " << p.getNombre() << " "
+                                  << p.getApellido() << " (ID " << p.getId() << "), " << m.inicial << " -> " << m.final
+                                  << " (" << std::showpos << m.crecimiento << ")\n";
+                            std::cout << linea.str();
+                        }
+                    } else {
+                        nombreOperacion = std::string("Promedio por año (") + nombreCampoHistorial(campoElegido) + ")";
+                        std::vector<double> promedios = historial->promedioPorAnio(campoElegido);
+                        std::ostringstream tabla;
+                        tabla << std::fixed << std::setprecision(0) << "\nPromedio de " << nombreCampoHistorial(campoElegido)
+                              << " por año:\n";
+                        for (int t = 0; t < historial->anios(); ++t) {
+                            tabla << "  " << historial->primerAnio() + t << std::setw(18) << promedios[t] << "\n";
+                        }
+                        std::cout << tabla.str();
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_historial = monitor.detener_tiempo();
+                long memoria_historial = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_historial << " ms, Memoria: " << memoria_historial << " KB\n";
+                monitor.registrar(nombreOperacion, tiempo_historial, memoria_historial);
+                break;
+            }
+
+            case 34: { // Calibración de fragmento, lote y prefetch
+                std::cout << "\nEn uso: ";
+                mostrarParametros(ajuste);
+                std::cout << "Presione 1 para calibrar de nuevo y guardar en " << rutaAjuste;
+                std::cout << "\nPresione 2 para volver\n";
+                int opcionAjuste;
+                std::cin >> opcionAjuste;
+                if (!std::cin) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Entrada inválida!\n";
+                    break;
+                }
+                if (opcionAjuste != 1) break;
+
+                monitor.iniciar_tiempo();
+                try {
+                    OperacionCancelable operacion;
+                    ReporteAjuste reporte = calibrarParametros(operacion.control("Calibrando"));
+                    mostrarReporteAjuste(reporte);
+                    ajuste = reporte.parametros;
+                    guardarParametros(ajuste, rutaAjuste);
+                    std::cout << "Guardado en " << rutaAjuste << "\n";
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+
+                double tiempo_ajuste = monitor.detener_tiempo();
+                long memoria_ajuste = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "Proceso terminado en " << tiempo_ajuste << " ms, Memoria: " << memoria_ajuste << " KB\n";
+                monitor.registrar("Calibrar parámetros", tiempo_ajuste, memoria_ajuste);
+                break;
+            }
+
+            case 35: { // Esquema de grupos de declaración
+                std::cout << "\nEsquema activo: " << esquemaGruposActivo()->nombre() << " ("
+                          << esquemaGruposActivo()->numeroGrupos() << " grupos por los últimos "
+                          << esquemaGruposActivo()->digitos() << " dígitos)\n";
+                std::cout << "Presione 1 para ver sus reglas";
+                std::cout << "\nPresione 2 para cargar un esquema desde un archivo";
+                std::cout << "\nPresione 3 para volver al esquema predeterminado\n";
+                int opcionEsquema;
+                std::cin >> opcionEsquema;
+                if (!std::cin || opcionEsquema < 1 || opcionEsquema > 3) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+                if (opcionEsquema == 1) {
+                    std::cout << "\n" << esquemaGruposActivo()->describir();
+                    break;
+                }
+
+                std::string rutaEsquema;
+                if (opcionEsquema == 2) {
+                    std::cout << "\nRuta del archivo (líneas nombre=, digitos= y GRUPO=desde-hasta,...): ";
+                    std::cin >> rutaEsquema;
+                }
+                monitor.iniciar_tiempo();
+                try {
+                    // Se compila completo antes de activarlo: un archivo inválido no cambia nada
+                    EsquemaGrupos nuevo = opcionEsquema == 2 ? EsquemaGrupos::desdeArchivo(rutaEsquema)
+                                                             : EsquemaGrupos::predeterminado();
+                    // Las filas no cambian, pero sí la verificación: el precálculo y la caché
+                    // de las opciones 10 y 11 responden por versión, así que se sube la versión
+                    precalculo.cancelar();
+                    activarEsquemaGrupos(std::move(nuevo));
+                    const bool resultadoVigente = versionResultado == versionDatos;
+                    const bool huellaVigente = versionHuella == versionDatos;
+                    versionDatos++;
+                    if (resultadoVigente) versionResultado = versionDatos; // Mismas filas en el mismo orden
+                    if (huellaVigente) versionHuella = versionDatos;
+                    if (modoPrecalculo && personas && !personas->empty()) precalculo.iniciar(*personas, versionDatos);
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << "\n";
+                    break;
+                }
+                double tiempo_esquema = monitor.detener_tiempo();
+                long memoria_esquema = monitor.obtener_memoria() - memoria_inicio;
+                std::cout << "\nEsquema activo: " << esquemaGruposActivo()->nombre() << " ("
+                          << esquemaGruposActivo()->listaGrupos() << ")\n";
+                if (personas && !personas->empty()) {
+                    std::cout << "Los datos actuales conservan sus grupos; las opciones 10 y 11 verifican cuáles cumplen las reglas nuevas.\n";
+                }
+                std::cout << "Proceso terminado en " << tiempo_esquema << " ms, Memoria: " << memoria_esquema << " KB\n";
+                monitor.registrar("Cargar esquema de grupos", tiempo_esquema, memoria_esquema);
+                break;
+            }
+
+            case 36: { // Índice de cédulas concurrente
+                if (!personas || personas->empty()) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+                std::cout << "\nÍndice de cédulas: ";
+                if (indiceCedulas) std::cout << "construido (" << indiceCedulas->bytes() / 1024 << " KB)\n";
+                else std::cout << "sin construir (datos cargados, activados o reagrupados)\n";
+                std::cout << "Presione 1 para construirlo con varios hilos sobre el conjunto actual";
+                std::cout << "\nPresione 2 para buscar una cédula (índice frente a búsqueda lineal)";
+                std::cout << "\nPresione 3 para medir el escalamiento por número de hilos\n";
+                int opcionIndice;
+                std::cin >> opcionIndice;
+                if (!std::cin || opcionIndice < 1 || opcionIndice > 3) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+
+                unsigned hilosIndice = 0;
+                if (opcionIndice == 1) {
+                    std::cout << "Hilos (0 = todos los del procesador, " << std::thread::hardware_concurrency() << "): ";
+                    if (!(std::cin >> hilosIndice)) {
+                        std::cin.clear();
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        std::cout << "Entrada inválida!\n";
+                        break;
+                    }
+                }
+                std::string cedulaIndice;
+                if (opcionIndice == 2) {
+                    std::cout << "Cédula a buscar: ";
+                    std::cin >> cedulaIndice;
+                }
+
+                if (opcionIndice == 3) {
+                    monitor.iniciar_tiempo();
+                    ReporteEscalamiento reporte;
+                    try {
+                        OperacionCancelable operacion;
+                        reporte = medirEscalamientoIndice(*personas, operacion.control("Midiendo", ajuste.tamFragmento));
+                    } catch (const std::exception& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        break;
+                    }
+                    double tiempo_escala = monitor.detener_tiempo();
+                    long memoria_escala = monitor.obtener_memoria() - memoria_inicio;
+                    mostrarEscalamientoIndice(reporte);
+                    std::cout << "Proceso terminado en " << tiempo_escala << " ms, Memoria: " << memoria_escala << " KB\n";
+                    monitor.registrar("Escalamiento del índice de cédulas", tiempo_escala, memoria_escala);
+                    break;
+                }
+
+                if (opcionIndice == 1 || !indiceCedulas) {
+                    monitor.iniciar_tiempo();
+                    try {
+                        OperacionCancelable operacion;
+                        indiceCedulas = construirIndiceCedulas(*personas, hilosIndice,
+                                                               operacion.control("Indexando", ajuste.tamFragmento));
+                    } catch (const std::exception& e) {
+                        std::cout << "\n" << e.what() << "\n";
+                        break;
+                    }
+                    double tiempo_indice = monitor.detener_tiempo();
+                    long memoria_indice = monitor.obtener_memoria() - memoria_inicio;
+                    std::cout << "\nÍndice construido en " << tiempo_indice << " ms (" << indiceCedulas->bytes() / 1024
+                              << " KB, " << indiceCedulas->repetidas() << " cédulas repetidas), Memoria: "
+                              << memoria_indice << " KB\n";
+                    monitor.registrar("Construir índice de cédulas", tiempo_indice, memoria_indice);
+                    memoria_inicio = monitor.obtener_memoria();
+                    if (opcionIndice == 1) break;
+                }
+
+                monitor.iniciar_tiempo();
+                long long filaIndice = indiceCedulas->buscar(cedulaIndice);
+                double tiempo_indice = monitor.detener_tiempo();
+                monitor.iniciar_tiempo();
+                const Persona* lineal = buscarPorID(*personas, cedulaIndice);
+                double tiempo_lineal = monitor.detener_tiempo();
+                long memoria_busqueda = monitor.obtener_memoria() - memoria_inicio;
+
+                if (filaIndice >= 0) (*personas)[filaIndice].mostrar();
+                else std::cout << "\nNo se encontró persona con ID " << cedulaIndice << "\n";
+                if ((filaIndice >= 0 ? &(*personas)[filaIndice] : nullptr) != lineal) {
+                    std::cout << "ADVERTENCIA: el índice y la búsqueda lineal no coinciden\n";
+                }
+                std::cout << "Índice: " << tiempo_indice << " ms, búsqueda lineal: " << tiempo_lineal << " ms\n";
+                std::cout << "Proceso terminado en " << tiempo_indice << " ms, Memoria: " << memoria_busqueda << " KB\n";
+                monitor.registrar("Buscar por ID con índice concurrente", tiempo_indice, memoria_busqueda);
+                monitor.registrar("Buscar por ID lineal", tiempo_lineal, memoria_busqueda);
+                break;
+            }
+
+            case 37: { // Importar/exportar con diccionarios de hash perfecto
+                std::cout << "\nPresione 1 para exportar el conjunto actual a CSV";
+                std::cout << "\nPresione 2 para exportarlo a binario codificado";
+                std::cout << "\nPresione 3 para importar un CSV (reemplaza el conjunto actual)";
+                std::cout << "\nPresione 4 para importar un binario codificado (reemplaza el conjunto actual)";
+                std::cout << "\nPresione 5 para medir la codificación de textos (hash perfecto, std::find, unordered_map)\n";
+                int opcionArchivo;
+                std::cin >> opcionArchivo;
+                if (!std::cin || opcionArchivo < 1 || opcionArchivo > 5) {
+                    std::cin.clear();
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Opción inválida!\n";
+                    break;
+                }
+                const bool importa = opcionArchivo == 3 || opcionArchivo == 4;
+                if (!importa && (!personas || personas->empty())) {
+                    std::cout << "\nNo hay datos disponibles. Use opción 0 primero.\n";
+                    break;
+                }
+
+                std::string rutaArchivo;
+                if (opcionArchivo != 5) {
+                    std::cout << "Ruta del archivo: ";
+                    std::cin >> rutaArchivo;
+                }
+
+                std::string nombreOperacion;
+                ResultadoImportacion importado;
+                std::vector<MedicionDiccionario> mediciones;
+                monitor.iniciar_tiempo();
+                try {
+                    OperacionCancelable operacion;
+                    ControlOperacion control = operacion.control("Procesando", ajuste.tamFragmento);
+                    switch (opcionArchivo) {
+                        case 1:
+                            nombreOperacion = "Exportar CSV";
+                            exportarCSV(*personas, rutaArchivo, control);
+                            break;
+                        case 2:
+                            nombreOperacion = "Exportar binario codificado";
+                            exportarBinario(*personas, rutaArchivo, control);
+                            break;
+                        case 3:
+                            nombreOperacion = "Importar CSV";
+                            importado = importarCSV(rutaArchivo, control);
+                            break;
+                        case 4:
+                            nombreOperacion = "Importar binario codificado";
+                            importado = importarBinario(rutaArchivo, control);
+                            break;
+                        default:
+                            nombreOperacion = "Medir diccionarios de hash perfecto";
+                            mediciones = medirDiccionarios(*personas, control);
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "\n" << e.what() << (importa ? ". Se conserva el conjunto anterior." : "") << "\n";
+                    break;
+                }
+
+                if (importa) {
+                    for (const auto& error : importado.errores) std::cout << "\n  Rechazada: " << error;
+                    if (importado.rechazadas > importado.errores.size()) {
+                        std::cout << "\n  ... y " << importado.rechazadas - importado.errores.size() << " más";
+                    }
+                    if (importado.personas.empty()) {
+                        std::cout << "\nNo se importó ninguna persona. Se conserva el conjunto anterior.\n";
+                        break;
+                    }
+                    reemplazarConjunto(importado.personas);
+                    indexarCedulas();
+                    std::cout << "\nImportadas " << personas->size() << " personas (" << importado.rechazadas
+                              << " filas rechazadas).\n";
+                }
+                double tiempo_archivo = monitor.detener_tiempo();
+                long memoria_archivo = monitor.obtener_memoria() - memoria_inicio;
+                if (opcionArchivo == 5) mostrarMedicionDiccionarios(mediciones, personas->size());
+                std::cout << "Proceso terminado en " << tiempo_archivo << " ms, Memoria: " << memoria_archivo << " KB\n";
+                monitor.registrar(nombreOperacion, tiempo_archivo, memoria_archivo);
+                break;
+            }
+
+            case 18: // Salir
+                std::cout << "Saliendo...\n";
+                break;
+                
+            default:
+                std::cout << "Opción inválida!\n";
+        }
+
+        // El primer registro de la opción es su tiempo (en 8 y 9, el del filtrado)
+        if (grabadora.activa() && opcion != 30) {
+            try {
+                if (monitor.cantidad_registros() > registrosAntes) {
+                    grabadora.terminarOperacion(monitor.operacion_registrada(registrosAntes), monitor.tiempo_registrado(registrosAntes));
+                } else {
+                    grabadora.terminarOperacion("", -1.0);
+                }
+            } catch (const std::exception& e) {
+                std::cout << "\n" << e.what() << ". Grabación detenida.\n";
+                grabadora.detener();
+            }
         }
         
     } while(opcion != 18);
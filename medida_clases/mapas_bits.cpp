@@ -0,0 +1,349 @@
+#include "mapas_bits.h"
+#include <algorithm>
+#include <iterator>
+
+// ----------------------------------------------------------------------------
+// Contenedores
+// ----------------------------------------------------------------------------
+
+bool MapaBitsRoaring::Contenedor::contiene(uint16_t bajo) const {
+    if (esMapa()) return (bits[bajo / 64] >> (bajo % 64)) & 1;
+    return std::binary_search(arreglo.begin(), arreglo.end(), bajo);
+}
+
+void MapaBitsRoaring::Contenedor::aMapa() {
+    bits.assign(PALABRAS_BLOQUE, 0);
+    for (uint16_t bajo : arreglo) bits[bajo / 64] |= 1ULL << (bajo % 64);
+    std::vector<uint16_t>().swap(arreglo);
+}
+
+void MapaBitsRoaring::Contenedor::aArreglo() {
+    std::vector<uint16_t> valores;
+    valores.reserve(cantidad);
+    for (size_t palabra = 0; palabra < bits.size(); ++palabra) {
+        for (uint64_t resto = bits[palabra]; resto; resto &= resto - 1) {
+            valores.push_back(static_cast<uint16_t>(palabra * 64 + __builtin_ctzll(resto)));
+        }
+    }
+    std::vector<uint64_t>().swap(bits);
+    arreglo.swap(valores);
+}
+
+MapaBitsRoaring::Contenedor MapaBitsRoaring::intersecarContenedores(const Contenedor& a, const Contenedor& b) {
+    Contenedor r;
+    r.clave = a.clave;
+    if (a.esMapa() && b.esMapa()) {
+        r.bits.resize(PALABRAS_BLOQUE);
+        for (size_t i = 0; i < PALABRAS_BLOQUE; ++i) {
+            r.bits[i] = a.bits[i] & b.bits[i];
+            r.cantidad += __builtin_popcountll(r.bits[i]);
+        }
+        if (r.cantidad <= LIMITE_ARREGLO) r.aArreglo();
+    } else if (a.esMapa() || b.esMapa()) {
+        const Contenedor& arreglo = a.esMapa() ? b : a;
+        const Contenedor& mapa = a.esMapa() ? a : b;
+        for (uint16_t bajo : arreglo.arreglo) {
+            if (mapa.contiene(bajo)) r.arreglo.push_back(bajo);
+        }
+        r.cantidad = static_cast<uint32_t>(r.arreglo.size());
+    } else {
+        std::set_intersection(a.arreglo.begin(), a.arreglo.end(), b.arreglo.begin(), b.arreglo.end(),
+                              std::back_inserter(r.arreglo));
+        r.cantidad = static_cast<uint32_t>(r.arreglo.size());
+    }
+    return r;
+}
+
+MapaBitsRoaring::Contenedor MapaBitsRoaring::unirContenedores(const Contenedor& a, const Contenedor& b) {
+    Contenedor r;
+    r.clave = a.clave;
+    if (!a.esMapa() && !b.esMapa()) {
+        std::set_union(a.arreglo.begin(), a.arreglo.end(), b.arreglo.begin(), b.arreglo.end(),
+                       std::back_inserter(r.arreglo));
+        r.cantidad = static_cast<uint32_t>(r.arreglo.size());
+        if (r.cantidad > LIMITE_ARREGLO) r.aMapa();
+        return r;
+    }
+    r.bits.assign(PALABRAS_BLOQUE, 0);
+    for (const Contenedor* c : {&a, &b}) {
+        if (c->esMapa()) {
+            for (size_t i = 0; i < PALABRAS_BLOQUE; ++i) r.bits[i] |= c->bits[i];
+        } else {
+            for (uint16_t bajo : c->arreglo) r.bits[bajo / 64] |= 1ULL << (bajo % 64);
+        }
+    }
+    for (uint64_t palabra : r.bits) r.cantidad += __builtin_popcountll(palabra);
+    return r;
+}
+
+uint64_t MapaBitsRoaring::contarInterseccion(const Contenedor& a, const Contenedor& b) {
+    uint64_t cantidad = 0;
+    if (a.esMapa() && b.esMapa()) {
+        for (size_t i = 0; i < PALABRAS_BLOQUE; ++i) cantidad += __builtin_popcountll(a.bits[i] & b.bits[i]);
+    } else if (a.esMapa() || b.esMapa()) {
+        const Contenedor& arreglo = a.esMapa() ? b : a;
+        const Contenedor& mapa = a.esMapa() ? a : b;
+        for (uint16_t bajo : arreglo.arreglo) cantidad += mapa.contiene(bajo);
+    } else {
+        // Mezcla de dos listas ordenadas sin escribir el resultado
+        auto i = a.arreglo.begin(), j = b.arreglo.begin();
+        while (i != a.arreglo.end() && j != b.arreglo.end()) {
+            if (*i < *j) ++i;
+            else if (*j < *i) ++j;
+            else { ++cantidad; ++i; ++j; }
+        }
+    }
+    return cantidad;
+}
+
+// ----------------------------------------------------------------------------
+// Mapa completo
+// ----------------------------------------------------------------------------
+
+void MapaBitsRoaring::agregar(uint32_t fila) {
+    const uint16_t clave = static_cast<uint16_t>(fila >> 16);
+    const uint16_t bajo = static_cast<uint16_t>(fila & 0xFFFF);
+    if (contenedores.empty() || contenedores.back().clave != clave) {
+        contenedores.emplace_back();
+        contenedores.back().clave = clave;
+    }
+    Contenedor& c = contenedores.back();
+    if (c.esMapa()) {
+        uint64_t mascara = 1ULL << (bajo % 64);
+        if (!(c.bits[bajo / 64] & mascara)) c.cantidad++;
+        c.bits[bajo / 64] |= mascara;
+        return;
+    }
+    if (!c.arreglo.empty() && c.arreglo.back() == bajo) return;
+    c.arreglo.push_back(bajo);
+    c.cantidad++;
+    if (c.cantidad > LIMITE_ARREGLO) c.aMapa();
+}
+
+bool MapaBitsRoaring::contiene(uint32_t fila) const {
+    const uint16_t clave = static_cast<uint16_t>(fila >> 16);
+    auto it = std::lower_bound(contenedores.begin(), contenedores.end(), clave,
+                               [](const Contenedor& c, uint16_t k) { return c.clave < k; });
+    return it != contenedores.end() && it->clave == clave && it->contiene(static_cast<uint16_t>(fila & 0xFFFF));
+}
+
+uint64_t MapaBitsRoaring::cardinalidad() const {
+    uint64_t total = 0;
+    for (const auto& c : contenedores) total += c.cantidad;
+    return total;
+}
+
+size_t MapaBitsRoaring::bytes() const {
+    size_t total = contenedores.capacity() * sizeof(Contenedor);
+    for (const auto& c : contenedores) {
+        total += c.arreglo.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+    }
+    return total;
+}
+
+MapaBitsRoaring MapaBitsRoaring::todas(uint32_t n) {
+    MapaBitsRoaring mapa;
+    for (uint32_t inicio = 0; inicio < n; inicio += 65536) {
+        Contenedor c;
+        c.clave = static_cast<uint16_t>(inicio >> 16);
+        c.cantidad = std::min<uint32_t>(65536, n - inicio);
+        c.bits.assign(PALABRAS_BLOQUE, 0);
+        for (uint32_t i = 0; i < c.cantidad; ++i) c.bits[i / 64] |= 1ULL << (i % 64);
+        if (c.cantidad <= LIMITE_ARREGLO) c.aArreglo();
+        mapa.contenedores.push_back(std::move(c));
+    }
+    return mapa;
+}
+
+MapaBitsRoaring MapaBitsRoaring::interseccion(const MapaBitsRoaring& a, const MapaBitsRoaring& b) {
+    MapaBitsRoaring r;
+    auto i = a.contenedores.begin(), j = b.contenedores.begin();
+    while (i != a.contenedores.end() && j != b.contenedores.end()) {
+        if (i->clave < j->clave) ++i;
+        else if (j->clave < i->clave) ++j;
+        else {
+            Contenedor c = intersecarContenedores(*i, *j);
+            if (c.cantidad) r.contenedores.push_back(std::move(c));
+            ++i;
+            ++j;
+        }
+    }
+    return r;
+}
+
+MapaBitsRoaring MapaBitsRoaring::unir(const MapaBitsRoaring& a, const MapaBitsRoaring& b) {
+    MapaBitsRoaring r;
+    auto i = a.contenedores.begin(), j = b.contenedores.begin();
+    while (i != a.contenedores.end() || j != b.contenedores.end()) {
+        if (j == b.contenedores.end() || (i != a.contenedores.end() && i->clave < j->clave)) {
+            r.contenedores.push_back(*i++);
+        } else if (i == a.contenedores.end() || j->clave < i->clave) {
+            r.contenedores.push_back(*j++);
+        } else {
+            r.contenedores.push_back(unirContenedores(*i++, *j++));
+        }
+    }
+    return r;
+}
+
+uint64_t MapaBitsRoaring::cardinalidadInterseccion(const MapaBitsRoaring& a, const MapaBitsRoaring& b) {
+    uint64_t total = 0;
+    auto i = a.contenedores.begin(), j = b.contenedores.begin();
+    while (i != a.contenedores.end() && j != b.contenedores.end()) {
+        if (i->clave < j->clave) ++i;
+        else if (j->clave < i->clave) ++j;
+        else total += contarInterseccion(*i++, *j++);
+    }
+    return total;
+}
+
+// ----------------------------------------------------------------------------
+// Índices por columna
+// ----------------------------------------------------------------------------
+
+/**
+ * Código de un valor; lo registra con su mapa vacío si es nuevo.
+ */
+static size_t codigoDe(const std::string& valor, std::unordered_map<std::string, size_t>& codigos,
+                       std::vector<std::string>& nombres, std::vector<MapaBitsRoaring>& mapas) {
+    auto it = codigos.find(valor);
+    if (it != codigos.end()) return it->second;
+    codigos.emplace(valor, nombres.size());
+    nombres.push_back(valor);
+    mapas.emplace_back();
+    return nombres.size() - 1;
+}
+
+IndicesMapaBits::IndicesMapaBits(const std::vector<Persona>& personas) : total(personas.size()) {
+    // Una sola pasada en orden de fila: cada agregar() es un push_back
+    for (uint32_t fila = 0; fila < personas.size(); ++fila) {
+        const Persona& p = personas[fila];
+        size_t ciudad = codigoDe(p.getCiudadNacimiento(), codigoCiudad, nombresCiudad, porCiudad);
+        size_t grupo = codigoDe(p.getGrupoDeclaracion(), codigoGrupo, nombresGrupo, porGrupo);
+        porCiudad[ciudad].agregar(fila);
+        porGrupo[grupo].agregar(fila);
+        (p.getDeclaranteRenta() ? declarantes : noDeclarantes).agregar(fila);
+    }
+    todasLasFilas = MapaBitsRoaring::todas(static_cast<uint32_t>(total));
+}
+
+MapaBitsRoaring IndicesMapaBits::unirValores(const std::vector<std::string>& valores,
+                                             const std::unordered_map<std::string, size_t>& codigos,
+                                             const std::vector<MapaBitsRoaring>& mapas) const {
+    MapaBitsRoaring resultado;
+    for (const auto& v : valores) {
+        auto it = codigos.find(v);
+        if (it != codigos.end()) resultado = MapaBitsRoaring::unir(resultado, mapas[it->second]);
+    }
+    return resultado;
+}
+
+/**
+ * Un mapa por campo filtrado; los de un solo valor se usan sin copiar.
+ */
+std::vector<const MapaBitsRoaring*> IndicesMapaBits::mapasDelFiltro(const FiltroCategorico& filtro,
+                                                                    std::vector<MapaBitsRoaring>& temporales) const {
+    static const MapaBitsRoaring vacio;
+    std::vector<const MapaBitsRoaring*> mapas;
+    temporales.reserve(2); // Los punteros a temporales deben seguir siendo válidos
+
+    auto agregarCampo = [&](const std::vector<std::string>& valores,
+                            const std::unordered_map<std::string, size_t>& codigos,
+                            const std::vector<MapaBitsRoaring>& porValor) {
+        if (valores.empty()) return;
+        if (valores.size() == 1) {
+            auto it = codigos.find(valores[0]);
+            mapas.push_back(it == codigos.end() ? &vacio : &porValor[it->second]);
+            return;
+        }
+        temporales.push_back(unirValores(valores, codigos, porValor));
+        mapas.push_back(&temporales.back());
+    };
+    agregarCampo(filtro.ciudades, codigoCiudad, porCiudad);
+    agregarCampo(filtro.grupos, codigoGrupo, porGrupo);
+    if (filtro.declarante >= 0) mapas.push_back(filtro.declarante ? &declarantes : &noDeclarantes);
+
+    // Primero los más selectivos: los AND intermedios quedan pequeños
+    std::sort(mapas.begin(), mapas.end(), [](const MapaBitsRoaring* a, const MapaBitsRoaring* b) {
+        return a->cardinalidad() < b->cardinalidad();
+    });
+    return mapas;
+}
+
+MapaBitsRoaring IndicesMapaBits::filtrar(const FiltroCategorico& filtro) const {
+    std::vector<MapaBitsRoaring> temporales;
+    std::vector<const MapaBitsRoaring*> mapas = mapasDelFiltro(filtro, temporales);
+    if (mapas.empty()) return todasLasFilas;
+    MapaBitsRoaring resultado = *mapas[0];
+    for (size_t i = 1; i < mapas.size(); ++i) resultado = MapaBitsRoaring::interseccion(resultado, *mapas[i]);
+    return resultado;
+}
+
+uint64_t IndicesMapaBits::contar(const FiltroCategorico& filtro) const {
+    std::vector<MapaBitsRoaring> temporales;
+    std::vector<const MapaBitsRoaring*> mapas = mapasDelFiltro(filtro, temporales);
+    if (mapas.empty()) return total;
+    if (mapas.size() == 1) return mapas[0]->cardinalidad();
+    if (mapas.size() == 2) return MapaBitsRoaring::cardinalidadInterseccion(*mapas[0], *mapas[1]);
+
+    // Sin copiar el primer mapa: el parcial ya nace de intersecar los dos más selectivos
+    MapaBitsRoaring parcial = MapaBitsRoaring::interseccion(*mapas[0], *mapas[1]);
+    for (size_t i = 2; i + 1 < mapas.size(); ++i) parcial = MapaBitsRoaring::interseccion(parcial, *mapas[i]);
+    return MapaBitsRoaring::cardinalidadInterseccion(parcial, *mapas.back());
+}
+
+ResumenFiltro IndicesMapaBits::resumir(const std::vector<Persona>& personas, const MapaBitsRoaring& filas,
+                                       size_t filasPorLote, size_t distanciaPrefetch) const {
+    ResumenFiltro r;
+    std::vector<uint32_t> lote;
+    lote.reserve(std::max<size_t>(1, filasPorLote));
+    auto procesarLote = [&]() {
+        for (size_t i = 0; i < lote.size(); ++i) {
+            if (distanciaPrefetch > 0 && i + distanciaPrefetch < lote.size()) {
+                // Los campos numéricos son los últimos de Persona: se pide esa línea
+                const char* adelantada = reinterpret_cast<const char*>(&personas[lote[i + distanciaPrefetch]]);
+                __builtin_prefetch(adelantada + sizeof(Persona) - 1);
+            }
+            const uint32_t fila = lote[i];
+            const Persona& p = personas[fila];
+            r.conteo++;
+            r.sumaPatrimonio += p.getPatrimonio();
+            r.sumaEdad += p.getEdad();
+            // Estricto: ante empates gana la primera fila, como std::max_element
+            if (r.filaMasPatrimonio < 0 || p.getPatrimonio() > personas[r.filaMasPatrimonio].getPatrimonio()) r.filaMasPatrimonio = fila;
+            if (r.filaMasLongevo < 0 || p.getEdad() > personas[r.filaMasLongevo].getEdad()) r.filaMasLongevo = fila;
+        }
+        lote.clear();
+    };
+    filas.paraCada([&](uint32_t fila) {
+        lote.push_back(fila);
+        if (lote.size() >= filasPorLote) procesarLote();
+    });
+    procesarLote();
+    return r;
+}
+
+size_t IndicesMapaBits::bytes() const {
+    size_t total = declarantes.bytes() + noDeclarantes.bytes();
+    for (const auto& m : porCiudad) total += m.bytes();
+    for (const auto& m : porGrupo) total += m.bytes();
+    return total;
+}
+
+ResumenFiltro resumirPorRecorrido(const std::vector<Persona>& personas, const FiltroCategorico& filtro) {
+    auto admite = [](const std::vector<std::string>& valores, const std::string& valor) {
+        return valores.empty() || std::find(valores.begin(), valores.end(), valor) != valores.end();
+    };
+    ResumenFiltro r;
+    for (size_t fila = 0; fila < personas.size(); ++fila) {
+        const Persona& p = personas[fila];
+        if (!admite(filtro.ciudades, p.getCiudadNacimiento()) || !admite(filtro.grupos, p.getGrupoDeclaracion())) continue;
+        if (filtro.declarante >= 0 && p.getDeclaranteRenta() != (filtro.declarante == 1)) continue;
+        r.conteo++;
+        r.sumaPatrimonio += p.getPatrimonio();
+        r.sumaEdad += p.getEdad();
+        if (r.filaMasPatrimonio < 0 || p.getPatrimonio() > personas[r.filaMasPatrimonio].getPatrimonio()) r.filaMasPatrimonio = static_cast<long long>(fila);
+        if (r.filaMasLongevo < 0 || p.getEdad() > personas[r.filaMasLongevo].getEdad()) r.filaMasLongevo = static_cast<long long>(fila);
+    }
+    return r;
+}
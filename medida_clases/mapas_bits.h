@@ -0,0 +1,157 @@
+#ifndef MAPAS_BITS_H
+#define MAPAS_BITS_H
+
+#include "persona.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// ÍNDICES DE MAPAS DE BITS COMPRIMIDOS (ESTILO ROARING)
+// ============================================================================
+// Ciudad, grupo y declarante tienen pocos valores distintos, así que cada
+// valor se indexa con un mapa de bits de las filas que lo tienen. Los mapas
+// se dividen en bloques de 2^16 filas; cada bloque se guarda como:
+//   - arreglo ordenado de uint16 si tiene hasta 4096 filas (2 bytes/fila),
+//   - mapa de bits de 8 KB si tiene más (1 bit/fila).
+// Un filtro combinado ("grupo B en Cali y declarante") se resuelve con AND/OR
+// bloque a bloque y popcount para contar; las agregaciones recorren solo los
+// bits encendidos.
+// ============================================================================
+
+/**
+ * Conjunto de filas comprimido por bloques de 65536.
+ *
+ * CONSTRUCCIÓN: agregar() espera filas en orden ascendente
+ */
+class MapaBitsRoaring {
+public:
+    void agregar(uint32_t fila);
+    bool contiene(uint32_t fila) const;
+    uint64_t cardinalidad() const;
+    size_t bytes() const;
+
+    /** Recorre las filas en orden ascendente. */
+    template <typename Funcion>
+    void paraCada(Funcion visitar) const {
+        for (const auto& c : contenedores) {
+            const uint32_t base = static_cast<uint32_t>(c.clave) << 16;
+            if (c.esMapa()) {
+                for (size_t palabra = 0; palabra < c.bits.size(); ++palabra) {
+                    for (uint64_t resto = c.bits[palabra]; resto; resto &= resto - 1) {
+                        visitar(base | static_cast<uint32_t>(palabra * 64 + __builtin_ctzll(resto)));
+                    }
+                }
+            } else {
+                for (uint16_t bajo : c.arreglo) visitar(base | bajo);
+            }
+        }
+    }
+
+    static MapaBitsRoaring interseccion(const MapaBitsRoaring& a, const MapaBitsRoaring& b);
+    static MapaBitsRoaring unir(const MapaBitsRoaring& a, const MapaBitsRoaring& b);
+
+    /** Tamaño de a AND b sin construir el resultado (solo popcount). */
+    static uint64_t cardinalidadInterseccion(const MapaBitsRoaring& a, const MapaBitsRoaring& b);
+
+    /** Mapa con todas las filas [0, n). */
+    static MapaBitsRoaring todas(uint32_t n);
+
+private:
+    static const size_t LIMITE_ARREGLO = 4096; // Por encima, el mapa de bits (8 KB) es más pequeño
+    static const size_t PALABRAS_BLOQUE = 1024; // 65536 bits
+
+    struct Contenedor {
+        uint16_t clave = 0;              // 16 bits altos de las filas
+        uint32_t cantidad = 0;
+        std::vector<uint16_t> arreglo;   // Si no es mapa
+        std::vector<uint64_t> bits;      // Si es mapa (PALABRAS_BLOQUE palabras)
+
+        bool esMapa() const { return !bits.empty(); }
+        bool contiene(uint16_t bajo) const;
+        void aMapa();
+        void aArreglo();
+    };
+
+    static Contenedor intersecarContenedores(const Contenedor& a, const Contenedor& b);
+    static Contenedor unirContenedores(const Contenedor& a, const Contenedor& b);
+    static uint64_t contarInterseccion(const Contenedor& a, const Contenedor& b);
+
+    std::vector<Contenedor> contenedores; // Ordenados por clave
+};
+
+/**
+ * Filtro categórico: OR entre los valores de un mismo campo, AND entre
+ * campos. Un campo vacío no filtra.
+ */
+struct FiltroCategorico {
+    std::vector<std::string> ciudades;
+    std::vector<std::string> grupos;
+    int declarante = -1; // -1 = cualquiera, 0 = no declarante, 1 = declarante
+};
+
+/**
+ * Agregados de las filas de un filtro, calculados en una sola pasada.
+ */
+struct ResumenFiltro {
+    uint64_t conteo = 0;
+    long long filaMasPatrimonio = -1; // -1 si no hay filas
+    long long filaMasLongevo = -1;
+    double sumaPatrimonio = 0.0;
+    double sumaEdad = 0.0;
+};
+
+/**
+ * Índices de mapas de bits por ciudad, grupo y declarante.
+ *
+ * ADVERTENCIA: Como el planificador, describen una colección concreta y
+ *              deben reconstruirse si esta se regenera o se modifica
+ */
+class IndicesMapaBits {
+public:
+    explicit IndicesMapaBits(const std::vector<Persona>& personas);
+
+    /** Filas que cumplen el filtro (AND/OR de los mapas de cada valor). */
+    MapaBitsRoaring filtrar(const FiltroCategorico& filtro) const;
+
+    /** Conteo por popcount; solo materializa si hay más de dos campos. */
+    uint64_t contar(const FiltroCategorico& filtro) const;
+
+    /**
+     * Conteo, sumas y argmax recorriendo solo los bits encendidos.
+     *
+     * IMPLEMENTACIÓN: Saca hasta filasPorLote filas del mapa y luego las lee;
+     *                 con distanciaPrefetch > 0 pide la Persona de la fila
+     *                 que va esa cantidad de posiciones adelante en el lote
+     *                 (valores calibrados en autoajuste.h)
+     */
+    ResumenFiltro resumir(const std::vector<Persona>& personas, const MapaBitsRoaring& filas,
+                          size_t filasPorLote = 1024, size_t distanciaPrefetch = 0) const;
+
+    size_t bytes() const;
+    size_t filas() const { return total; }
+    const std::vector<std::string>& ciudades() const { return nombresCiudad; }
+    const std::vector<std::string>& grupos() const { return nombresGrupo; }
+
+private:
+    MapaBitsRoaring unirValores(const std::vector<std::string>& valores,
+                                const std::unordered_map<std::string, size_t>& codigos,
+                                const std::vector<MapaBitsRoaring>& mapas) const;
+    std::vector<const MapaBitsRoaring*> mapasDelFiltro(const FiltroCategorico& filtro,
+                                                       std::vector<MapaBitsRoaring>& temporales) const;
+
+    size_t total;
+    std::vector<std::string> nombresCiudad, nombresGrupo;
+    std::unordered_map<std::string, size_t> codigoCiudad, codigoGrupo;
+    std::vector<MapaBitsRoaring> porCiudad, porGrupo;
+    MapaBitsRoaring declarantes, noDeclarantes;
+    MapaBitsRoaring todasLasFilas;
+};
+
+/**
+ * Resultado de referencia con un recorrido completo (para comparar).
+ */
+ResumenFiltro resumirPorRecorrido(const std::vector<Persona>& personas, const FiltroCategorico& filtro);
+
+#endif // MAPAS_BITS_H
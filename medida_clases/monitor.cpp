@@ -56,6 +56,25 @@ long Monitor::obtener_memoria() {
     return resident * page_size_kb;
 }
 
+/**
+ * Obtiene la memoria disponible del sistema en KB.
+ * 
+ * POR QUÉ: Decidir antes de generar si un conjunto cabe en RAM.
+ * CÓMO: Leyendo MemAvailable de /proc/meminfo (Linux); incluye la caché
+ *       de páginas que el kernel puede liberar.
+ * PARA QUÉ: Rechazar o desviar a disco las generaciones que no caben.
+ * @return KB disponibles, o 0 si no se pudo leer
+ */
+long Monitor::obtener_memoria_disponible() {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string linea;
+    long valor;
+    while (std::getline(meminfo, linea)) {
+        if (sscanf(linea.c_str(), "MemAvailable: %ld kB", &valor) == 1) return valor;
+    }
+    return 0;
+}
+
 /**
  * Registra una operación con sus métricas de tiempo y memoria.
  * 
@@ -71,6 +90,60 @@ void Monitor::registrar(const std::string& operacion, double tiempo, long memori
     }
 }
 
+/**
+ * Registra cuántos bloques leyó y cuántos descartó una consulta con mapas de zonas.
+ * 
+ * POR QUÉ: El tiempo por sí solo no explica cuánto trabajo se evitó.
+ * CÓMO: Guardando un RegistroSaltos en el historial.
+ * PARA QUÉ: Mostrar la tasa de salto de cada consulta en el resumen.
+ */
+void Monitor::registrar_saltos(const std::string& operacion, size_t bloques_leidos, size_t bloques_saltados) {
+    saltos.push_back({operacion, bloques_leidos, bloques_saltados});
+}
+
+/**
+ * Cuenta un acierto de la caché de resultados.
+ * 
+ * POR QUÉ: Saber qué fracción de consultas se evita recalcular.
+ * CÓMO: Incrementando el contador de aciertos.
+ * PARA QUÉ: Mostrar la tasa de aciertos en el resumen.
+ */
+void Monitor::registrar_acierto_cache() {
+    aciertos_cache++;
+}
+
+/**
+ * Cuenta un fallo de la caché de resultados (la consulta se calculó).
+ */
+void Monitor::registrar_fallo_cache() {
+    fallos_cache++;
+}
+
+/**
+ * Número de operaciones registradas hasta ahora.
+ * 
+ * POR QUÉ: La grabación de sesiones necesita saber qué registró cada opción del menú.
+ * CÓMO: Tamaño del historial; los registros nuevos quedan a partir de ese índice.
+ * PARA QUÉ: Asociar a cada opción grabada su nombre y su tiempo.
+ */
+size_t Monitor::cantidad_registros() const {
+    return registros.size();
+}
+
+/**
+ * Nombre de la operación del registro i (0 <= i < cantidad_registros()).
+ */
+const std::string& Monitor::operacion_registrada(size_t i) const {
+    return registros.at(i).operacion;
+}
+
+/**
+ * Tiempo en milisegundos del registro i (0 <= i < cantidad_registros()).
+ */
+double Monitor::tiempo_registrado(size_t i) const {
+    return registros.at(i).tiempo;
+}
+
 /**
  * Muestra las estadísticas de una operación.
  * 
@@ -99,6 +172,22 @@ void Monitor::mostrar_resumen() {
     }
     std::cout << "\nTotal tiempo: " << total_tiempo << " ms";
     std::cout << "\nMemoria máxima: " << max_memoria << " KB\n";
+    
+    long consultas_cache = aciertos_cache + fallos_cache;
+    if (consultas_cache > 0) {
+        std::cout << "Caché de resultados: " << aciertos_cache << " aciertos, " << fallos_cache << " fallos ("
+                  << aciertos_cache * 100.0 / consultas_cache << "% de aciertos)\n";
+    }
+    
+    if (!saltos.empty()) {
+        std::cout << "\n=== SALTOS DE BLOQUES (MAPAS DE ZONAS) ===";
+        for (const auto& reg : saltos) {
+            size_t total = reg.leidos + reg.saltados;
+            std::cout << "\n" << reg.operacion << ": " << reg.saltados << "/" << total
+                      << " bloques saltados (" << (total ? reg.saltados * 100.0 / total : 0.0) << "%)";
+        }
+        std::cout << "\n";
+    }
 }
 
 /**
@@ -19,8 +19,15 @@ public:
     void iniciar_tiempo();
     double detener_tiempo();
     long obtener_memoria();
+    long obtener_memoria_disponible();
     
     void registrar(const std::string& operacion, double tiempo, long memoria);
+    void registrar_saltos(const std::string& operacion, size_t bloques_leidos, size_t bloques_saltados);
+    void registrar_acierto_cache();
+    void registrar_fallo_cache();
+    size_t cantidad_registros() const;
+    const std::string& operacion_registrada(size_t i) const;
+    double tiempo_registrado(size_t i) const;
     void mostrar_estadistica(const std::string& operacion, double tiempo, long memoria);
     void mostrar_resumen();
     void exportar_csv(const std::string& nombre_archivo = "estadisticas.csv");
@@ -33,10 +40,20 @@ private:
         long memoria;          // Memoria en KB
     };
     
+    // Estructura para almacenar bloques leídos/saltados por mapas de zonas
+    struct RegistroSaltos {
+        std::string operacion; // Nombre de la operación
+        size_t leidos;         // Bloques leídos
+        size_t saltados;       // Bloques descartados sin leer
+    };
+    
     std::chrono::high_resolution_clock::time_point inicio; // Punto de inicio del cronómetro
     std::vector<Registro> registros; // Historial de registros
+    std::vector<RegistroSaltos> saltos; // Historial de saltos de bloques
     double total_tiempo = 0;         // Tiempo total acumulado
     long max_memoria = 0;            // Máximo de memoria utilizado
+    long aciertos_cache = 0;         // Consultas servidas desde la caché
+    long fallos_cache = 0;           // Consultas que hubo que calcular
 };
 
 #endif // MONITOR_H
\ No newline at end of file
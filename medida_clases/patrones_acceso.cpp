@@ -0,0 +1,171 @@
+#include "patrones_acceso.h"
+#include "persona.h"
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+// Accesos mínimos por medición: los tamaños pequeños repiten el recorrido
+// hasta sumar suficientes elementos como para que el reloj no domine
+static const size_t ACCESOS_POR_MEDICION = 4 * 1024 * 1024;
+static const size_t NUM_PATRONES = 6;
+
+const char* nombrePatron(PatronAcceso patron) {
+    switch (patron) {
+        case PatronAcceso::CONTIGUO: return "Contiguo";
+        case PatronAcceso::PUNTEROS: return "Punteros";
+        case PatronAcceso::INDICES32: return "Índices32";
+        case PatronAcceso::PUNTEROS_ALEATORIOS: return "Punt. aleat.";
+        case PatronAcceso::INDICES32_ALEATORIOS: return "Índ. aleat.";
+        case PatronAcceso::CADENA_DEPENDIENTE: return "Cadena dep.";
+    }
+    return "";
+}
+
+std::vector<size_t> tamanosConjuntoTrabajo(const std::vector<NivelCache>& caches, size_t maximoBytes) {
+    std::vector<size_t> tamanos;
+    for (const auto& c : caches) {
+        tamanos.push_back(c.bytes / 2);
+        tamanos.push_back(c.bytes * 2);
+    }
+    // Sin información de sysfs se recorre de 16 KB en adelante
+    size_t siguiente = caches.empty() ? 16 * 1024 : caches.back().bytes * 4;
+    for (; siguiente <= maximoBytes; siguiente *= 2) tamanos.push_back(siguiente);
+
+    std::sort(tamanos.begin(), tamanos.end());
+    tamanos.erase(std::unique(tamanos.begin(), tamanos.end()), tamanos.end());
+    tamanos.erase(std::remove_if(tamanos.begin(), tamanos.end(),
+                                 [&](size_t t) { return t > maximoBytes || t < sizeof(Persona); }),
+                  tamanos.end());
+    return tamanos;
+}
+
+static std::string nivelDondeCabe(size_t bytes, const std::vector<NivelCache>& caches) {
+    for (const auto& c : caches) {
+        if (bytes <= c.bytes) return "L" + std::to_string(c.nivel);
+    }
+    return "RAM";
+}
+
+/**
+ * Mide un tamaño: registros contiguos más los vectores de punteros e
+ * índices que usarían las variantes "PorReferencia" y las selecciones.
+ */
+static PuntoPatrones medirTamano(const BancoPruebas& banco, size_t bytes, std::mt19937& generador) {
+    const size_t n = bytes / sizeof(Persona);
+    const Persona plantilla("Ana", "Gomez", "1000000000", "Bogota", "1/1/1980", "A", 45, 1e8, 5e8, 1e8, true);
+    std::vector<Persona> registros(n, plantilla);
+
+    std::vector<uint32_t> filas(n);
+    std::iota(filas.begin(), filas.end(), 0u);
+    std::vector<const Persona*> punteros(n);
+    for (size_t i = 0; i < n; ++i) punteros[i] = &registros[i];
+
+    std::vector<uint32_t> filasAleatorias = filas;
+    std::shuffle(filasAleatorias.begin(), filasAleatorias.end(), generador);
+    std::vector<const Persona*> punterosAleatorios(n);
+    for (size_t i = 0; i < n; ++i) punterosAleatorios[i] = &registros[filasAleatorias[i]];
+
+    // Un solo ciclo que pasa por todas las filas en orden aleatorio
+    std::vector<uint32_t> siguiente(n);
+    for (size_t i = 0; i < n; ++i) siguiente[filasAleatorias[i]] = filasAleatorias[(i + 1) % n];
+
+    const size_t pasadas = std::max<size_t>(1, ACCESOS_POR_MEDICION / n);
+    volatile double sumidero = 0.0;
+
+    auto porIndices = [&](const std::vector<uint32_t>& orden) {
+        double suma = 0.0;
+        for (size_t p = 0; p < pasadas; ++p) {
+            for (uint32_t fila : orden) suma += registros[fila].getPatrimonio();
+        }
+        sumidero = suma;
+    };
+    auto porPunteros = [&](const std::vector<const Persona*>& orden) {
+        double suma = 0.0;
+        for (size_t p = 0; p < pasadas; ++p) {
+            for (const Persona* persona : orden) suma += persona->getPatrimonio();
+        }
+        sumidero = suma;
+    };
+
+    std::vector<VarianteBanco> variantes(NUM_PATRONES);
+    variantes[0] = {nombrePatron(PatronAcceso::CONTIGUO), [&] {
+        double suma = 0.0;
+        for (size_t p = 0; p < pasadas; ++p) {
+            for (const auto& persona : registros) suma += persona.getPatrimonio();
+        }
+        sumidero = suma;
+    }};
+    variantes[1] = {nombrePatron(PatronAcceso::PUNTEROS), [&] { porPunteros(punteros); }};
+    variantes[2] = {nombrePatron(PatronAcceso::INDICES32), [&] { porIndices(filas); }};
+    variantes[3] = {nombrePatron(PatronAcceso::PUNTEROS_ALEATORIOS), [&] { porPunteros(punterosAleatorios); }};
+    variantes[4] = {nombrePatron(PatronAcceso::INDICES32_ALEATORIOS), [&] { porIndices(filasAleatorias); }};
+    variantes[5] = {nombrePatron(PatronAcceso::CADENA_DEPENDIENTE), [&] {
+        double suma = 0.0;
+        uint32_t fila = 0;
+        for (size_t k = 0; k < pasadas * n; ++k) {
+            suma += registros[fila].getPatrimonio();
+            fila = siguiente[fila];
+        }
+        sumidero = suma;
+    }};
+
+    PuntoPatrones punto;
+    punto.bytes = n * sizeof(Persona);
+    punto.elementos = n;
+    for (const auto& r : banco.ejecutar(variantes)) {
+        punto.nsPorElemento.push_back(r.mediana * 1e6 / static_cast<double>(pasadas * n));
+        punto.coeficienteVariacion.push_back(r.coeficienteVariacion);
+    }
+    return punto;
+}
+
+MapaPatrones medirPatronesAcceso(const ConfiguracionBanco& configuracion, size_t maximoBytes) {
+    if (maximoBytes < sizeof(Persona)) {
+        throw std::invalid_argument("El conjunto de trabajo máximo debe ser de al menos un registro");
+    }
+    ConfiguracionBanco config = configuracion;
+    config.cache = ModoCache::PRECALENTAR; // Se mide el estado estable de cada tamaño
+    BancoPruebas banco(config);
+
+    MapaPatrones mapa;
+    mapa.caches = cachesDelNucleo(banco.nucleo());
+    std::mt19937 generador(12345); // Semilla fija: mismos órdenes en cada ejecución
+    for (size_t bytes : tamanosConjuntoTrabajo(mapa.caches, maximoBytes)) {
+        PuntoPatrones punto = medirTamano(banco, bytes, generador);
+        punto.nivel = nivelDondeCabe(punto.bytes, mapa.caches);
+        mapa.puntos.push_back(std::move(punto));
+    }
+    return mapa;
+}
+
+void mostrarMapaPatrones(const MapaPatrones& mapa, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+
+    salida << "\n=== MAPA DE PATRONES DE ACCESO (ns por elemento, mediana) ===\n";
+    salida << "Cachés detectadas:";
+    if (mapa.caches.empty()) salida << " (sysfs no disponible)";
+    for (const auto& c : mapa.caches) salida << " L" << c.nivel << "=" << c.bytes / 1024 << " KB";
+    salida << "\nRegistro Persona: " << sizeof(Persona) << " bytes\n\n";
+
+    salida << std::right << std::setw(12) << "KB" << std::setw(6) << "Nivel";
+    for (size_t p = 0; p < NUM_PATRONES; ++p) salida << std::setw(14) << nombrePatron(static_cast<PatronAcceso>(p));
+    salida << "\n" << std::fixed << std::setprecision(2);
+    for (const auto& punto : mapa.puntos) {
+        salida << std::setw(12) << punto.bytes / 1024 << std::setw(6) << punto.nivel;
+        bool ruidoso = false;
+        for (size_t p = 0; p < punto.nsPorElemento.size(); ++p) {
+            salida << std::setw(14) << punto.nsPorElemento[p];
+            ruidoso = ruidoso || punto.coeficienteVariacion[p] > 5.0;
+        }
+        salida << (ruidoso ? "  (CV > 5%)" : "") << "\n";
+    }
+    salida << "Punteros/Índices32 = resultados de filtrado en orden de fila; "
+              "aleatorios = tras ordenar por otra clave.\n";
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
@@ -0,0 +1,69 @@
+#ifndef PATRONES_ACCESO_H
+#define PATRONES_ACCESO_H
+
+#include "banco_pruebas.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// MAPA DE PATRONES DE ACCESO POR TAMAÑO DE CONJUNTO DE TRABAJO
+// ============================================================================
+// Las funciones "PorReferencia" filtran a números de fila (SeleccionFilas o
+// ConjuntoFilas, 4 bytes por fila) y luego recorren esas filas: un recorrido
+// secuencial se vuelve indirecto. Antes filtraban a vector<const Persona*>;
+// este módulo mide, con registros Persona reales, lo que cuesta cada forma:
+//   - recorrido contiguo del vector,
+//   - recorrido por punteros (en orden y desordenados),
+//   - recorrido por índices de fila de 32 bits (en orden y desordenados),
+//   - cadena dependiente (cada carga decide la siguiente),
+// para conjuntos de trabajo desde L1 hasta más allá de la caché de último
+// nivel, usando los tamaños de caché detectados en sysfs.
+// ============================================================================
+
+enum class PatronAcceso {
+    CONTIGUO,
+    PUNTEROS,
+    INDICES32,
+    PUNTEROS_ALEATORIOS,
+    INDICES32_ALEATORIOS,
+    CADENA_DEPENDIENTE
+};
+
+const char* nombrePatron(PatronAcceso patron);
+
+/**
+ * Resultado de un tamaño de conjunto de trabajo.
+ */
+struct PuntoPatrones {
+    size_t bytes = 0;           // Bytes de registros Persona recorridos
+    size_t elementos = 0;
+    std::string nivel;          // Nivel de caché donde cabe ("L1", "L2", "L3", "RAM")
+    std::vector<double> nsPorElemento; // Mediana, en el orden de PatronAcceso
+    std::vector<double> coeficienteVariacion;
+};
+
+struct MapaPatrones {
+    std::vector<NivelCache> caches;
+    std::vector<PuntoPatrones> puntos;
+};
+
+/**
+ * Tamaños a medir: la mitad y el doble de cada nivel de caché, más
+ * tamaños mayores hasta maximoBytes (duplicando).
+ */
+std::vector<size_t> tamanosConjuntoTrabajo(const std::vector<NivelCache>& caches, size_t maximoBytes);
+
+/**
+ * Mide todos los patrones para cada tamaño con el banco de pruebas
+ * (núcleo fijo, variantes intercaladas, cachés precalentadas).
+ *
+ * @param maximoBytes Tamaño máximo del conjunto de trabajo
+ * @throws std::invalid_argument si maximoBytes es menor que un registro
+ */
+MapaPatrones medirPatronesAcceso(const ConfiguracionBanco& configuracion, size_t maximoBytes);
+
+void mostrarMapaPatrones(const MapaPatrones& mapa, std::ostream& salida);
+
+#endif // PATRONES_ACCESO_H
@@ -39,12 +39,15 @@ public:
             double patri, double deud, bool declara);
     
     // Métodos de acceso (getters) - Implementados inline para eficiencia
-    std::string getNombre() const { return nombre; }
-    std::string getApellido() const { return apellido; }
-    std::string getId() const { return id; }
-    std::string getCiudadNacimiento() const { return ciudadNacimiento; }
-    std::string getFechaNacimiento() const { return fechaNacimiento; }
-    std::string getGrupoDeclaracion() const { return grupoDeclaracion; }
+    // Los textos se devuelven por referencia constante: comparar o leer un campo
+    // no copia el string. La referencia vale mientras viva la persona; quien
+    // necesite conservar el valor debe copiarlo explícitamente.
+    const std::string& getNombre() const { return nombre; }
+    const std::string& getApellido() const { return apellido; }
+    const std::string& getId() const { return id; }
+    const std::string& getCiudadNacimiento() const { return ciudadNacimiento; }
+    const std::string& getFechaNacimiento() const { return fechaNacimiento; }
+    const std::string& getGrupoDeclaracion() const { return grupoDeclaracion; }
     int getEdad() const { return edad; }
     double getIngresosAnuales() const { return ingresosAnuales; }
     double getPatrimonio() const { return patrimonio; }
@@ -0,0 +1,388 @@
+#include "planificador.h"
+#include <algorithm> // std::sort, std::lower_bound, std::set_intersection
+#include <chrono>    // Medición de tiempo en EXPLAIN ANALYZE
+#include <cmath>     // std::log2
+#include <cstdlib>   // std::strtoull
+#include <iostream>
+#include <iomanip>
+#include <stdexcept> // std::invalid_argument
+#include <unordered_map>
+
+// ========================================================================
+// MODELO DE COSTOS
+// ========================================================================
+// Unidades abstractas aproximadas al costo de tocar una fila en memoria.
+// Leer una entrada de una lista de filas es secuencial y compacto (4 bytes),
+// mientras que ir a buscar una Persona arbitraria para evaluar un predicado
+// residual implica un acceso aleatorio y comparaciones de strings.
+
+static const double COSTO_FILA_SECUENCIAL = 1.0;  // Evaluar una fila en un escaneo
+static const double COSTO_ENTRADA_LISTA = 0.25;   // Leer un uint32 de una lista
+static const double COSTO_FILA_ALEATORIA = 4.0;   // Visitar una fila fuera de orden
+
+static const size_t CUBETAS_HISTOGRAMA = 32;
+
+// ========================================================================
+// HISTOGRAMA
+// ========================================================================
+
+/**
+ * Construye el histograma de ancho fijo.
+ *
+ * @param valores Valores de la columna
+ * @param numCubetas Número de cubetas
+ */
+void Histograma::construir(const std::vector<double>& valores, size_t numCubetas) {
+    cubetas.assign(numCubetas, 0);
+    total = valores.size();
+    if (valores.empty()) return;
+
+    auto extremos = std::minmax_element(valores.begin(), valores.end());
+    minimo = *extremos.first;
+    maximo = *extremos.second;
+    double ancho = (maximo - minimo) / numCubetas;
+
+    for (double v : valores) {
+        size_t c = ancho > 0 ? static_cast<size_t>((v - minimo) / ancho) : 0;
+        if (c >= numCubetas) c = numCubetas - 1; // El máximo cae en la última cubeta
+        cubetas[c]++;
+    }
+}
+
+/**
+ * Estima la fracción de filas con valor en [desde, hasta].
+ *
+ * IMPLEMENTACIÓN: Suma las cubetas cubiertas por completo y una fracción
+ * proporcional de las cubetas cubiertas parcialmente.
+ */
+double Histograma::fraccionEnRango(double desde, double hasta) const {
+    if (total == 0 || hasta < desde) return 0.0;
+    if (maximo == minimo) return (desde <= minimo && minimo <= hasta) ? 1.0 : 0.0;
+
+    double ancho = (maximo - minimo) / cubetas.size();
+    double filas = 0.0;
+    for (size_t c = 0; c < cubetas.size(); ++c) {
+        double ini = minimo + c * ancho;
+        double fin = ini + ancho;
+        double solapeIni = std::max(ini, desde);
+        double solapeFin = std::min(fin, hasta + 1.0); // Columnas enteras: rango inclusivo
+        if (solapeFin <= solapeIni) continue;
+        filas += cubetas[c] * std::min(1.0, (solapeFin - solapeIni) / ancho);
+    }
+    return std::min(1.0, filas / total);
+}
+
+// ========================================================================
+// ÍNDICES
+// ========================================================================
+
+int IndicesColeccion::codigoCiudad(const std::string& ciudad) const {
+    auto it = std::find(ciudades.begin(), ciudades.end(), ciudad);
+    return it == ciudades.end() ? -1 : static_cast<int>(it - ciudades.begin());
+}
+
+int IndicesColeccion::codigoGrupo(const std::string& grupo) const {
+    auto it = std::find(grupos.begin(), grupos.end(), grupo);
+    return it == grupos.end() ? -1 : static_cast<int>(it - grupos.begin());
+}
+
+/**
+ * Construye listas de filas en formato CSR a partir del código de cada fila.
+ *
+ * CÓMO: Conteo por código, suma prefija para los offsets y una segunda
+ *       pasada que coloca cada fila; las listas quedan ordenadas por fila.
+ */
+static void construirCSR(const std::vector<uint32_t>& codigos, size_t numCodigos,
+                         std::vector<uint32_t>& inicio, std::vector<uint32_t>& filas) {
+    inicio.assign(numCodigos + 1, 0);
+    for (uint32_t c : codigos) inicio[c + 1]++;
+    for (size_t c = 0; c < numCodigos; ++c) inicio[c + 1] += inicio[c];
+
+    filas.resize(codigos.size());
+    std::vector<uint32_t> siguiente(inicio.begin(), inicio.end() - 1);
+    for (uint32_t fila = 0; fila < codigos.size(); ++fila) {
+        filas[siguiente[codigos[fila]]++] = fila;
+    }
+}
+
+/**
+ * Asigna códigos densos a los valores de una columna de texto.
+ */
+static std::vector<uint32_t> codificar(const std::vector<Persona>& personas,
+                                       const std::string& (Persona::*campo)() const,
+                                       std::vector<std::string>& diccionario) {
+    std::unordered_map<std::string, uint32_t> codigos;
+    std::vector<uint32_t> resultado;
+    resultado.reserve(personas.size());
+    for (const auto& p : personas) {
+        const std::string& valor = (p.*campo)();
+        auto it = codigos.find(valor);
+        if (it == codigos.end()) {
+            it = codigos.emplace(valor, static_cast<uint32_t>(diccionario.size())).first;
+            diccionario.push_back(valor);
+        }
+        resultado.push_back(it->second);
+    }
+    return resultado;
+}
+
+// ========================================================================
+// PLANIFICADOR
+// ========================================================================
+
+/**
+ * Construye índices y estadísticas en una sola carga.
+ *
+ * COMPLEJIDAD: O(n log n) por los ordenamientos de cédulas y edades
+ */
+Planificador::Planificador(const std::vector<Persona>& personas) : personas(personas) {
+    const uint32_t n = static_cast<uint32_t>(personas.size());
+
+    // Índice de cédulas ordenado para búsqueda binaria
+    idx.idOrdenado.reserve(n);
+    for (uint32_t fila = 0; fila < n; ++fila) {
+        idx.idOrdenado.push_back({std::strtoull(personas[fila].getId().c_str(), nullptr, 10), fila});
+    }
+    std::sort(idx.idOrdenado.begin(), idx.idOrdenado.end(),
+        [](const IndicesColeccion::EntradaID& a, const IndicesColeccion::EntradaID& b) { return a.id < b.id; });
+
+    // Listas de filas por ciudad y por grupo
+    auto codigosCiudad = codificar(personas, &Persona::getCiudadNacimiento, idx.ciudades);
+    construirCSR(codigosCiudad, idx.ciudades.size(), idx.inicioCiudad, idx.filasCiudad);
+    auto codigosGrupo = codificar(personas, &Persona::getGrupoDeclaracion, idx.grupos);
+    construirCSR(codigosGrupo, idx.grupos.size(), idx.inicioGrupo, idx.filasGrupo);
+
+    // Índice ordenado por edad (estable para conservar el orden de filas)
+    idx.ordenEdad.resize(n);
+    for (uint32_t fila = 0; fila < n; ++fila) idx.ordenEdad[fila] = fila;
+    std::stable_sort(idx.ordenEdad.begin(), idx.ordenEdad.end(),
+        [&personas](uint32_t a, uint32_t b) { return personas[a].getEdad() < personas[b].getEdad(); });
+    idx.edadesOrdenadas.reserve(n);
+    for (uint32_t fila : idx.ordenEdad) idx.edadesOrdenadas.push_back(personas[fila].getEdad());
+    construirHistograma();
+}
+
+Planificador::Planificador(const std::vector<Persona>& personas, IndicesColeccion indices)
+    : personas(personas), idx(std::move(indices)) {
+    const size_t n = personas.size();
+    if (idx.idOrdenado.size() != n || idx.ordenEdad.size() != n || idx.edadesOrdenadas.size() != n ||
+        idx.filasCiudad.size() != n || idx.filasGrupo.size() != n) {
+        throw std::invalid_argument("Los índices no corresponden a la colección");
+    }
+
+    // Todas las filas deben existir y los offsets cerrar en n
+    auto filasValidas = [n](const std::vector<uint32_t>& filas) {
+        return std::all_of(filas.begin(), filas.end(), [n](uint32_t f) { return f < n; });
+    };
+    bool idsValidos = std::all_of(idx.idOrdenado.begin(), idx.idOrdenado.end(),
+        [n](const IndicesColeccion::EntradaID& e) { return e.fila < n; });
+    if (!idsValidos || !filasValidas(idx.filasCiudad) || !filasValidas(idx.filasGrupo) || !filasValidas(idx.ordenEdad) ||
+        idx.inicioCiudad.size() != idx.ciudades.size() + 1 || idx.inicioCiudad.back() != n ||
+        idx.inicioGrupo.size() != idx.grupos.size() + 1 || idx.inicioGrupo.back() != n) {
+        throw std::invalid_argument("Los índices no corresponden a la colección");
+    }
+    construirHistograma();
+}
+
+void Planificador::construirHistograma() {
+    std::vector<double> edades(idx.edadesOrdenadas.begin(), idx.edadesOrdenadas.end());
+    histogramaEdad.construir(edades, CUBETAS_HISTOGRAMA);
+}
+
+double Planificador::selectividadEdad(const Consulta& consulta) const {
+    if (consulta.edadMin < 0 && consulta.edadMax < 0) return 1.0;
+    double desde = consulta.edadMin < 0 ? histogramaEdad.minimo : consulta.edadMin;
+    double hasta = consulta.edadMax < 0 ? histogramaEdad.maximo : consulta.edadMax;
+    return histogramaEdad.fraccionEnRango(desde, hasta);
+}
+
+/**
+ * Evalúa todos los predicados de la consulta sobre una fila.
+ */
+bool Planificador::cumple(uint32_t fila, const Consulta& consulta) const {
+    const Persona& p = personas[fila];
+    if (!consulta.id.empty() && p.getId() != consulta.id) return false;
+    if (!consulta.ciudad.empty() && p.getCiudadNacimiento() != consulta.ciudad) return false;
+    if (!consulta.grupo.empty() && p.getGrupoDeclaracion() != consulta.grupo) return false;
+    if (consulta.edadMin >= 0 && p.getEdad() < consulta.edadMin) return false;
+    if (consulta.edadMax >= 0 && p.getEdad() > consulta.edadMax) return false;
+    return true;
+}
+
+/**
+ * Enumera los planes aplicables con su costo y cardinalidad estimados.
+ *
+ * SUPUESTO: Independencia entre columnas, por lo que la selectividad de la
+ * conjunción es el producto de las selectividades individuales.
+ */
+std::vector<Plan> Planificador::planesCandidatos(const Consulta& consulta) const {
+    const double n = static_cast<double>(personas.size());
+    const double log2n = n > 1 ? std::log2(n) : 1.0;
+
+    // Selectividades y tamaños de listas a partir de las cardinalidades exactas
+    double largoCiudad = n, largoGrupo = n;
+    if (!consulta.ciudad.empty()) {
+        int c = idx.codigoCiudad(consulta.ciudad);
+        largoCiudad = c < 0 ? 0 : idx.inicioCiudad[c + 1] - idx.inicioCiudad[c];
+    }
+    if (!consulta.grupo.empty()) {
+        int g = idx.codigoGrupo(consulta.grupo);
+        largoGrupo = g < 0 ? 0 : idx.inicioGrupo[g + 1] - idx.inicioGrupo[g];
+    }
+    double selCiudad = n > 0 ? largoCiudad / n : 0.0;
+    double selGrupo = n > 0 ? largoGrupo / n : 0.0;
+    double selEdad = selectividadEdad(consulta);
+    double selId = consulta.id.empty() ? 1.0 : (n > 0 ? 1.0 / n : 0.0);
+    double filasEstimadas = n * selCiudad * selGrupo * selEdad * selId;
+
+    bool filtraEdad = consulta.edadMin >= 0 || consulta.edadMax >= 0;
+    std::vector<Plan> planes;
+
+    planes.push_back({TipoPlan::ESCANEO_COMPLETO, n * COSTO_FILA_SECUENCIAL, filasEstimadas});
+
+    if (!consulta.id.empty()) {
+        planes.push_back({TipoPlan::BUSQUEDA_ID, (log2n + 1.0) * COSTO_FILA_ALEATORIA, filasEstimadas});
+    }
+
+    if (!consulta.ciudad.empty() || !consulta.grupo.empty()) {
+        double leidas = (consulta.ciudad.empty() ? 0 : largoCiudad) + (consulta.grupo.empty() ? 0 : largoGrupo);
+        double candidatos = n * selCiudad * selGrupo;
+        bool residual = filtraEdad || !consulta.id.empty();
+        double costo = leidas * COSTO_ENTRADA_LISTA + (residual ? candidatos * COSTO_FILA_ALEATORIA : 0.0);
+        planes.push_back({TipoPlan::INTERSECCION_LISTAS, costo, filasEstimadas});
+    }
+
+    if (filtraEdad) {
+        double enRango = n * selEdad;
+        bool residual = !consulta.ciudad.empty() || !consulta.grupo.empty() || !consulta.id.empty();
+        double costo = log2n + enRango * (COSTO_ENTRADA_LISTA + (residual ? COSTO_FILA_ALEATORIA : 0.0));
+        planes.push_back({TipoPlan::RANGO_EDAD, costo, filasEstimadas});
+    }
+
+    std::sort(planes.begin(), planes.end(),
+        [](const Plan& a, const Plan& b) { return a.costoEstimado < b.costoEstimado; });
+    return planes;
+}
+
+Plan Planificador::planificar(const Consulta& consulta) const {
+    return planesCandidatos(consulta).front();
+}
+
+/**
+ * Ejecuta el plan indicado.
+ *
+ * @return Filas que cumplen todos los predicados, en orden ascendente
+ */
+std::vector<uint32_t> Planificador::ejecutar(const Plan& plan, const Consulta& consulta) const {
+    std::vector<uint32_t> resultado;
+
+    switch (plan.tipo) {
+        case TipoPlan::BUSQUEDA_ID: {
+            uint64_t id = std::strtoull(consulta.id.c_str(), nullptr, 10);
+            auto it = std::lower_bound(idx.idOrdenado.begin(), idx.idOrdenado.end(), id,
+                [](const IndicesColeccion::EntradaID& e, uint64_t valor) { return e.id < valor; });
+            for (; it != idx.idOrdenado.end() && it->id == id; ++it) {
+                if (cumple(it->fila, consulta)) resultado.push_back(it->fila);
+            }
+            break;
+        }
+
+        case TipoPlan::ESCANEO_COMPLETO: {
+            for (uint32_t fila = 0; fila < personas.size(); ++fila) {
+                if (cumple(fila, consulta)) resultado.push_back(fila);
+            }
+            break;
+        }
+
+        case TipoPlan::INTERSECCION_LISTAS: {
+            int c = consulta.ciudad.empty() ? -2 : idx.codigoCiudad(consulta.ciudad);
+            int g = consulta.grupo.empty() ? -2 : idx.codigoGrupo(consulta.grupo);
+            if (c == -1 || g == -1) break; // Valor inexistente: resultado vacío
+
+            std::vector<uint32_t> candidatos;
+            if (c >= 0 && g >= 0) {
+                std::set_intersection(idx.filasCiudad.begin() + idx.inicioCiudad[c],
+                                      idx.filasCiudad.begin() + idx.inicioCiudad[c + 1],
+                                      idx.filasGrupo.begin() + idx.inicioGrupo[g],
+                                      idx.filasGrupo.begin() + idx.inicioGrupo[g + 1],
+                                      std::back_inserter(candidatos));
+            } else if (c >= 0) {
+                candidatos.assign(idx.filasCiudad.begin() + idx.inicioCiudad[c],
+                                  idx.filasCiudad.begin() + idx.inicioCiudad[c + 1]);
+            } else {
+                candidatos.assign(idx.filasGrupo.begin() + idx.inicioGrupo[g],
+                                  idx.filasGrupo.begin() + idx.inicioGrupo[g + 1]);
+            }
+
+            bool residual = consulta.edadMin >= 0 || consulta.edadMax >= 0 || !consulta.id.empty();
+            if (!residual) {
+                resultado.swap(candidatos);
+            } else {
+                for (uint32_t fila : candidatos) {
+                    if (cumple(fila, consulta)) resultado.push_back(fila);
+                }
+            }
+            break;
+        }
+
+        case TipoPlan::RANGO_EDAD: {
+            int desde = consulta.edadMin < 0 ? 0 : consulta.edadMin;
+            auto it = std::lower_bound(idx.edadesOrdenadas.begin(), idx.edadesOrdenadas.end(), desde);
+            for (size_t i = it - idx.edadesOrdenadas.begin(); i < idx.edadesOrdenadas.size(); ++i) {
+                if (consulta.edadMax >= 0 && idx.edadesOrdenadas[i] > consulta.edadMax) break;
+                if (cumple(idx.ordenEdad[i], consulta)) resultado.push_back(idx.ordenEdad[i]);
+            }
+            std::sort(resultado.begin(), resultado.end()); // Mismo orden que los demás planes
+            break;
+        }
+    }
+
+    return resultado;
+}
+
+/**
+ * Muestra el plan elegido y los candidatos descartados (EXPLAIN).
+ *
+ * SALIDA: Costos y filas estimadas de cada candidato; con analizar=true
+ *         además filas reales y tiempo de ejecución del plan elegido.
+ */
+std::vector<uint32_t> Planificador::explicar(const Consulta& consulta, bool analizar) const {
+    std::vector<Plan> planes = planesCandidatos(consulta);
+    const Plan& elegido = planes.front();
+
+    std::ios::fmtflags formatoOriginal = std::cout.flags();
+    std::streamsize precisionOriginal = std::cout.precision();
+
+    std::cout << "\n=== EXPLAIN" << (analizar ? " ANALYZE" : "") << " ===\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& plan : planes) {
+        std::cout << (&plan == &elegido ? " -> " : "    ")
+                  << std::left << std::setw(22) << nombrePlan(plan.tipo) << std::right
+                  << " costo=" << plan.costoEstimado
+                  << " filas_est=" << plan.filasEstimadas << "\n";
+    }
+
+    std::vector<uint32_t> resultado;
+    if (analizar) {
+        auto inicio = std::chrono::high_resolution_clock::now();
+        resultado = ejecutar(elegido, consulta);
+        std::chrono::duration<double, std::milli> duracion = std::chrono::high_resolution_clock::now() - inicio;
+        std::cout << "Plan elegido: " << nombrePlan(elegido.tipo)
+                  << " | Filas estimadas: " << elegido.filasEstimadas
+                  << " | Filas reales: " << resultado.size()
+                  << " | Tiempo: " << duracion.count() << " ms\n";
+    }
+    std::cout.flags(formatoOriginal);
+    std::cout.precision(precisionOriginal);
+    return resultado;
+}
+
+const char* nombrePlan(TipoPlan tipo) {
+    switch (tipo) {
+        case TipoPlan::BUSQUEDA_ID:         return "BUSQUEDA_ID";
+        case TipoPlan::ESCANEO_COMPLETO:    return "ESCANEO_COMPLETO";
+        case TipoPlan::INTERSECCION_LISTAS: return "INTERSECCION_LISTAS";
+        case TipoPlan::RANGO_EDAD:          return "RANGO_EDAD";
+    }
+    return "DESCONOCIDO";
+}
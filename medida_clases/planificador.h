@@ -0,0 +1,159 @@
+#ifndef PLANIFICADOR_H
+#define PLANIFICADOR_H
+
+#include "persona.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// PLANIFICADOR DE CONSULTAS BASADO EN COSTOS
+// ============================================================================
+// Este módulo mantiene índices (ID, ciudad, grupo y edad) y estadísticas por
+// columna sobre una colección de personas, y elige para cada consulta el
+// camino de acceso más barato: escaneo completo, intersección de listas de
+// filas o recorrido de un rango del índice de edad.
+// ============================================================================
+
+/**
+ * Consulta conjuntiva sobre la colección.
+ *
+ * PROPÓSITO: Describir los predicados de una búsqueda de forma independiente
+ *            del camino de acceso que se use para resolverla
+ * CONVENCIÓN: Un string vacío o un límite negativo significa "sin filtro"
+ */
+struct Consulta {
+    std::string id;      // Cédula exacta (vacío = cualquiera)
+    std::string ciudad;  // Ciudad de nacimiento (vacío = cualquiera)
+    std::string grupo;   // Grupo de declaración (vacío = cualquiera)
+    int edadMin = -1;    // Edad mínima inclusiva (-1 = sin límite)
+    int edadMax = -1;    // Edad máxima inclusiva (-1 = sin límite)
+};
+
+/**
+ * Caminos de acceso que el planificador sabe ejecutar.
+ */
+enum class TipoPlan {
+    BUSQUEDA_ID,         // Búsqueda binaria en el índice de cédulas
+    ESCANEO_COMPLETO,    // Recorrido secuencial de todas las filas
+    INTERSECCION_LISTAS, // Intersección de listas de filas por ciudad/grupo
+    RANGO_EDAD           // Recorrido del índice ordenado por edad
+};
+
+/**
+ * Plan elegido para una consulta junto con sus estimaciones.
+ */
+struct Plan {
+    TipoPlan tipo;
+    double costoEstimado;     // Costo en unidades abstractas (≈ filas tocadas)
+    double filasEstimadas;    // Cardinalidad estimada del resultado
+};
+
+/**
+ * Histograma de ancho fijo sobre una columna numérica.
+ *
+ * PROPÓSITO: Estimar la selectividad de predicados de rango
+ * IMPLEMENTACIÓN: Cubetas de igual ancho con interpolación uniforme dentro
+ *                 de cada cubeta
+ */
+struct Histograma {
+    double minimo = 0.0;
+    double maximo = 0.0;
+    std::vector<size_t> cubetas;
+    size_t total = 0;
+
+    void construir(const std::vector<double>& valores, size_t numCubetas);
+    double fraccionEnRango(double desde, double hasta) const;
+};
+
+/**
+ * Índices de la colección en formato CSR (offsets + filas).
+ *
+ * PROPÓSITO: Acceso rápido por ID, ciudad, grupo y rango de edad
+ * DISEÑO: Solo vectores planos de enteros y offsets, sin punteros, de modo
+ *         que puedan copiarse o serializarse tal cual
+ */
+struct IndicesColeccion {
+    struct EntradaID {
+        uint64_t id;   // Cédula numérica
+        uint32_t fila; // Posición en el vector de personas
+    };
+
+    std::vector<EntradaID> idOrdenado;      // Ordenado por cédula
+
+    std::vector<std::string> ciudades;      // Código -> nombre de ciudad
+    std::vector<uint32_t> inicioCiudad;     // Offsets (tamaño ciudades + 1)
+    std::vector<uint32_t> filasCiudad;      // Filas agrupadas por ciudad
+
+    std::vector<std::string> grupos;        // Código -> nombre de grupo
+    std::vector<uint32_t> inicioGrupo;      // Offsets (tamaño grupos + 1)
+    std::vector<uint32_t> filasGrupo;       // Filas agrupadas por grupo
+
+    std::vector<uint32_t> ordenEdad;        // Filas ordenadas por edad
+    std::vector<int> edadesOrdenadas;       // Edad de cada entrada de ordenEdad
+
+    int codigoCiudad(const std::string& ciudad) const;
+    int codigoGrupo(const std::string& grupo) const;
+};
+
+/**
+ * Planificador de consultas con estadísticas por columna.
+ *
+ * PROPÓSITO: Escoger automáticamente el camino de acceso más barato
+ * IMPLEMENTACIÓN: Estima la selectividad de cada predicado (suponiendo
+ *                 independencia entre columnas), calcula el costo de cada
+ *                 plan candidato y ejecuta el de menor costo
+ * ADVERTENCIA: Guarda una referencia a la colección; debe reconstruirse si
+ *              la colección se regenera o se modifica
+ */
+class Planificador {
+public:
+    explicit Planificador(const std::vector<Persona>& personas);
+
+    /**
+     * Usa índices ya construidos (p. ej. cargados de disco); solo recalcula
+     * el histograma de edades, que es O(n) sobre edadesOrdenadas.
+     *
+     * @throws std::invalid_argument si los índices no cubren todas las filas
+     */
+    Planificador(const std::vector<Persona>& personas, IndicesColeccion indices);
+
+    /**
+     * Calcula todos los planes aplicables a la consulta, del más barato al
+     * más caro.
+     */
+    std::vector<Plan> planesCandidatos(const Consulta& consulta) const;
+
+    /**
+     * Devuelve el plan de menor costo estimado.
+     */
+    Plan planificar(const Consulta& consulta) const;
+
+    /**
+     * Ejecuta un plan y devuelve las filas que cumplen la consulta.
+     */
+    std::vector<uint32_t> ejecutar(const Plan& plan, const Consulta& consulta) const;
+
+    /**
+     * Muestra el plan elegido al estilo EXPLAIN. Si analizar es true, además
+     * lo ejecuta y muestra filas reales y tiempo (EXPLAIN ANALYZE).
+     *
+     * @return Filas resultantes (vacío si analizar es false)
+     */
+    std::vector<uint32_t> explicar(const Consulta& consulta, bool analizar) const;
+
+    const IndicesColeccion& indices() const { return idx; }
+
+private:
+    void construirHistograma();
+    bool cumple(uint32_t fila, const Consulta& consulta) const;
+    double selectividadEdad(const Consulta& consulta) const;
+
+    const std::vector<Persona>& personas;
+    IndicesColeccion idx;
+    Histograma histogramaEdad;
+};
+
+const char* nombrePlan(TipoPlan tipo);
+
+#endif // PLANIFICADOR_H
@@ -0,0 +1,263 @@
+#include "precalculo.h"
+#include "generador.h"  // verificarGrupoPorReferencia
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+// Mínimo de filas por hilo para que valga la pena repartir el trabajo
+static const size_t MIN_FILAS_POR_HILO = 4096;
+
+/**
+ * Resultados parciales de un tramo contiguo de filas.
+ */
+struct ParcialPrecalculo {
+    long filaMasLongevo = -1;
+    long filaMasPatrimonio = -1;
+    std::vector<EstadisticaGrupo> grupos; // Orden del esquema; los desconocidos, al final por aparición
+    std::map<std::string, EstadisticaCiudad> ciudades;
+    size_t correctos = 0;
+    size_t incorrectos = 0;
+};
+
+/**
+ * Se queda con la fila candidata solo si su valor es estrictamente mayor.
+ *
+ * NOTA: Los tramos se recorren y combinan en orden de fila, así que ante
+ * un empate se conserva la primera, como std::max_element.
+ */
+template <typename Valor>
+static void conservarMayor(long& actual, long candidata, const std::vector<Persona>& personas, Valor valor) {
+    if (candidata < 0) return;
+    if (actual < 0 || valor(personas[actual]) < valor(personas[candidata])) actual = candidata;
+}
+
+static double edadDe(const Persona& p) { return p.getEdad(); }
+static double patrimonioDe(const Persona& p) { return p.getPatrimonio(); }
+
+/**
+ * Un casillero por grupo del esquema, en su orden de códigos.
+ *
+ * NOTA: Mismo orden en que los imprime AcumuladorGrupos (generador.cpp), así
+ * la respuesta precalculada y la calculada coinciden también en los empates
+ */
+static std::vector<EstadisticaGrupo> casillerosDelEsquema(const EsquemaGrupos& esquema) {
+    std::vector<EstadisticaGrupo> grupos(esquema.numeroGrupos());
+    for (size_t g = 0; g < grupos.size(); ++g) grupos[g].grupo = esquema.nombreGrupo(g);
+    return grupos;
+}
+
+/**
+ * Casillero del grupo; uno fuera del esquema (datos de otro esquema) se agrega al final.
+ */
+static EstadisticaGrupo& casilleroGrupo(std::vector<EstadisticaGrupo>& grupos, const std::string& nombre) {
+    for (auto& g : grupos) {
+        if (g.grupo == nombre) return g;
+    }
+    grupos.emplace_back();
+    grupos.back().grupo = nombre;
+    return grupos.back();
+}
+
+/**
+ * Recorre una sola vez las filas [inicio, fin) calculando todo a la vez.
+ */
+static ParcialPrecalculo procesarTramo(const std::vector<Persona>& personas, size_t inicio, size_t fin,
+                                       const EsquemaGrupos& esquema, const ControlOperacion& control) {
+    ParcialPrecalculo parcial;
+    parcial.grupos = casillerosDelEsquema(esquema);
+    for (size_t desde = inicio; desde < fin; desde += control.tamFragmento) {
+        control.avanzar(desde - inicio, fin - inicio);
+        size_t hasta = std::min(fin, desde + control.tamFragmento);
+        for (size_t i = desde; i < hasta; ++i) {
+            const Persona& p = personas[i];
+            long fila = static_cast<long>(i);
+            conservarMayor(parcial.filaMasLongevo, fila, personas, edadDe);
+            conservarMayor(parcial.filaMasPatrimonio, fila, personas, patrimonioDe);
+
+            EstadisticaGrupo& grupo = casilleroGrupo(parcial.grupos, p.getGrupoDeclaracion());
+            grupo.conteo++;
+            grupo.sumaPatrimonio += p.getPatrimonio();
+            grupo.sumaEdad += p.getEdad();
+            conservarMayor(grupo.filaMasPatrimonio, fila, personas, patrimonioDe);
+
+            EstadisticaCiudad& ciudad = parcial.ciudades[p.getCiudadNacimiento()];
+            conservarMayor(ciudad.filaMasLongevo, fila, personas, edadDe);
+            conservarMayor(ciudad.filaMasPatrimonio, fila, personas, patrimonioDe);
+
+            if (verificarGrupoPorReferencia(p, esquema)) parcial.correctos++;
+            else parcial.incorrectos++;
+        }
+    }
+    return parcial;
+}
+
+RespuestasPrecalculadas precalcularRespuestas(const std::vector<Persona>& personas, unsigned hilos,
+                                              const TokenCancelacion* token) {
+    if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+    size_t maxHilos = std::max<size_t>(1, personas.size() / MIN_FILAS_POR_HILO);
+    hilos = static_cast<unsigned>(std::min<size_t>(hilos, maxHilos));
+
+    ControlOperacion control;
+    control.token = token;
+    // Todos los tramos verifican con el mismo esquema aunque se active otro a mitad de camino
+    const std::shared_ptr<const EsquemaGrupos> esquema = esquemaGruposActivo();
+
+    // Un tramo contiguo por hilo
+    std::vector<std::future<ParcialPrecalculo>> tramos;
+    size_t porHilo = (personas.size() + hilos - 1) / hilos;
+    for (unsigned h = 0; h < hilos; ++h) {
+        size_t inicio = std::min(personas.size(), h * porHilo);
+        size_t fin = std::min(personas.size(), inicio + porHilo);
+        tramos.push_back(std::async(std::launch::async, procesarTramo, std::cref(personas), inicio, fin,
+                                    std::cref(*esquema), control));
+    }
+
+    // Combinar en orden de tramo (necesario para el criterio de empates)
+    ParcialPrecalculo total;
+    total.grupos = casillerosDelEsquema(*esquema);
+    for (auto& tramo : tramos) {
+        ParcialPrecalculo parcial = tramo.get();
+        conservarMayor(total.filaMasLongevo, parcial.filaMasLongevo, personas, edadDe);
+        conservarMayor(total.filaMasPatrimonio, parcial.filaMasPatrimonio, personas, patrimonioDe);
+        for (const auto& g : parcial.grupos) {
+            EstadisticaGrupo& grupo = casilleroGrupo(total.grupos, g.grupo);
+            grupo.conteo += g.conteo;
+            grupo.sumaPatrimonio += g.sumaPatrimonio;
+            grupo.sumaEdad += g.sumaEdad;
+            conservarMayor(grupo.filaMasPatrimonio, g.filaMasPatrimonio, personas, patrimonioDe);
+        }
+        for (const auto& c : parcial.ciudades) {
+            EstadisticaCiudad& ciudad = total.ciudades[c.first];
+            conservarMayor(ciudad.filaMasLongevo, c.second.filaMasLongevo, personas, edadDe);
+            conservarMayor(ciudad.filaMasPatrimonio, c.second.filaMasPatrimonio, personas, patrimonioDe);
+        }
+        total.correctos += parcial.correctos;
+        total.incorrectos += parcial.incorrectos;
+    }
+
+    RespuestasPrecalculadas respuestas;
+    respuestas.filaMasLongevo = total.filaMasLongevo;
+    respuestas.filaMasPatrimonio = total.filaMasPatrimonio;
+    respuestas.grupos = std::move(total.grupos);
+    for (auto& c : total.ciudades) {
+        c.second.ciudad = c.first;
+        respuestas.ciudades.push_back(c.second);
+    }
+    respuestas.correctos = total.correctos;
+    respuestas.incorrectos = total.incorrectos;
+    return respuestas;
+}
+
+/**
+ * Imprime los promedios por grupo y el grupo ganador, como
+ * encontrarGrupoMayor{Patrimonio,Longevidad}Por{Valor,Referencia}.
+ */
+static void mostrarGrupoMayor(const RespuestasPrecalculadas& respuestas, bool porPatrimonio,
+                              const std::string& variante) {
+    std::string grupoMayor;
+    double mayorPromedio = 0.0;
+    for (const auto& g : respuestas.grupos) {
+        if (g.conteo == 0) continue;
+        double promedio = (porPatrimonio ? g.sumaPatrimonio : g.sumaEdad) / g.conteo;
+        std::cout << "Grupo " << g.grupo << (porPatrimonio ? " - Promedio Patrimonio: " : " - Promedio Edad: ")
+                  << promedio << std::endl;
+        if (promedio > mayorPromedio) {
+            mayorPromedio = promedio;
+            grupoMayor = g.grupo;
+        }
+    }
+    std::cout << "\nGrupo con mayor " << (porPatrimonio ? "patrimonio" : "longevidad")
+              << " en promedio por " << variante << ": " << grupoMayor << "\n";
+}
+
+bool responderPrecalculado(const RespuestasPrecalculadas& respuestas, const std::vector<Persona>& personas,
+                           PreguntaPrecalculada pregunta, const std::string& parametro) {
+    long fila = -1;
+    switch (pregunta) {
+        case PreguntaPrecalculada::MAS_LONGEVO:
+            fila = respuestas.filaMasLongevo;
+            break;
+        case PreguntaPrecalculada::MAS_PATRIMONIO:
+            fila = respuestas.filaMasPatrimonio;
+            break;
+        case PreguntaPrecalculada::MAS_LONGEVO_CIUDAD:
+        case PreguntaPrecalculada::MAS_PATRIMONIO_CIUDAD:
+            for (const auto& c : respuestas.ciudades) {
+                if (c.ciudad != parametro) continue;
+                fila = pregunta == PreguntaPrecalculada::MAS_LONGEVO_CIUDAD ? c.filaMasLongevo : c.filaMasPatrimonio;
+            }
+            break;
+        case PreguntaPrecalculada::MAS_PATRIMONIO_GRUPO:
+            for (const auto& g : respuestas.grupos) {
+                if (g.grupo == parametro) fila = g.filaMasPatrimonio;
+            }
+            break;
+        case PreguntaPrecalculada::VERIFICACION: {
+            std::string titulo = parametro;
+            std::transform(titulo.begin(), titulo.end(), titulo.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            size_t verificadas = respuestas.correctos + respuestas.incorrectos;
+            std::cout << "\n=== VERIFICACIÓN MASIVA POR " << titulo << " ===" << std::endl;
+            std::cout << "\n--- RESUMEN VERIFICACIÓN MASIVA ---" << std::endl;
+            std::cout << "Total personas verificadas: " << verificadas << std::endl;
+            std::cout << "Correctos: " << respuestas.correctos << std::endl;
+            std::cout << "Incorrectos: " << respuestas.incorrectos << std::endl;
+            std::cout << "Porcentaje de acierto: " << (respuestas.correctos * 100.0 / verificadas) << "%" << std::endl;
+            std::cout << "======================================" << std::endl;
+            return true;
+        }
+        case PreguntaPrecalculada::GRUPO_MAYOR_PATRIMONIO:
+            mostrarGrupoMayor(respuestas, true, parametro);
+            return true;
+        case PreguntaPrecalculada::GRUPO_MAYOR_LONGEVIDAD:
+            mostrarGrupoMayor(respuestas, false, parametro);
+            return true;
+    }
+
+    if (fila < 0 || static_cast<size_t>(fila) >= personas.size()) return false;
+    personas[fila].mostrar();
+    return true;
+}
+
+PrecalculoEnSegundoPlano::~PrecalculoEnSegundoPlano() {
+    cancelar();
+}
+
+void PrecalculoEnSegundoPlano::iniciar(const std::vector<Persona>& personas, unsigned long version) {
+    cancelar();
+    token = std::make_unique<TokenCancelacion>();
+    const TokenCancelacion* t = token.get();
+    const std::vector<Persona>* datos = &personas;
+    futuro = std::async(std::launch::async, [datos, version, t] {
+        RespuestasPrecalculadas respuestas = precalcularRespuestas(*datos, 0, t);
+        respuestas.version = version;
+        return respuestas;
+    });
+}
+
+const RespuestasPrecalculadas* PrecalculoEnSegundoPlano::listas(unsigned long version) {
+    if (futuro.valid() && futuro.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        try {
+            resultado = std::make_unique<RespuestasPrecalculadas>(futuro.get());
+        } catch (const std::exception&) {
+            resultado.reset(); // Si falló, el menú calcula bajo demanda
+        }
+    }
+    if (resultado && resultado->version == version) return resultado.get();
+    return nullptr;
+}
+
+void PrecalculoEnSegundoPlano::cancelar() {
+    if (futuro.valid()) {
+        token->cancelar();
+        try {
+            futuro.get(); // Espera a que el hilo deje de leer la colección
+        } catch (const std::exception&) {
+        }
+    }
+    resultado.reset();
+}
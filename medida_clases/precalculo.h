@@ -0,0 +1,120 @@
+#ifndef PRECALCULO_H
+#define PRECALCULO_H
+
+#include "persona.h"
+#include "cancelacion.h"
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// PRECÁLCULO EN SEGUNDO PLANO DE LAS RESPUESTAS DEL MENÚ
+// ============================================================================
+// Justo después de generar datos, un hilo de fondo recorre la colección una
+// sola vez (en paralelo por tramos) y calcula todas las respuestas de las
+// opciones 4 a 15: más longevo y más rico (global, por ciudad y por grupo),
+// promedios por grupo y verificación de grupos. El menú las sirve al
+// instante cuando están listas y, si no, calcula como siempre.
+// ============================================================================
+
+/**
+ * Estadísticas de un grupo de declaración.
+ */
+struct EstadisticaGrupo {
+    std::string grupo;
+    size_t conteo = 0;
+    double sumaPatrimonio = 0.0;
+    double sumaEdad = 0.0;
+    long filaMasPatrimonio = -1;
+};
+
+/**
+ * Máximos de una ciudad.
+ */
+struct EstadisticaCiudad {
+    std::string ciudad;
+    long filaMasLongevo = -1;
+    long filaMasPatrimonio = -1;
+};
+
+/**
+ * Todas las respuestas precalculadas para una versión del conjunto.
+ *
+ * EMPATES: Igual que std::max_element, gana la primera fila con el máximo
+ */
+struct RespuestasPrecalculadas {
+    unsigned long version = 0;
+    long filaMasLongevo = -1;
+    long filaMasPatrimonio = -1;
+    std::vector<EstadisticaGrupo> grupos;   // En el orden del esquema (como el cálculo bajo demanda)
+    std::vector<EstadisticaCiudad> ciudades;
+    size_t correctos = 0;
+    size_t incorrectos = 0;
+};
+
+/**
+ * Preguntas del menú que pueden responderse con el precálculo.
+ */
+enum class PreguntaPrecalculada {
+    MAS_LONGEVO,            // Opciones 4 y 5 (país)
+    MAS_LONGEVO_CIUDAD,     // Opciones 4 y 5 (ciudad)
+    MAS_PATRIMONIO,         // Opciones 6 y 7 (país)
+    MAS_PATRIMONIO_CIUDAD,  // Opciones 6 y 7 (ciudad)
+    MAS_PATRIMONIO_GRUPO,   // Opciones 6 y 7 (grupo)
+    VERIFICACION,           // Opciones 10 y 11
+    GRUPO_MAYOR_PATRIMONIO, // Opciones 12 y 13
+    GRUPO_MAYOR_LONGEVIDAD  // Opciones 14 y 15
+};
+
+/**
+ * Calcula todas las respuestas en una pasada fusionada y paralela.
+ *
+ * @param personas Colección a analizar
+ * @param hilos Número de hilos (0 = los que ofrezca el hardware)
+ * @param token Token de cancelación (puede ser nullptr)
+ * @throws OperacionCancelada si el token se activa
+ */
+RespuestasPrecalculadas precalcularRespuestas(const std::vector<Persona>& personas, unsigned hilos,
+                                              const TokenCancelacion* token);
+
+/**
+ * Imprime la respuesta a una pregunta con el mismo formato del menú.
+ *
+ * @return false si el parámetro (ciudad/grupo) no está en el precálculo;
+ *         en ese caso no imprime nada y debe calcularse como siempre
+ */
+bool responderPrecalculado(const RespuestasPrecalculadas& respuestas, const std::vector<Persona>& personas,
+                           PreguntaPrecalculada pregunta, const std::string& parametro);
+
+/**
+ * Ejecuta precalcularRespuestas en un hilo de fondo.
+ *
+ * ADVERTENCIA: El hilo lee la colección; antes de modificarla o liberarla
+ *              hay que llamar a cancelar()
+ */
+class PrecalculoEnSegundoPlano {
+public:
+    ~PrecalculoEnSegundoPlano();
+
+    /** Cancela el cálculo anterior (si hay) e inicia uno nuevo. */
+    void iniciar(const std::vector<Persona>& personas, unsigned long version);
+
+    /**
+     * Respuestas listas para la versión indicada, sin bloquear.
+     *
+     * @return nullptr si aún no terminan o son de otra versión
+     */
+    const RespuestasPrecalculadas* listas(unsigned long version);
+
+    /** Cancela el cálculo en curso y espera a que el hilo termine. */
+    void cancelar();
+
+private:
+    std::future<RespuestasPrecalculadas> futuro;
+    std::unique_ptr<RespuestasPrecalculadas> resultado;
+    std::unique_ptr<TokenCancelacion> token; // En el heap: el hilo guarda su dirección
+};
+
+#endif // PRECALCULO_H
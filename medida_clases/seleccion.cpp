@@ -0,0 +1,224 @@
+#include "seleccion.h"
+#include <algorithm> // std::min
+#include <cstdio>    // std::snprintf
+#include <iterator>  // std::back_inserter
+#include <sstream>   // std::istringstream
+#include <stdexcept> // std::invalid_argument
+#include <thread>    // std::thread
+
+// Por debajo de este número de filas el costo de crear hilos supera la ganancia
+static const size_t FILAS_MINIMAS_POR_HILO = 4096;
+
+SeleccionFilas seleccionarTodas(size_t n) {
+    SeleccionFilas seleccion(n);
+    for (size_t i = 0; i < n; ++i) seleccion[i] = static_cast<uint32_t>(i);
+    return seleccion;
+}
+
+void ConjuntoFilas::agregar(uint32_t fila) {
+    if (denso) {
+        uint64_t mascara = 1ULL << (fila % 64);
+        if (!(bits[fila / 64] & mascara)) cantidad++;
+        bits[fila / 64] |= mascara;
+        return;
+    }
+    lista.push_back(fila);
+    cantidad++;
+}
+
+void ConjuntoFilas::aMapaBits() {
+    bits.assign((n + 63) / 64, 0);
+    for (uint32_t fila : lista) bits[fila / 64] |= 1ULL << (fila % 64);
+    SeleccionFilas().swap(lista);
+    denso = true;
+}
+
+void ConjuntoFilas::aLista() {
+    SeleccionFilas filasOrdenadas;
+    filasOrdenadas.reserve(cantidad);
+    paraCada([&](uint32_t fila) { filasOrdenadas.push_back(fila); });
+    std::vector<uint64_t>().swap(bits);
+    lista.swap(filasOrdenadas);
+    denso = false;
+}
+
+/**
+ * Elige la representación: el mapa de bits ocupa n/8 bytes sin importar
+ * cuántas filas tenga; la lista, 4 bytes por fila.
+ */
+void ConjuntoFilas::compactar() {
+    bool convieneMapa = cantidad * sizeof(uint32_t) > (n + 63) / 64 * sizeof(uint64_t);
+    if (convieneMapa && !denso) aMapaBits();
+    else if (!convieneMapa && denso) aLista();
+    else if (!denso) lista.shrink_to_fit();
+}
+
+bool ConjuntoFilas::contiene(uint32_t fila) const {
+    if (fila >= n) return false;
+    if (denso) return (bits[fila / 64] >> (fila % 64)) & 1;
+    return std::binary_search(lista.begin(), lista.end(), fila);
+}
+
+SeleccionFilas ConjuntoFilas::filas() const {
+    if (!denso) return lista;
+    SeleccionFilas resultado;
+    resultado.reserve(cantidad);
+    paraCada([&](uint32_t fila) { resultado.push_back(fila); });
+    return resultado;
+}
+
+static void exigirMismoUniverso(const ConjuntoFilas& a, const ConjuntoFilas& b) {
+    if (a.universo() != b.universo()) {
+        throw std::invalid_argument("Los conjuntos de filas pertenecen a colecciones de distinto tamaño");
+    }
+}
+
+ConjuntoFilas ConjuntoFilas::interseccion(const ConjuntoFilas& a, const ConjuntoFilas& b) {
+    exigirMismoUniverso(a, b);
+    ConjuntoFilas resultado(a.n);
+    if (a.denso && b.denso) {
+        resultado.bits.resize(a.bits.size());
+        for (size_t i = 0; i < a.bits.size(); ++i) {
+            resultado.bits[i] = a.bits[i] & b.bits[i];
+            resultado.cantidad += __builtin_popcountll(resultado.bits[i]);
+        }
+        resultado.denso = true;
+    } else if (a.denso || b.denso) {
+        // Se recorre la lista y se consulta el mapa: O(tamaño de la lista)
+        const ConjuntoFilas& disperso = a.denso ? b : a;
+        const ConjuntoFilas& mapa = a.denso ? a : b;
+        for (uint32_t fila : disperso.lista) {
+            if (mapa.contiene(fila)) resultado.agregar(fila);
+        }
+    } else {
+        std::set_intersection(a.lista.begin(), a.lista.end(), b.lista.begin(), b.lista.end(),
+                              std::back_inserter(resultado.lista));
+        resultado.cantidad = resultado.lista.size();
+    }
+    resultado.compactar();
+    return resultado;
+}
+
+ConjuntoFilas ConjuntoFilas::unir(const ConjuntoFilas& a, const ConjuntoFilas& b) {
+    exigirMismoUniverso(a, b);
+    ConjuntoFilas resultado(a.n);
+    if (!a.denso && !b.denso) {
+        std::set_union(a.lista.begin(), a.lista.end(), b.lista.begin(), b.lista.end(),
+                       std::back_inserter(resultado.lista));
+        resultado.cantidad = resultado.lista.size();
+    } else {
+        resultado.bits.assign((a.n + 63) / 64, 0);
+        resultado.denso = true;
+        for (const ConjuntoFilas* c : {&a, &b}) {
+            if (c->denso) {
+                for (size_t i = 0; i < c->bits.size(); ++i) resultado.bits[i] |= c->bits[i];
+            } else {
+                for (uint32_t fila : c->lista) resultado.bits[fila / 64] |= 1ULL << (fila % 64);
+            }
+        }
+        for (uint64_t palabra : resultado.bits) resultado.cantidad += __builtin_popcountll(palabra);
+    }
+    resultado.compactar();
+    return resultado;
+}
+
+unsigned columnasDesdeTexto(const std::string& texto) {
+    unsigned columnas = 0;
+    std::istringstream entrada(texto);
+    std::string nombre;
+    while (std::getline(entrada, nombre, ',')) {
+        if (nombre == "resumen") columnas |= COLUMNAS_RESUMEN;
+        else if (nombre == "id") columnas |= COL_ID;
+        else if (nombre == "nombre") columnas |= COL_NOMBRE;
+        else if (nombre == "ciudad") columnas |= COL_CIUDAD;
+        else if (nombre == "fecha") columnas |= COL_FECHA;
+        else if (nombre == "grupo") columnas |= COL_GRUPO;
+        else if (nombre == "edad") columnas |= COL_EDAD;
+        else if (nombre == "ingresos") columnas |= COL_INGRESOS;
+        else if (nombre == "patrimonio") columnas |= COL_PATRIMONIO;
+        else if (nombre == "deudas") columnas |= COL_DEUDAS;
+        else if (nombre == "declarante") columnas |= COL_DECLARANTE;
+    }
+    return columnas ? columnas : static_cast<unsigned>(COLUMNAS_RESUMEN);
+}
+
+/**
+ * Agrega un separador de columna si la línea ya tiene contenido.
+ */
+static void separar(std::string& linea, size_t inicioLinea) {
+    if (linea.size() > inicioLinea) linea += " | ";
+}
+
+static void agregarMonto(std::string& linea, size_t inicioLinea, double valor) {
+    char buffer[48];
+    std::snprintf(buffer, sizeof(buffer), "$%.2f", valor);
+    separar(linea, inicioLinea);
+    linea += buffer;
+}
+
+/**
+ * Formatea una fila con las columnas pedidas, con el mismo aspecto que
+ * Persona::mostrarResumen() cuando se piden las columnas del resumen.
+ */
+static void formatearFila(std::string& salida, const Persona& p, uint32_t fila, unsigned columnas) {
+    salida += std::to_string(fila);
+    salida += ". ";
+    size_t inicioLinea = salida.size();
+
+    if (columnas & COL_ID) { salida += "["; salida += p.getId(); salida += "]"; }
+    if (columnas & COL_NOMBRE) {
+        if (salida.size() > inicioLinea) salida += " ";
+        salida += p.getNombre(); salida += " "; salida += p.getApellido();
+    }
+    if (columnas & COL_CIUDAD) { separar(salida, inicioLinea); salida += p.getCiudadNacimiento(); }
+    if (columnas & COL_FECHA) { separar(salida, inicioLinea); salida += p.getFechaNacimiento(); }
+    if (columnas & COL_GRUPO) { separar(salida, inicioLinea); salida += "Grupo "; salida += p.getGrupoDeclaracion(); }
+    if (columnas & COL_EDAD) { separar(salida, inicioLinea); salida += std::to_string(p.getEdad()); salida += " años"; }
+    if (columnas & COL_INGRESOS) agregarMonto(salida, inicioLinea, p.getIngresosAnuales());
+    if (columnas & COL_PATRIMONIO) agregarMonto(salida, inicioLinea, p.getPatrimonio());
+    if (columnas & COL_DEUDAS) agregarMonto(salida, inicioLinea, p.getDeudas());
+    if (columnas & COL_DECLARANTE) { separar(salida, inicioLinea); salida += p.getDeclaranteRenta() ? "Declarante" : "No declarante"; }
+    salida += "\n";
+}
+
+std::string proyectarSeleccion(const std::vector<Persona>& personas, const SeleccionFilas& seleccion,
+                               size_t desde, size_t hasta, unsigned columnas, unsigned hilos) {
+    hasta = std::min(hasta, seleccion.size());
+    if (desde >= hasta) return std::string();
+
+    size_t filas = hasta - desde;
+    if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+    hilos = static_cast<unsigned>(std::min<size_t>(hilos, (filas + FILAS_MINIMAS_POR_HILO - 1) / FILAS_MINIMAS_POR_HILO));
+
+    auto formatearTramo = [&](size_t ini, size_t fin, std::string& buffer) {
+        for (size_t i = ini; i < fin; ++i) {
+            formatearFila(buffer, personas[seleccion[i]], seleccion[i], columnas);
+        }
+    };
+
+    if (hilos <= 1) {
+        std::string salida;
+        formatearTramo(desde, hasta, salida);
+        return salida;
+    }
+
+    // Un buffer por hilo; se concatenan en orden al final
+    std::vector<std::string> buffers(hilos);
+    std::vector<std::thread> trabajadores;
+    size_t porHilo = (filas + hilos - 1) / hilos;
+    for (unsigned h = 0; h < hilos; ++h) {
+        size_t ini = desde + h * porHilo;
+        size_t fin = std::min(hasta, ini + porHilo);
+        trabajadores.emplace_back(formatearTramo, ini, fin, std::ref(buffers[h]));
+    }
+    for (auto& t : trabajadores) t.join();
+
+    std::string salida;
+    for (const auto& b : buffers) salida += b;
+    return salida;
+}
+
+void mostrarSeleccion(const std::vector<Persona>& personas, const SeleccionFilas& seleccion,
+                      size_t desde, size_t hasta, unsigned columnas, unsigned hilos) {
+    std::cout << proyectarSeleccion(personas, seleccion, desde, hasta, columnas, hilos);
+}
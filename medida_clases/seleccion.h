@@ -0,0 +1,156 @@
+#ifndef SELECCION_H
+#define SELECCION_H
+
+#include "persona.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// VECTORES DE SELECCIÓN Y PROYECCIÓN TARDÍA
+// ============================================================================
+// Las consultas de listado se separan en dos etapas:
+//   1. Filtrado: recorre la colección y devuelve solo los números de fila
+//      (uint32_t) que cumplen el criterio, sin copiar ni imprimir nada.
+//   2. Proyección: formatea únicamente las columnas pedidas de las filas que
+//      realmente se van a mostrar, opcionalmente en paralelo.
+// ============================================================================
+
+/**
+ * Vector de selección: filas de la colección que cumplen un criterio.
+ *
+ * VENTAJA: 4 bytes por coincidencia frente a 8 de un puntero o
+ *          sizeof(Persona) de una copia
+ */
+using SeleccionFilas = std::vector<uint32_t>;
+
+/**
+ * Filas que admite una colección en memoria.
+ *
+ * POR QUÉ: Selecciones, índices del planificador y mapas de bits guardan
+ *          números de fila de 32 bits; más filas los desbordarían en
+ *          silencio. Las colecciones mayores se generan en disco (opción 23)
+ */
+const size_t FILAS_MAXIMAS_EN_MEMORIA = UINT32_MAX;
+
+/**
+ * Conjunto de resultados identificado por números de fila.
+ *
+ * PROPÓSITO: Reemplazar los vector<const Persona*> de los filtros: 4 bytes
+ *            por coincidencia en vez de 8, y los números de fila siguen
+ *            siendo válidos si el vector se realoja o si la colección se
+ *            guarda y se vuelve a cargar (las instantáneas conservan el orden)
+ * REPRESENTACIÓN: Lista ordenada de filas mientras el resultado es disperso;
+ *                 mapa de bits de una palabra cada 64 filas cuando hay más de
+ *                 una coincidencia cada 32 filas (ver compactar())
+ * ERRORES: std::invalid_argument al combinar conjuntos de universos distintos
+ */
+class ConjuntoFilas {
+public:
+    ConjuntoFilas() = default;
+
+    /** Conjunto vacío sobre una colección de n filas. */
+    explicit ConjuntoFilas(size_t universo) : n(universo) {}
+
+    /** Agrega una fila; en forma de lista deben llegar en orden ascendente. */
+    void agregar(uint32_t fila);
+
+    /** Pasa a la representación más pequeña según la densidad. */
+    void compactar();
+
+    bool contiene(uint32_t fila) const;
+    size_t size() const { return cantidad; }
+    bool empty() const { return cantidad == 0; }
+    size_t universo() const { return n; }
+    bool esMapaBits() const { return denso; }
+
+    /** Memoria del resultado en bytes. */
+    size_t bytes() const { return lista.capacity() * sizeof(uint32_t) + bits.capacity() * sizeof(uint64_t); }
+
+    /** Recorre las filas en orden ascendente. */
+    template <typename Funcion>
+    void paraCada(Funcion visitar) const {
+        if (!denso) {
+            for (uint32_t fila : lista) visitar(fila);
+            return;
+        }
+        for (size_t palabra = 0; palabra < bits.size(); ++palabra) {
+            for (uint64_t resto = bits[palabra]; resto; resto &= resto - 1) {
+                visitar(static_cast<uint32_t>(palabra * 64 + __builtin_ctzll(resto)));
+            }
+        }
+    }
+
+    /** Filas como vector de selección (p. ej. para un cursor). */
+    SeleccionFilas filas() const;
+
+    static ConjuntoFilas interseccion(const ConjuntoFilas& a, const ConjuntoFilas& b);
+    static ConjuntoFilas unir(const ConjuntoFilas& a, const ConjuntoFilas& b);
+
+private:
+    void aMapaBits();
+    void aLista();
+
+    size_t n = 0;          // Filas de la colección
+    size_t cantidad = 0;   // Filas en el conjunto
+    bool denso = false;
+    SeleccionFilas lista;         // Si !denso
+    std::vector<uint64_t> bits;   // Si denso
+};
+
+/**
+ * Columnas que puede incluir una proyección (combinables con |).
+ */
+enum ColumnaProyeccion : unsigned {
+    COL_ID         = 1u << 0,
+    COL_NOMBRE     = 1u << 1, // Nombre y apellidos
+    COL_CIUDAD     = 1u << 2,
+    COL_FECHA      = 1u << 3,
+    COL_GRUPO      = 1u << 4,
+    COL_EDAD       = 1u << 5,
+    COL_INGRESOS   = 1u << 6,
+    COL_PATRIMONIO = 1u << 7,
+    COL_DEUDAS     = 1u << 8,
+    COL_DECLARANTE = 1u << 9,
+
+    // Mismas columnas que Persona::mostrarResumen()
+    COLUMNAS_RESUMEN = COL_ID | COL_NOMBRE | COL_CIUDAD | COL_INGRESOS
+};
+
+/**
+ * Selecciona todas las filas de una colección de tamaño n.
+ */
+SeleccionFilas seleccionarTodas(size_t n);
+
+/**
+ * Interpreta una lista de columnas separadas por comas.
+ *
+ * @param texto Ej. "id,ciudad,edad" o "resumen"
+ * @return Máscara de columnas (COLUMNAS_RESUMEN si el texto no es válido)
+ */
+unsigned columnasDesdeTexto(const std::string& texto);
+
+/**
+ * Formatea las filas [desde, hasta) de una selección.
+ *
+ * @param personas Colección original
+ * @param seleccion Filas seleccionadas
+ * @param desde Primera posición de la selección a formatear
+ * @param hasta Una más que la última posición a formatear
+ * @param columnas Máscara de columnas a incluir
+ * @param hilos Hilos de formateo (0 = los que ofrezca el hardware)
+ * @return Texto listo para imprimir, una línea por fila
+ *
+ * IMPLEMENTACIÓN: Cada hilo formatea un tramo contiguo en su propio buffer
+ *                 y los buffers se concatenan en orden
+ */
+std::string proyectarSeleccion(const std::vector<Persona>& personas, const SeleccionFilas& seleccion,
+                               size_t desde, size_t hasta, unsigned columnas, unsigned hilos = 0);
+
+/**
+ * Proyecta e imprime las filas [desde, hasta) de una selección.
+ */
+void mostrarSeleccion(const std::vector<Persona>& personas, const SeleccionFilas& seleccion,
+                      size_t desde, size_t hasta, unsigned columnas, unsigned hilos = 0);
+
+#endif // SELECCION_H
@@ -0,0 +1,25 @@
+#ifndef TEXTO_H
+#define TEXTO_H
+
+#include <cstddef>
+#include <string>
+
+// ============================================================================
+// UTILIDADES DE TEXTO PARA LAS TABLAS DE REPORTE
+// ============================================================================
+
+/**
+ * Completa con espacios hasta el ancho en caracteres visibles.
+ *
+ * PROPÓSITO: Alinear columnas con etiquetas acentuadas; std::setw cuenta
+ *            bytes y cada tilde ocupa dos en UTF-8.
+ * IMPLEMENTACIÓN: Cuenta los bytes que no son de continuación (10xxxxxx).
+ * NOTA: Un texto más ancho que la columna se devuelve sin recortar.
+ */
+inline std::string rellenar(const std::string& texto, size_t ancho) {
+    size_t visibles = 0;
+    for (char ch : texto) visibles += (static_cast<unsigned char>(ch) & 0xC0) != 0x80;
+    return texto + std::string(ancho > visibles ? ancho - visibles : 0, ' ');
+}
+
+#endif // TEXTO_H
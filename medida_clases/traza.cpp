@@ -0,0 +1,436 @@
+#include "traza.h"
+#include "generador.h"
+#include "texto.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+static const char MAGICO[8] = {'P', 'E', 'R', 'S', 'T', 'R', 'Z', '1'};
+
+/**
+ * Streambuf de entrada que lee carácter a carácter de otro y guarda copia.
+ *
+ * IMPLEMENTACIÓN: Búfer de un solo carácter, así no se adelanta a la fuente
+ *                 más de lo que pide el istream y nada queda atrapado aquí
+ *                 al dejar de grabar
+ */
+class GrabadoraTraza::EntradaCapturada : public std::streambuf {
+public:
+    explicit EntradaCapturada(std::streambuf* fuente) : fuente(fuente) {}
+
+    std::streambuf* original() const { return fuente; }
+    std::string texto;
+
+protected:
+    int_type underflow() override {
+        int_type c = fuente->sbumpc();
+        if (traits_type::eq_int_type(c, traits_type::eof())) return c;
+        actual = traits_type::to_char_type(c);
+        texto.push_back(actual);
+        setg(&actual, &actual, &actual + 1);
+        return c;
+    }
+
+private:
+    std::streambuf* fuente;
+    char actual = 0;
+};
+
+/**
+ * Añade el entero en little-endian, byte a byte: la traza se lee igual en
+ * cualquier máquina.
+ */
+template <typename T>
+static void escribirValor(std::string& salida, T valor) {
+    for (size_t i = 0; i < sizeof(T); ++i) salida.push_back(static_cast<char>((valor >> (8 * i)) & 0xFF));
+}
+
+template <typename T>
+static T leerValor(const char* datos) {
+    T valor = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) valor |= static_cast<T>(static_cast<unsigned char>(datos[i])) << (8 * i);
+    return valor;
+}
+
+static uint32_t bitsDe(float valor) {
+    static_assert(sizeof(float) == sizeof(uint32_t), "float de 32 bits");
+    uint32_t bits;
+    std::memcpy(&bits, &valor, sizeof(bits));
+    return bits;
+}
+
+static float floatDe(uint32_t bits) {
+    float valor;
+    std::memcpy(&valor, &bits, sizeof(valor));
+    return valor;
+}
+
+static void escribirTexto(std::string& salida, const std::string& texto) {
+    size_t largo = std::min<size_t>(texto.size(), 255); // Ciudades, cédulas y nombres de operación caben
+    salida.push_back(static_cast<char>(largo));
+    salida.append(texto, 0, largo);
+}
+
+GrabadoraTraza::GrabadoraTraza() = default;
+
+GrabadoraTraza::~GrabadoraTraza() {
+    detener();
+}
+
+void GrabadoraTraza::iniciar(const std::string& ruta, std::istream& entradaGrabada) {
+    detener();
+    archivo.open(ruta, std::ios::binary | std::ios::trunc);
+    if (!archivo) throw std::runtime_error("No se pudo crear la traza: " + ruta);
+    archivo.write(MAGICO, sizeof(MAGICO));
+
+    captura = std::make_unique<EntradaCapturada>(entradaGrabada.rdbuf());
+    entrada = &entradaGrabada;
+    entrada->rdbuf(captura.get());
+    rutaArchivo = ruta;
+    inicio = std::chrono::steady_clock::now();
+    opcionActual = -1;
+    escritos = 0;
+}
+
+void GrabadoraTraza::detener() {
+    if (!activa()) return;
+    entrada->rdbuf(captura->original());
+    captura.reset();
+    entrada = nullptr;
+    archivo.close();
+}
+
+void GrabadoraTraza::comenzarOperacion(int opcion) {
+    if (!activa()) return;
+    captura->texto.clear();
+    opcionActual = opcion;
+    // El instante es el de la llegada de la opción: al reproducir a ritmo original se lanza entonces
+    instanteActual = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - inicio).count());
+}
+
+void GrabadoraTraza::terminarOperacion(const std::string& operacion, double duracionMs) {
+    if (!activa() || opcionActual < 0 || opcionActual > 255) return;
+
+    std::istringstream palabras(captura->texto);
+    std::vector<std::string> parametros;
+    for (std::string palabra; palabras >> palabra && parametros.size() < 255;) parametros.push_back(palabra);
+
+    std::string registro;
+    escribirValor<uint64_t>(registro, instanteActual);
+    escribirValor<uint32_t>(registro, bitsDe(static_cast<float>(duracionMs)));
+    escribirValor<uint8_t>(registro, static_cast<uint8_t>(opcionActual));
+    escribirValor<uint8_t>(registro, static_cast<uint8_t>(parametros.size()));
+    for (const auto& p : parametros) escribirTexto(registro, p);
+    escribirTexto(registro, operacion);
+
+    // Un evento por escritura y vaciado: si el programa se cierra, la traza sigue siendo legible
+    archivo.write(registro.data(), registro.size());
+    archivo.flush();
+    if (!archivo) throw std::runtime_error("No se pudo escribir la traza: " + rutaArchivo);
+    escritos++;
+    opcionActual = -1;
+}
+
+std::vector<EventoTraza> leerTraza(const std::string& ruta) {
+    std::ifstream archivo(ruta, std::ios::binary);
+    if (!archivo) throw std::runtime_error("No se pudo abrir la traza: " + ruta);
+    std::string datos((std::istreambuf_iterator<char>(archivo)), std::istreambuf_iterator<char>());
+    if (datos.size() < sizeof(MAGICO) || std::memcmp(datos.data(), MAGICO, sizeof(MAGICO)) != 0) {
+        throw std::runtime_error("El archivo no es una traza de sesión: " + ruta);
+    }
+
+    size_t pos = sizeof(MAGICO);
+    auto exigir = [&](size_t bytes) {
+        if (datos.size() - pos < bytes) throw std::runtime_error("Traza dañada: evento truncado");
+    };
+    auto leerTexto = [&]() {
+        exigir(1);
+        size_t largo = static_cast<unsigned char>(datos[pos++]);
+        exigir(largo);
+        std::string texto = datos.substr(pos, largo);
+        pos += largo;
+        return texto;
+    };
+
+    std::vector<EventoTraza> eventos;
+    while (pos < datos.size()) {
+        EventoTraza e;
+        exigir(sizeof(uint64_t) + sizeof(uint32_t) + 2);
+        e.instanteUs = leerValor<uint64_t>(datos.data() + pos);
+        e.duracionMs = floatDe(leerValor<uint32_t>(datos.data() + pos + sizeof(uint64_t)));
+        pos += sizeof(uint64_t) + sizeof(uint32_t);
+        e.opcion = static_cast<unsigned char>(datos[pos++]);
+        size_t numParametros = static_cast<unsigned char>(datos[pos++]);
+        for (size_t i = 0; i < numParametros; ++i) e.parametros.push_back(leerTexto());
+        e.operacion = leerTexto();
+        eventos.push_back(std::move(e));
+    }
+    return eventos;
+}
+
+/**
+ * Salida que descarta todo sin estado propio, así varios hilos pueden
+ * escribir en std::cout a la vez mientras está silenciada.
+ */
+class SalidaNula : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+/**
+ * Consulta de un evento lista para ejecutarse.
+ */
+struct ConsultaPreparada {
+    size_t operacion;      // Índice en el reporte
+    uint64_t instanteUs;
+    std::function<void()> ejecutar;
+};
+
+// Destino de los resultados reproducidos, para que el compilador no descarte las consultas
+static thread_local volatile size_t sumidero;
+
+static const char* nombreVariante(bool porReferencia) {
+    return porReferencia ? " (referencia)" : " (valor)";
+}
+
+/**
+ * Traduce un evento a la llamada equivalente de generador.h.
+ *
+ * @return false si la opción no es una consulta reproducible o le faltan parámetros
+ */
+static bool prepararConsulta(const EventoTraza& e, VarianteReproduccion variante, const std::vector<Persona>& personas,
+                             std::string& etiqueta, std::function<void()>& ejecutar) {
+    const std::vector<std::string>& p = e.parametros;
+    if (e.opcion == 3) {
+        if (p.empty()) return false;
+        std::string id = p[0];
+        etiqueta = "Buscar por ID";
+        ejecutar = [&personas, id] { sumidero = buscarPorID(personas, id) != nullptr; };
+        return true;
+    }
+    if (e.opcion < 4 || e.opcion > 15) return false;
+
+    // Las opciones 4-15 vienen en pares: la par por valor, la impar por referencia
+    bool referencia = e.opcion % 2 == 1;
+    if (variante == VarianteReproduccion::VALOR) referencia = false;
+    if (variante == VarianteReproduccion::REFERENCIA) referencia = true;
+    const int base = e.opcion - e.opcion % 2;
+    const std::string sufijo = nombreVariante(referencia);
+
+    switch (base) {
+        case 4:
+        case 6: {
+            if (p.empty() || (p[0] != "1" && p.size() < 2)) return false;
+            const bool longevo = base == 4;
+            const std::string criterio = p[0];
+            const std::string valor = p.size() > 1 ? p[1] : "";
+            etiqueta = std::string(longevo ? "Más longeva" : "Más patrimonio") +
+                       (criterio == "1" ? " en el país" : criterio == "2" ? " en ciudad" : " en grupo") + sufijo;
+            if (criterio == "1") {
+                if (longevo) ejecutar = [&personas, referencia] {
+                    sumidero = referencia ? buscarMasLongevoPorReferencia(personas)->getEdad()
+                                          : buscarMasLongevoPorValor(personas).getEdad();
+                };
+                else ejecutar = [&personas, referencia] {
+                    sumidero = referencia ? buscarMasPatrimonioPorReferencia(personas)->getId().size()
+                                          : buscarMasPatrimonioPorValor(personas).getId().size();
+                };
+            } else if (criterio == "2") {
+                if (longevo) ejecutar = [&personas, referencia, valor] {
+                    sumidero = referencia ? buscarMasLongevoPorReferenciaEnCiudad(personas, valor)->getEdad()
+                                          : buscarMasLongevoPorValorEnCiudad(personas, valor).getEdad();
+                };
+                else ejecutar = [&personas, referencia, valor] {
+                    sumidero = referencia ? buscarMasPatrimonioPorReferenciaEnCiudad(personas, valor)->getId().size()
+                                          : buscarMasPatrimonioPorValorEnCiudad(personas, valor).getId().size();
+                };
+            } else if (criterio == "3" && !longevo) {
+                ejecutar = [&personas, referencia, valor] {
+                    sumidero = referencia ? buscarMasPatrimonioPorReferenciaEnGrupo(personas, valor)->getId().size()
+                                          : buscarMasPatrimonioPorValorEnGrupo(personas, valor).getId().size();
+                };
+            } else {
+                return false;
+            }
+            return true;
+        }
+        case 8: {
+            if (p.empty()) return false;
+            std::string grupo = p[0];
+            etiqueta = "Listar grupo (solo filtrado)" + sufijo;
+            ejecutar = [&personas, referencia, grupo] {
+                sumidero = referencia ? listarPersonasPorReferenciaEnGrupo(personas, grupo).size()
+                                      : listarPersonasPorValorEnGrupo(personas, grupo).size();
+            };
+            return true;
+        }
+        case 10:
+            etiqueta = "Verificar grupos" + sufijo;
+            ejecutar = [&personas, referencia] {
+                if (referencia) verificarGruposMasivoPorReferencia(personas);
+                else verificarGruposMasivoPorValor(personas);
+            };
+            return true;
+        case 12:
+            etiqueta = "Grupo con mayor patrimonio" + sufijo;
+            ejecutar = [&personas, referencia] {
+                sumidero = (referencia ? encontrarGrupoMayorPatrimonioPorReferencia(personas)
+                                       : encontrarGrupoMayorPatrimonioPorValor(personas)).size();
+            };
+            return true;
+        case 14:
+            etiqueta = "Grupo con mayor longevidad" + sufijo;
+            ejecutar = [&personas, referencia] {
+                sumidero = (referencia ? encontrarGrupoMayorLongevidadPorReferencia(personas)
+                                       : encontrarGrupoMayorLongevidadPorValor(personas)).size();
+            };
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Latencias de un hilo: una lista por operación del reporte.
+ */
+struct LatenciasHilo {
+    std::vector<std::vector<double>> ms;
+    std::vector<size_t> errores;
+};
+
+ReporteReproduccion reproducirTraza(const std::vector<EventoTraza>& traza, const std::vector<Persona>& personas,
+                                    const ConfiguracionReproduccion& configuracion, const ControlOperacion& control) {
+    if (configuracion.aceleracion < 0) throw std::invalid_argument("La aceleración no puede ser negativa");
+    ReporteReproduccion reporte;
+    reporte.hilos = std::max(1u, configuracion.hilos);
+
+    std::vector<ConsultaPreparada> consultas;
+    std::map<std::string, size_t> indicePorEtiqueta;
+    std::vector<double> sumaGrabada;
+    for (const auto& e : traza) {
+        std::string etiqueta;
+        std::function<void()> ejecutar;
+        if (!prepararConsulta(e, configuracion.variante, personas, etiqueta, ejecutar)) {
+            reporte.omitidas++;
+            continue;
+        }
+        auto it = indicePorEtiqueta.find(etiqueta);
+        if (it == indicePorEtiqueta.end()) {
+            it = indicePorEtiqueta.emplace(etiqueta, reporte.porOperacion.size()).first;
+            reporte.porOperacion.emplace_back();
+            reporte.porOperacion.back().operacion = etiqueta;
+            sumaGrabada.push_back(0.0);
+        }
+        if (e.duracionMs >= 0) {
+            reporte.porOperacion[it->second].grabadas++;
+            sumaGrabada[it->second] += e.duracionMs;
+            reporte.totalGrabadoMs += e.duracionMs;
+        }
+        consultas.push_back({it->second, e.instanteUs, std::move(ejecutar)});
+    }
+    if (consultas.empty()) return reporte;
+
+    SalidaNula nula;
+    std::streambuf* salidaOriginal = std::cout.rdbuf(&nula);
+    const uint64_t primerInstante = consultas.front().instanteUs;
+    const auto inicio = std::chrono::steady_clock::now();
+
+    std::vector<std::future<LatenciasHilo>> hilos;
+    for (unsigned h = 0; h < reporte.hilos; ++h) {
+        ControlOperacion propio;
+        propio.token = control.token;
+        if (h == 0) propio.progreso = control.progreso; // Un solo hilo dibuja el progreso
+        hilos.push_back(std::async(std::launch::async, [&, propio]() {
+            LatenciasHilo latencias;
+            latencias.ms.resize(reporte.porOperacion.size());
+            latencias.errores.resize(reporte.porOperacion.size());
+            for (size_t k = 0; k < consultas.size(); ++k) {
+                propio.avanzar(k, consultas.size());
+                const ConsultaPreparada& c = consultas[k];
+                if (configuracion.aceleracion > 0) {
+                    // Lazo abierto: cada consulta sale a su hora aunque la anterior se haya atrasado
+                    auto espera = std::chrono::microseconds(static_cast<int64_t>(
+                        (c.instanteUs - primerInstante) / configuracion.aceleracion));
+                    std::this_thread::sleep_until(inicio + espera);
+                }
+                auto antes = std::chrono::steady_clock::now();
+                try {
+                    c.ejecutar();
+                } catch (const std::exception&) {
+                    latencias.errores[c.operacion]++;
+                }
+                latencias.ms[c.operacion].push_back(
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - antes).count());
+            }
+            propio.avanzar(consultas.size(), consultas.size());
+            return latencias;
+        }));
+    }
+
+    std::vector<LatenciasHilo> resultados;
+    try {
+        for (auto& h : hilos) resultados.push_back(h.get());
+    } catch (...) {
+        for (auto& h : hilos) if (h.valid()) h.wait(); // Nadie debe seguir escribiendo en la salida nula
+        std::cout.rdbuf(salidaOriginal);
+        throw;
+    }
+    std::cout.rdbuf(salidaOriginal);
+    reporte.paredMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+
+    for (size_t op = 0; op < reporte.porOperacion.size(); ++op) {
+        LatenciaOperacion& l = reporte.porOperacion[op];
+        std::vector<double> todas;
+        for (const auto& r : resultados) {
+            todas.insert(todas.end(), r.ms[op].begin(), r.ms[op].end());
+            l.errores += r.errores[op];
+        }
+        std::sort(todas.begin(), todas.end());
+        double suma = 0.0;
+        for (double t : todas) suma += t;
+        l.ejecuciones = todas.size();
+        l.mediaMs = suma / todas.size();
+        l.medianaMs = todas[todas.size() / 2];
+        l.p95Ms = todas[std::min(todas.size() - 1, todas.size() * 95 / 100)];
+        l.grabadaMediaMs = l.grabadas ? sumaGrabada[op] / l.grabadas : 0.0;
+        reporte.reproducidas += l.ejecuciones;
+        reporte.errores += l.errores;
+        reporte.totalReproducidoMs += suma / reporte.hilos;
+    }
+    return reporte;
+}
+
+void mostrarReporteReproduccion(const ReporteReproduccion& reporte, std::ostream& salida) {
+    std::ios::fmtflags formatoOriginal = salida.flags();
+    std::streamsize precisionOriginal = salida.precision();
+
+    salida << "\n=== REPRODUCCIÓN DE TRAZA ===\n";
+    salida << "Consultas reproducidas: " << reporte.reproducidas << " (" << reporte.hilos << " hilo(s)), omitidas: "
+           << reporte.omitidas << ", con error: " << reporte.errores << "\n\n";
+    salida << std::fixed << std::setprecision(3) << rellenar("Operación", 44)
+           << std::setw(7) << "Veces" << std::setw(12) << "Grabada" << std::setw(12) << "Media"
+           << std::setw(12) << "Mediana" << std::setw(12) << "p95" << std::setw(10) << "Dif." << "\n";
+    for (const auto& l : reporte.porOperacion) {
+        salida << rellenar(l.operacion, 44) << std::setw(7) << l.ejecuciones;
+        if (l.grabadas) salida << std::setw(12) << l.grabadaMediaMs;
+        else salida << std::setw(12) << "-";
+        salida << std::setw(12) << l.mediaMs << std::setw(12) << l.medianaMs << std::setw(12) << l.p95Ms;
+        if (l.grabadas && l.grabadaMediaMs > 0) {
+            salida << std::setw(9) << std::setprecision(1) << (l.mediaMs - l.grabadaMediaMs) * 100.0 / l.grabadaMediaMs
+                   << "%" << std::setprecision(3);
+        }
+        salida << "\n";
+    }
+    salida << "\nTiempos en ms. Total grabado: " << reporte.totalGrabadoMs << " ms, total reproducido (por hilo): "
+           << reporte.totalReproducidoMs << " ms, duración de la reproducción: " << reporte.paredMs << " ms\n";
+
+    salida.flags(formatoOriginal);
+    salida.precision(precisionOriginal);
+}
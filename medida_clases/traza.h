@@ -0,0 +1,161 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include "persona.h"
+#include "cancelacion.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// GRABACIÓN Y REPRODUCCIÓN DE SESIONES
+// ============================================================================
+// Los bancos de pruebas miden cada función por separado, pero una sesión
+// real es una mezcla de consultas con parámetros concretos (ciudades,
+// grupos, cédulas). La grabadora intercepta la entrada estándar y guarda,
+// por cada opción ejecutada, lo que se leyó durante ella y el tiempo que
+// registró el monitor. La reproducción vuelve a ejecutar las consultas de
+// la traza sobre cualquier conjunto, a la velocidad original o acelerada y
+// con varios hilos a la vez, y compara las latencias.
+//
+// Formato del archivo (binario, little-endian byte a byte, sin importar el
+// orden de la máquina que grabó):
+//   "PERSTRZ1"
+//   por evento: uint64 instante en que empezó la opción (us desde el inicio
+//               de la grabación), float IEEE-754 duración (ms,
+//               -1 si no se midió), uint8 opción, uint8 parámetros,
+//               cada parámetro y el nombre de la operación como uint8
+//               largo + bytes
+// ============================================================================
+
+/**
+ * Una opción del menú tal como se ejecutó.
+ */
+struct EventoTraza {
+    uint64_t instanteUs = 0;             // Comienzo de la opción, desde el inicio de la grabación
+    int opcion = -1;                     // Opción del menú
+    std::vector<std::string> parametros; // Palabras leídas durante la opción
+    std::string operacion;               // Nombre registrado en el monitor ("" si no se midió)
+    double duracionMs = -1.0;            // Tiempo registrado (-1 si no se midió)
+};
+
+/**
+ * Graba en un archivo las opciones ejecutadas y sus parámetros.
+ *
+ * IMPLEMENTACIÓN: Reemplaza el streambuf de la entrada por uno que copia
+ *                 cada carácter leído; así ninguna opción del menú necesita
+ *                 saber que se está grabando
+ * ADVERTENCIA: Debe detenerse antes de destruir la entrada interceptada
+ */
+class GrabadoraTraza {
+public:
+    GrabadoraTraza();
+    ~GrabadoraTraza();
+    GrabadoraTraza(const GrabadoraTraza&) = delete;
+    GrabadoraTraza& operator=(const GrabadoraTraza&) = delete;
+
+    /**
+     * Empieza a grabar en ruta (se sobrescribe).
+     *
+     * @throws std::runtime_error si no se puede crear el archivo
+     */
+    void iniciar(const std::string& ruta, std::istream& entrada = std::cin);
+
+    /** Deja de interceptar la entrada y cierra el archivo. */
+    void detener();
+
+    bool activa() const { return archivo.is_open(); }
+    const std::string& ruta() const { return rutaArchivo; }
+    size_t eventos() const { return escritos; }
+
+    /** Descarta lo leído hasta ahora y marca el instante: empieza la opción dada. */
+    void comenzarOperacion(int opcion);
+
+    /**
+     * Escribe el evento de la opción en curso.
+     *
+     * @param operacion Nombre registrado en el monitor ("" si no se midió)
+     * @param duracionMs Tiempo registrado (-1 si no se midió)
+     */
+    void terminarOperacion(const std::string& operacion, double duracionMs);
+
+private:
+    class EntradaCapturada;
+
+    std::unique_ptr<EntradaCapturada> captura;
+    std::istream* entrada = nullptr;
+    std::ofstream archivo;
+    std::string rutaArchivo;
+    std::chrono::steady_clock::time_point inicio;
+    int opcionActual = -1;
+    uint64_t instanteActual = 0; // Comienzo de opcionActual (us desde inicio)
+    size_t escritos = 0;
+};
+
+/**
+ * Lee una traza escrita por GrabadoraTraza.
+ *
+ * @throws std::runtime_error si el archivo falta o está dañado
+ */
+std::vector<EventoTraza> leerTraza(const std::string& ruta);
+
+/**
+ * Qué variante de cada consulta se ejecuta al reproducir.
+ */
+enum class VarianteReproduccion {
+    ORIGINAL,   // La de la opción grabada
+    VALOR,      // Siempre la versión por valor (opciones pares 4-14)
+    REFERENCIA  // Siempre la versión por referencia (opciones impares 5-15)
+};
+
+struct ConfiguracionReproduccion {
+    double aceleracion = 0.0; // 0 = sin esperas; 1 = ritmo original; 10 = diez veces más rápido
+    unsigned hilos = 1;       // Cada hilo reproduce la traza completa
+    VarianteReproduccion variante = VarianteReproduccion::ORIGINAL;
+};
+
+/**
+ * Latencias de una consulta: las grabadas y las de la reproducción.
+ */
+struct LatenciaOperacion {
+    std::string operacion;
+    size_t ejecuciones = 0;
+    size_t errores = 0;            // Consultas que lanzaron excepción (p. ej. ciudad sin personas)
+    size_t grabadas = 0;           // Eventos con duración grabada
+    double grabadaMediaMs = 0.0;
+    double mediaMs = 0.0;
+    double medianaMs = 0.0;
+    double p95Ms = 0.0;
+};
+
+struct ReporteReproduccion {
+    size_t reproducidas = 0;       // Ejecuciones, sumando todos los hilos
+    size_t omitidas = 0;           // Eventos de opciones que no son consultas (0, 16, 26...)
+    size_t errores = 0;
+    unsigned hilos = 1;
+    double totalGrabadoMs = 0.0;   // Suma de duraciones grabadas de las consultas reproducibles
+    double totalReproducidoMs = 0.0; // Suma de latencias de un hilo promedio
+    double paredMs = 0.0;          // Duración de la reproducción completa
+    std::vector<LatenciaOperacion> porOperacion;
+};
+
+/**
+ * Reproduce las consultas (opciones 3-15) de una traza sobre personas.
+ *
+ * NOTA: Se llama directamente a las funciones de búsqueda, sin caché ni
+ *       precálculo ni impresión, así que una consulta grabada como acierto
+ *       de caché aparecerá más lenta. Los listados (8 y 9) miden solo el
+ *       filtrado, sin la navegación por páginas.
+ * @throws OperacionCancelada si el control lo indica
+ */
+ReporteReproduccion reproducirTraza(const std::vector<EventoTraza>& traza, const std::vector<Persona>& personas,
+                                    const ConfiguracionReproduccion& configuracion,
+                                    const ControlOperacion& control = ControlOperacion());
+
+void mostrarReporteReproduccion(const ReporteReproduccion& reporte, std::ostream& salida = std::cout);
+
+#endif // TRAZA_H
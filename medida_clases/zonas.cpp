@@ -0,0 +1,167 @@
+#include "zonas.h"
+#include <algorithm> // std::find, std::min, std::max, std::stable_sort
+
+/**
+ * Devuelve el código de un valor en el diccionario, agregándolo si es nuevo.
+ */
+static size_t codigoEn(std::vector<std::string>& diccionario, const std::string& valor) {
+    auto it = std::find(diccionario.begin(), diccionario.end(), valor);
+    if (it != diccionario.end()) return it - diccionario.begin();
+    diccionario.push_back(valor);
+    return diccionario.size() - 1;
+}
+
+/**
+ * Convierte un código en su bit de máscara (los códigos altos comparten el bit 63).
+ */
+static uint64_t bitDeCodigo(size_t codigo) {
+    return uint64_t(1) << std::min<size_t>(codigo, 63);
+}
+
+/**
+ * Construye las zonas en una sola pasada secuencial.
+ *
+ * COMPLEJIDAD: O(n) tiempo, O(n / filasPorBloque) espacio
+ */
+MapaZonas::MapaZonas(const std::vector<Persona>& personas, size_t filasPorBloque) : personas(personas) {
+    if (filasPorBloque == 0) filasPorBloque = FILAS_POR_BLOQUE;
+
+    for (size_t inicio = 0; inicio < personas.size(); inicio += filasPorBloque) {
+        size_t fin = std::min(personas.size(), inicio + filasPorBloque);
+        const Persona& primera = personas[inicio];
+
+        ZonaBloque z;
+        z.inicio = static_cast<uint32_t>(inicio);
+        z.fin = static_cast<uint32_t>(fin);
+        z.edadMin = z.edadMax = primera.getEdad();
+        z.patrimonioMin = z.patrimonioMax = primera.getPatrimonio();
+        z.mascaraCiudades = 0;
+        z.mascaraGrupos = 0;
+
+        for (size_t i = inicio; i < fin; ++i) {
+            const Persona& p = personas[i];
+            z.edadMin = std::min(z.edadMin, p.getEdad());
+            z.edadMax = std::max(z.edadMax, p.getEdad());
+            z.patrimonioMin = std::min(z.patrimonioMin, p.getPatrimonio());
+            z.patrimonioMax = std::max(z.patrimonioMax, p.getPatrimonio());
+            z.mascaraCiudades |= bitDeCodigo(codigoEn(ciudades, p.getCiudadNacimiento()));
+            z.mascaraGrupos |= bitDeCodigo(codigoEn(grupos, p.getGrupoDeclaracion()));
+        }
+        zonas.push_back(z);
+    }
+}
+
+uint64_t MapaZonas::bitCiudad(const std::string& ciudad) const {
+    auto it = std::find(ciudades.begin(), ciudades.end(), ciudad);
+    return it == ciudades.end() ? 0 : bitDeCodigo(it - ciudades.begin());
+}
+
+uint64_t MapaZonas::bitGrupo(const std::string& grupo) const {
+    auto it = std::find(grupos.begin(), grupos.end(), grupo);
+    return it == grupos.end() ? 0 : bitDeCodigo(it - grupos.begin());
+}
+
+size_t MapaZonas::contarPatrimonioMayorQue(double umbral, EstadisticaSalto& salto) const {
+    size_t total = 0;
+    for (const auto& z : zonas) {
+        if (z.patrimonioMax <= umbral) { salto.bloquesSaltados++; continue; }
+        salto.bloquesLeidos++;
+        if (z.patrimonioMin > umbral) { total += z.fin - z.inicio; continue; } // Bloque completo
+        for (uint32_t i = z.inicio; i < z.fin; ++i) {
+            if (personas[i].getPatrimonio() > umbral) total++;
+        }
+    }
+    return total;
+}
+
+size_t MapaZonas::contarEdadMayorQue(int umbral, EstadisticaSalto& salto) const {
+    size_t total = 0;
+    for (const auto& z : zonas) {
+        if (z.edadMax <= umbral) { salto.bloquesSaltados++; continue; }
+        salto.bloquesLeidos++;
+        if (z.edadMin > umbral) { total += z.fin - z.inicio; continue; }
+        for (uint32_t i = z.inicio; i < z.fin; ++i) {
+            if (personas[i].getEdad() > umbral) total++;
+        }
+    }
+    return total;
+}
+
+size_t MapaZonas::contarEnCiudad(const std::string& ciudad, EstadisticaSalto& salto) const {
+    uint64_t bit = bitCiudad(ciudad);
+    size_t total = 0;
+    for (const auto& z : zonas) {
+        if (!(z.mascaraCiudades & bit)) { salto.bloquesSaltados++; continue; }
+        salto.bloquesLeidos++;
+        for (uint32_t i = z.inicio; i < z.fin; ++i) {
+            if (personas[i].getCiudadNacimiento() == ciudad) total++;
+        }
+    }
+    return total;
+}
+
+const Persona* MapaZonas::masPatrimonioEnCiudad(const std::string& ciudad, EstadisticaSalto& salto) const {
+    uint64_t bit = bitCiudad(ciudad);
+    const Persona* mejor = nullptr;
+    for (const auto& z : zonas) {
+        if (!(z.mascaraCiudades & bit) || (mejor && z.patrimonioMax <= mejor->getPatrimonio())) {
+            salto.bloquesSaltados++;
+            continue;
+        }
+        salto.bloquesLeidos++;
+        for (uint32_t i = z.inicio; i < z.fin; ++i) {
+            const Persona& p = personas[i];
+            if (p.getCiudadNacimiento() == ciudad && (!mejor || p.getPatrimonio() > mejor->getPatrimonio())) {
+                mejor = &p;
+            }
+        }
+    }
+    return mejor;
+}
+
+const Persona* MapaZonas::masPatrimonioEnGrupo(const std::string& grupo, EstadisticaSalto& salto) const {
+    uint64_t bit = bitGrupo(grupo);
+    const Persona* mejor = nullptr;
+    for (const auto& z : zonas) {
+        if (!(z.mascaraGrupos & bit) || (mejor && z.patrimonioMax <= mejor->getPatrimonio())) {
+            salto.bloquesSaltados++;
+            continue;
+        }
+        salto.bloquesLeidos++;
+        for (uint32_t i = z.inicio; i < z.fin; ++i) {
+            const Persona& p = personas[i];
+            if (p.getGrupoDeclaracion() == grupo && (!mejor || p.getPatrimonio() > mejor->getPatrimonio())) {
+                mejor = &p;
+            }
+        }
+    }
+    return mejor;
+}
+
+/**
+ * Reordena la colección por el criterio indicado.
+ *
+ * CÓMO: stable_sort para conservar el orden original entre iguales.
+ * CIUDAD agrupa también por patrimonio dentro de cada ciudad, así las
+ * búsquedas de máximo por ciudad descartan casi todos los bloques.
+ */
+void agruparColeccion(std::vector<Persona>& personas, CriterioAgrupacion criterio) {
+    switch (criterio) {
+        case CriterioAgrupacion::CIUDAD:
+            std::stable_sort(personas.begin(), personas.end(), [](const Persona& a, const Persona& b) {
+                if (a.getCiudadNacimiento() != b.getCiudadNacimiento()) {
+                    return a.getCiudadNacimiento() < b.getCiudadNacimiento();
+                }
+                return a.getPatrimonio() < b.getPatrimonio();
+            });
+            break;
+        case CriterioAgrupacion::EDAD:
+            std::stable_sort(personas.begin(), personas.end(),
+                [](const Persona& a, const Persona& b) { return a.getEdad() < b.getEdad(); });
+            break;
+        case CriterioAgrupacion::PATRIMONIO:
+            std::stable_sort(personas.begin(), personas.end(),
+                [](const Persona& a, const Persona& b) { return a.getPatrimonio() < b.getPatrimonio(); });
+            break;
+    }
+}
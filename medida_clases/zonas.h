@@ -0,0 +1,102 @@
+#ifndef ZONAS_H
+#define ZONAS_H
+
+#include "persona.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// MAPAS DE ZONAS POR BLOQUE
+// ============================================================================
+// La colección se divide en bloques de tamaño fijo y para cada bloque se
+// guardan mínimos/máximos de las columnas numéricas y máscaras de presencia
+// de ciudades y grupos. Las consultas de rango, igualdad y máximo descartan
+// los bloques que no pueden aportar filas sin leerlos.
+// ============================================================================
+
+/**
+ * Resumen de un bloque de filas consecutivas.
+ *
+ * NOTA: Las máscaras usan un bit por código de ciudad/grupo; los códigos a
+ *       partir de 63 comparten el último bit (significa "puede contener").
+ */
+struct ZonaBloque {
+    uint32_t inicio;            // Primera fila del bloque
+    uint32_t fin;               // Una más que la última fila del bloque
+    int edadMin, edadMax;
+    double patrimonioMin, patrimonioMax;
+    uint64_t mascaraCiudades;   // Ciudades presentes en el bloque
+    uint64_t mascaraGrupos;     // Grupos presentes en el bloque
+};
+
+/**
+ * Conteo de bloques leídos y descartados por una consulta.
+ */
+struct EstadisticaSalto {
+    size_t bloquesLeidos = 0;
+    size_t bloquesSaltados = 0;
+};
+
+/**
+ * Criterios para reordenar (agrupar) la colección antes de construir zonas.
+ */
+enum class CriterioAgrupacion { CIUDAD, EDAD, PATRIMONIO };
+
+/**
+ * Mapa de zonas sobre una colección de personas.
+ *
+ * PROPÓSITO: Evitar leer bloques que no pueden cumplir un predicado
+ * EFICACIA: Máxima cuando la colección está ordenada o agrupada por la
+ *           columna consultada; con datos aleatorios casi ningún bloque
+ *           se descarta en rangos, pero sí en máximos
+ * ADVERTENCIA: Guarda una referencia a la colección; debe reconstruirse si
+ *              la colección cambia
+ */
+class MapaZonas {
+public:
+    static const size_t FILAS_POR_BLOQUE = 65536;
+
+    explicit MapaZonas(const std::vector<Persona>& personas, size_t filasPorBloque = FILAS_POR_BLOQUE);
+
+    /** Cuenta personas con patrimonio > umbral. */
+    size_t contarPatrimonioMayorQue(double umbral, EstadisticaSalto& salto) const;
+
+    /** Cuenta personas con edad > umbral. */
+    size_t contarEdadMayorQue(int umbral, EstadisticaSalto& salto) const;
+
+    /** Cuenta personas nacidas en la ciudad indicada. */
+    size_t contarEnCiudad(const std::string& ciudad, EstadisticaSalto& salto) const;
+
+    /**
+     * Persona con mayor patrimonio en una ciudad.
+     * Descarta bloques sin la ciudad o cuyo máximo no supera al mejor actual.
+     *
+     * @return Puntero a la persona o nullptr si la ciudad no tiene personas
+     */
+    const Persona* masPatrimonioEnCiudad(const std::string& ciudad, EstadisticaSalto& salto) const;
+
+    /** Igual que masPatrimonioEnCiudad pero filtrando por grupo. */
+    const Persona* masPatrimonioEnGrupo(const std::string& grupo, EstadisticaSalto& salto) const;
+
+    size_t numeroBloques() const { return zonas.size(); }
+
+private:
+    uint64_t bitCiudad(const std::string& ciudad) const;
+    uint64_t bitGrupo(const std::string& grupo) const;
+
+    const std::vector<Persona>& personas;
+    std::vector<std::string> ciudades; // Código -> nombre
+    std::vector<std::string> grupos;   // Código -> nombre
+    std::vector<ZonaBloque> zonas;
+};
+
+/**
+ * Reordena la colección para que filas con valores cercanos queden juntas.
+ *
+ * PROPÓSITO: Hacer efectivos los mapas de zonas en consultas de rango
+ * ADVERTENCIA: Invalida índices, punteros y mapas construidos antes
+ */
+void agruparColeccion(std::vector<Persona>& personas, CriterioAgrupacion criterio);
+
+#endif // ZONAS_H